@@ -0,0 +1,59 @@
+﻿#include <Lupus/ByteReader.h>
+
+namespace Lupus {
+    ByteReader::ByteReader(const Byte* buffer, U32 size)
+    {
+        if (!buffer && size > 0) {
+            throw null_pointer("buffer points to NULL");
+        }
+
+        mBegin = mCursor = buffer;
+        mEnd = buffer + size;
+    }
+
+    ByteReader::ByteReader(const Vector<Byte>& buffer) NOEXCEPT :
+        mBegin(buffer.data()),
+        mCursor(buffer.data()),
+        mEnd(buffer.data() + buffer.size())
+    {
+    }
+
+    U32 ByteReader::Position() const NOEXCEPT
+    {
+        return (U32)(mCursor - mBegin);
+    }
+
+    U32 ByteReader::Remaining() const NOEXCEPT
+    {
+        return (U32)(mEnd - mCursor);
+    }
+
+    String ByteReader::ReadString()
+    {
+        U32 size = Read<U32>();
+        const Byte* data = Borrow(size);
+
+        return String((const char*)data, size);
+    }
+
+    void ByteReader::Read(Byte* buffer, U32 size)
+    {
+        memcpy(buffer, Borrow(size), size);
+    }
+
+    const Byte* ByteReader::Borrow(U32 size)
+    {
+        if (size > Remaining()) {
+            throw std::out_of_range("reader has not enough data left");
+        }
+
+        const Byte* result = mCursor;
+        mCursor += size;
+        return result;
+    }
+
+    void ByteReader::Skip(U32 size)
+    {
+        Borrow(size);
+    }
+}
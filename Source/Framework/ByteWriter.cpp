@@ -0,0 +1,126 @@
+﻿#include <Lupus/ByteWriter.h>
+#include <algorithm>
+
+namespace Lupus {
+    ByteWriter::ByteWriter() NOEXCEPT :
+        mCounting(true)
+    {
+    }
+
+    ByteWriter::ByteWriter(Byte* buffer, U32 size)
+    {
+        if (!buffer && size > 0) {
+            throw null_pointer("buffer points to NULL");
+        }
+
+        mBase = mCursor = buffer;
+        mEnd = buffer + size;
+    }
+
+    ByteWriter::ByteWriter(const ByteSegment* segments, U32 count)
+    {
+        if (!segments && count > 0) {
+            throw null_pointer("segments points to NULL");
+        }
+
+        mSegments = segments;
+        mSegmentCount = count;
+
+        if (count > 0) {
+            mBase = mCursor = segments[0].Data;
+            mEnd = segments[0].Data + segments[0].Size;
+        }
+    }
+
+    U32 ByteWriter::Written() const NOEXCEPT
+    {
+        return mFlushed + Used();
+    }
+
+    void ByteWriter::Write(bool value)
+    {
+        Write((U8)(value ? 1 : 0));
+    }
+
+    void ByteWriter::Write(const String& value)
+    {
+        if (value.size() > UINT32_MAX) {
+            throw std::out_of_range("string is too long");
+        }
+
+        Write((U32)value.size());
+        Write((const Byte*)value.data(), (U32)value.size());
+    }
+
+    void ByteWriter::Write(const Byte* buffer, U32 size)
+    {
+        if (mCounting) {
+            mFlushed += size;
+            return;
+        }
+
+        while (size > 0) {
+            if (mCursor == mEnd && !Next(1)) {
+                throw std::out_of_range("writer has no space left");
+            }
+
+            U32 count = std::min(size, (U32)(mEnd - mCursor));
+
+            memcpy(mCursor, buffer, count);
+            mCursor += count;
+            buffer += count;
+            size -= count;
+        }
+    }
+
+    Byte* ByteWriter::Reserve(U32 size)
+    {
+        // Der Aufrufer schreibt dann elementweise, was nur gezählt wird.
+        if (mCounting) {
+            return nullptr;
+        }
+
+        if ((U32)(mEnd - mCursor) < size && !Next(size)) {
+            return nullptr;
+        }
+
+        Byte* result = mCursor;
+        mCursor += size;
+        return result;
+    }
+
+    bool ByteWriter::Next(U32 size)
+    {
+        // Segmente werden nur gewechselt wenn das aktuelle voll ist, da sonst
+        // eine Lücke in den Daten entsteht.
+        if (!mSegments || mCursor != mEnd) {
+            return false;
+        }
+
+        while (++mSegmentIndex < mSegmentCount) {
+            const ByteSegment& segment = mSegments[mSegmentIndex];
+
+            Span(segment.Data, segment.Size);
+
+            if (segment.Size >= size && segment.Size > 0) {
+                return true;
+            } else if (segment.Size > 0) {
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    void ByteWriter::Span(Byte* buffer, U32 size) NOEXCEPT
+    {
+        mFlushed += Used();
+        mBase = mCursor = buffer;
+        mEnd = buffer + size;
+    }
+
+    U32 ByteWriter::Used() const NOEXCEPT
+    {
+        return (U32)(mCursor - mBase);
+    }
+}
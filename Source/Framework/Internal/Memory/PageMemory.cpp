@@ -0,0 +1,150 @@
+﻿#include <Internal/Memory/PageMemory.h>
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace Lupus {
+    namespace Internal {
+        namespace {
+            const size_t HugePageSize = 2 * 1024 * 1024;
+
+            size_t RoundUp(size_t size, size_t page)
+            {
+                return (size == 0) ? page : (size + page - 1) & ~(page - 1);
+            }
+
+            void Prefault(Byte* pages, size_t reserved, size_t page)
+            {
+                // Ein Schreibzugriff pro Seite lagert diese auf dem Knoten ein,
+                // an den der Bereich gebunden ist.
+                for (size_t offset = 0; offset < reserved; offset += page) {
+                    ((volatile Byte*)pages)[offset] = 0;
+                }
+            }
+
+#ifndef _MSC_VER
+            void* Map(size_t size, int flags)
+            {
+                return mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+            }
+
+            void Bind(Byte* pages, size_t reserved, S32 node)
+            {
+#ifdef SYS_mbind
+                const long bind = 2; // MPOL_BIND
+                unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {};
+
+                if (node >= 1024) {
+                    return;
+                }
+
+                mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+
+                // Schlägt die Bindung fehl, bspw ohne NUMA-Unterstützung,
+                // dann bleibt die Standardrichtlinie des Threads bestehen.
+                syscall(SYS_mbind, pages, reserved, bind, mask, sizeof(mask) * 8 + 1, 0);
+#endif
+            }
+#endif
+        }
+
+        Byte* AllocatePages(size_t size, const MemoryBacking& backing, size_t& reserved)
+        {
+#ifdef _MSC_VER
+            SYSTEM_INFO info;
+            DWORD node = (backing.NumaNode >= 0) ? (DWORD)backing.NumaNode : NUMA_NO_PREFERRED_NODE;
+            void* pages = nullptr;
+
+            GetSystemInfo(&info);
+
+            // Große Seiten benötigen das Recht SeLockMemoryPrivilege und sind
+            // immer sofort eingelagert.
+            if (backing.HugePages && GetLargePageMinimum() > 0) {
+                reserved = RoundUp(size, GetLargePageMinimum());
+                pages = VirtualAllocExNuma(GetCurrentProcess(), nullptr, reserved, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+            }
+
+            if (!pages) {
+                reserved = RoundUp(size, info.dwPageSize);
+                pages = VirtualAllocExNuma(GetCurrentProcess(), nullptr, reserved, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+            }
+
+            if (!pages) {
+                throw std::bad_alloc();
+            }
+
+            if (backing.Prefault) {
+                Prefault((Byte*)pages, reserved, info.dwPageSize);
+            }
+
+            return (Byte*)pages;
+#else
+            const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+            void* pages = MAP_FAILED;
+
+            if (backing.HugePages) {
+                reserved = RoundUp(size, HugePageSize);
+#ifdef MAP_HUGETLB
+                pages = Map(reserved, MAP_HUGETLB);
+#endif
+
+                // Ohne reservierte Huge Pages werden Transparent Huge Pages
+                // angefragt, die nur für ausgerichtete Bereiche greifen.
+                if (pages == MAP_FAILED) {
+                    Byte* raw = (Byte*)Map(reserved + HugePageSize, 0);
+
+                    if (raw == (Byte*)MAP_FAILED) {
+                        throw std::bad_alloc();
+                    }
+
+                    Byte* aligned = (Byte*)(((UIntPtr)raw + HugePageSize - 1) & ~(UIntPtr)(HugePageSize - 1));
+
+                    // Der Überhang vor und nach dem ausgerichteten Bereich
+                    // wird wieder freigegeben.
+                    if (aligned > raw) {
+                        munmap(raw, aligned - raw);
+                    }
+
+                    munmap(aligned + reserved, raw + HugePageSize - aligned);
+
+                    pages = aligned;
+#ifdef MADV_HUGEPAGE
+                    madvise(pages, reserved, MADV_HUGEPAGE);
+#endif
+                }
+            } else {
+                reserved = RoundUp(size, page);
+                pages = Map(reserved, 0);
+            }
+
+            if (pages == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+
+            if (backing.NumaNode >= 0) {
+                Bind((Byte*)pages, reserved, backing.NumaNode);
+            }
+
+            if (backing.Prefault) {
+                Prefault((Byte*)pages, reserved, page);
+            }
+
+            return (Byte*)pages;
+#endif
+        }
+
+        void FreePages(Byte* pages, size_t reserved) NOEXCEPT
+        {
+#ifdef _MSC_VER
+            VirtualFree(pages, 0, MEM_RELEASE);
+#else
+            munmap(pages, reserved);
+#endif
+        }
+    }
+}
@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include <Lupus/Memory/StackAllocator.h>
+
+namespace Lupus {
+    namespace Internal {
+        /*!
+         * Fordert ganze Seiten direkt vom System an, anstatt über new. Je
+         * nach MemoryBacking werden 2 MiB Seiten verwendet, der Speicher an
+         * einen NUMA-Knoten gebunden und alle Seiten sofort eingelagert.
+         *
+         * \param[in]   size        Die benötigte Größe in Bytes.
+         * \param[in]   backing     Die Art des Speichers.
+         * \param[out]  reserved    Die tatsächlich reservierte Größe, wird
+         *                          für FreePages benötigt.
+         *
+         * \returns Zeiger auf den Speicher, an der Seitengröße ausgerichtet.
+         */
+        Byte* AllocatePages(size_t size, const MemoryBacking& backing, size_t& reserved) LU_THROWS(std::bad_alloc);
+
+        /*!
+         * Gibt mit AllocatePages angeforderten Speicher frei.
+         *
+         * \param[in]   pages       Zeiger auf den Speicher.
+         * \param[in]   reserved    Die von AllocatePages gelieferte Größe.
+         */
+        void FreePages(Byte* pages, size_t reserved) NOEXCEPT;
+    }
+}
@@ -0,0 +1,172 @@
+﻿#include <Internal/Network/HandleTransfer.h>
+
+#ifndef _MSC_VER
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#ifndef MSG_CMSG_CLOEXEC
+#define MSG_CMSG_CLOEXEC 0
+#endif
+#endif
+
+namespace Lupus {
+    namespace Internal {
+#ifdef _MSC_VER
+        void SendHandles(SocketHandle channel, const Vector<SocketHandle>& handles, const Vector<Byte>& payload)
+        {
+            throw socket_error("Handle passing is not supported on this platform");
+        }
+
+        void ReceiveHandles(SocketHandle channel, Vector<SocketHandle>& handles, Vector<Byte>& payload)
+        {
+            throw socket_error("Handle passing is not supported on this platform");
+        }
+#else
+        namespace {
+            void ReceiveAll(SocketHandle channel, Byte* data, U32 size)
+            {
+                while (size > 0) {
+                    ssize_t result = recv(channel, data, size, 0);
+
+                    if (result < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+
+                        throw socket_error(GetLastSocketErrorString);
+                    } else if (result == 0) {
+                        throw socket_error("Channel was closed during handle transfer");
+                    }
+
+                    data += result;
+                    size -= (U32)result;
+                }
+            }
+        }
+
+        void SendHandles(SocketHandle channel, const Vector<SocketHandle>& handles, const Vector<Byte>& payload)
+        {
+            if (handles.empty() || handles.size() > MaxTransferHandles) {
+                throw std::invalid_argument("Number of handles is out of range");
+            }
+
+            // Nachricht: [U32 Handleanzahl][U32 Nutzdatengröße][Nutzdaten]
+            U32 header[2] = { (U32)handles.size(), (U32)payload.size() };
+            Vector<Byte> message((Byte*)header, (Byte*)header + sizeof(header));
+            message.insert(std::end(message), std::begin(payload), std::end(payload));
+
+            union {
+                cmsghdr align;
+                char buffer[CMSG_SPACE(sizeof(int) * MaxTransferHandles)];
+            } control;
+
+            iovec iov = { message.data(), message.size() };
+            msghdr msg;
+
+            memset(&control, 0, sizeof(control));
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control.buffer;
+            msg.msg_controllen = CMSG_SPACE(sizeof(int) * handles.size());
+
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int) * handles.size());
+            memcpy(CMSG_DATA(cmsg), handles.data(), sizeof(int) * handles.size());
+
+            // Die Handles werden mit dem ersten Byte übertragen, der Rest
+            // der Nachricht kann bei Stream-Sockets aufgeteilt werden.
+            ssize_t result;
+
+            while ((result = sendmsg(channel, &msg, MSG_NOSIGNAL)) < 0 && errno == EINTR) {
+            }
+
+            if (result < 0) {
+                throw socket_error(GetLastSocketErrorString);
+            }
+
+            while ((size_t)result < message.size()) {
+                ssize_t sent = send(channel, message.data() + result, message.size() - result, MSG_NOSIGNAL);
+
+                if (sent < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    throw socket_error(GetLastSocketErrorString);
+                }
+
+                result += sent;
+            }
+        }
+
+        void ReceiveHandles(SocketHandle channel, Vector<SocketHandle>& handles, Vector<Byte>& payload)
+        {
+            U32 header[2] = { 0, 0 };
+
+            union {
+                cmsghdr align;
+                char buffer[CMSG_SPACE(sizeof(int) * MaxTransferHandles)];
+            } control;
+
+            iovec iov = { header, sizeof(header) };
+            msghdr msg;
+            ssize_t result;
+
+            memset(&control, 0, sizeof(control));
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control.buffer;
+            msg.msg_controllen = sizeof(control.buffer);
+
+            while ((result = recvmsg(channel, &msg, MSG_CMSG_CLOEXEC)) < 0 && errno == EINTR) {
+            }
+
+            if (result < 0) {
+                throw socket_error(GetLastSocketErrorString);
+            } else if (result == 0) {
+                throw socket_error("Channel was closed during handle transfer");
+            }
+
+            handles.clear();
+
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+                    U32 count = (U32)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+                    const int* data = (const int*)CMSG_DATA(cmsg);
+                    handles.insert(std::end(handles), data, data + count);
+                }
+            }
+
+            try {
+                if (msg.msg_flags & MSG_CTRUNC) {
+                    throw socket_error("Handle transfer was truncated");
+                }
+
+                ReceiveAll(channel, (Byte*)header + result, (U32)(sizeof(header) - result));
+
+                if (header[0] != handles.size()) {
+                    throw socket_error("Handle transfer is missing handles");
+                }
+
+                payload.resize(header[1]);
+                ReceiveAll(channel, payload.data(), header[1]);
+            } catch (socket_error&) {
+                for (SocketHandle handle : handles) {
+                    closesocket(handle);
+                }
+
+                handles.clear();
+                throw;
+            }
+        }
+#endif
+    }
+}
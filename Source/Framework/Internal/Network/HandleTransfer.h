@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+
+namespace Lupus {
+    namespace Internal {
+        //! Maximale Anzahl an Handles pro Nachricht.
+        static const U32 MaxTransferHandles = 8;
+
+        /*!
+         * Sendet native Handles zusammen mit den Nutzdaten über einen
+         * verbundenen AF_UNIX Socket (SCM_RIGHTS). Der empfangende Prozess
+         * erhält Duplikate der Handles, die auf dieselben Kernelobjekte
+         * verweisen.
+         *
+         * \param[in]   channel Verbundener AF_UNIX Socket.
+         * \param[in]   handles Die zu übertragenden Handles.
+         * \param[in]   payload Nutzdaten die mit den Handles gesendet werden.
+         */
+        void SendHandles(SocketHandle channel, const Vector<SocketHandle>& handles, const Vector<Byte>& payload) LU_THROWS(socket_error, std::invalid_argument);
+
+        /*!
+         * Empfängt eine mit SendHandles gesendete Nachricht. Diese Funktion
+         * blockiert bis die gesamte Nachricht gelesen wurde.
+         *
+         * \param[in]   channel Verbundener AF_UNIX Socket.
+         * \param[out]  handles Die empfangenen Handles.
+         * \param[out]  payload Die empfangenen Nutzdaten.
+         */
+        void ReceiveHandles(SocketHandle channel, Vector<SocketHandle>& handles, Vector<Byte>& payload) LU_THROWS(socket_error);
+    }
+}
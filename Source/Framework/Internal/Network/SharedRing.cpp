@@ -0,0 +1,105 @@
+﻿#include <Internal/Network/SharedRing.h>
+
+namespace Lupus {
+    namespace Internal {
+        SharedRing::SharedRing(void* memory, U32 capacity) NOEXCEPT :
+            mHeader((SharedRingHeader*)memory),
+            mData((Byte*)memory + sizeof(SharedRingHeader)),
+            mCapacity(capacity),
+            mMask(capacity - 1)
+        {
+        }
+
+        U32 SharedRing::Size(U32 capacity) NOEXCEPT
+        {
+            return (U32)sizeof(SharedRingHeader) + capacity;
+        }
+
+        void SharedRing::Initialize() NOEXCEPT
+        {
+            mHeader->Head.store(0);
+            mHeader->Tail.store(0);
+            mHeader->ReaderWaiting.store(0);
+            mHeader->WriterWaiting.store(0);
+            mHeader->Closed.store(0);
+        }
+
+        SharedRingHeader* SharedRing::Header() const NOEXCEPT
+        {
+            return mHeader;
+        }
+
+        U32 SharedRing::Capacity() const NOEXCEPT
+        {
+            return mCapacity;
+        }
+
+        bool SharedRing::Empty() const NOEXCEPT
+        {
+            return mHeader->Head.load(std::memory_order_acquire) == mHeader->Tail.load(std::memory_order_relaxed);
+        }
+
+        U32 SharedRing::Peek() const NOEXCEPT
+        {
+            U64 tail = mHeader->Tail.load(std::memory_order_relaxed);
+            U32 size = 0;
+
+            if (mHeader->Head.load(std::memory_order_acquire) == tail) {
+                return 0;
+            }
+
+            CopyOut(tail, (Byte*)&size, 4);
+            return size;
+        }
+
+        bool SharedRing::TryWrite(const Byte* data, U32 size) NOEXCEPT
+        {
+            U64 head = mHeader->Head.load(std::memory_order_relaxed);
+            U64 tail = mHeader->Tail.load(std::memory_order_acquire);
+
+            if ((U64)size + 4 > mCapacity - (head - tail)) {
+                return false;
+            }
+
+            CopyIn(head, (const Byte*)&size, 4);
+            CopyIn(head + 4, data, size);
+
+            // Die Schreibposition wird erst nach den Daten veröffentlicht.
+            mHeader->Head.store(head + 4 + size, std::memory_order_seq_cst);
+            return true;
+        }
+
+        S32 SharedRing::TryRead(Byte* data, U32 size) NOEXCEPT
+        {
+            U64 tail = mHeader->Tail.load(std::memory_order_relaxed);
+            U32 length = 0;
+
+            if (mHeader->Head.load(std::memory_order_acquire) == tail) {
+                return -1;
+            }
+
+            CopyOut(tail, (Byte*)&length, 4);
+            CopyOut(tail + 4, data, (size < length) ? size : length);
+            mHeader->Tail.store(tail + 4 + length, std::memory_order_seq_cst);
+            return (S32)((size < length) ? size : length);
+        }
+
+        void SharedRing::CopyIn(U64 position, const Byte* data, U32 size) NOEXCEPT
+        {
+            U32 index = (U32)(position & mMask);
+            U32 first = (size < mCapacity - index) ? size : mCapacity - index;
+
+            memcpy(mData + index, data, first);
+            memcpy(mData, data + first, size - first);
+        }
+
+        void SharedRing::CopyOut(U64 position, Byte* data, U32 size) const NOEXCEPT
+        {
+            U32 index = (U32)(position & mMask);
+            U32 first = (size < mCapacity - index) ? size : mCapacity - index;
+
+            memcpy(data, mData + index, first);
+            memcpy(data + first, mData, size - first);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+
+namespace Lupus {
+    namespace Internal {
+        /*!
+         * Kopf eines Rings im geteilten Speicher. Lese- und Schreibposition
+         * liegen auf eigenen Cache-Lines, damit Produzent und Konsument sich
+         * nicht gegenseitig ausbremsen. Die Positionen laufen monoton und
+         * werden erst beim Zugriff auf den Datenbereich maskiert.
+         */
+        struct SharedRingHeader
+        {
+            Atomic<U64> Head; //!< Schreibposition, nur vom Produzenten verändert.
+            Byte HeadPadding[64 - sizeof(Atomic<U64>)];
+            Atomic<U64> Tail; //!< Leseposition, nur vom Konsumenten verändert.
+            Byte TailPadding[64 - sizeof(Atomic<U64>)];
+            Atomic<U32> ReaderWaiting; //!< Konsument schläft und will geweckt werden.
+            Atomic<U32> WriterWaiting; //!< Produzent wartet auf freien Platz.
+            Atomic<U32> Closed; //!< Eine Seite hat den Kanal geschlossen.
+            Byte FlagPadding[64 - 3 * sizeof(Atomic<U32>)];
+        };
+
+        /*!
+         * Single-Producer/Single-Consumer Ring für Nachrichten variabler
+         * Länge. Jede Nachricht besteht aus einer 4 Byte Länge gefolgt von
+         * den Nutzdaten, beide dürfen über das Ende des Datenbereichs hinaus
+         * umbrechen.
+         *
+         * Der Ring besitzt den Speicher nicht, er wird lediglich über den
+         * Kopf und den direkt anschließenden Datenbereich gelegt.
+         */
+        class SharedRing
+        {
+        public:
+            SharedRing() = default;
+            SharedRing(void* memory, U32 capacity) NOEXCEPT;
+
+            //! \returns Die benötigte Speichergröße für einen Ring.
+            static U32 Size(U32 capacity) NOEXCEPT;
+
+            //! Setzt Positionen und Flags zurück. Nur vom Ersteller aufrufen.
+            void Initialize() NOEXCEPT;
+
+            //! \returns Zeiger auf den Kopf des Rings.
+            SharedRingHeader* Header() const NOEXCEPT;
+
+            //! \returns Die Größe des Datenbereichs in Bytes.
+            U32 Capacity() const NOEXCEPT;
+
+            //! \returns TRUE wenn keine Nachricht im Ring liegt.
+            bool Empty() const NOEXCEPT;
+
+            //! \returns Die Größe der nächsten Nachricht oder Null.
+            U32 Peek() const NOEXCEPT;
+
+            /*!
+             * Schreibt eine Nachricht falls genug Platz vorhanden ist.
+             *
+             * \returns FALSE wenn der Ring zu voll ist.
+             */
+            bool TryWrite(const Byte* data, U32 size) NOEXCEPT;
+
+            /*!
+             * Liest die nächste Nachricht. Ist der Buffer zu klein, dann wird
+             * die Nachricht abgeschnitten und der Rest verworfen.
+             *
+             * \returns Die Anzahl der kopierten Bytes oder -1 wenn der Ring
+             *          leer ist.
+             */
+            S32 TryRead(Byte* data, U32 size) NOEXCEPT;
+
+        private:
+
+            void CopyIn(U64 position, const Byte* data, U32 size) NOEXCEPT;
+            void CopyOut(U64 position, Byte* data, U32 size) const NOEXCEPT;
+
+            SharedRingHeader* mHeader = nullptr;
+            Byte* mData = nullptr;
+            U32 mCapacity = 0;
+            U32 mMask = 0;
+        };
+    }
+}
@@ -1,17 +1,66 @@
 ﻿#include <Lupus/Network/Socket.h>
 #include <Internal/Network/SocketState.h>
+#include <Internal/Network/HandleTransfer.h>
 #include <Lupus/Network/IPAddress.h>
-#include <Lupus/Network/IPEndPoint.h>
+#include <Lupus/Network/EndPoint.h>
 #include <Lupus/Network/SocketInformation.h>
+#include <Lupus/Network/EventLoop.h>
+#include <Lupus/ByteWriter.h>
+#include <algorithm>
+
+#ifndef _MSC_VER
+#include <sys/uio.h>
+#endif
 
 namespace Lupus {
 	namespace Internal {
+        namespace {
+            //! Maximale Anzahl an Segmenten pro Systemaufruf.
+            const U32 MaxSegments = Socket::MaxSegments;
+
+            Pointer<EndPoint> GetEndPoint(const AddrStorage& storage, AddrLength length)
+            {
+                try {
+                    return EndPoint::Create(Vector<Byte>((Byte*)&storage, (Byte*)&storage + sizeof(AddrStorage)), (U32)length);
+                } catch (std::invalid_argument&) {
+                    // Unbekannte Adressfamilie bzw unbenannter Sender
+                    return EndPointPtr(nullptr);
+                }
+            }
+
+            // Ob der Kernel dem Socket bereits eine Adresse zugewiesen hat.
+            bool HasAddress(const AddrStorage& storage, AddrLength length)
+            {
+                switch (storage.ss_family) {
+                    case AF_INET:
+                        return ((const AddrIn&)storage).sin_port != 0;
+
+                    case AF_INET6:
+                        return ((const AddrIn6&)storage).sin6_port != 0;
+
+                    default:
+                        return length > sizeof(storage.ss_family);
+                }
+            }
+
+            // Nicht blockierende Sockets bauen die Verbindung im Hintergrund
+            // auf, sie steht sobald der Socket schreibbar ist.
+            bool IsConnectPending(Socket* socket)
+            {
+#ifdef _MSC_VER
+                return !socket->Blocking() && WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+                return !socket->Blocking() && errno == EINPROGRESS;
+#endif
+            }
+        }
+
 		Pointer<Socket> SocketState::Accept(Socket* socket)
 		{
 			throw socket_error("Socket is not in an valid state for Accept");
 		}
 		
-		void SocketState::Bind(Socket* socket, Pointer<IPEndPoint> localEndPoint)
+		void SocketState::Bind(Socket* socket, Pointer<EndPoint> localEndPoint)
 		{
 			throw socket_error("Socket is not in an valid state for Bind");
 		}
@@ -26,8 +75,8 @@ namespace Lupus {
             socket->mSendTime = 0;
             socket->mRecvTime = 0;
             socket->mBlocking = true;
-            socket->mLocal = IPEndPointPtr(nullptr);
-            socket->mRemote = IPEndPointPtr(nullptr);
+            socket->mLocal = EndPointPtr(nullptr);
+            socket->mRemote = EndPointPtr(nullptr);
             socket->mBound = false;
             socket->mConnected = false;
             ChangeState(socket, Pointer<SocketState>(new SocketClosed()));
@@ -39,57 +88,133 @@ namespace Lupus {
                 throw socket_error("Cannot close invalid socket handle");
             }
 
-            Thread t([this, &socket, timeout]() {
-                std::this_thread::sleep_for(std::chrono::seconds(timeout));
-                this->Close(socket);
-            });
+            // Der Zeitgeber hängt an der Lebensdauer des Sockets und nicht an
+            // dessen Zustand. Wurde der Socket inzwischen zerstört oder das
+            // Handle geschlossen, dann verfällt der Zeitgeber.
+            if (!socket->mDelayedClose) {
+                socket->mDelayedClose.reset(new DelayedClose());
+                socket->mDelayedClose->Target = socket;
+            }
 
-            t.detach();
+            Pointer<DelayedClose> token = socket->mDelayedClose;
+            SocketHandle handle = socket->Handle();
+
+            EventLoop::Shared()->Schedule((U64)timeout * 1000, [token, handle]() {
+                LockGuard<Mutex> lock(token->Lock);
+
+                if (token->Target && token->Target->Handle() == handle) {
+                    try {
+                        token->Target->Close();
+                    } catch (socket_error&) {
+                    }
+                }
+            });
 		}
 		
-		void SocketState::Connect(Socket* socket, Pointer<IPEndPoint> remoteEndPoint)
+		void SocketState::Connect(Socket* socket, Pointer<EndPoint> remoteEndPoint)
 		{
 			throw socket_error("Socket is not in an valid state for Connect");
 		}
 
         SocketInformation SocketState::DuplicateAndClose(Socket* socket)
         {
-            IPEndPointPtr point;
-            S32 family = (S32)socket->Family();
-            S32 type = (S32)socket->Type();
-            S32 protocol = (S32)socket->Protocol();
-            SocketInformation info = {
-                SocketInformationOption::None,
-                Vector<Byte>()
-            };
-
             if (!socket->mLocal && !socket->mRemote) {
                 throw null_pointer("Socket endpoint points to NULL");
-            } else if (!socket->mLocal) {
-                point = socket->mRemote;
-            } else {
-                point = socket->mLocal;
             }
 
-            info.ProtocolInformation.insert(std::end(info.ProtocolInformation), (Byte*)&family, (Byte*)&family + 4);
-            info.ProtocolInformation.insert(std::end(info.ProtocolInformation), (Byte*)&type, (Byte*)&type + 4);
-            info.ProtocolInformation.insert(std::end(info.ProtocolInformation), (Byte*)&protocol, (Byte*)&protocol + 4);
+            SocketInformation info = GetSocketInformation(socket);
+            Close(socket);
+            return info;
+        }
 
-            if (socket->IsBound()) {
-                Vector<Byte> bytes = point->Address()->Bytes();
-                info.Options = SocketInformationOption::Bound;
-                info.ProtocolInformation.insert(std::end(info.ProtocolInformation), std::begin(bytes), std::end(bytes));
-            } else if (socket->IsConnected()) {
-                Vector<Byte> bytes = socket->mRemote->Address()->Bytes();
-                info.Options = SocketInformationOption::Connected;
-                info.ProtocolInformation.insert(std::end(info.ProtocolInformation), std::begin(bytes), std::end(bytes));
-            } else {
-                info.ProtocolInformation.resize(info.ProtocolInformation.size() + sizeof(AddrStorage));
+        SocketInformation SocketState::DuplicateAndClose(Socket* socket, Pointer<Socket> channel)
+        {
+            SocketInformation info = Duplicate(socket, channel);
+            Close(socket);
+            return info;
+        }
+
+        SocketInformation SocketState::Duplicate(Socket* socket, Pointer<Socket> channel)
+        {
+            if (!channel) {
+                throw null_pointer("channel points to NULL");
+            } else if (channel->Family() != AddressFamily::UNIX) {
+                throw socket_error("channel must be an AF_UNIX socket");
             }
 
-            Close(socket);
+            SocketInformation info = GetSocketInformation(socket);
+            U32 options = (U32)info.Options;
+            Vector<Byte> payload((Byte*)&options, (Byte*)&options + 4);
+
+            payload.insert(std::end(payload), std::begin(info.ProtocolInformation), std::end(info.ProtocolInformation));
+            SendHandles(channel->Handle(), Vector<SocketHandle>(1, socket->Handle()), payload);
             return info;
         }
+
+        Pointer<Socket> SocketState::ReceiveDuplicate(Pointer<Socket> channel)
+        {
+            if (!channel) {
+                throw null_pointer("channel points to NULL");
+            } else if (channel->Family() != AddressFamily::UNIX) {
+                throw socket_error("channel must be an AF_UNIX socket");
+            }
+
+            Vector<SocketHandle> handles;
+            Vector<Byte> payload;
+
+            ReceiveHandles(channel->Handle(), handles, payload);
+
+            if (handles.size() != 1 || payload.size() != 4 + 16 + sizeof(AddrStorage)) {
+                for (SocketHandle handle : handles) {
+                    closesocket(handle);
+                }
+
+                throw socket_error("Received invalid socket information");
+            }
+
+            AddrStorage storage;
+            AddrLength length = sizeof(AddrStorage);
+            bool bound = false;
+            Socket* socket = new Socket();
+            SocketPtr result(socket);
+
+            socket->mHandle = handles[0];
+            socket->mFamily = (U16)*((S32*)(payload.data() + 4));
+            socket->mType = (U16)*((S32*)(payload.data() + 8));
+            socket->mProtocol = (U16)*((S32*)(payload.data() + 12));
+
+#ifndef _MSC_VER
+            socket->mBlocking = !(fcntl(socket->mHandle, F_GETFL) & O_NONBLOCK);
+#endif
+
+            // Der Handle ist derselbe Kernel-Socket, Endpunkte und Zustand
+            // werden daher direkt abgefragt. Die Optionen kennen bspw von
+            // einem gebundenen und danach verbundenen Socket nur einen der
+            // beiden Zustände.
+            memset(&storage, 0, sizeof(AddrStorage));
+
+            if (getsockname(socket->mHandle, (Addr*)&storage, &length) == 0) {
+                socket->mLocal = GetEndPoint(storage, length);
+                bound = HasAddress(storage, length);
+            }
+
+            length = sizeof(AddrStorage);
+            memset(&storage, 0, sizeof(AddrStorage));
+
+            if (getpeername(socket->mHandle, (Addr*)&storage, &length) == 0) {
+                socket->mRemote = GetEndPoint(storage, length);
+                socket->mState = Pointer<SocketState>(new SocketConnected(socket, socket->mRemote));
+                socket->mBound = bound;
+            } else if (socket->IsListening()) {
+                socket->mState = Pointer<SocketState>(new SocketListen(socket));
+            } else if (bound) {
+                socket->mState = Pointer<SocketState>(new SocketBound(socket, socket->mLocal));
+            } else {
+                socket->mState = Pointer<SocketState>(new SocketReady(socket));
+            }
+
+            return result;
+        }
 		
 		void SocketState::Listen(Socket* socket, U32 backlog)
 		{
@@ -101,17 +226,32 @@ namespace Lupus {
 			throw socket_error("Socket is not in an valid state for Receive");
 		}
 		
-		S32 SocketState::ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint>& remoteEndPoint)
+		S32 SocketState::ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint)
 		{
 			throw socket_error("Socket is not in an valid state for ReceiveFrom");
 		}
+
+        S32 SocketState::Receive(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, SocketError& errorCode)
+        {
+            throw socket_error("Socket is not in an valid state for Receive");
+        }
+
+        S32 SocketState::ReceiveFrom(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint)
+        {
+            throw socket_error("Socket is not in an valid state for ReceiveFrom");
+        }
 		
 		S32 SocketState::Send(Socket* socket, const Vector<Byte>& buaffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode)
 		{
 			throw socket_error("Socket is not in an valid state for Send");
 		}
 		
-		S32 SocketState::SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint> remoteEndPoint)
+        S32 SocketState::Send(Socket* socket, const ByteSegment* segments, U32 count, SocketFlags socketFlags, SocketError& errorCode)
+        {
+            throw socket_error("Socket is not in an valid state for Send");
+        }
+
+		S32 SocketState::SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint)
 		{
 			throw socket_error("Socket is not in an valid state for SendTo");
 		}
@@ -121,47 +261,118 @@ namespace Lupus {
 			throw socket_error("Socket is not in an valid state for Shutdown");
 		}
 
-        Pointer<Socket> SocketState::CreateSocket(SocketHandle h, AddrStorage s)
+        SocketInformation SocketState::GetSocketInformation(Socket* socket) const NOEXCEPT
+        {
+            S32 family = (S32)socket->Family();
+            S32 type = (S32)socket->Type();
+            S32 protocol = (S32)socket->Protocol();
+            U32 length = 0;
+            Vector<Byte> address;
+            SocketInformation info = {
+                SocketInformationOption::None,
+                Vector<Byte>()
+            };
+
+            info.ProtocolInformation.insert(std::end(info.ProtocolInformation), (Byte*)&family, (Byte*)&family + 4);
+            info.ProtocolInformation.insert(std::end(info.ProtocolInformation), (Byte*)&type, (Byte*)&type + 4);
+            info.ProtocolInformation.insert(std::end(info.ProtocolInformation), (Byte*)&protocol, (Byte*)&protocol + 4);
+
+            // Ein gebundener und danach verbundener Socket gilt als verbunden.
+            if (socket->IsConnected() && socket->mRemote) {
+                address = socket->mRemote->Serialize();
+                length = socket->mRemote->Length();
+                info.Options = SocketInformationOption::Connected;
+            } else if (socket->IsBound() && socket->mLocal) {
+                address = socket->mLocal->Serialize();
+                length = socket->mLocal->Length();
+                info.Options = SocketInformationOption::Bound;
+            } else {
+                address.resize(sizeof(AddrStorage));
+            }
+
+            info.ProtocolInformation.insert(std::end(info.ProtocolInformation), std::begin(address), std::end(address));
+            info.ProtocolInformation.insert(std::end(info.ProtocolInformation), (Byte*)&length, (Byte*)&length + 4);
+            return info;
+        }
+
+        Pointer<Socket> SocketState::CreateSocket(Socket* listener, SocketHandle h, AddrStorage s, AddrLength l) NOEXCEPT
         {
             Socket* sock = new Socket();
             sock->mHandle = h;
+            sock->mFamily = listener->mFamily;
+            sock->mType = listener->mType;
+            sock->mProtocol = listener->mProtocol;
             sock->mConnected = true;
-            sock->mRemote = IPEndPointPtr(new IPEndPoint(Vector<Byte>((Byte*)&s, (Byte*)&s + sizeof(AddrStorage))));
+            sock->mRemote = GetEndPoint(s, l);
             sock->mState = Pointer<SocketState>(new SocketConnected(sock));
             return SocketPtr(sock);
         }
 
-		void SocketState::ChangeState(Socket* socket, Pointer<SocketState> state)
+        S32 SocketState::ReceiveFromHandle(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint)
+        {
+            if (offset > buffer.size() || size > buffer.size() - offset) {
+                throw std::out_of_range("offset and size does not match buffer size");
+            }
+
+            return ReceiveFromHandle(socket, buffer.data() + offset, size, socketFlags, remoteEndPoint);
+        }
+
+        S32 SocketState::ReceiveFromHandle(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) NOEXCEPT
+        {
+            S32 result = 0;
+            AddrStorage storage;
+            AddrLength length = sizeof(AddrStorage);
+
+            memset(&storage, 0, sizeof(AddrStorage));
+            result = recvfrom(socket->Handle(), (char*)buffer, size, (int)socketFlags, (Addr*)&storage, &length);
+            remoteEndPoint = (result >= 0) ? GetEndPoint(storage, length) : EndPointPtr(nullptr);
+            return result;
+        }
+
+        S32 SocketState::SendToHandle(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint)
+        {
+            if (!remoteEndPoint) {
+                throw socket_error("remoteEndPoint points to NULL");
+            } else if (offset > buffer.size() || size > buffer.size() - offset) {
+                throw std::out_of_range("offset and size does not match buffer size");
+            }
+
+            Vector<Byte> address = remoteEndPoint->Serialize();
+
+            return sendto(socket->Handle(), (const char*)&buffer[offset], size, (int)socketFlags, (const Addr*)address.data(), (AddrLength)remoteEndPoint->Length());
+        }
+
+		void SocketState::ChangeState(Socket* socket, Pointer<SocketState> state) NOEXCEPT
 		{
             socket->mState = state;
         }
 
-        void SocketState::SetLocalEndPoint(Socket* socket, Pointer<IPEndPoint> remote)
+        void SocketState::SetLocalEndPoint(Socket* socket, Pointer<EndPoint> remote) NOEXCEPT
         {
             socket->mLocal = remote;
         }
 
-        void SocketState::SetRemoteEndPoint(Socket* socket, Pointer<IPEndPoint> remote)
+        void SocketState::SetRemoteEndPoint(Socket* socket, Pointer<EndPoint> remote) NOEXCEPT
         {
             socket->mRemote = remote;
         }
 
-        Pointer<IPEndPoint> SocketState::GetLocalEndPoint(Socket* socket) const
+        Pointer<EndPoint> SocketState::GetLocalEndPoint(Socket* socket) const NOEXCEPT
         {
             return socket->mLocal;
         }
 
-        Pointer<IPEndPoint> SocketState::GetRemoteEndPoint(Socket* socket) const
+        Pointer<EndPoint> SocketState::GetRemoteEndPoint(Socket* socket) const NOEXCEPT
         {
             return socket->mRemote;
         }
 
-        void SocketState::SetConnected(Socket* socket, bool value)
+        void SocketState::SetConnected(Socket* socket, bool value) NOEXCEPT
         {
             socket->mConnected = value;
         }
 
-        void SocketState::SetBound(Socket* socket, bool value)
+        void SocketState::SetBound(Socket* socket, bool value) NOEXCEPT
         {
             socket->mBound = value;
         }
@@ -171,28 +382,25 @@ namespace Lupus {
             SetBound(socket, true);
         }
 
-        SocketBound::SocketBound(Socket* socket, Pointer<IPEndPoint> endPoint)
+        SocketBound::SocketBound(Socket* socket, Pointer<EndPoint> endPoint)
         {
             SetBound(socket, true);
             SetLocalEndPoint(socket, endPoint);
         }
 
-        void SocketBound::Connect(Socket* socket, Pointer<IPEndPoint> remoteEndPoint)
+        void SocketBound::Connect(Socket* socket, Pointer<EndPoint> remoteEndPoint)
         {
             if (!remoteEndPoint) {
                 throw null_pointer("remoteEndPoint points to NULL");
             }
 
-            AddrStorage storage;
-
-            memset(&storage, 0, sizeof(AddrStorage));
-            memcpy(&storage, remoteEndPoint->Serialize().data(), sizeof(AddrStorage));
+            Vector<Byte> address = remoteEndPoint->Serialize();
 
-            if (connect(socket->Handle(), (Addr*)&storage, sizeof(AddrStorage)) != 0) {
+            if (connect(socket->Handle(), (const Addr*)address.data(), (AddrLength)remoteEndPoint->Length()) != 0 && !IsConnectPending(socket)) {
                 throw socket_error(GetLastSocketErrorString);
             }
 
-            ChangeState(socket, Pointer<SocketState>(new SocketConnected(socket)));
+            ChangeState(socket, Pointer<SocketState>(new SocketConnected(socket, remoteEndPoint)));
         }
 
         void SocketBound::Listen(Socket* socket, U32 backlog)
@@ -204,6 +412,21 @@ namespace Lupus {
             ChangeState(socket, Pointer<SocketState>(new SocketListen(socket)));
         }
 
+        S32 SocketBound::ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint)
+        {
+            return ReceiveFromHandle(socket, buffer, offset, size, socketFlags, remoteEndPoint);
+        }
+
+        S32 SocketBound::ReceiveFrom(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint)
+        {
+            return ReceiveFromHandle(socket, buffer, size, socketFlags, remoteEndPoint);
+        }
+
+        S32 SocketBound::SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint)
+        {
+            return SendToHandle(socket, buffer, offset, size, socketFlags, remoteEndPoint);
+        }
+
         SocketListen::SocketListen(Socket* s)
         {
             SetConnected(s, false);
@@ -214,15 +437,15 @@ namespace Lupus {
         {
             SocketHandle handle;
             AddrStorage storage;
-            AddrLength length;
+            AddrLength length = sizeof(AddrStorage);
 
             memset(&storage, 0, sizeof(AddrStorage));
 
-            if ((handle = accept(socket->Handle(), (Addr*)&storage, &length)) != INVALID_SOCKET) {
+            if ((handle = accept(socket->Handle(), (Addr*)&storage, &length)) == INVALID_SOCKET) {
                 throw socket_error(GetLastSocketErrorString);
             }
 
-            return CreateSocket(handle, storage);
+            return CreateSocket(socket, handle, storage, length);
         }
 
         SocketConnected::SocketConnected(Socket* s)
@@ -230,24 +453,21 @@ namespace Lupus {
             SetConnected(s, true);
         }
 
-        SocketConnected::SocketConnected(Socket* s, Pointer<IPEndPoint> p)
+        SocketConnected::SocketConnected(Socket* s, Pointer<EndPoint> p)
         {
             SetConnected(s, true);
             SetRemoteEndPoint(s, p);
         }
 
-        void SocketConnected::Connect(Socket* socket, Pointer<IPEndPoint> remoteEndPoint)
+        void SocketConnected::Connect(Socket* socket, Pointer<EndPoint> remoteEndPoint)
         {
             if (!remoteEndPoint) {
                 throw null_pointer("remoteEndPoint points to NULL");
             }
 
-            AddrStorage storage;
-
-            memset(&storage, 0, sizeof(AddrStorage));
-            memcpy(&storage, remoteEndPoint->Serialize().data(), sizeof(AddrStorage));
+            Vector<Byte> address = remoteEndPoint->Serialize();
 
-            if (connect(socket->Handle(), (Addr*)&storage, sizeof(AddrStorage)) != 0) {
+            if (connect(socket->Handle(), (const Addr*)address.data(), (AddrLength)remoteEndPoint->Length()) != 0) {
                 throw socket_error(GetLastSocketErrorString);
             }
         }
@@ -258,23 +478,22 @@ namespace Lupus {
                 throw std::out_of_range("offset and size does not match buffer size");
             }
 
-            return recv(socket->Handle(), (char*)buffer[offset], size, (int)socketFlags);
+            return Receive(socket, buffer.data() + offset, size, socketFlags, errorCode);
         }
         
-        S32 SocketConnected::ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint>& remoteEndPoint)
+        S32 SocketConnected::ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint)
         {
-            if (offset > buffer.size() || size > buffer.size() - offset) {
-                throw std::out_of_range("offset and size does not match buffer size");
-            }
+            return ReceiveFromHandle(socket, buffer, offset, size, socketFlags, remoteEndPoint);
+        }
 
-            S32 result = 0;
-            AddrStorage storage;
-            AddrLength length = sizeof(AddrStorage);
+        S32 SocketConnected::Receive(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, SocketError& errorCode)
+        {
+            return recv(socket->Handle(), (char*)buffer, size, (int)socketFlags);
+        }
 
-            memset(&storage, 0, sizeof(AddrStorage));
-            result = recvfrom(socket->Handle(), (char*)&buffer[offset], size, (int)socketFlags, (Addr*)&storage, &length);
-            remoteEndPoint = IPEndPointPtr(new IPEndPoint(Vector<Byte>((Byte*)&storage, (Byte*)&storage + sizeof(AddrLength))));
-            return result;
+        S32 SocketConnected::ReceiveFrom(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint)
+        {
+            return ReceiveFromHandle(socket, buffer, size, socketFlags, remoteEndPoint);
         }
 
         S32 SocketConnected::Send(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode)
@@ -286,15 +505,45 @@ namespace Lupus {
             return send(socket->Handle(), (const char*)&buffer[offset], size, (int)socketFlags);
         }
         
-        S32 SocketConnected::SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint> remoteEndPoint)
+        S32 SocketConnected::Send(Socket* socket, const ByteSegment* segments, U32 count, SocketFlags socketFlags, SocketError& errorCode)
         {
-            if (offset > buffer.size() || size > buffer.size() - offset) {
-                throw std::out_of_range("offset and size does not match buffer size");
+#ifdef _MSC_VER
+            WSABUF buffers[MaxSegments];
+            DWORD sent = 0;
+
+            count = std::min(count, MaxSegments);
+
+            for (U32 i = 0; i < count; i++) {
+                buffers[i].buf = (char*)segments[i].Data;
+                buffers[i].len = (ULONG)segments[i].Size;
             }
 
-            Vector<Byte> address = remoteEndPoint->Serialize();
+            if (WSASend(socket->Handle(), buffers, count, &sent, (DWORD)socketFlags, nullptr, nullptr) != 0) {
+                return SOCKET_ERROR;
+            }
 
-            return sendto(socket->Handle(), (const char*)buffer[offset], size, (int)socketFlags, (const Addr*)address.data(), buffer.size());
+            return (S32)sent;
+#else
+            iovec buffers[MaxSegments];
+            msghdr message;
+
+            count = std::min(count, MaxSegments);
+
+            for (U32 i = 0; i < count; i++) {
+                buffers[i].iov_base = segments[i].Data;
+                buffers[i].iov_len = segments[i].Size;
+            }
+
+            memset(&message, 0, sizeof(message));
+            message.msg_iov = buffers;
+            message.msg_iovlen = count;
+            return (S32)sendmsg(socket->Handle(), &message, (int)socketFlags);
+#endif
+        }
+
+        S32 SocketConnected::SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint)
+        {
+            return SendToHandle(socket, buffer, offset, size, socketFlags, remoteEndPoint);
         }
         
         void SocketConnected::Shutdown(Socket* socket, SocketShutdown how)
@@ -310,23 +559,47 @@ namespace Lupus {
             SetConnected(s, false);
         }
 
-        void SocketReady::Bind(Socket* socket, Pointer<IPEndPoint> localEndPoint) throw(socket_error)
+        void SocketReady::Bind(Socket* socket, Pointer<EndPoint> localEndPoint) LU_THROWS(socket_error)
         {
+            if (!localEndPoint) {
+                throw null_pointer("localEndPoint points to NULL");
+            }
+
             int yes = 1;
             Vector<Byte> address = localEndPoint->Serialize();
 
-            if (setsockopt(socket->Handle(), SOL_SOCKET, SO_REUSEADDR, (const char*)yes, sizeof(int)) != 0) {
+            if (setsockopt(socket->Handle(), SOL_SOCKET, SO_REUSEADDR, (const char*)&yes, sizeof(int)) != 0) {
+                throw socket_error(GetLastSocketErrorString);
+            }
+
+            if (bind(socket->Handle(), (const Addr*)address.data(), (AddrLength)localEndPoint->Length()) != 0) {
                 throw socket_error(GetLastSocketErrorString);
             }
 
             ChangeState(socket, Pointer<SocketState>(new SocketBound(socket, localEndPoint)));
         }
 
-        void SocketReady::Connect(Socket* socket, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, null_pointer)
+        void SocketReady::Connect(Socket* socket, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, null_pointer)
         {
+            if (!remoteEndPoint) {
+                throw null_pointer("remoteEndPoint points to NULL");
+            }
+
+            Vector<Byte> address = remoteEndPoint->Serialize();
+
+            if (connect(socket->Handle(), (const Addr*)address.data(), (AddrLength)remoteEndPoint->Length()) != 0 && !IsConnectPending(socket)) {
+                throw socket_error(GetLastSocketErrorString);
+            }
+
             ChangeState(socket, Pointer<SocketState>(new SocketConnected(socket, remoteEndPoint)));
         }
 
+        S32 SocketReady::SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint)
+        {
+            // Datagram-Sockets werden beim ersten Senden implizit gebunden.
+            return SendToHandle(socket, buffer, offset, size, socketFlags, remoteEndPoint);
+        }
+
         void SocketClosed::Close(Socket* socket)
         {
             throw socket_error("Socket is not in an valid state for Close");
@@ -341,5 +614,15 @@ namespace Lupus {
         {
             throw socket_error("Socket is not in an valid state for DuplicateAndClose");
         }
+
+        SocketInformation SocketClosed::DuplicateAndClose(Socket* socket, Pointer<Socket> channel)
+        {
+            throw socket_error("Socket is not in an valid state for DuplicateAndClose");
+        }
+
+        SocketInformation SocketClosed::Duplicate(Socket* socket, Pointer<Socket> channel)
+        {
+            throw socket_error("Socket is not in an valid state for Duplicate");
+        }
     }
 }
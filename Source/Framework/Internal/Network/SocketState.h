@@ -4,38 +4,60 @@
 
 namespace Lupus {
     struct SocketInformation;
-    class IPEndPoint;
+    struct ByteSegment;
+    class EndPoint;
     class IPAddress;
     class Socket;
 
     namespace Internal {
+        //! Verbindet verzögerte Schließvorgänge mit der Lebensdauer des
+        //! Sockets. ~Socket setzt Target unter Lock auf einen nullptr.
+        struct DelayedClose
+        {
+            Mutex Lock;
+            Socket* Target;
+        };
+
         class SocketState : public ReferenceType
         {
         public:
             virtual ~SocketState() = default;
 
-            virtual Pointer<Socket> Accept(Socket* socket) throw(socket_error);
-            virtual void Bind(Socket* socket, Pointer<IPEndPoint> localEndPoint) throw(socket_error);
-            virtual void Close(Socket* socket) throw(socket_error);
-            virtual void Close(Socket* socket, U32 timeout) throw(socket_error);
-            virtual void Connect(Socket* socket, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, null_pointer);
-            virtual SocketInformation DuplicateAndClose(Socket* socket) throw(null_pointer, socket_error);
-            virtual void Listen(Socket* socket, U32 backlog) throw(socket_error);
-            virtual S32 Receive(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) throw(socket_error, std::out_of_range);
-            virtual S32 ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint>& remoteEndPoint) throw(socket_error, std::out_of_range);
-            virtual S32 Send(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) throw(socket_error, std::out_of_range);
-            virtual S32 SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, std::out_of_range);
-            virtual void Shutdown(Socket* socket, SocketShutdown how) throw(socket_error);
+            virtual Pointer<Socket> Accept(Socket* socket) LU_THROWS(socket_error);
+            virtual void Bind(Socket* socket, Pointer<EndPoint> localEndPoint) LU_THROWS(socket_error);
+            virtual void Close(Socket* socket) LU_THROWS(socket_error);
+            virtual void Close(Socket* socket, U32 timeout) LU_THROWS(socket_error);
+            virtual void Connect(Socket* socket, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, null_pointer);
+            virtual SocketInformation DuplicateAndClose(Socket* socket) LU_THROWS(null_pointer, socket_error);
+            virtual SocketInformation DuplicateAndClose(Socket* socket, Pointer<Socket> channel) LU_THROWS(null_pointer, socket_error);
+            virtual SocketInformation Duplicate(Socket* socket, Pointer<Socket> channel) LU_THROWS(null_pointer, socket_error);
+            virtual void Listen(Socket* socket, U32 backlog) LU_THROWS(socket_error);
+            virtual S32 Receive(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error, std::out_of_range);
+            virtual S32 ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error, std::out_of_range);
+            virtual S32 Receive(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error);
+            virtual S32 ReceiveFrom(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error);
+            virtual S32 Send(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error, std::out_of_range);
+            virtual S32 Send(Socket* socket, const ByteSegment* segments, U32 count, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error);
+            virtual S32 SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, std::out_of_range);
+            virtual void Shutdown(Socket* socket, SocketShutdown how) LU_THROWS(socket_error);
+
+            static Pointer<Socket> ReceiveDuplicate(Pointer<Socket> channel) LU_THROWS(null_pointer, socket_error);
 
         protected:
 
-            Pointer<Socket> CreateSocket(SocketHandle, AddrStorage) NOEXCEPT;
+            SocketInformation GetSocketInformation(Socket* socket) const NOEXCEPT;
+
+            Pointer<Socket> CreateSocket(Socket* listener, SocketHandle, AddrStorage, AddrLength) NOEXCEPT;
+
+            S32 ReceiveFromHandle(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(std::out_of_range);
+            S32 ReceiveFromHandle(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) NOEXCEPT;
+            S32 SendToHandle(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, std::out_of_range);
 
             void ChangeState(Socket* socket, Pointer<SocketState> state) NOEXCEPT;
-            void SetLocalEndPoint(Socket* socket, Pointer<IPEndPoint>) NOEXCEPT;
-            void SetRemoteEndPoint(Socket* socket, Pointer<IPEndPoint>) NOEXCEPT;
-            Pointer<IPEndPoint> GetLocalEndPoint(Socket* socket) const NOEXCEPT;
-            Pointer<IPEndPoint> GetRemoteEndPoint(Socket* socket) const NOEXCEPT;
+            void SetLocalEndPoint(Socket* socket, Pointer<EndPoint>) NOEXCEPT;
+            void SetRemoteEndPoint(Socket* socket, Pointer<EndPoint>) NOEXCEPT;
+            Pointer<EndPoint> GetLocalEndPoint(Socket* socket) const NOEXCEPT;
+            Pointer<EndPoint> GetRemoteEndPoint(Socket* socket) const NOEXCEPT;
 
             void SetConnected(Socket*, bool) NOEXCEPT;
             void SetBound(Socket*, bool) NOEXCEPT;
@@ -45,11 +67,14 @@ namespace Lupus {
         {
         public:
             SocketBound(Socket*);
-            SocketBound(Socket*, Pointer<IPEndPoint>);
+            SocketBound(Socket*, Pointer<EndPoint>);
             virtual ~SocketBound() = default;
 
-            virtual void Connect(Socket* socket, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, null_pointer) override;
-            virtual void Listen(Socket* socket, U32 backlog) throw(socket_error) override;
+            virtual void Connect(Socket* socket, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, null_pointer) override;
+            virtual void Listen(Socket* socket, U32 backlog) LU_THROWS(socket_error) override;
+            virtual S32 ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error, std::out_of_range) override;
+            virtual S32 ReceiveFrom(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error) override;
+            virtual S32 SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, std::out_of_range) override;
         };
 
         class SocketListen : public SocketState
@@ -58,22 +83,25 @@ namespace Lupus {
             SocketListen(Socket*);
             virtual ~SocketListen() = default;
 
-            virtual Pointer<Socket> Accept(Socket* socket) throw(socket_error);
+            virtual Pointer<Socket> Accept(Socket* socket) LU_THROWS(socket_error);
         };
 
         class SocketConnected : public SocketState
         {
         public:
             SocketConnected(Socket*);
-            SocketConnected(Socket*, Pointer<IPEndPoint>);
+            SocketConnected(Socket*, Pointer<EndPoint>);
             virtual ~SocketConnected() = default;
 
-            virtual void Connect(Socket* socket, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, null_pointer);
-            virtual S32 Receive(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) throw(socket_error, std::out_of_range) override;
-            virtual S32 ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint>& remoteEndPoint) throw(socket_error, std::out_of_range) override;
-            virtual S32 Send(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) throw(socket_error, std::out_of_range) override;
-            virtual S32 SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, std::out_of_range) override;
-            virtual void Shutdown(Socket* socket, SocketShutdown how) throw(socket_error) override;
+            virtual void Connect(Socket* socket, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, null_pointer);
+            virtual S32 Receive(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error, std::out_of_range) override;
+            virtual S32 ReceiveFrom(Socket* socket, Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error, std::out_of_range) override;
+            virtual S32 Receive(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error) override;
+            virtual S32 ReceiveFrom(Socket* socket, Byte* buffer, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error) override;
+            virtual S32 Send(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error, std::out_of_range) override;
+            virtual S32 Send(Socket* socket, const ByteSegment* segments, U32 count, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error) override;
+            virtual S32 SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, std::out_of_range) override;
+            virtual void Shutdown(Socket* socket, SocketShutdown how) LU_THROWS(socket_error) override;
         };
 
         class SocketReady : public SocketState
@@ -82,8 +110,9 @@ namespace Lupus {
             SocketReady(Socket*);
             virtual ~SocketReady() = default;
 
-            virtual void Bind(Socket* socket, Pointer<IPEndPoint> localEndPoint) throw(socket_error) override;
-            virtual void Connect(Socket* socket, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, null_pointer) override;
+            virtual void Bind(Socket* socket, Pointer<EndPoint> localEndPoint) LU_THROWS(socket_error) override;
+            virtual void Connect(Socket* socket, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, null_pointer) override;
+            virtual S32 SendTo(Socket* socket, const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, std::out_of_range) override;
         };
 
         class SocketClosed : public SocketState
@@ -92,9 +121,11 @@ namespace Lupus {
             SocketClosed() = default;
             virtual ~SocketClosed() = default;
 
-            virtual void Close(Socket* socket) throw(socket_error) override;
-            virtual void Close(Socket* socket, U32 timeout) throw(socket_error) override;
-            virtual SocketInformation DuplicateAndClose(Socket* socket) throw(socket_error) override;
+            virtual void Close(Socket* socket) LU_THROWS(socket_error) override;
+            virtual void Close(Socket* socket, U32 timeout) LU_THROWS(socket_error) override;
+            virtual SocketInformation DuplicateAndClose(Socket* socket) LU_THROWS(socket_error) override;
+            virtual SocketInformation DuplicateAndClose(Socket* socket, Pointer<Socket> channel) LU_THROWS(socket_error) override;
+            virtual SocketInformation Duplicate(Socket* socket, Pointer<Socket> channel) LU_THROWS(socket_error) override;
         };
     }
 }
@@ -0,0 +1,135 @@
+﻿#include <Internal/Threading/ThreadSlot.h>
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace Lupus {
+    namespace Internal {
+        namespace {
+            // Markiert einen Thread der keinen Platz mehr erhalten hat.
+            const U32 NoSlot = 0xFFFFFFFF;
+
+            struct SlotOwner
+            {
+                void* Owner;
+                SlotRelease Release;
+            };
+
+            struct SlotRegistry
+            {
+                Mutex Lock;
+                Vector<SlotOwner> Owners;
+                U32 Free[MaxThreadSlots];
+                U32 FreeCount = 0;
+                U32 Next = 1;
+#ifdef _MSC_VER
+                DWORD Key = FLS_OUT_OF_INDEXES;
+#else
+                pthread_key_t Key;
+                bool HasKey = false;
+#endif
+            };
+
+            LU_THREAD_LOCAL U32 CurrentSlot = 0;
+            std::once_flag RegistryFlag;
+            // Lebt bis zum Prozessende, Threads können auch nach den
+            // statischen Destruktoren noch enden.
+            SlotRegistry* Registry = nullptr;
+
+            void ReleaseSlot(U32 slot)
+            {
+                LockGuard<Mutex> lock(Registry->Lock);
+
+                for (const SlotOwner& owner : Registry->Owners) {
+                    owner.Release(owner.Owner, slot);
+                }
+
+                Registry->Free[Registry->FreeCount++] = slot;
+            }
+
+#ifdef _MSC_VER
+            void WINAPI OnThreadExit(void* value)
+#else
+            void OnThreadExit(void* value)
+#endif
+            {
+                if (value) {
+                    ReleaseSlot((U32)(UIntPtr)value);
+                }
+
+                CurrentSlot = 0;
+            }
+
+            void InitializeRegistry()
+            {
+                std::call_once(RegistryFlag, []() {
+                    Registry = new SlotRegistry();
+#ifdef _MSC_VER
+                    Registry->Key = FlsAlloc(&OnThreadExit);
+#else
+                    Registry->HasKey = (pthread_key_create(&Registry->Key, &OnThreadExit) == 0);
+#endif
+                });
+            }
+        }
+
+        U32 CurrentThreadSlot() NOEXCEPT
+        {
+            if (CurrentSlot != 0) {
+                return (CurrentSlot != NoSlot) ? CurrentSlot : 0;
+            }
+
+            InitializeRegistry();
+
+            LockGuard<Mutex> lock(Registry->Lock);
+            U32 slot = NoSlot;
+
+            if (Registry->FreeCount > 0) {
+                slot = Registry->Free[--Registry->FreeCount];
+            } else if (Registry->Next <= MaxThreadSlots) {
+                slot = Registry->Next++;
+            }
+
+            // Ohne Benachrichtigung beim Beenden wird der Platz nie frei.
+            if (slot != NoSlot) {
+#ifdef _MSC_VER
+                if (Registry->Key != FLS_OUT_OF_INDEXES) {
+                    FlsSetValue(Registry->Key, (void*)(UIntPtr)slot);
+                }
+#else
+                if (Registry->HasKey) {
+                    pthread_setspecific(Registry->Key, (void*)(UIntPtr)slot);
+                }
+#endif
+            }
+
+            CurrentSlot = slot;
+            return (slot != NoSlot) ? slot : 0;
+        }
+
+        void AttachSlotOwner(void* owner, SlotRelease release)
+        {
+            InitializeRegistry();
+
+            LockGuard<Mutex> lock(Registry->Lock);
+            SlotOwner entry = { owner, release };
+
+            Registry->Owners.push_back(entry);
+        }
+
+        void DetachSlotOwner(void* owner) NOEXCEPT
+        {
+            InitializeRegistry();
+
+            LockGuard<Mutex> lock(Registry->Lock);
+
+            Registry->Owners.erase(std::remove_if(Registry->Owners.begin(), Registry->Owners.end(), [owner](const SlotOwner& entry) {
+                return entry.Owner == owner;
+            }), Registry->Owners.end());
+        }
+    }
+}
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+
+namespace Lupus {
+    namespace Internal {
+        //! Maximale Anzahl gleichzeitig vergebener Plätze.
+        const U32 MaxThreadSlots = 64;
+
+        //! Wird im endenden Thread für jeden angemeldeten Besitzer aufgerufen,
+        //! bevor dessen Platz erneut vergeben wird.
+        typedef void (*SlotRelease)(void* owner, U32 slot);
+
+        /*!
+         * Vergibt kleine Nummern an Threads, bspw als Index in die Caches
+         * eines Pools. Beendet sich ein Thread, dann leeren alle
+         * angemeldeten Besitzer ihren Cache für diesen Platz und die Nummer
+         * wird an den nächsten neuen Thread vergeben.
+         *
+         * \returns Die Nummer des aktuellen Threads von 1 bis
+         *          MaxThreadSlots, oder Null wenn alle Plätze belegt sind.
+         *          Ein Thread ohne Platz erhält auch später keinen.
+         */
+        U32 CurrentThreadSlot() NOEXCEPT;
+
+        /*!
+         * Meldet einen Besitzer von Caches pro Thread an, bspw im
+         * Konstruktor eines Pools.
+         *
+         * \param[in]   owner   Wird an release übergeben.
+         * \param[in]   release Leert den Cache eines Platzes.
+         */
+        void AttachSlotOwner(void* owner, SlotRelease release) LU_THROWS(std::bad_alloc);
+
+        /*!
+         * Meldet einen Besitzer ab. Nach der Rückkehr läuft kein release
+         * für ihn mehr.
+         */
+        void DetachSlotOwner(void* owner) NOEXCEPT;
+    }
+}
@@ -0,0 +1,160 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+
+namespace Lupus {
+    namespace Internal {
+        /*!
+         * Chase-Lev Deque für Zeiger. Nur der besitzende Thread darf Push und
+         * Pop aufrufen und arbeitet dabei am unteren Ende wie mit einem
+         * Stapel. Beliebige andere Threads entnehmen mit Steal vom oberen
+         * Ende, also die ältesten Einträge.
+         *
+         * Ist das Array voll, dann wird es verdoppelt. Alte Arrays werden
+         * erst mit der Deque freigegeben, da ein Dieb noch darauf zugreifen
+         * kann.
+         */
+        template <typename T>
+        class WorkStealingDeque : public ReferenceType
+        {
+        public:
+
+            WorkStealingDeque(S64 capacity = 256) :
+                mTop(0),
+                mBottom(0),
+                mArray(new Array(capacity))
+            {
+                mArrays.push_back(mArray.load());
+            }
+
+            ~WorkStealingDeque()
+            {
+                for (Array* array : mArrays) {
+                    delete array;
+                }
+            }
+
+            //! Nur vom besitzenden Thread.
+            void Push(T* item)
+            {
+                S64 bottom = mBottom.load(std::memory_order_relaxed);
+                S64 top = mTop.load(std::memory_order_acquire);
+                Array* array = mArray.load(std::memory_order_relaxed);
+
+                if (bottom - top > array->Capacity - 1) {
+                    array = Grow(array, top, bottom);
+                }
+
+                array->Put(bottom, item);
+                std::atomic_thread_fence(std::memory_order_release);
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            //! Nur vom besitzenden Thread.
+            T* Pop()
+            {
+                S64 bottom = mBottom.load(std::memory_order_relaxed) - 1;
+                Array* array = mArray.load(std::memory_order_relaxed);
+
+                mBottom.store(bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                S64 top = mTop.load(std::memory_order_relaxed);
+
+                if (top > bottom) {
+                    mBottom.store(bottom + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                T* item = array->Get(bottom);
+
+                // Um den letzten Eintrag wird mit den Dieben gerungen.
+                if (top == bottom) {
+                    if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        item = nullptr;
+                    }
+
+                    mBottom.store(bottom + 1, std::memory_order_relaxed);
+                }
+
+                return item;
+            }
+
+            //! Von jedem Thread.
+            T* Steal()
+            {
+                S64 top = mTop.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                S64 bottom = mBottom.load(std::memory_order_acquire);
+
+                if (top >= bottom) {
+                    return nullptr;
+                }
+
+                T* item = mArray.load(std::memory_order_acquire)->Get(top);
+
+                if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    return nullptr;
+                }
+
+                return item;
+            }
+
+            //! Ungefähre Anzahl der Einträge.
+            S64 Size() const
+            {
+                S64 size = mBottom.load(std::memory_order_relaxed) - mTop.load(std::memory_order_relaxed);
+
+                return (size > 0) ? size : 0;
+            }
+
+        private:
+
+            struct Array
+            {
+                Array(S64 capacity) :
+                    Capacity(capacity),
+                    Items(new Atomic<T*>[(size_t)capacity])
+                {
+                }
+
+                ~Array()
+                {
+                    delete[] Items;
+                }
+
+                T* Get(S64 index) const
+                {
+                    return Items[index & (Capacity - 1)].load(std::memory_order_relaxed);
+                }
+
+                void Put(S64 index, T* item)
+                {
+                    Items[index & (Capacity - 1)].store(item, std::memory_order_relaxed);
+                }
+
+                S64 Capacity;
+                Atomic<T*>* Items;
+            };
+
+            Array* Grow(Array* array, S64 top, S64 bottom)
+            {
+                Array* grown = new Array(array->Capacity * 2);
+
+                for (S64 i = top; i < bottom; i++) {
+                    grown->Put(i, array->Get(i));
+                }
+
+                mArrays.push_back(grown);
+                mArray.store(grown, std::memory_order_release);
+                return grown;
+            }
+
+            Atomic<S64> mTop;
+            Byte mPadding[64 - sizeof(Atomic<S64>)];
+            Atomic<S64> mBottom;
+            Atomic<Array*> mArray;
+            Vector<Array*> mArrays;
+        };
+    }
+}
@@ -0,0 +1,84 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define LU_BIG_ENDIAN
+#endif
+
+namespace Lupus {
+    namespace Internal {
+        inline U8 ByteSwap(U8 value) NOEXCEPT { return value; }
+#ifdef _MSC_VER
+        inline U16 ByteSwap(U16 value) NOEXCEPT { return _byteswap_ushort(value); }
+        inline U32 ByteSwap(U32 value) NOEXCEPT { return _byteswap_ulong(value); }
+        inline U64 ByteSwap(U64 value) NOEXCEPT { return _byteswap_uint64(value); }
+#else
+        inline U16 ByteSwap(U16 value) NOEXCEPT { return __builtin_bswap16(value); }
+        inline U32 ByteSwap(U32 value) NOEXCEPT { return __builtin_bswap32(value); }
+        inline U64 ByteSwap(U64 value) NOEXCEPT { return __builtin_bswap64(value); }
+#endif
+
+        //! Konvertiert einen Wert zwischen Host und Netzwerk Byteorder.
+        template <typename T>
+        inline T ConvertByteOrder(T value) NOEXCEPT
+        {
+#ifdef LU_BIG_ENDIAN
+            return value;
+#else
+            return ByteSwap(value);
+#endif
+        }
+    }
+
+    /*!
+     * Konvertiert count 16-Bit Ganzzahlen von Host zu Netzwerk Byteorder.
+     * Je nach Prozessor werden dafür AVX2 bzw SSSE3 Byte-Shuffles
+     * verwendet, der Rest wird einzeln konvertiert.
+     *
+     * Quelle und Ziel dürfen identisch sein, sich aber nicht teilweise
+     * überlappen. Eine bestimmte Ausrichtung ist nicht notwendig.
+     *
+     * \param[in]   source  Die zu konvertierenden Werte.
+     * \param[out]  target  Das Ziel der konvertierten Werte.
+     * \param[in]   count   Anzahl der Werte.
+     */
+    LUPUS_API void HostToNetworkOrder(const U16* source, U16* target, U32 count) NOEXCEPT;
+
+    /*!
+     * Konvertiert count 32-Bit Ganzzahlen von Host zu Netzwerk Byteorder.
+     *
+     * \sa HostToNetworkOrder(const U16*, U16*, U32)
+     */
+    LUPUS_API void HostToNetworkOrder(const U32* source, U32* target, U32 count) NOEXCEPT;
+
+    /*!
+     * Konvertiert count 64-Bit Ganzzahlen von Host zu Netzwerk Byteorder.
+     *
+     * \sa HostToNetworkOrder(const U16*, U16*, U32)
+     */
+    LUPUS_API void HostToNetworkOrder(const U64* source, U64* target, U32 count) NOEXCEPT;
+
+    /*!
+     * Konvertiert count 16-Bit Ganzzahlen von Netzwerk zu Host Byteorder.
+     *
+     * \sa HostToNetworkOrder(const U16*, U16*, U32)
+     */
+    LUPUS_API void NetworkToHostOrder(const U16* source, U16* target, U32 count) NOEXCEPT;
+
+    /*!
+     * Konvertiert count 32-Bit Ganzzahlen von Netzwerk zu Host Byteorder.
+     *
+     * \sa HostToNetworkOrder(const U16*, U16*, U32)
+     */
+    LUPUS_API void NetworkToHostOrder(const U32* source, U32* target, U32 count) NOEXCEPT;
+
+    /*!
+     * Konvertiert count 64-Bit Ganzzahlen von Netzwerk zu Host Byteorder.
+     *
+     * \sa HostToNetworkOrder(const U16*, U16*, U32)
+     */
+    LUPUS_API void NetworkToHostOrder(const U64* source, U64* target, U32 count) NOEXCEPT;
+}
@@ -0,0 +1,101 @@
+﻿#pragma once
+
+#include <Lupus/ByteWriter.h>
+
+namespace Lupus {
+    /*!
+     * Liest Werte aus einem geliehenen Speicherbereich, bspw direkt aus dem
+     * Lese-Buffer eines NetworkStream. Der Bereich wird nicht kopiert und
+     * muss so lange gültig bleiben wie der Reader.
+     *
+     * Das Format entspricht dem von ByteWriter.
+     */
+    class LUPUS_API ByteReader : public ReferenceType
+    {
+    public:
+
+        /*!
+         * Erstellt einen Reader über den angegebenen Speicherbereich.
+         *
+         * \param[in]   buffer  Zeiger auf die Daten.
+         * \param[in]   size    Größe der Daten in Bytes.
+         */
+        ByteReader(const Byte* buffer, U32 size) LU_THROWS(null_pointer);
+
+        /*!
+         * Erstellt einen Reader über den Inhalt des Vektors.
+         */
+        explicit ByteReader(const Vector<Byte>& buffer) NOEXCEPT;
+        virtual ~ByteReader() = default;
+
+        /*!
+         * \returns Anzahl der bereits gelesenen Bytes.
+         */
+        virtual U32 Position() const NOEXCEPT;
+
+        /*!
+         * \returns Anzahl der noch verfügbaren Bytes.
+         */
+        virtual U32 Remaining() const NOEXCEPT;
+
+        /*!
+         * Liest eine Ganz- bzw Gleitkommazahl in Netzwerk Byteorder.
+         *
+         * \returns Der gelesene Wert in Host Byteorder.
+         */
+        template <typename T>
+        T Read() LU_THROWS(std::out_of_range)
+        {
+            static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type");
+
+            if ((size_t)(mEnd - mCursor) < sizeof(T)) {
+                throw std::out_of_range("reader has not enough data left");
+            }
+
+            T value = Internal::LoadNetworkOrder<T>(mCursor);
+            mCursor += sizeof(T);
+            return value;
+        }
+
+        /*!
+         * Liest eine mit ByteWriter::Write(const String&) geschriebene
+         * Zeichenkette.
+         */
+        virtual String ReadString() LU_THROWS(std::out_of_range);
+
+        /*!
+         * Kopiert die nächsten Bytes in den angegebenen Buffer.
+         *
+         * \param[out]  buffer  Zeiger auf den Zielbuffer.
+         * \param[in]   size    Anzahl der Bytes.
+         */
+        virtual void Read(Byte* buffer, U32 size) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Liefert einen Zeiger auf die nächsten Bytes ohne sie zu kopieren
+         * und rückt die Position weiter.
+         *
+         * \param[in]   size    Anzahl der Bytes.
+         *
+         * \returns Zeiger in den geliehenen Speicherbereich.
+         */
+        virtual const Byte* Borrow(U32 size) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Überspringt die angegebene Anzahl an Bytes.
+         */
+        virtual void Skip(U32 size) LU_THROWS(std::out_of_range);
+
+    private:
+
+        const Byte* mBegin = nullptr;
+        const Byte* mCursor = nullptr;
+        const Byte* mEnd = nullptr;
+    };
+
+    template <>
+    inline bool ByteReader::Read<bool>() LU_THROWS(std::out_of_range)
+    {
+        return (*Borrow(1) != 0);
+    }
+}
@@ -0,0 +1,190 @@
+﻿#pragma once
+
+#include <Lupus/ByteOrder.h>
+#include <type_traits>
+#include <cstring>
+
+namespace Lupus {
+    namespace Internal {
+        //! Vorzeichenlose Ganzzahl mit der angegebenen Bytegröße.
+        template <size_t Size>
+        struct ByteOrderType;
+
+        template <> struct ByteOrderType<1> { typedef U8 Type; };
+        template <> struct ByteOrderType<2> { typedef U16 Type; };
+        template <> struct ByteOrderType<4> { typedef U32 Type; };
+        template <> struct ByteOrderType<8> { typedef U64 Type; };
+
+        //! Speichert den Wert in Netzwerk Byteorder an der Zieladresse.
+        template <typename T>
+        inline void StoreNetworkOrder(Byte* target, T value) NOEXCEPT
+        {
+            typedef typename ByteOrderType<sizeof(T)>::Type Bits;
+            Bits bits;
+
+            memcpy(&bits, &value, sizeof(T));
+            bits = ConvertByteOrder(bits);
+            memcpy(target, &bits, sizeof(T));
+        }
+
+        //! Liest einen Wert in Netzwerk Byteorder von der Quelladresse.
+        template <typename T>
+        inline T LoadNetworkOrder(const Byte* source) NOEXCEPT
+        {
+            typedef typename ByteOrderType<sizeof(T)>::Type Bits;
+            Bits bits;
+            T value;
+
+            memcpy(&bits, source, sizeof(T));
+            bits = ConvertByteOrder(bits);
+            memcpy(&value, &bits, sizeof(T));
+            return value;
+        }
+    }
+
+    /*!
+     * Beschreibt einen zusammenhängenden Speicherbereich. Eine Liste von
+     * Segmenten kann direkt in iovec bzw WSABUF übertragen werden.
+     */
+    struct ByteSegment
+    {
+        Byte* Data = nullptr;
+        U32 Size = 0;
+    };
+
+    /*!
+     * Schreibt Werte direkt in einen vom Aufrufer bereitgestellten Speicher.
+     * Ganzzahlen und Gleitkommazahlen werden unabhängig von der Plattform in
+     * Netzwerk Byteorder geschrieben.
+     *
+     * Solange im aktuellen Bereich genug Platz ist wird inline geschrieben.
+     * Erst wenn der Bereich voll ist wird Next aufgerufen, wodurch
+     * abgeleitete Klassen weitere Ziele (bspw den Schreib-Buffer eines
+     * NetworkStream) anbinden können.
+     */
+    class LUPUS_API ByteWriter : public ReferenceType
+    {
+    public:
+
+        /*!
+         * Erstellt einen Writer der die Daten verwirft und nur zählt. Damit
+         * lässt sich die Größe eines Objekts vorab bestimmen, bspw um den
+         * passenden Bereich eines StackAllocator anzufordern. Der Writer
+         * besitzt keinen Speicher, Reserve retouniert daher immer einen
+         * nullptr.
+         */
+        ByteWriter() NOEXCEPT;
+
+        /*!
+         * Erstellt einen Writer über einen festen Speicherbereich.
+         *
+         * \param[in]   buffer  Zeiger auf den Speicherbereich.
+         * \param[in]   size    Größe des Bereichs in Bytes.
+         */
+        ByteWriter(Byte* buffer, U32 size) LU_THROWS(null_pointer);
+
+        /*!
+         * Erstellt einen Writer über mehrere Segmente, die der Reihe nach und
+         * lückenlos befüllt werden. Die Segmente werden nicht kopiert und
+         * müssen daher so lange gültig bleiben wie der Writer.
+         *
+         * \param[in]   segments    Zeiger auf das erste Segment.
+         * \param[in]   count       Anzahl der Segmente.
+         */
+        ByteWriter(const ByteSegment* segments, U32 count) LU_THROWS(null_pointer);
+        virtual ~ByteWriter() = default;
+
+        /*!
+         * \returns Anzahl der bisher geschriebenen Bytes.
+         */
+        virtual U32 Written() const NOEXCEPT;
+
+        /*!
+         * Schreibt eine Ganz- bzw Gleitkommazahl in Netzwerk Byteorder.
+         *
+         * \param[in]   value   Der zu schreibende Wert.
+         */
+        template <typename T>
+        void Write(T value) LU_THROWS(std::out_of_range)
+        {
+            static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type");
+
+            if ((size_t)(mEnd - mCursor) >= sizeof(T)) {
+                Internal::StoreNetworkOrder(mCursor, value);
+                mCursor += sizeof(T);
+            } else if (mCounting) {
+                mFlushed += (U32)sizeof(T);
+            } else {
+                Byte bytes[sizeof(T)];
+
+                Internal::StoreNetworkOrder(bytes, value);
+                Write(bytes, (U32)sizeof(T));
+            }
+        }
+
+        /*!
+         * Schreibt einen Wahrheitswert als einzelnes Byte.
+         */
+        virtual void Write(bool value) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Schreibt eine Zeichenkette mit vorangestellter 32-Bit Länge.
+         */
+        virtual void Write(const String& value) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Kopiert die angegebenen Bytes, auch über Segmentgrenzen hinweg.
+         *
+         * \param[in]   buffer  Zeiger auf die Daten.
+         * \param[in]   size    Anzahl der Bytes.
+         */
+        virtual void Write(const Byte* buffer, U32 size) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Reserviert einen zusammenhängenden Bereich, der vom Aufrufer direkt
+         * beschrieben werden muss. Bei Segmenten kann dafür nur zum nächsten
+         * Segment gewechselt werden wenn das aktuelle voll ist.
+         *
+         * \param[in]   size    Anzahl der Bytes.
+         *
+         * \returns Zeiger auf den Bereich, oder einen nullptr falls kein
+         *          zusammenhängender Bereich dieser Größe verfügbar ist.
+         */
+        virtual Byte* Reserve(U32 size);
+
+    protected:
+
+        /*!
+         * Wird aufgerufen wenn der aktuelle Bereich weniger als size Bytes
+         * frei hat. Abgeleitete Klassen setzen mittels Span einen neuen
+         * Bereich.
+         *
+         * \param[in]   size    Mindestgröße des neuen Bereichs.
+         *
+         * \returns FALSE falls kein weiterer Bereich verfügbar ist.
+         */
+        virtual bool Next(U32 size);
+
+        /*!
+         * Setzt den aktuellen Bereich. Die im alten Bereich geschriebenen
+         * Bytes werden zu Written hinzugezählt.
+         */
+        void Span(Byte* buffer, U32 size) NOEXCEPT;
+
+        /*!
+         * \returns Anzahl der im aktuellen Bereich geschriebenen Bytes.
+         */
+        U32 Used() const NOEXCEPT;
+
+    private:
+
+        Byte* mBase = nullptr;
+        Byte* mCursor = nullptr;
+        Byte* mEnd = nullptr;
+        U32 mFlushed = 0;
+        const ByteSegment* mSegments = nullptr;
+        U32 mSegmentCount = 0;
+        U32 mSegmentIndex = 0;
+        bool mCounting = false;
+    };
+}
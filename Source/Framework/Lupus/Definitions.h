@@ -10,6 +10,8 @@
 #endif
 
 #define NOEXCEPT throw()
+#define LU_THREAD_LOCAL __declspec(thread)
+#define LU_ALIGN(n) __declspec(align(n))
 
 #elif __CYGWIN
 
@@ -19,6 +21,8 @@
 #define LUPUS_API __attribute__ ((dllimport))
 #endif
 
+#define NOEXCEPT noexcept
+
 #else
 
 #if __GNUC__ >= 4
@@ -30,6 +34,26 @@
 #define NOEXCEPT noexcept
 #endif
 
+#ifndef LU_THREAD_LOCAL
+// Threadlokale Variablen mit konstanter Initialisierung, thread_local
+// unterstützt erst VS2015.
+#define LU_THREAD_LOCAL __thread
+#endif
+
+#ifndef LU_ALIGN
+// Ausrichtung eines Typs, alignas unterstützt erst VS2015.
+#define LU_ALIGN(n) __attribute__ ((aligned (n)))
+#endif
+
+// Dynamische Ausnahmespezifikationen sind ab C++17 nicht mehr erlaubt, dort
+// bleibt nur noexcept(false). GCC verlangt sie außerdem an jeder Definition,
+// außerhalb von MSVC dienen sie daher nur noch der Dokumentation.
+#if !defined(_MSC_VER) || __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define LU_THROWS(...) noexcept(false)
+#else
+#define LU_THROWS(...) throw(__VA_ARGS__)
+#endif
+
 // STD
 
 #include <cstdint>
@@ -58,7 +82,7 @@
         inline cls(const Lupus::String& message = "") : mMessage(message) { } \
         virtual ~cls() = default; \
         cls& operator=(const cls&) = default; \
-        virtual inline const char* what() const override { return mMessage.c_str(); } \
+        virtual inline const char* what() const NOEXCEPT override { return mMessage.c_str(); } \
     };
 
 // Boost
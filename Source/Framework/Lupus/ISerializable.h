@@ -1,6 +1,6 @@
 ﻿#pragma once
 
-#include <Lupus/Definitions.h>
+#include <Lupus/ByteReader.h>
 
 namespace Lupus {
     //! Serialisierungsschnittstelle für Objekte
@@ -10,27 +10,71 @@ namespace Lupus {
         virtual ~ISerializable() = default;
 
         /*!
-         * Serialisiert das Objekt und speichert is in einen Byte-Buffer.
-         * Diese Methode ist unabhängig von der Architektur oder Plattform.
-         * Der Byte-Buffer kann bspw auch über das Netzwerk zu anderen Peers
+         * Serialisiert das Objekt direkt in den angegebenen Writer. Diese
+         * Methode ist unabhängig von der Architektur oder Plattform. Die
+         * Daten können bspw auch über das Netzwerk zu anderen Peers
          * geschickt und deserialisiert werden.
          *
+         * Da der Writer in einen vom Aufrufer bereitgestellten Speicher
+         * schreibt (StackAllocator, NetworkStream, Segmente), wird hier kein
+         * Speicher angefordert. Fehler des Writers, bspw std::out_of_range
+         * wenn kein Platz mehr ist, werden weitergereicht.
+         *
+         * Zustandslose Objekte schreiben nichts.
+         *
+         * \param[in]   writer  Das Ziel der serialisierten Daten.
+         */
+        virtual void Serialize(ByteWriter& writer) const = 0;
+
+        /*!
+         * Deserialisiert das Objekt aus dem angegebenen Reader. Falls die
+         * Daten nicht vom Typ des selben Objekts sind, dann ist das
+         * Verhalten undefiniert. Zu kurze Daten werfen std::out_of_range.
+         *
+         * Zustandslose Objekte ignorieren diese Methode.
+         *
+         * \param[in]   reader  Das Objekt in serialisierter Form.
+         */
+        virtual void Deserialize(ByteReader& reader) LU_THROWS(std::out_of_range, std::invalid_argument) = 0;
+
+        /*!
+         * Serialisiert das Objekt und speichert es in einen Byte-Buffer.
+         * Dazu wird zuerst die Größe ermittelt und dann genau einmal
+         * angefordert.
+         *
          * Diese Methode retouniert immer einen leeren Buffer wenn das Objekt
          * zustandslos ist.
          *
          * \returns Byte-Buffer des Objekts.
          */
-        virtual Vector<Byte> Serialize() const NOEXCEPT = 0;
+        virtual Vector<Byte> Serialize() const NOEXCEPT
+        {
+            ByteWriter counter;
+            Serialize(counter);
+
+            Vector<Byte> buffer(counter.Written());
+            ByteWriter writer(buffer.data(), (U32)buffer.size());
+            Serialize(writer);
+            return buffer;
+        }
 
         /*!
          * Deserialisiert den Byte-Buffer und transformiert ihn in ein gültiges
-         * Objekt vom serialisierten Typ. Falls Der Byte-Buffer nicht vom Typ
-         * des selben Objekts ist, dann ist das Verhalten undefiniert.
-         *
-         * Zustandslose Objekte ignorieren diese Methode.
+         * Objekt vom serialisierten Typ.
          *
          * \param[in]   buffer  Das Objekt in serialisierter Form.
+         *
+         * \sa Deserialize(ByteReader&)
          */
-        virtual void Deserialize(const Vector<Byte>& buffer) throw(std::invalid_argument) = 0;
+        virtual void Deserialize(const Vector<Byte>& buffer) LU_THROWS(std::invalid_argument)
+        {
+            ByteReader reader(buffer);
+
+            try {
+                Deserialize(reader);
+            } catch (std::out_of_range& e) {
+                throw std::invalid_argument(e.what());
+            }
+        }
     };
 }
@@ -0,0 +1,135 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+#include <algorithm>
+
+namespace Lupus {
+    /*!
+     * Momentaufnahme der Zähler eines Allocators.
+     *
+     * Die Zähler werden nur geführt wenn LUPUS_ALLOCATOR_STATISTICS für die
+     * Bibliothek und die Anwendung definiert ist (in den Projekten für Debug
+     * und Profile), sonst sind alle Werte Null. Die Größe der Klassen hängt
+     * nicht vom Makro ab.
+     */
+    struct AllocatorStatistics
+    {
+        //! Derzeit belegte Bytes inklusive Verschnitt durch Ausrichtung.
+        U64 BytesInUse = 0;
+
+        //! Höchststand von BytesInUse im laufenden Frame.
+        U64 FramePeak = 0;
+
+        //! Höchststand von BytesInUse im zuletzt abgeschlossenen Frame.
+        U64 LastFramePeak = 0;
+
+        //! Höchststand von BytesInUse seit dem Erstellen.
+        U64 Peak = 0;
+
+        //! Anzahl der erfolgreichen Anforderungen.
+        U64 Allocations = 0;
+
+        //! Anzahl der Anforderungen für die kein Platz mehr war.
+        U64 Failures = 0;
+
+        //! Summe der Bytes die bei allen Anforderungen für die Ausrichtung
+        //! übersprungen wurden.
+        U64 AlignmentWaste = 0;
+    };
+
+    /*!
+     * Zähler hinter AllocatorStatistics. Es schreibt immer nur der Thread
+     * der den Allocator verwendet, die Zähler werden daher ohne
+     * read-modify-write aktualisiert. Andere Threads dürfen jederzeit mit
+     * Snapshot lesen, die einzelnen Werte sind dabei atomar, aber nicht
+     * untereinander konsistent.
+     */
+    class AllocatorCounters : public ReferenceType
+    {
+    public:
+
+        AllocatorCounters() NOEXCEPT :
+            mInUse(0), mFramePeak(0), mLastFramePeak(0), mPeak(0),
+            mAllocations(0), mFailures(0), mWaste(0)
+        {
+        }
+
+        /*!
+         * Zählt eine erfolgreiche Anforderung.
+         *
+         * \param[in]   inUse   Die danach belegten Bytes.
+         * \param[in]   waste   Die für die Ausrichtung übersprungenen Bytes.
+         */
+        void Allocated(U64 inUse, U64 waste) NOEXCEPT
+        {
+            Store(mInUse, inUse);
+            Store(mAllocations, Load(mAllocations) + 1);
+
+            if (waste > 0) {
+                Store(mWaste, Load(mWaste) + waste);
+            }
+
+            if (inUse > Load(mFramePeak)) {
+                Store(mFramePeak, inUse);
+
+                if (inUse > Load(mPeak)) {
+                    Store(mPeak, inUse);
+                }
+            }
+        }
+
+        //! Zählt eine Anforderung für die kein Platz mehr war.
+        void Failed() NOEXCEPT
+        {
+            Store(mFailures, Load(mFailures) + 1);
+        }
+
+        //! Übernimmt die belegten Bytes nach einer Freigabe.
+        void Released(U64 inUse) NOEXCEPT
+        {
+            Store(mInUse, inUse);
+        }
+
+        //! Schließt den laufenden Frame ab.
+        void NextFrame() NOEXCEPT
+        {
+            Store(mLastFramePeak, Load(mFramePeak));
+            Store(mFramePeak, Load(mInUse));
+        }
+
+        //! \returns Die aktuellen Werte, aus jedem Thread.
+        AllocatorStatistics Snapshot() const NOEXCEPT
+        {
+            AllocatorStatistics result;
+
+            result.BytesInUse = Load(mInUse);
+            result.FramePeak = Load(mFramePeak);
+            result.LastFramePeak = Load(mLastFramePeak);
+            result.Peak = Load(mPeak);
+            result.Allocations = Load(mAllocations);
+            result.Failures = Load(mFailures);
+            result.AlignmentWaste = Load(mWaste);
+            return result;
+        }
+
+    private:
+
+        static U64 Load(const Atomic<U64>& value) NOEXCEPT
+        {
+            return value.load(std::memory_order_relaxed);
+        }
+
+        static void Store(Atomic<U64>& value, U64 data) NOEXCEPT
+        {
+            value.store(data, std::memory_order_relaxed);
+        }
+
+        Atomic<U64> mInUse;
+        Atomic<U64> mFramePeak;
+        Atomic<U64> mLastFramePeak;
+        Atomic<U64> mPeak;
+        Atomic<U64> mAllocations;
+        Atomic<U64> mFailures;
+        Atomic<U64> mWaste;
+    };
+}
@@ -0,0 +1,152 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+#include <Lupus/Memory/StackAllocator.h>
+
+namespace Lupus {
+    namespace Internal {
+        struct BuddyBlock;
+    }
+
+    //! Momentaufnahme der Belegung eines BuddyAllocator.
+    struct BuddyStatistics
+    {
+        //! Die Größe der Arena in Bytes.
+        U64 Capacity = 0;
+
+        //! Die Summe aller freien Blöcke.
+        U64 FreeBytes = 0;
+
+        //! Die Summe der angeforderten Größen aller vergebenen Blöcke.
+        U64 RequestedBytes = 0;
+
+        //! Die Größe des größten freien Blocks.
+        U64 LargestFreeBlock = 0;
+
+        //! Die Anzahl der vergebenen Blöcke.
+        U32 Blocks = 0;
+
+        //! Die Anzahl freier Blöcke pro Ordnung, beginnend mit MinBlockSize.
+        Vector<U32> FreeBlocks;
+
+        //! Anteil des freien Speichers der nicht im größten freien Block
+        //! liegt. Null wenn der freie Speicher zusammenhängend ist.
+        float ExternalFragmentation = 0.0f;
+
+        //! Anteil der vergebenen Bytes die durch das Aufrunden auf eine
+        //! Zweierpotenz nicht angefordert wurden.
+        float InternalFragmentation = 0.0f;
+    };
+
+    /*!
+     * Buddy-Allocator für Buffer variabler Größe mit langer Lebensdauer,
+     * bspw die Buffer einer Verbindung.
+     *
+     * Die Arena besteht aus Blöcken von MaxBlockSize, die bei Bedarf so
+     * lange halbiert werden bis die Anforderung gerade noch hinein passt.
+     * Jede Größe wird dafür auf eine Zweierpotenz ab MinBlockSize
+     * aufgerundet. Wird ein Block frei und ist auch sein Partner (Buddy)
+     * frei, dann werden beide wieder zusammengefasst. Allocate und Free
+     * benötigen dadurch höchstens O(log(MaxBlockSize / MinBlockSize))
+     * Schritte.
+     *
+     * Alle Methoden sind threadsicher, ein Allocator kann also von den
+     * Verbindungen mehrerer Threads geteilt werden.
+     */
+    class LUPUS_API BuddyAllocator : public ReferenceType
+    {
+    public:
+
+        static const U32 MaxOrders = 32; //!< Maximale Anzahl an Blockgrößen.
+
+        /*!
+         * Erstellt eine neue Arena.
+         *
+         * \param[in]   capacity        Die Größe der Arena, wird auf ein
+         *                              Vielfaches von maxBlockSize
+         *                              aufgerundet.
+         * \param[in]   minBlockSize    Die kleinste Blockgröße, eine
+         *                              Zweierpotenz.
+         * \param[in]   maxBlockSize    Die größte Blockgröße, eine
+         *                              Zweierpotenz.
+         * \param[in]   backing         Die Art des Speichers.
+         */
+        BuddyAllocator(U64 capacity, U32 minBlockSize = 4 * KiB, U32 maxBlockSize = 1 * MiB, const MemoryBacking& backing = MemoryBacking()) LU_THROWS(std::bad_alloc, std::invalid_argument);
+        virtual ~BuddyAllocator();
+
+        /*!
+         * Fordert einen Block an.
+         *
+         * \param[in]   bytes   Die benötigte Größe in Bytes.
+         *
+         * \returns Zeiger auf den Block, oder einen nullptr wenn die Größe
+         *          MaxBlockSize übersteigt oder kein passender Block frei
+         *          ist.
+         */
+        virtual void* Allocate(U32 bytes) NOEXCEPT;
+
+        /*!
+         * Gibt einen Block zurück und fasst ihn mit freien Partnern
+         * zusammen.
+         *
+         * \param[in]   block   Zeiger auf den Block oder ein nullptr.
+         */
+        virtual void Free(void* block) LU_THROWS(std::invalid_argument);
+
+        /*!
+         * \param[in]   block   Zeiger auf einen vergebenen Block.
+         *
+         * \returns Die tatsächliche Größe des Blocks.
+         */
+        virtual U32 BlockSize(const void* block) const LU_THROWS(std::invalid_argument);
+
+        /*!
+         * \returns TRUE wenn der Zeiger in der Arena liegt.
+         */
+        virtual bool Owns(const void* block) const NOEXCEPT;
+
+        /*!
+         * \returns Die kleinste Blockgröße.
+         */
+        virtual U32 MinBlockSize() const NOEXCEPT;
+
+        /*!
+         * \returns Die größte Blockgröße.
+         */
+        virtual U32 MaxBlockSize() const NOEXCEPT;
+
+        /*!
+         * \returns Die aktuelle Belegung und Fragmentierung der Arena.
+         */
+        virtual BuddyStatistics Statistics() const NOEXCEPT;
+
+    private:
+
+        //! Standardkonstruktor ist nicht erlaubt.
+        BuddyAllocator() = delete;
+
+        size_t Index(const void* block) const LU_THROWS(std::invalid_argument);
+        void Push(size_t index, U32 order) NOEXCEPT;
+        void Remove(size_t index, U32 order) NOEXCEPT;
+
+        Byte* mArena = nullptr;
+        size_t mReserved = 0;
+        U64 mCapacity;
+        U32 mMinBlockSize;
+        U32 mMinShift;
+        U32 mOrders;
+        // Pro Block von MinBlockSize die Ordnung des dort beginnenden Blocks
+        // und ob dieser frei ist.
+        Vector<Byte> mHeads;
+        // Pro Block von MinBlockSize die angeforderte Größe.
+        Vector<U32> mRequested;
+        Internal::BuddyBlock* mFree[MaxOrders];
+        U32 mFreeCount[MaxOrders];
+        U64 mFreeBytes = 0;
+        U64 mRequestedBytes = 0;
+        U32 mBlocks = 0;
+        mutable Mutex mMutex;
+    };
+
+    typedef Pointer<BuddyAllocator> BuddyAllocatorPtr;
+}
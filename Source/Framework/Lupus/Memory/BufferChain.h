@@ -0,0 +1,220 @@
+﻿#pragma once
+
+#include <Lupus/Memory/BufferPool.h>
+
+namespace Lupus {
+    struct ByteSegment;
+
+    /*!
+     * Ausschnitt aus einem PooledBuffer. Der Ausschnitt hält einen Verweis
+     * auf den Buffer, dieser bleibt daher solange gültig wie der Ausschnitt.
+     */
+    struct BufferSlice
+    {
+        PooledBuffer Buffer;
+        U32 Offset = 0;
+        U32 Size = 0;
+
+        //! \returns Zeiger auf das erste Byte des Ausschnitts.
+        Byte* Data() const NOEXCEPT
+        {
+            return Buffer.Data() + Offset;
+        }
+    };
+
+    /*!
+     * Folge von Ausschnitten aus referenzgezählten Buffern, die zusammen eine
+     * Nachricht bilden. Kopien, Slice und Split teilen sich den Speicher mit
+     * dem Original, dabei werden nur Verweise gezählt und keine Daten
+     * kopiert. Dadurch kann eine empfangene Nachricht zerlegt, mit einem
+     * Header versehen und an mehrere Sockets gesendet werden, ohne dass die
+     * Nutzdaten je kopiert werden.
+     *
+     * Geteilte Buffer werden nie verändert. Kopiert werden Bytes nur bei
+     * Append bzw Prepend von Rohdaten, wobei freier Platz am Ende bzw am
+     * Anfang eines nicht geteilten Buffers wiederverwendet wird, und bei
+     * Coalesce.
+     *
+     * Die Buffer werden aus BufferPool::Shared() geliehen. Eine Kette ist
+     * wie ein Vektor nicht threadsicher, Kopien dürfen aber in verschiedenen
+     * Threads verwendet werden.
+     */
+    class LUPUS_API BufferChain
+    {
+    public:
+
+        /*!
+         * Erstellt eine leere Kette.
+         */
+        BufferChain() NOEXCEPT;
+
+        /*!
+         * Erstellt eine Kette mit den gültigen Bytes des Buffers.
+         *
+         * \param[in]   buffer  Der zu verwendende Buffer.
+         */
+        explicit BufferChain(const PooledBuffer& buffer) LU_THROWS(std::bad_alloc);
+        BufferChain(const BufferChain& chain) LU_THROWS(std::bad_alloc);
+        BufferChain(BufferChain&& chain) NOEXCEPT;
+        ~BufferChain() = default;
+
+        BufferChain& operator=(const BufferChain& chain) LU_THROWS(std::bad_alloc);
+        BufferChain& operator=(BufferChain&& chain) NOEXCEPT;
+
+        /*!
+         * \returns TRUE wenn die Kette keine Bytes enthält.
+         */
+        bool IsEmpty() const NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der Bytes in der Kette.
+         */
+        U32 Size() const NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der Ausschnitte.
+         */
+        U32 SliceCount() const NOEXCEPT;
+
+        /*!
+         * \param[in]   index   Index des Ausschnitts.
+         *
+         * \returns Den Ausschnitt an der angegebenen Stelle.
+         */
+        const BufferSlice& At(U32 index) const LU_THROWS(std::out_of_range);
+
+        /*!
+         * Ruft Append(buffer, 0, buffer.Size()) auf.
+         */
+        void Append(const PooledBuffer& buffer) LU_THROWS(std::bad_alloc, std::length_error);
+
+        /*!
+         * Hängt einen Ausschnitt des Buffers an, ohne die Daten zu kopieren.
+         * Schließt der Ausschnitt direkt an den letzten an, dann wird dieser
+         * erweitert.
+         *
+         * \param[in]   buffer  Der Buffer.
+         * \param[in]   offset  Beginn des Ausschnitts im Buffer.
+         * \param[in]   size    Größe des Ausschnitts, höchstens bis Size()
+         *                      des Buffers.
+         */
+        void Append(const PooledBuffer& buffer, U32 offset, U32 size) LU_THROWS(std::bad_alloc, std::length_error, std::out_of_range);
+
+        /*!
+         * Hängt alle Ausschnitte der anderen Kette an, ohne die Daten zu
+         * kopieren.
+         */
+        void Append(const BufferChain& chain) LU_THROWS(std::bad_alloc, std::length_error);
+
+        /*!
+         * Kopiert die Bytes an das Ende der Kette. Nicht geteilter Platz
+         * hinter dem letzten Ausschnitt wird zuerst aufgefüllt.
+         *
+         * \param[in]   data    Zeiger auf die Daten.
+         * \param[in]   size    Anzahl der Bytes.
+         */
+        void Append(const Byte* data, U32 size) LU_THROWS(std::bad_alloc, std::length_error, null_pointer);
+
+        /*!
+         * Ruft Prepend(buffer, 0, buffer.Size()) auf.
+         */
+        void Prepend(const PooledBuffer& buffer) LU_THROWS(std::bad_alloc, std::length_error);
+
+        /*!
+         * Stellt einen Ausschnitt des Buffers voran, ohne die Daten zu
+         * kopieren.
+         *
+         * \sa Append(const PooledBuffer&, U32, U32)
+         */
+        void Prepend(const PooledBuffer& buffer, U32 offset, U32 size) LU_THROWS(std::bad_alloc, std::length_error, std::out_of_range);
+
+        /*!
+         * Stellt alle Ausschnitte der anderen Kette voran, ohne die Daten zu
+         * kopieren.
+         */
+        void Prepend(const BufferChain& chain) LU_THROWS(std::bad_alloc, std::length_error);
+
+        /*!
+         * Kopiert die Bytes an den Anfang der Kette, bspw einen Header. Ist
+         * vor dem ersten Ausschnitt genug nicht geteilter Platz frei, dann
+         * wird dieser verwendet. Ansonsten werden die Bytes an das Ende
+         * eines neuen Buffers geschrieben, damit weitere Header wieder davor
+         * passen.
+         *
+         * \param[in]   data    Zeiger auf die Daten.
+         * \param[in]   size    Anzahl der Bytes.
+         */
+        void Prepend(const Byte* data, U32 size) LU_THROWS(std::bad_alloc, std::length_error, null_pointer);
+
+        /*!
+         * Erstellt eine Kette über einen Teil dieser Kette, ohne die Daten zu
+         * kopieren.
+         *
+         * \param[in]   offset  Beginn des Teils.
+         * \param[in]   size    Größe des Teils.
+         *
+         * \returns Die neue Kette.
+         */
+        BufferChain Slice(U32 offset, U32 size) const LU_THROWS(std::bad_alloc, std::out_of_range);
+
+        /*!
+         * Trennt die ersten size Bytes von der Kette ab, ohne die Daten zu
+         * kopieren.
+         *
+         * \param[in]   size    Anzahl der Bytes.
+         *
+         * \returns Kette mit den abgetrennten Bytes.
+         */
+        BufferChain Split(U32 size) LU_THROWS(std::bad_alloc, std::out_of_range);
+
+        /*!
+         * Entfernt die ersten size Bytes, bspw nach einem teilweisen Send.
+         *
+         * \param[in]   size    Anzahl der Bytes.
+         */
+        void Consume(U32 size) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Gibt alle Ausschnitte frei.
+         */
+        void Clear() NOEXCEPT;
+
+        /*!
+         * Kopiert einen Teil der Kette in einen zusammenhängenden Speicher.
+         *
+         * \param[out]  target  Der Zielspeicher mit mindestens size Bytes.
+         * \param[in]   offset  Beginn des Teils in der Kette.
+         * \param[in]   size    Anzahl der Bytes.
+         */
+        void CopyTo(Byte* target, U32 offset, U32 size) const LU_THROWS(std::out_of_range, null_pointer);
+
+        /*!
+         * Fasst die Kette in einem einzigen Ausschnitt zusammen. Besteht sie
+         * bereits aus höchstens einem Ausschnitt, dann wird nichts kopiert.
+         *
+         * \returns Zeiger auf die zusammenhängenden Bytes, oder einen
+         *          nullptr wenn die Kette leer ist.
+         */
+        const Byte* Coalesce() LU_THROWS(std::bad_alloc);
+
+        /*!
+         * Überträgt die Ausschnitte als Segmente, bspw für einen
+         * Scatter/Gather Aufruf.
+         *
+         * \param[out]  segments    Zeiger auf das erste Segment.
+         * \param[in]   count       Anzahl der verfügbaren Segmente.
+         *
+         * \returns Die Anzahl der befüllten Segmente. Enthält die Kette mehr
+         *          Ausschnitte, dann werden nur die ersten count übertragen.
+         */
+        U32 Segments(ByteSegment* segments, U32 count) const NOEXCEPT;
+
+    private:
+
+        void Grow(U32 size) LU_THROWS(std::length_error);
+        void Push(const PooledBuffer& buffer, U32 offset, U32 size, bool front) LU_THROWS(std::bad_alloc);
+
+        Deque<BufferSlice> mSlices;
+        U32 mSize = 0;
+    };
+}
@@ -0,0 +1,154 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+
+namespace Lupus {
+    class BufferPool;
+
+    namespace Internal {
+        struct BufferBlock;
+        struct BufferCache;
+    }
+
+    /*!
+     * Referenzgezählter Verweis auf einen Buffer aus einem BufferPool. Kopien
+     * teilen sich den selben Speicher, sobald die letzte Kopie zerstört wird
+     * geht der Buffer an den Pool zurück.
+     *
+     * Der Pool muss länger leben als alle seine Buffer.
+     */
+    class LUPUS_API PooledBuffer
+    {
+    public:
+
+        /*!
+         * Erstellt einen leeren Verweis ohne Buffer.
+         */
+        PooledBuffer() NOEXCEPT;
+        PooledBuffer(const PooledBuffer& buffer) NOEXCEPT;
+        PooledBuffer(PooledBuffer&& buffer) NOEXCEPT;
+        ~PooledBuffer();
+
+        PooledBuffer& operator=(const PooledBuffer& buffer) NOEXCEPT;
+        PooledBuffer& operator=(PooledBuffer&& buffer) NOEXCEPT;
+
+        /*!
+         * \returns TRUE wenn kein Buffer referenziert wird.
+         */
+        bool IsEmpty() const NOEXCEPT;
+
+        /*!
+         * \returns Zeiger auf den Speicher, oder einen nullptr wenn der
+         *          Verweis leer ist.
+         */
+        Byte* Data() const NOEXCEPT;
+
+        /*!
+         * \returns Die Größe des Speichers in Bytes.
+         */
+        U32 Capacity() const NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der gültigen Bytes, bspw nach einem Receive.
+         */
+        U32 Size() const NOEXCEPT;
+
+        /*!
+         * Setzt die Anzahl der gültigen Bytes.
+         *
+         * \param[in]   size    Höchstens Capacity().
+         */
+        void Size(U32 size) LU_THROWS(std::out_of_range);
+
+        /*!
+         * \returns Die Anzahl der Verweise auf den Buffer.
+         */
+        U32 References() const NOEXCEPT;
+
+        /*!
+         * Gibt den Verweis auf. Ist es der letzte, dann geht der Buffer an
+         * den Pool zurück.
+         */
+        void Reset() NOEXCEPT;
+
+    private:
+
+        friend class BufferPool;
+
+        explicit PooledBuffer(Internal::BufferBlock* block) NOEXCEPT;
+
+        Internal::BufferBlock* mBlock = nullptr;
+    };
+
+    /*!
+     * Pool für Empfangsbuffer fester Größenklassen (2 KiB, 16 KiB und
+     * 64 KiB). Die Buffer werden in Slabs angefordert und nie einzeln an das
+     * System zurückgegeben.
+     *
+     * Jeder Thread hält einen kleinen Cache je Größenklasse, Lease und die
+     * Rückgabe kommen daher meist ohne atomare Operationen auf geteilte
+     * Daten aus. Buffer die in einem anderen Thread freigegeben werden
+     * landen in dessen Cache oder, wenn dieser voll ist, stapelweise in
+     * einer lock-freien globalen Liste. Nur das Anlegen neuer Slabs ist
+     * durch einen Mutex geschützt.
+     *
+     * Die Caches gehören dem Pool. Beendet sich ein Thread, dann gehen die
+     * Buffer seines Caches an die globale Liste und sein Cache an den
+     * nächsten neuen Thread. Bis zu 64 gleichzeitige Threads erhalten einen
+     * Cache, alle weiteren verwenden direkt die globale Liste.
+     */
+    class LUPUS_API BufferPool : public ReferenceType
+    {
+    public:
+
+        static const U32 SmallSize = 2 * KiB; //!< Kleinste Größenklasse.
+        static const U32 MediumSize = 16 * KiB; //!< Mittlere Größenklasse.
+        static const U32 LargeSize = 64 * KiB; //!< Größte Größenklasse.
+
+        BufferPool() LU_THROWS(std::bad_alloc);
+        virtual ~BufferPool();
+
+        /*!
+         * Leiht einen Buffer mit mindestens der angegebenen Größe. Anfragen
+         * über LargeSize werden einzeln angefordert und nicht gecached.
+         *
+         * \param[in]   size    Die benötigte Größe in Bytes.
+         *
+         * \returns Verweis auf einen Buffer mit Size() gleich Null.
+         */
+        virtual PooledBuffer Lease(U32 size) LU_THROWS(std::bad_alloc, std::length_error);
+
+        /*!
+         * \returns Die Anzahl der Bytes die der Pool in Slabs hält.
+         */
+        virtual U64 Reserved() const NOEXCEPT;
+
+        /*!
+         * \returns Einen prozessweiten Pool der nie zerstört wird.
+         */
+        static Pointer<BufferPool> Shared() NOEXCEPT;
+
+    private:
+
+        friend class PooledBuffer;
+
+        void Return(Internal::BufferBlock* block) NOEXCEPT;
+        Internal::BufferBlock* Refill(U32 index, Internal::BufferCache* cache) LU_THROWS(std::bad_alloc);
+        Internal::BufferBlock* Pop(U32 index) NOEXCEPT;
+        void Push(U32 index, Internal::BufferBlock* batch, U32 count) NOEXCEPT;
+        Internal::BufferCache* CurrentCache() const NOEXCEPT;
+
+        static Internal::BufferBlock* Link(Internal::BufferBlock** blocks, U32 count) NOEXCEPT;
+        static void ReleaseCache(void* owner, U32 slot) NOEXCEPT;
+
+        // Lock-freie Stapel zurückgegebener Buffer je Größenklasse, der
+        // Zeiger trägt einen Zähler gegen das ABA-Problem.
+        Atomic<U64> mReturned[3];
+        Internal::BufferCache* mCaches = nullptr;
+        Mutex mMutex;
+        Vector<Byte*> mSlabs;
+        Atomic<U64> mReserved;
+    };
+
+    typedef Pointer<BufferPool> BufferPoolPtr;
+}
@@ -0,0 +1,134 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+#include <type_traits>
+
+namespace Lupus {
+    namespace Internal {
+        struct StackChunk;
+    }
+
+    /*!
+     * Stack basierter Allocator der bei Bedarf wächst. Ist der aktuelle
+     * Block voll, dann wird ein weiterer Block angehängt, Allocate liefert
+     * daher nie einen nullptr. Anforderungen die größer als ein Block sind
+     * erhalten einen eigenen, entsprechend großen Block.
+     *
+     * Markierungen können über Blockgrenzen hinweg gesetzt werden. Blöcke
+     * die durch FreeToMarker oder Clear frei werden, bleiben für spätere
+     * Anforderungen erhalten. Der Speicherbedarf folgt dadurch der größten
+     * tatsächlichen Auslastung statt einer vorab geschätzten Größe. Mit Trim
+     * werden die freien Blöcke an das System zurückgegeben.
+     */
+    class LUPUS_API ChunkedStackAllocator : public ReferenceType
+    {
+    public:
+
+        /*!
+         * Erstellt einen neuen Stack und fordert den ersten Block an.
+         *
+         * \param[in]   chunkBytes  Die Größe eines Blocks in Bytes.
+         */
+        explicit ChunkedStackAllocator(U32 chunkBytes) LU_THROWS(std::bad_alloc);
+        virtual ~ChunkedStackAllocator();
+
+        /*!
+         * Fordert neuen Speicher an. Reicht der aktuelle Block nicht aus,
+         * dann wird ein freier Block wiederverwendet oder ein neuer Block
+         * angefordert.
+         *
+         * \tparam      T       Datentyp des Objekts.
+         * \param[in]   count   Anzahl der angeforderten Objekte.
+         *
+         * \returns Zeiger auf das allozierte Objekt.
+         */
+        template <typename T>
+        T* Allocate(U32 count = 1) LU_THROWS(std::bad_alloc)
+        {
+            const size_t bytes = sizeof(T) * (size_t)count;
+            const size_t align = std::alignment_of<T>::value;
+
+            void* ptr = (void*)mHead;
+            size_t space = mSize;
+
+            if (std::align(align, bytes, ptr, space)) {
+                mHead = (Byte*)ptr + bytes;
+                mSize = space - bytes;
+                return (T*)ptr;
+            }
+
+            return (T*)Grow(bytes, align);
+        }
+
+        /*!
+         * Fordert neuen Speicher ohne bekannten Typ an, bspw für einen
+         * memory_resource.
+         *
+         * \param[in]   bytes       Anzahl der Bytes.
+         * \param[in]   alignment   Die Ausrichtung, eine Zweierpotenz.
+         *
+         * \returns Zeiger auf den Speicher.
+         */
+        virtual void* AllocateBytes(size_t bytes, size_t alignment) LU_THROWS(std::bad_alloc);
+
+        /*!
+         * Markiert den jetzigen Speicherbereich und retouniert den Wert als
+         * UIntPtr.
+         *
+         * \returns Markierung als UIntPtr.
+         */
+        virtual UIntPtr GetMarker() const NOEXCEPT;
+
+        /*!
+         * Gibt den Speicher bis zur markierten Stelle frei. Blöcke die nach
+         * der Markierung angehängt wurden, werden für spätere Anforderungen
+         * aufbewahrt.
+         *
+         * Falls noch alte Werte im freigebenen Speicherbereich bearbeitet
+         * werden dann führt dies zu undefinierten Verhalten.
+         *
+         * \param[in]   marker  Die markierte Stell im Speicher.
+         */
+        virtual void FreeToMarker(UIntPtr marker) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Setzt den Kopf auf die Basis des ersten Blocks zurück. Alle
+         * weiteren Blöcke werden für spätere Anforderungen aufbewahrt.
+         */
+        virtual void Clear() NOEXCEPT;
+
+        /*!
+         * Gibt alle derzeit unbenutzten Blöcke an das System zurück.
+         */
+        virtual void Trim() NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der Bytes in allen Blöcken, auch in den
+         *          unbenutzten.
+         */
+        virtual U64 Reserved() const NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der Blöcke, auch der unbenutzten.
+         */
+        virtual U32 ChunkCount() const NOEXCEPT;
+
+    private:
+
+        //! Standardkonstruktor ist nicht erlaubt.
+        ChunkedStackAllocator() = delete;
+
+        void* Grow(size_t bytes, size_t align) LU_THROWS(std::bad_alloc);
+        void Enter(Internal::StackChunk* chunk) NOEXCEPT;
+
+        Internal::StackChunk* mCurrent = nullptr;
+        Internal::StackChunk* mFree = nullptr;
+        Byte* mHead = nullptr;
+        size_t mSize = 0;
+        U32 mChunkSize;
+        U32 mChunkCount = 0;
+        U64 mReserved = 0;
+    };
+
+    typedef Pointer<ChunkedStackAllocator> ChunkedStackAllocatorPtr;
+}
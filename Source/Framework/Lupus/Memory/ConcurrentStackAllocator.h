@@ -0,0 +1,111 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+#include <type_traits>
+#include <algorithm>
+
+namespace Lupus {
+    /*!
+     * Threadsichere Variante des StackAllocator. Mehrere Threads können
+     * gleichzeitig Speicher aus dem selben Block anfordern, bspw die Worker
+     * die gemeinsam einen Frame aufbauen.
+     *
+     * Allocate reserviert den Speicher mit einem einzigen atomaren
+     * fetch-add auf den Kopf, Anforderungen werden dafür auf Granularity
+     * Bytes aufgerundet. Nur Typen mit einer größeren Ausrichtung verwenden
+     * eine compare-exchange Schleife.
+     *
+     * GetMarker, FreeToMarker und Clear setzen den Kopf für alle Threads.
+     * Sie dürfen nur aufgerufen werden wenn kein anderer Thread gleichzeitig
+     * anfordert, bspw am Ende eines Frames nachdem alle Worker fertig sind.
+     */
+    class LUPUS_API ConcurrentStackAllocator : public ReferenceType
+    {
+    public:
+
+        //! Auf diese Größe werden alle Anforderungen aufgerundet.
+        static const U32 Granularity = 16;
+
+        /*!
+         * Erstellt einen neuen Stack mit der angegebenen Bytegröße.
+         *
+         * \param[in]   maxBytes    Die Größe des Stacks in Bytes.
+         */
+        explicit ConcurrentStackAllocator(U32 maxBytes) NOEXCEPT;
+        virtual ~ConcurrentStackAllocator();
+
+        /*!
+         * Fordert neuen Speicher an. Darf aus jedem Thread aufgerufen werden.
+         * Falls nicht genug Platz vorhanden ist, dann wird ein nullptr
+         * retouniert.
+         *
+         * \tparam      T       Datentyp des Objekts.
+         * \param[in]   count   Anzahl der angeforderten Objekte.
+         *
+         * \returns Zeiger auf das allozierte Objekt, oder einen nullptr wenn
+         *          nicht genug Speicher vorhanden ist.
+         */
+        template <typename T>
+        T* Allocate(U32 count = 1) NOEXCEPT
+        {
+            const size_t bytes = sizeof(T) * (size_t)count;
+            const size_t align = std::alignment_of<T>::value;
+
+            if (align > Granularity) {
+                return (T*)AllocateAligned(bytes, align);
+            }
+
+            const size_t size = (bytes + Granularity - 1) & ~(size_t)(Granularity - 1);
+
+            // Zu große Anforderungen dürfen den Kopf nicht verschieben, sonst
+            // wären auch alle folgenden kleinen Anforderungen verloren.
+            if (size > mMaxSize - std::min<size_t>(mOffset.load(std::memory_order_relaxed), mMaxSize)) {
+                return nullptr;
+            }
+
+            const size_t offset = mOffset.fetch_add(size, std::memory_order_relaxed);
+
+            if (offset > mMaxSize || size > mMaxSize - offset) {
+                return nullptr;
+            }
+
+            return (T*)(mBlock + offset);
+        }
+
+        /*!
+         * Markiert den jetzigen Speicherbereich und retouniert den Wert als
+         * UIntPtr.
+         *
+         * \returns Markierung als UIntPtr.
+         */
+        virtual UIntPtr GetMarker() const NOEXCEPT;
+
+        /*!
+         * Gibt den Speicher bis zur markierten Stelle frei, auch den Speicher
+         * den andere Threads nach der Markierung angefordert haben.
+         *
+         * \param[in]   marker  Die markierte Stell im Speicher.
+         */
+        virtual void FreeToMarker(UIntPtr marker) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Setzt den Kopf auf die Basis zurück. Dadurch werden sämtliche noch
+         * vorhandenen Werte/Zeiger im Bereich des Stacks ungültig.
+         */
+        virtual void Clear() NOEXCEPT;
+
+    private:
+
+        //! Standardkonstruktor ist nicht erlaubt.
+        ConcurrentStackAllocator() = delete;
+
+        void* AllocateAligned(size_t bytes, size_t align) NOEXCEPT;
+
+        Byte* mStorage;
+        Byte* mBlock;
+        U32 mMaxSize;
+        Atomic<size_t> mOffset;
+    };
+
+    typedef Pointer<ConcurrentStackAllocator> ConcurrentStackAllocatorPtr;
+}
@@ -18,6 +18,15 @@ namespace Lupus {
          * @param[in]   singleStackSize Die Bytegröße pro Stack.
          */
         explicit DoubleBufferAllocator(U32 singleStackSize) NOEXCEPT;
+
+        /*!
+         * Erstellt einen neuen DoubleBuffer, dessen Stacks ihren Speicher
+         * direkt in ganzen Seiten vom System anfordern.
+         *
+         * @param[in]   singleStackSize Die Bytegröße pro Stack.
+         * @param[in]   backing         Die Art des Speichers.
+         */
+        DoubleBufferAllocator(U32 singleStackSize, const MemoryBacking& backing) LU_THROWS(std::bad_alloc);
         virtual ~DoubleBufferAllocator();
 
         /*!
@@ -48,6 +57,40 @@ namespace Lupus {
             return mStackAllocator[mCurrent]->Allocate<T>(count);
         }
 
+        /*!
+         * Fordert Speicher ohne bekannten Typ aus dem aktiven Stack an.
+         *
+         * \sa StackAllocator::AllocateBytes
+         */
+        virtual void* AllocateBytes(size_t bytes, size_t alignment) NOEXCEPT;
+
+        /*!
+         * Markiert den jetzigen Speicherbereich des aktiven Stacks.
+         *
+         * \sa StackAllocator::GetMarker
+         */
+        virtual UIntPtr GetMarker() const NOEXCEPT;
+
+        /*!
+         * Gibt den Speicher des aktiven Stacks bis zur markierten Stelle
+         * frei. Die Markierung muss aus dem selben Frame stammen.
+         *
+         * \sa StackAllocator::FreeToMarker
+         */
+        virtual void FreeToMarker(UIntPtr marker) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Liest die Zähler beider Stacks, auch aus einem anderen Thread.
+         * Jeder Swap schließt einen Frame ab. BytesInUse und die Anzahlen
+         * gelten für beide Stacks, FramePeak für den aktiven Stack und
+         * LastFramePeak für den Stack des vorigen Frames. Peak ist der
+         * Höchststand eines einzelnen Stacks und damit die Untergrenze für
+         * singleStackSize.
+         *
+         * \sa AllocatorStatistics
+         */
+        virtual AllocatorStatistics Statistics() const NOEXCEPT;
+
     private:
 
         //! Standardkonstruktor ist nicht erlaubt.
@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include <Lupus/Memory/StackAllocator.h>
+#include <Lupus/Memory/ChunkedStackAllocator.h>
+#include <Lupus/Memory/DoubleBufferedAllocator.h>
+
+// std::pmr benötigt C++17, ältere Compiler sehen nur diesen Header.
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+
+#define LUPUS_MEMORY_RESOURCE 1
+
+#include <memory_resource>
+#include <new>
+
+namespace Lupus {
+    /*!
+     * memory_resource über einem Stack-Allocator, damit std::pmr Container
+     * ihren Speicher per Zeigerverschiebung aus einer Arena erhalten.
+     *
+     * Einzelne Freigaben werden ignoriert. Der Speicher wird erst mit Clear,
+     * FreeToMarker bzw Swap des Allocators wieder verfügbar, Container aus
+     * dem freigegebenen Bereich dürfen danach nicht mehr verwendet werden.
+     * Wie der Allocator selbst ist die Resource nicht threadsicher.
+     *
+     * \tparam  Allocator   StackAllocator, ChunkedStackAllocator oder
+     *                      DoubleBufferAllocator.
+     */
+    template <typename Allocator>
+    class ArenaResource : public std::pmr::memory_resource
+    {
+    public:
+
+        /*!
+         * Erstellt eine Resource über dem angegebenen Allocator, der länger
+         * existieren muss als die Resource.
+         */
+        explicit ArenaResource(Allocator& allocator) noexcept :
+            mAllocator(allocator)
+        {
+        }
+
+        /*!
+         * \returns Den zugrunde liegenden Allocator.
+         */
+        Allocator& Arena() const noexcept
+        {
+            return mAllocator;
+        }
+
+    protected:
+
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            void* result = mAllocator.AllocateBytes(bytes, alignment);
+
+            if (!result) {
+                throw std::bad_alloc();
+            }
+
+            return result;
+        }
+
+        void do_deallocate(void*, size_t, size_t) override
+        {
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return (this == &other);
+        }
+
+    private:
+
+        Allocator& mAllocator;
+    };
+
+    //! Wirft std::bad_alloc wenn der Stack voll ist.
+    typedef ArenaResource<StackAllocator> StackResource;
+
+    //! Wächst bei Bedarf um weitere Blöcke.
+    typedef ArenaResource<ChunkedStackAllocator> ChunkedStackResource;
+
+    //! Fordert immer aus dem aktiven Stack an, folgt also jedem Swap.
+    typedef ArenaResource<DoubleBufferAllocator> DoubleBufferResource;
+}
+
+#endif
+#endif
@@ -0,0 +1,165 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+#include <type_traits>
+#include <utility>
+#include <new>
+
+namespace Lupus {
+    namespace Internal {
+        struct PoolBlock;
+        struct PoolCache;
+    }
+
+    /*!
+     * Pool für Speicherblöcke fester Größe, die Grundlage von PoolAllocator.
+     *
+     * Jeder Thread hält zwei Magazine mit freien Blöcken, AllocateBlock und
+     * FreeBlock kommen daher meist ohne atomare Operationen aus. Ist ein
+     * Magazin voll bzw leer, dann wird es als Ganzes mit einer lock-freien
+     * Liste ausgetauscht. Nur wenn auch diese leer ist wird eine neue Seite
+     * angefordert, die Seiten werden erst mit dem Pool freigegeben.
+     *
+     * Die Caches gehören dem Pool. Beendet sich ein Thread, dann gehen seine
+     * Magazine an die globale Liste und sein Cache an den nächsten neuen
+     * Thread. Bis zu 64 gleichzeitige Threads erhalten einen Cache, alle
+     * weiteren verwenden direkt die globale Liste.
+     */
+    class LUPUS_API FixedSizePool : public ReferenceType
+    {
+    public:
+
+        static const U32 CacheLineSize = 64; //!< Ausrichtung gegen False Sharing.
+        static const U32 MagazineSize = 64; //!< Blöcke pro Magazin.
+        static const U32 PageSize = 64 * KiB; //!< Mindestgröße einer Seite.
+
+        /*!
+         * Erstellt einen Pool für Blöcke der angegebenen Größe.
+         *
+         * \param[in]   blockSize   Die Größe eines Blocks in Bytes.
+         * \param[in]   alignment   Die Ausrichtung der Blöcke, eine
+         *                          Zweierpotenz. Mit CacheLineSize teilen
+         *                          sich keine zwei Blöcke eine Cache-Line.
+         */
+        FixedSizePool(U32 blockSize, U32 alignment) LU_THROWS(std::bad_alloc, std::invalid_argument);
+        virtual ~FixedSizePool();
+
+        /*!
+         * Fordert einen Block an. Darf aus jedem Thread aufgerufen werden.
+         *
+         * \returns Zeiger auf den Block.
+         */
+        virtual void* AllocateBlock() LU_THROWS(std::bad_alloc);
+
+        /*!
+         * Gibt einen Block zurück, auch aus einem anderen Thread als dem,
+         * der ihn angefordert hat.
+         *
+         * \param[in]   block   Zeiger auf den Block oder ein nullptr.
+         */
+        virtual void FreeBlock(void* block) NOEXCEPT;
+
+        /*!
+         * \returns Die tatsächliche Größe eines Blocks.
+         */
+        virtual U32 BlockSize() const NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der Bytes die der Pool in Seiten hält.
+         */
+        virtual U64 Reserved() const NOEXCEPT;
+
+    private:
+
+        //! Standardkonstruktor ist nicht erlaubt.
+        FixedSizePool() = delete;
+
+        Internal::PoolBlock* Refill() LU_THROWS(std::bad_alloc);
+        Internal::PoolBlock* Pop() NOEXCEPT;
+        void Push(Internal::PoolBlock* magazine, U32 count) NOEXCEPT;
+        Internal::PoolCache* CurrentCache() const NOEXCEPT;
+
+        static void ReleaseCache(void* owner, U32 slot) NOEXCEPT;
+
+        U32 mBlockSize;
+        U32 mAlignment;
+        // Lock-freier Stapel voller Magazine, der Zeiger trägt einen Zähler
+        // gegen das ABA-Problem.
+        Atomic<U64> mMagazines;
+        Internal::PoolCache* mCaches = nullptr;
+        Mutex mMutex;
+        Vector<Byte*> mPages;
+        Atomic<U64> mReserved;
+    };
+
+    /*!
+     * Allocator für Objekte mit individueller Lebensdauer, bspw Verbindungen
+     * oder Timer-Einträge, ohne den globalen Heap.
+     *
+     * \tparam  T               Der Typ der Objekte.
+     * \tparam  CacheLineAlign  Richtet jedes Objekt an einer eigenen
+     *                          Cache-Line aus, für Objekte die von
+     *                          verschiedenen Threads bearbeitet werden.
+     */
+    template <typename T, bool CacheLineAlign = false>
+    class PoolAllocator : public FixedSizePool
+    {
+    public:
+
+        PoolAllocator() LU_THROWS(std::bad_alloc) :
+            FixedSizePool((U32)sizeof(T), CacheLineAlign ? CacheLineSize : (U32)std::alignment_of<T>::value)
+        {
+        }
+
+        virtual ~PoolAllocator() = default;
+
+        /*!
+         * Fordert Speicher für ein Objekt an, ohne es zu konstruieren.
+         */
+        T* Allocate() LU_THROWS(std::bad_alloc)
+        {
+            return (T*)AllocateBlock();
+        }
+
+        /*!
+         * Gibt den Speicher eines Objekts zurück, ohne es zu zerstören.
+         */
+        void Free(T* object) NOEXCEPT
+        {
+            FreeBlock(object);
+        }
+
+        /*!
+         * Fordert Speicher an und konstruiert darin ein Objekt.
+         *
+         * \param[in]   args    Die Argumente für den Konstruktor.
+         *
+         * \returns Zeiger auf das neue Objekt.
+         */
+        template <typename... Args>
+        T* Create(Args&&... args)
+        {
+            T* object = Allocate();
+
+            try {
+                return new (object) T(std::forward<Args>(args)...);
+            } catch (...) {
+                Free(object);
+                throw;
+            }
+        }
+
+        /*!
+         * Zerstört das Objekt und gibt seinen Speicher zurück.
+         *
+         * \param[in]   object  Zeiger auf das Objekt oder ein nullptr.
+         */
+        void Destroy(T* object) NOEXCEPT
+        {
+            if (object) {
+                object->~T();
+                Free(object);
+            }
+        }
+    };
+}
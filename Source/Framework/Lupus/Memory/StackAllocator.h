@@ -1,9 +1,31 @@
 ﻿#pragma once
 
 #include <Lupus/Definitions.h>
+#include <Lupus/Memory/AllocatorStatistics.h>
 #include <type_traits>
 
 namespace Lupus {
+    /*!
+     * Legt fest, wie ein Allocator seinen Speicher vom System anfordert.
+     * Große Arenen profitieren von 2 MiB Seiten (weniger TLB-Fehlzugriffe)
+     * und, auf Systemen mit mehreren Sockeln, von Speicher auf dem Knoten
+     * des verwendenden Threads.
+     */
+    struct MemoryBacking
+    {
+        //! Verwendet 2 MiB Seiten. Unter Linux wird zuerst MAP_HUGETLB
+        //! versucht und sonst Transparent Huge Pages angefragt, unter Windows
+        //! sind dafür große Seiten und SeLockMemoryPrivilege nötig.
+        bool HugePages = false;
+
+        //! Der NUMA-Knoten an den der Speicher gebunden wird, oder -1.
+        S32 NumaNode = -1;
+
+        //! Lagert alle Seiten bereits beim Anlegen ein, damit im Betrieb
+        //! keine Seitenfehler auftreten.
+        bool Prefault = false;
+    };
+
     //! Stack basierter Allocator der das markieren von Speicher erlaubt.
     class LUPUS_API StackAllocator : public ReferenceType
     {
@@ -15,6 +37,15 @@ namespace Lupus {
          * \param[in]   maxBytes    Die Größe des Stacks in Bytes.
          */
         explicit StackAllocator(U32 maxBytes) NOEXCEPT;
+
+        /*!
+         * Erstellt einen neuen Stack, dessen Speicher direkt in ganzen Seiten
+         * vom System angefordert wird.
+         *
+         * \param[in]   maxBytes    Die Größe des Stacks in Bytes.
+         * \param[in]   backing     Die Art des Speichers.
+         */
+        StackAllocator(U32 maxBytes, const MemoryBacking& backing) LU_THROWS(std::bad_alloc);
         virtual ~StackAllocator();
 
         /*!
@@ -37,15 +68,33 @@ namespace Lupus {
 
             if (std::align(align, bytes, ptr, mSize)) {
                 T* result = (T*)ptr;
+#ifdef LUPUS_ALLOCATOR_STATISTICS
+                mStatistics.Allocated(mMaxSize - mSize + bytes, (U64)((Byte*)ptr - mHead));
+#endif
                 mHead = (Byte*)ptr;
                 mHead += bytes;
                 mSize -= bytes;
                 return result;
             }
 
+#ifdef LUPUS_ALLOCATOR_STATISTICS
+            mStatistics.Failed();
+#endif
             return nullptr;
         }
 
+        /*!
+         * Fordert neuen Speicher ohne bekannten Typ an, bspw für einen
+         * memory_resource.
+         *
+         * \param[in]   bytes       Anzahl der Bytes.
+         * \param[in]   alignment   Die Ausrichtung, eine Zweierpotenz.
+         *
+         * \returns Zeiger auf den Speicher, oder einen nullptr wenn nicht
+         *          genug Speicher vorhanden ist.
+         */
+        virtual void* AllocateBytes(size_t bytes, size_t alignment) NOEXCEPT;
+
         /*!
          * Markiert den jetzigen Speicherbereich und retouniert den Wert als
          * UIntPtr.
@@ -64,7 +113,7 @@ namespace Lupus {
          *
          * \param[in]   marker  Die markierte Stell im Speicher.
          */
-        virtual void FreeToMarker(UIntPtr marker) throw(std::out_of_range);
+        virtual void FreeToMarker(UIntPtr marker) LU_THROWS(std::out_of_range);
 
         /*!
          * Setzt den Kopf auf die Basis zurück. Dadurch werden sümtliche noch
@@ -75,6 +124,19 @@ namespace Lupus {
          */
         virtual void Clear() NOEXCEPT;
 
+        /*!
+         * Schließt einen Frame für die Statistik ab. Der Höchststand des
+         * Frames ist danach als LastFramePeak abrufbar.
+         */
+        virtual void NextFrame() NOEXCEPT;
+
+        /*!
+         * Liest die Zähler, auch aus einem anderen Thread.
+         *
+         * \sa AllocatorStatistics
+         */
+        virtual AllocatorStatistics Statistics() const NOEXCEPT;
+
     private:
 
         //! Standardkonstruktor ist nicht erlaubt.
@@ -82,8 +144,12 @@ namespace Lupus {
 
         Byte* mBlock;
         Byte* mHead;
-        U32 mSize;
+        size_t mSize;
         U32 mMaxSize;
+        // Größe der Seiten vom System, Null wenn der Block mit new angefordert
+        // wurde.
+        size_t mReserved = 0;
+        AllocatorCounters mStatistics;
     };
 
     typedef Pointer<StackAllocator> StackAllocatorPtr;
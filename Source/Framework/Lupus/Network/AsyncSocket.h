@@ -0,0 +1,559 @@
+﻿#pragma once
+
+#include <Lupus/Network/EventLoop.h>
+#include <Lupus/Network/Socket.h>
+
+// Koroutinen benötigen C++20, ältere Compiler sehen nur diesen Header.
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#define LUPUS_COROUTINES 1
+
+#include <coroutine>
+#include <exception>
+
+namespace Lupus {
+    namespace Internal {
+        /*!
+         * Pool für Koroutinen-Frames. Frames werden in Größenklassen zu 64
+         * Bytes eingeteilt und freigegebene Frames pro Thread in einer
+         * Freiliste behalten, damit tausende kurzlebige Koroutinen keinen
+         * Druck auf den globalen Heap ausüben. Frames über 2 KiB werden
+         * direkt angefordert.
+         */
+        class FramePool
+        {
+        public:
+
+            static const size_t Granularity = 64;
+            static const size_t ClassCount = 32;
+            static const size_t CacheLimit = 4096;
+
+            static void* Allocate(size_t size)
+            {
+                size_t index = (size + Granularity - 1) / Granularity;
+
+                if (index == 0 || index > ClassCount) {
+                    return ::operator new(size);
+                }
+
+                FreeList& list = Lists().Classes[index - 1];
+
+                if (list.Head) {
+                    Block* block = list.Head;
+
+                    list.Head = block->Next;
+                    list.Count--;
+                    return block;
+                }
+
+                return ::operator new(index * Granularity);
+            }
+
+            static void Free(void* pointer, size_t size) noexcept
+            {
+                size_t index = (size + Granularity - 1) / Granularity;
+
+                if (index == 0 || index > ClassCount) {
+                    ::operator delete(pointer);
+                    return;
+                }
+
+                FreeList& list = Lists().Classes[index - 1];
+
+                // Frames dürfen in einem anderen Thread freigegeben werden als
+                // sie angefordert wurden, die Liste wächst dann nur begrenzt.
+                if (list.Count >= CacheLimit) {
+                    ::operator delete(pointer);
+                    return;
+                }
+
+                Block* block = static_cast<Block*>(pointer);
+
+                block->Next = list.Head;
+                list.Head = block;
+                list.Count++;
+            }
+
+        private:
+
+            struct Block
+            {
+                Block* Next;
+            };
+
+            struct FreeList
+            {
+                Block* Head = nullptr;
+                size_t Count = 0;
+            };
+
+            struct ThreadLists
+            {
+                ~ThreadLists()
+                {
+                    for (FreeList& list : Classes) {
+                        while (Block* block = list.Head) {
+                            list.Head = block->Next;
+                            ::operator delete(block);
+                        }
+                    }
+                }
+
+                FreeList Classes[ClassCount];
+            };
+
+            static ThreadLists& Lists() noexcept
+            {
+                static thread_local ThreadLists lists;
+                return lists;
+            }
+        };
+
+        //! Gemeinsamer Teil aller Promise-Typen von Task.
+        struct TaskPromiseBase
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                {
+                    TaskPromiseBase& promise = handle.promise();
+
+                    if (promise.Continuation) {
+                        return promise.Continuation;
+                    } else if (promise.Detached) {
+                        handle.destroy();
+                    }
+
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return std::suspend_always();
+            }
+
+            FinalAwaiter final_suspend() const noexcept
+            {
+                return FinalAwaiter();
+            }
+
+            void unhandled_exception() noexcept
+            {
+                Exception = std::current_exception();
+            }
+
+            static void* operator new(size_t size)
+            {
+                return FramePool::Allocate(size);
+            }
+
+            static void operator delete(void* pointer, size_t size) noexcept
+            {
+                FramePool::Free(pointer, size);
+            }
+
+            std::coroutine_handle<> Continuation;
+            std::exception_ptr Exception;
+            bool Detached = false;
+        };
+
+        template <typename T>
+        struct TaskPromise : public TaskPromiseBase
+        {
+            template <typename U>
+            void return_value(U&& value)
+            {
+                Value = std::forward<U>(value);
+            }
+
+            T Result()
+            {
+                if (Exception) {
+                    std::rethrow_exception(Exception);
+                }
+
+                return std::move(Value);
+            }
+
+            T Value = T();
+        };
+
+        template <>
+        struct TaskPromise<void> : public TaskPromiseBase
+        {
+            void return_void() const noexcept
+            {
+            }
+
+            void Result()
+            {
+                if (Exception) {
+                    std::rethrow_exception(Exception);
+                }
+            }
+        };
+
+        //! Wartende Operation eines AsyncSocket.
+        struct AsyncWait
+        {
+            //! Versucht die Operation, TRUE sobald sie abgeschlossen ist.
+            virtual bool Attempt() noexcept = 0;
+
+            std::coroutine_handle<> Handle;
+        };
+
+        //! Zwischen AsyncSocket und seinem Handler im EventLoop geteilt.
+        struct AsyncState
+        {
+            AsyncWait* Current = nullptr;
+        };
+
+        //! \returns TRUE wenn die letzte Socketoperation blockieren würde.
+        inline bool WouldBlock() noexcept
+        {
+#ifdef _MSC_VER
+            return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+        }
+    }
+
+    /*!
+     * Koroutine mit Rückgabewert. Sie startet erst wenn sie mit co_await
+     * erwartet oder mit Spawn gestartet wird. Ausnahmen werden beim Erwarten
+     * weitergeworfen.
+     */
+    template <typename T = void>
+    class Task
+    {
+    public:
+
+        struct promise_type : public Internal::TaskPromise<T>
+        {
+            Task get_return_object() noexcept
+            {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+        };
+
+        Task(Task&& task) noexcept :
+            mHandle(task.mHandle)
+        {
+            task.mHandle = nullptr;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task()
+        {
+            if (mHandle) {
+                mHandle.destroy();
+            }
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+        {
+            mHandle.promise().Continuation = caller;
+            return mHandle;
+        }
+
+        T await_resume()
+        {
+            return mHandle.promise().Result();
+        }
+
+        /*!
+         * Startet die Koroutine ohne auf sie zu warten. Sie gibt ihren Frame
+         * nach dem Ende selbst frei, Ausnahmen werden verworfen.
+         */
+        friend void Spawn(Task&& task) noexcept
+        {
+            std::coroutine_handle<promise_type> handle = task.mHandle;
+
+            task.mHandle = nullptr;
+            handle.promise().Detached = true;
+            handle.resume();
+        }
+
+    private:
+
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept :
+            mHandle(handle)
+        {
+        }
+
+        std::coroutine_handle<promise_type> mHandle;
+    };
+
+    /*!
+     * Hülle um einen Socket die Operationen als erwartbare Objekte für
+     * co_await anbietet. Der Socket wird dabei nicht blockierend geschaltet.
+     * Jede Operation wird zuerst direkt versucht, nur wenn sie blockieren
+     * würde wartet die Koroutine im EventLoop und wird dort fortgesetzt.
+     *
+     * Der Socket wird einmalig für die Lebensdauer der Hülle registriert,
+     * ein Warten ändert nur die überwachten Ereignisse. Fristen und die
+     * SendQueue des Sockets bleiben dadurch erhalten.
+     *
+     * Die Koroutinen laufen im Thread der Schleife, diese darf keinen
+     * Dispatcher verwenden. Pro Socket darf nur eine Operation gleichzeitig
+     * warten.
+     */
+    class AsyncSocket
+    {
+    public:
+
+        /*!
+         * Registriert den Socket ohne Ereignisse im EventLoop.
+         *
+         * \param[in]   loop    Die Schleife in der die Koroutinen laufen.
+         * \param[in]   socket  Ein noch nicht registrierter Socket.
+         */
+        AsyncSocket(EventLoop& loop, Pointer<Socket> socket) :
+            mLoop(loop),
+            mSocket(socket),
+            mState(new Internal::AsyncState())
+        {
+            if (!socket) {
+                throw null_pointer("socket points to NULL");
+            }
+
+            Pointer<Internal::AsyncState> state = mState;
+
+            socket->Blocking(false);
+            loop.Add(socket, (SocketPollFlags)0, [&loop, state](Pointer<Socket> target, SocketPollFlags) {
+                Internal::AsyncWait* wait = state->Current;
+
+                if (!wait || !wait->Attempt()) {
+                    return;
+                }
+
+                state->Current = nullptr;
+                loop.Modify(target, (SocketPollFlags)0);
+                wait->Handle.resume();
+            });
+        }
+
+        AsyncSocket(const AsyncSocket&) = delete;
+        AsyncSocket& operator=(const AsyncSocket&) = delete;
+
+        ~AsyncSocket()
+        {
+            mLoop.Remove(mSocket);
+        }
+
+        /*!
+         * \returns Den zugrunde liegenden Socket.
+         */
+        Pointer<Socket> Target() const noexcept
+        {
+            return mSocket;
+        }
+
+        /*!
+         * Empfängt Daten.
+         *
+         * \returns Erwartbares Objekt, liefert die Anzahl der empfangenen
+         *          Bytes. Null wenn die Verbindung geschlossen wurde.
+         */
+        auto ReceiveAsync(Vector<Byte>& buffer, U32 offset, U32 size) noexcept
+        {
+            Pointer<Socket> socket = mSocket;
+
+            return Await<S32>(SocketPollFlags::Read, [socket, &buffer, offset, size](S32& result) {
+                return Transfer(socket->Receive(buffer, offset, size), result);
+            });
+        }
+
+        /*!
+         * Ruft ReceiveAsync(buffer, 0, buffer.size()) auf.
+         */
+        auto ReceiveAsync(Vector<Byte>& buffer) noexcept
+        {
+            return ReceiveAsync(buffer, 0, (U32)buffer.size());
+        }
+
+        /*!
+         * Sendet Daten. Wie bei Socket::Send können weniger Bytes gesendet
+         * werden als angefordert.
+         *
+         * \returns Erwartbares Objekt, liefert die Anzahl der gesendeten
+         *          Bytes.
+         */
+        auto SendAsync(const Vector<Byte>& buffer, U32 offset, U32 size) noexcept
+        {
+            Pointer<Socket> socket = mSocket;
+
+            return Await<S32>(SocketPollFlags::Write, [socket, &buffer, offset, size](S32& result) {
+                return Transfer(socket->Send(buffer, offset, size), result);
+            });
+        }
+
+        /*!
+         * Ruft SendAsync(buffer, 0, buffer.size()) auf.
+         */
+        auto SendAsync(const Vector<Byte>& buffer) noexcept
+        {
+            return SendAsync(buffer, 0, (U32)buffer.size());
+        }
+
+        /*!
+         * Akzeptiert eine Verbindung eines horchenden Sockets.
+         *
+         * \returns Erwartbares Objekt, liefert den verbundenen Socket.
+         */
+        auto AcceptAsync() noexcept
+        {
+            Pointer<Socket> socket = mSocket;
+
+            // Accept meldet einen Fehler nur als Ausnahme, errno ist danach
+            // nicht mehr verlässlich. Ohne wartende Verbindung wird daher gar
+            // nicht erst akzeptiert.
+            return Await<Pointer<Socket>>(SocketPollFlags::Read, [socket](Pointer<Socket>& result) {
+                if (socket->Poll(0, SocketPollFlags::Read) == SocketPollFlags::Timeout) {
+                    return false;
+                }
+
+                result = socket->Accept();
+                return true;
+            });
+        }
+
+        /*!
+         * Verbindet den Socket mit dem angegebenen Endpunkt.
+         *
+         * \returns Erwartbares Objekt, wirft socket_error wenn die Verbindung
+         *          nicht aufgebaut werden konnte.
+         */
+        auto ConnectAsync(Pointer<EndPoint> remoteEndPoint) noexcept
+        {
+            Pointer<Socket> socket = mSocket;
+            bool started = false;
+
+            // Der erste Versuch startet den Aufbau, danach wird auf Write
+            // gewartet und das Ergebnis über SO_ERROR abgefragt.
+            return Await<bool>(SocketPollFlags::Write, [socket, remoteEndPoint, started](bool& result) mutable {
+                if (!started) {
+                    started = true;
+                    socket->Connect(remoteEndPoint);
+                    return false;
+                }
+
+                S32 error = 0;
+                AddrLength length = sizeof(error);
+
+                if (getsockopt(socket->Handle(), SOL_SOCKET, SO_ERROR, (char*)&error, &length) != 0) {
+                    throw socket_error(GetLastSocketErrorString);
+                } else if (error != 0) {
+                    throw socket_error(GetSocketErrorString(error));
+                }
+
+                result = true;
+                return true;
+            });
+        }
+
+    private:
+
+        /*!
+         * Erwartbare Socketoperation. Attempt liefert TRUE sobald die
+         * Operation abgeschlossen ist und FALSE wenn sie blockieren würde.
+         * Die Funktion wird als Wert gespeichert und das Warten setzt nur
+         * die Ereignisse des registrierten Sockets, eine Operation benötigt
+         * also keinen Heap.
+         */
+        template <typename T, typename Function>
+        class Operation : public Internal::AsyncWait
+        {
+        public:
+
+            Operation(AsyncSocket& owner, SocketPollFlags events, Function attempt) :
+                mOwner(owner),
+                mEvents(events),
+                mAttempt(attempt)
+            {
+            }
+
+            bool await_ready()
+            {
+                return Attempt();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                Handle = handle;
+                mOwner.mState->Current = this;
+                mOwner.mLoop.Modify(mOwner.mSocket, mEvents);
+            }
+
+            T await_resume()
+            {
+                if (mException) {
+                    std::rethrow_exception(mException);
+                }
+
+                return std::move(mResult);
+            }
+
+        private:
+
+            bool Attempt() noexcept override
+            {
+                try {
+                    return mAttempt(mResult);
+                } catch (...) {
+                    mException = std::current_exception();
+                    return true;
+                }
+            }
+
+            AsyncSocket& mOwner;
+            SocketPollFlags mEvents;
+            Function mAttempt;
+            T mResult = T();
+            std::exception_ptr mException;
+        };
+
+        template <typename T, typename Function>
+        Operation<T, Function> Await(SocketPollFlags events, Function attempt) noexcept
+        {
+            return Operation<T, Function>(*this, events, attempt);
+        }
+
+        static bool Transfer(S32 count, S32& result)
+        {
+            if (count >= 0) {
+                result = count;
+                return true;
+            } else if (Internal::WouldBlock()) {
+                return false;
+            }
+
+            throw socket_error(GetLastSocketErrorString);
+        }
+
+        EventLoop& mLoop;
+        Pointer<Socket> mSocket;
+        Pointer<Internal::AsyncState> mState;
+    };
+}
+
+#endif
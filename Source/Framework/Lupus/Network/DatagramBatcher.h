@@ -0,0 +1,204 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+#include <Lupus/Memory/DoubleBufferedAllocator.h>
+
+namespace Lupus {
+    class EndPoint;
+    class Socket;
+
+    namespace Internal {
+        struct BatchState;
+    }
+
+    /*!
+     * Empfangenes Datagramm. Die Daten liegen im Speicher des Frames in dem
+     * sie empfangen wurden und bleiben bis zum Ende des folgenden Ticks
+     * gültig.
+     */
+    struct Datagram
+    {
+        //! Die Nummer des Absenders oder DatagramBatcher::InvalidPeer.
+        U32 Peer = 0;
+
+        //! Zeiger auf die empfangenen Bytes.
+        Byte* Data = nullptr;
+
+        //! Die Anzahl der empfangenen Bytes.
+        U32 Size = 0;
+
+        //! Die Socketadresse des Absenders, bspw für AddPeer.
+        const Byte* Address = nullptr;
+
+        //! Die Anzahl der gültigen Bytes von Address.
+        U32 Length = 0;
+    };
+
+    /*!
+     * Frame-orientierter Betrieb eines Datagram-Sockets für Spielserver.
+     *
+     * Ausgehende Datagramme werden mit Write direkt im Speicher des
+     * aktuellen Frames aufgebaut und erst mit Tick gesammelt gesendet.
+     * Receive holt alle wartenden Datagramme in den selben Speicher. Unter
+     * Linux werden dafür sendmmsg und recvmmsg mit bis zu BatchSize
+     * Datagrammen pro Systemaufruf verwendet, auf anderen Plattformen
+     * sendto und recvfrom.
+     *
+     * Jeder Tick tauscht die Buffer eines DoubleBufferAllocator, Daten
+     * bleiben also einen weiteren Tick gültig. Nach dem Anlegen der
+     * Gegenstellen benötigt der Betrieb keine Heap-Anforderungen mehr.
+     *
+     * Der Socket wird auf nicht blockierend gestellt. Die Klasse ist nicht
+     * threadsicher, sie gehört dem Thread der die Frames ausführt.
+     */
+    class LUPUS_API DatagramBatcher : public ReferenceType
+    {
+    public:
+
+        static const U32 InvalidPeer = 0xFFFFFFFF; //!< Unbekannter Absender.
+        static const U32 BatchSize = 64; //!< Datagramme pro Systemaufruf.
+
+        /*!
+         * Erstellt einen neuen Batcher für den angegebenen Socket.
+         *
+         * \param[in]   socket          Ein gebundener Datagram-Socket.
+         * \param[in]   frameBytes      Die Größe des Speichers pro Frame,
+         *                              für ausgehende und empfangene Daten.
+         * \param[in]   maxDatagrams    Die Anzahl der Datagramme pro Frame
+         *                              und Richtung.
+         * \param[in]   maxDatagramSize Die maximale Größe eines
+         *                              Datagramms. Größere empfangene
+         *                              werden abgeschnitten, größere
+         *                              ausgehende lehnt Write ab.
+         */
+        DatagramBatcher(Pointer<Socket> socket, U32 frameBytes, U32 maxDatagrams, U32 maxDatagramSize = 1500) LU_THROWS(null_pointer, std::invalid_argument, socket_error);
+        virtual ~DatagramBatcher();
+
+        /*!
+         * Meldet eine Gegenstelle an. Ist der Endpunkt bereits angemeldet,
+         * dann wird dessen Nummer retouniert.
+         *
+         * \param[in]   endPoint    Der Endpunkt der Gegenstelle.
+         *
+         * \returns Die Nummer der Gegenstelle.
+         */
+        virtual U32 AddPeer(Pointer<EndPoint> endPoint) LU_THROWS(null_pointer, std::invalid_argument);
+
+        /*!
+         * Meldet den Absender eines Datagramms an, bspw wenn sich ein neuer
+         * Client meldet.
+         *
+         * \param[in]   datagram    Ein empfangenes Datagramm.
+         *
+         * \returns Die Nummer der Gegenstelle.
+         */
+        virtual U32 AddPeer(const Datagram& datagram) LU_THROWS(std::invalid_argument);
+
+        /*!
+         * Meldet eine Gegenstelle ab. Ihre Nummer wird nicht erneut
+         * vergeben, Datagramme von ihr gelten danach als unbekannt.
+         *
+         * \param[in]   peer    Die Nummer der Gegenstelle.
+         */
+        virtual void RemovePeer(U32 peer) NOEXCEPT;
+
+        /*!
+         * Reserviert ein ausgehendes Datagramm im Speicher des aktuellen
+         * Frames. Der Aufrufer schreibt die Daten direkt in den
+         * retounierten Speicher, gesendet wird mit dem nächsten Tick.
+         *
+         * \param[in]   peer    Die Nummer der Gegenstelle.
+         * \param[in]   size    Die Größe des Datagramms, höchstens die
+         *                      maximale Größe aus dem Konstruktor.
+         *
+         * \returns Zeiger auf den Speicher des Datagramms, oder einen
+         *          nullptr wenn der Frame voll ist.
+         */
+        virtual Byte* Write(U32 peer, U32 size) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Kopiert ein ausgehendes Datagramm in den aktuellen Frame.
+         *
+         * \returns FALSE wenn der Frame voll ist, ansonsten TRUE.
+         */
+        virtual bool Send(U32 peer, const Byte* data, U32 size) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Empfängt alle wartenden Datagramme ohne zu blockieren, bis der
+         * Frame voll ist.
+         *
+         * \returns Die Anzahl der neu empfangenen Datagramme.
+         */
+        virtual U32 Receive() LU_THROWS(socket_error);
+
+        /*!
+         * \returns Alle seit dem letzten Tick empfangenen Datagramme.
+         */
+        virtual const Vector<Datagram>& Received() const NOEXCEPT;
+
+        /*!
+         * Sendet alle ausgehenden Datagramme des aktuellen Frames. Kann der
+         * Socket nicht alle aufnehmen, dann bleibt der Rest bis zum Tick
+         * erhalten. Lehnt das System einzelne Datagramme ab, bspw wegen
+         * EMSGSIZE oder einer unerreichbaren Gegenstelle, dann werden diese
+         * verworfen, in Dropped() gezählt und die übrigen gesendet. Nur
+         * Fehler des Sockets selbst werfen eine Exception.
+         *
+         * \returns Die Anzahl der gesendeten Datagramme.
+         */
+        virtual U32 Flush() LU_THROWS(socket_error);
+
+        /*!
+         * Schließt den Frame ab. Sendet alle ausgehenden Datagramme, tauscht
+         * die Buffer und bereinigt den neuen Frame. Nicht gesendete
+         * Datagramme werden verworfen. Wirft Flush eine Exception, dann wird
+         * der Frame trotzdem abgeschlossen.
+         *
+         * \returns Die Anzahl der gesendeten Datagramme.
+         */
+        virtual U32 Tick() LU_THROWS(socket_error);
+
+        /*!
+         * \returns Die Anzahl der noch nicht gesendeten Datagramme.
+         */
+        virtual U32 Pending() const NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der bisher vom System abgelehnten und daher
+         *          verworfenen Datagramme.
+         */
+        virtual U64 Dropped() const NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der bisherigen Systemaufrufe für Senden und
+         *          Empfangen.
+         */
+        virtual U64 SystemCalls() const NOEXCEPT;
+
+        /*!
+         * \returns Der Speicher der Frames, bspw für dessen Statistik.
+         */
+        virtual const DoubleBufferAllocator& Arena() const NOEXCEPT;
+
+    private:
+
+        //! Standardkonstruktor ist nicht erlaubt.
+        DatagramBatcher() = delete;
+
+        U32 Register(const Byte* address, U32 length) LU_THROWS(std::invalid_argument);
+        U32 FindPeer(const Byte* address, U32 length) const NOEXCEPT;
+        void EndFrame() NOEXCEPT;
+
+        Pointer<Socket> mSocket;
+        DoubleBufferAllocator mArena;
+        U32 mMaxDatagrams;
+        U32 mMaxDatagramSize;
+        U32 mSlotSize;
+        U64 mSystemCalls = 0;
+        U64 mDropped = 0;
+        Vector<Datagram> mReceived;
+        Internal::BatchState* mState = nullptr;
+    };
+
+    typedef Pointer<DatagramBatcher> DatagramBatcherPtr;
+}
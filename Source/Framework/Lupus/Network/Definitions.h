@@ -33,9 +33,29 @@ namespace Lupus {
 namespace Lupus {
     typedef SOCKET SocketHandle;
 
+    // <afunix.h> ist erst ab dem Windows 10 SDK vorhanden.
+    typedef struct {
+        ADDRESS_FAMILY sun_family;
+        char sun_path[108];
+    } AddrUnix;
+
+    //! \returns Den Text zu einem Fehlercode, bspw aus SO_ERROR.
+    inline String GetSocketErrorString(S32 error)
+    {
+        char buffer[256];
+        DWORD length = FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, (DWORD)error, 0, buffer, sizeof(buffer), nullptr);
+
+        // FormatMessage schließt mit einem Zeilenumbruch ab.
+        while (length > 0 && (buffer[length - 1] == '\r' || buffer[length - 1] == '\n')) {
+            length--;
+        }
+
+        return (length > 0) ? String(buffer, length) : std::to_string(error);
+    }
+
     namespace Internal {
         template <typename T>
-        S32 GetSocketDomain(T h) throw(socket_error)
+        S32 GetSocketDomain(T h) LU_THROWS(socket_error)
         {
             WSAPROTOCOL_INFO info;
             int size = sizeof(info);
@@ -50,7 +70,7 @@ namespace Lupus {
         }
 
         template <typename T>
-        S32 GetSocketProtocol(T h) throw(socket_error)
+        S32 GetSocketProtocol(T h) LU_THROWS(socket_error)
         {
             WSAPROTOCOL_INFO info;
             int size = sizeof(info);
@@ -69,8 +89,14 @@ namespace Lupus {
 #else
 
 #include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/types.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
@@ -89,16 +115,28 @@ namespace Lupus {
 #define LU_SHUTDOWN_WRITE SHUT_WR
 #define LU_SHUTDOWN_BOTH SHUT_RDWR
 
+// Winsock nennt das IP-in-IP Protokoll IPPROTO_IPV4.
+#ifndef IPPROTO_IPV4
+#define IPPROTO_IPV4 IPPROTO_IPIP
+#endif
+
 #define GetLastSocketErrorString (std::strerror(errno))
 #define GetLastAddressInfoErrorString (gai_strerror(errno))
 
 namespace Lupus {
     typedef int SocketHandle;
     typedef unsigned long u_long;
+    typedef sockaddr_un AddrUnix;
+
+    //! \returns Den Text zu einem Fehlercode, bspw aus SO_ERROR.
+    inline String GetSocketErrorString(S32 error)
+    {
+        return std::strerror(error);
+    }
 
     namespace Internal {
         template <typename T>
-        S32 GetSocketDomain(T h) throw(socket_error)
+        S32 GetSocketDomain(T h) LU_THROWS(socket_error)
         {
             int domain = 0;
             socklen_t size = sizeof(int);
@@ -111,7 +149,7 @@ namespace Lupus {
         }
 
         template <typename T>
-        S32 GetSocketProtocol(T h) throw(socket_error)
+        S32 GetSocketProtocol(T h) LU_THROWS(socket_error)
         {
             int protocol = 0;
             socklen_t size = sizeof(int);
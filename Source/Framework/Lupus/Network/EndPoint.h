@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+
+namespace Lupus {
+    /*!
+     * Basisklasse aller Endpunkte an die ein Socket gebunden bzw mit denen
+     * er verbunden werden kann.
+     */
+    class LUPUS_API EndPoint : public ReferenceType
+    {
+    public:
+        virtual ~EndPoint() = default;
+
+        /*!
+         * \returns Die Adressfamilie des Endpunkts.
+         */
+        virtual AddressFamily Family() const NOEXCEPT = 0;
+
+        /*!
+         * \returns Die Anzahl der gültigen Bytes der serialisierten Adresse.
+         *          Dieser Wert wird an bind, connect und sendto übergeben.
+         */
+        virtual U32 Length() const NOEXCEPT = 0;
+
+        /*!
+         * Serialisiert die Socketadresse. Der Buffer hat immer die Größe von
+         * AddrStorage, gültig sind allerdings nur die ersten Length() Bytes.
+         *
+         * \returns Interne Daten in Form eines Byte-Buffers.
+         */
+        virtual Vector<Byte> Serialize() const NOEXCEPT = 0;
+
+        /*!
+         * Erstellt anhand der Adressfamilie einen passenden Endpunkt aus
+         * einer serialisierten Socketadresse.
+         *
+         * \param[in]   buffer  Serialisierte Daten in der Größe von
+         *                      AddrStorage.
+         * \param[in]   length  Die Anzahl der gültigen Bytes.
+         *
+         * \returns Zeiger auf einen IPEndPoint oder einen UnixEndPoint.
+         */
+        static Pointer<EndPoint> Create(const Vector<Byte>& buffer, U32 length) LU_THROWS(std::invalid_argument);
+    };
+
+    typedef Pointer<EndPoint> EndPointPtr;
+}
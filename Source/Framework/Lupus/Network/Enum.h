@@ -87,6 +87,19 @@ namespace Lupus {
         Both = LU_SHUTDOWN_BOTH //!< Schließt sowohl Lese- als auch Schreibverbindung.
     };
 
+    //! Fristen die ein EventLoop pro Socket überwacht.
+    enum class SocketDeadline {
+        ReadIdle = 0, //!< Maximale Zeit ohne Leseereignis.
+        WriteStall = 1, //!< Maximale Zeit in der ausstehende Daten nicht geschrieben werden können.
+        Lifetime = 2 //!< Maximale Lebensdauer der Verbindung.
+    };
+
+    //! Art des Längenpräfix eines Frames.
+    enum class FramePrefix {
+        Fixed32, //!< 4 Bytes in Netzwerk-Byte-Reihenfolge.
+        Varint //!< 1 bis 5 Bytes, je 7 Bits beginnend mit den niedrigsten.
+    };
+
     enum class SocketFlags {
         None = 0,
         OutOfBand = MSG_OOB,
@@ -0,0 +1,238 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+#include <chrono>
+
+namespace Lupus {
+    class Scheduler;
+    class SendQueue;
+    class Socket;
+    class TimerWheel;
+
+    /*!
+     * Wartet mit poll auf Ereignisse mehrerer Sockets und ruft für jeden
+     * bereiten Socket dessen Handler auf. Zusätzlich besitzt jede Schleife
+     * ein TimerWheel mit einer Auflösung von einer Millisekunde, dessen
+     * Zeitgeber in derselben Schleife ablaufen.
+     *
+     * Pro Socket können Fristen für Lesepausen, blockierte Schreibvorgänge
+     * und die gesamte Lebensdauer gesetzt werden. Jede Frist ist ein
+     * Zeitgeber im Rad. Aktivität setzt nur einen Zeitstempel, erst beim
+     * Ablauf wird geprüft ob die Frist tatsächlich überschritten wurde,
+     * daher werden weder alle Verbindungen durchsucht noch Zeitgeber pro
+     * Ereignis neu eingefügt.
+     *
+     * Andere Threads senden über die SendQueue eines Sockets, siehe Queue.
+     * Mit einem Dispatcher laufen die Handler in dessen Workern statt in der
+     * Schleife selbst.
+     *
+     * Bis auf Post, Schedule und Stop dürfen alle Methoden nur aus dem
+     * Thread aufgerufen werden der die Schleife ausführt.
+     */
+    class LUPUS_API EventLoop : public ReferenceType
+    {
+    public:
+
+        //! Wird aufgerufen wenn ein registrierter Socket bereit ist.
+        typedef Function<void(Pointer<Socket>, SocketPollFlags)> Handler;
+
+        //! Wird für jeden Socket mit überschrittener Frist aufgerufen.
+        typedef Function<void(Pointer<Socket>, SocketDeadline)> ExpiredHandler;
+
+        /*!
+         * Erstellt eine neue Schleife samt internem Socketpaar zum Aufwecken.
+         */
+        EventLoop() LU_THROWS(socket_error);
+        virtual ~EventLoop();
+
+        /*!
+         * Registriert einen Socket.
+         *
+         * \param[in]   socket  Der zu überwachende Socket.
+         * \param[in]   events  Die zu überwachenden Ereignisse.
+         * \param[in]   handler Wird mit den eingetretenen Ereignissen
+         *                      aufgerufen.
+         */
+        virtual void Add(Pointer<Socket> socket, SocketPollFlags events, Handler handler) LU_THROWS(null_pointer, std::invalid_argument);
+
+        /*!
+         * Ändert die überwachten Ereignisse eines registrierten Sockets.
+         * Ohne Ereignisse und ohne zu sendende Daten wird der Socket nicht
+         * überwacht, bleibt aber samt Fristen und SendQueue registriert.
+         */
+        virtual void Modify(Pointer<Socket> socket, SocketPollFlags events) LU_THROWS(std::invalid_argument);
+
+        /*!
+         * Entfernt einen Socket. Ein bereits eingetretenes Ereignis wird
+         * danach nicht mehr zugestellt, noch nicht gesendete Daten der
+         * SendQueue werden verworfen.
+         */
+        virtual void Remove(Pointer<Socket> socket) NOEXCEPT;
+
+        /*!
+         * Retouniert die Sendewarteschlange eines registrierten Sockets und
+         * erstellt sie beim ersten Aufruf. Solange sie Daten enthält wartet
+         * die Schleife zusätzlich auf Write, der Handler erhält aber nur die
+         * mit Add bzw Modify angeforderten Ereignisse.
+         *
+         * \param[in]   socket  Der registrierte Socket.
+         *
+         * \returns Zeiger auf die Warteschlange.
+         */
+        virtual Pointer<SendQueue> Queue(Pointer<Socket> socket) LU_THROWS(std::invalid_argument);
+
+        /*!
+         * \returns Die Frist eines registrierten Sockets in Millisekunden,
+         *          Null wenn sie nicht überwacht wird.
+         */
+        virtual U32 Deadline(Pointer<Socket> socket, SocketDeadline type) const LU_THROWS(std::invalid_argument);
+
+        /*!
+         * Setzt eine Frist für einen registrierten Socket. Die Frist beginnt
+         * mit dem Aufruf. WriteStall wird nur überwacht solange der Socket
+         * auf Write wartet und beginnt jeweils beim Hinzufügen von Write zu
+         * den Ereignissen neu.
+         *
+         * \param[in]   socket          Der registrierte Socket.
+         * \param[in]   type            Die Art der Frist.
+         * \param[in]   milliSeconds    Die Frist in Millisekunden, Null
+         *                              deaktiviert sie.
+         */
+        virtual void Deadline(Pointer<Socket> socket, SocketDeadline type, U32 milliSeconds) LU_THROWS(std::invalid_argument);
+
+        /*!
+         * \returns Den Scheduler in dem die Handler ausgeführt werden oder
+         *          nullptr wenn sie in der Schleife laufen.
+         */
+        virtual Pointer<Scheduler> Dispatcher() const NOEXCEPT;
+
+        /*!
+         * Setzt den Scheduler in dem die Handler ausgeführt werden. Die
+         * Handler eines Sockets landen bevorzugt immer beim selben Worker,
+         * untätige Worker dürfen sie aber stehlen. Bis der Handler fertig ist
+         * wird der Socket nicht überwacht, er läuft also nie gleichzeitig
+         * mehrfach.
+         *
+         * Da die Handler dann nicht mehr im Thread der Schleife laufen, dürfen
+         * sie die Schleife nur über Post, Schedule und die SendQueue des
+         * Sockets verwenden. Die Schleife darf erst zerstört werden wenn keine
+         * Handler mehr laufen.
+         *
+         * \param[in]   scheduler   Der Scheduler oder nullptr.
+         */
+        virtual void Dispatcher(Pointer<Scheduler> scheduler) NOEXCEPT;
+
+        /*!
+         * Setzt die Funktion die für Sockets mit überschrittener Frist
+         * aufgerufen wird. Alle in einem Durchlauf abgelaufenen Fristen
+         * werden gesammelt und danach gemeinsam zugestellt. Ohne eigene
+         * Funktion werden solche Sockets entfernt und geschlossen.
+         */
+        virtual void Expired(ExpiredHandler handler) NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der registrierten Sockets.
+         */
+        virtual U32 Count() const NOEXCEPT;
+
+        /*!
+         * \returns Die Millisekunden seit dem Erstellen der Schleife.
+         *          Entspricht den Ticks des TimerWheels.
+         */
+        virtual U64 Now() const NOEXCEPT;
+
+        /*!
+         * Das Rad wird in RunOnce vor den Handlern auf Now() nachgezogen.
+         * Start wartet ab TimerWheel::Now(), außerhalb der Handler ist
+         * Schedule daher genauer.
+         *
+         * \returns Das Zeitgeberrad der Schleife.
+         */
+        virtual Pointer<TimerWheel> Timers() const NOEXCEPT;
+
+        /*!
+         * Führt die Funktion im Thread der Schleife aus. Darf aus jedem
+         * Thread aufgerufen werden.
+         */
+        virtual void Post(Function<void()> task) LU_THROWS(socket_error);
+
+        /*!
+         * Ruft die Funktion nach der angegebenen Zeit im Thread der Schleife
+         * auf. Darf aus jedem Thread aufgerufen werden.
+         *
+         * \param[in]   milliSeconds    Die Wartezeit in Millisekunden.
+         * \param[in]   callback        Die aufzurufende Funktion.
+         */
+        virtual void Schedule(U64 milliSeconds, Function<void()> callback) LU_THROWS(socket_error);
+
+        /*!
+         * Wartet einmalig auf Ereignisse und verarbeitet diese samt
+         * abgelaufener Zeitgeber und übergebener Funktionen.
+         *
+         * \param[in]   milliSeconds    Maximale Wartezeit, -1 wartet bis ein
+         *                              Ereignis eintritt.
+         *
+         * \returns Die Anzahl der verarbeiteten Ereignisse.
+         */
+        virtual U32 RunOnce(S32 milliSeconds) LU_THROWS(socket_error);
+
+        /*!
+         * Führt die Schleife aus bis Stop aufgerufen wird.
+         */
+        virtual void Run() LU_THROWS(socket_error);
+
+        /*!
+         * Beendet Run nach dem aktuellen Durchlauf. Darf aus jedem Thread
+         * aufgerufen werden.
+         */
+        virtual void Stop() NOEXCEPT;
+
+        /*!
+         * Eine gemeinsame Schleife die beim ersten Aufruf in einem eigenen
+         * Thread gestartet wird. Sie wird für Zeitgeber verwendet die keinem
+         * eigenen EventLoop zugeordnet sind, bspw Socket::Close(U32).
+         *
+         * \returns Zeiger auf die gemeinsame Schleife.
+         */
+        static Pointer<EventLoop> Shared() LU_THROWS(socket_error);
+
+    private:
+
+        friend class SendQueue;
+
+        struct Connection;
+
+        Pointer<Connection> Find(Pointer<Socket> socket) const LU_THROWS(std::invalid_argument);
+        void Arm(Connection& connection, SocketDeadline type, U64 now) NOEXCEPT;
+        void Watch(Connection& connection, SocketPollFlags events) NOEXCEPT;
+        void Update(Connection& connection) NOEXCEPT;
+        void Dispatch(Pointer<Connection> connection, SocketPollFlags events) LU_THROWS(std::bad_alloc);
+        bool Flush(Pointer<Connection> connection);
+        void Submit(SendQueue* queue) NOEXCEPT;
+        void Wake() NOEXCEPT;
+        U32 RunExpired();
+        U32 RunQueues();
+        U32 RunPosted();
+
+        Vector<pollfd> mPollDescriptors;
+        Vector<Pointer<Connection>> mEntries;
+        Hash<SocketHandle, U32> mIndices;
+        Vector<std::pair<SocketHandle, short>> mReady;
+        Vector<std::pair<Pointer<Connection>, SocketDeadline>> mExpired;
+        ExpiredHandler mExpiredHandler;
+        Pointer<Scheduler> mDispatcher;
+        Pointer<TimerWheel> mTimers;
+        std::chrono::steady_clock::time_point mStart;
+        Pointer<Socket> mWakeRead;
+        Pointer<Socket> mWakeWrite;
+        Atomic<bool> mWakePending;
+        Atomic<SendQueue*> mSubmitted;
+        Hash<SendQueue*, Pointer<SendQueue>> mRetired;
+        Atomic<bool> mStopped;
+        Atomic<std::thread::id> mThread;
+        Mutex mMutex;
+        Vector<Function<void()>> mPosted;
+    };
+
+    typedef Pointer<EventLoop> EventLoopPtr;
+}
@@ -0,0 +1,166 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+
+namespace Lupus {
+    class NetworkStream;
+    class BufferChain;
+
+    //! Verweis auf einen empfangenen Frame ohne eigene Kopie der Daten.
+    struct FrameView
+    {
+        const Byte* Data = nullptr;
+        U32 Size = 0;
+    };
+
+    /*!
+     * Zerlegt einen NetworkStream in Nachrichten mit vorangestellter Länge.
+     *
+     * Frames die in den Lese-Buffer des Streams passen werden direkt dort
+     * gelesen, FrameView zeigt dann in den Buffer und es wird nichts kopiert
+     * oder angefordert. Nur größere Frames werden in einem internen Vektor
+     * zusammengesetzt, der für weitere Frames wiederverwendet wird.
+     *
+     * Geschriebene Frames landen im Schreib-Buffer des Streams. Viele kleine
+     * Frames werden dadurch mit einem einzigen Flush gesendet.
+     */
+    class LUPUS_API FrameCodec : public ReferenceType
+    {
+    public:
+
+        //! Standardwert für die maximale Größe eines Frames.
+        static const U32 DefaultMaxSize = 16 * 1024 * 1024;
+
+        /*!
+         * Erstellt einen Codec mit 4 Byte Präfix und DefaultMaxSize.
+         */
+        FrameCodec(Pointer<NetworkStream> stream) LU_THROWS(null_pointer);
+
+        /*!
+         * Erstellt einen Codec über den angegebenen Stream.
+         *
+         * \param[in]   stream  Der zu verwendende Stream.
+         * \param[in]   prefix  Die Art des Längenpräfix.
+         * \param[in]   maxSize Maximale Größe eines Frames ohne Präfix.
+         */
+        FrameCodec(Pointer<NetworkStream> stream, FramePrefix prefix, U32 maxSize) LU_THROWS(null_pointer);
+        virtual ~FrameCodec() = default;
+
+        /*!
+         * \returns Den zugrunde liegenden Stream.
+         */
+        virtual Pointer<NetworkStream> Stream() const NOEXCEPT;
+
+        /*!
+         * \returns Die Art des Längenpräfix.
+         */
+        virtual FramePrefix Prefix() const NOEXCEPT;
+
+        /*!
+         * \returns Die maximale Größe eines Frames.
+         */
+        virtual U32 MaxSize() const NOEXCEPT;
+
+        /*!
+         * Liest einen Frame ausschließlich aus bereits empfangenen Daten und
+         * führt keinen Systemaufruf aus. Geeignet für einen EventLoop, der
+         * nach NetworkStream::Fill alle vollständigen Frames abholt.
+         *
+         * \param[out]  frame   Der Frame. Bleibt bis zum nächsten Lesen
+         *                      gültig.
+         *
+         * \returns TRUE wenn ein vollständiger Frame gelesen wurde.
+         */
+        virtual bool TryRead(FrameView& frame) LU_THROWS(std::length_error);
+
+        /*!
+         * Liest den nächsten Frame und blockiert bis er vollständig ist.
+         *
+         * \param[out]  frame   Der Frame. Bleibt bis zum nächsten Lesen
+         *                      gültig.
+         *
+         * \returns FALSE wenn die Verbindung zwischen zwei Frames geschlossen
+         *          wurde. Fehlt dem Datenstrom der Platz für weitere Daten,
+         *          dann wird std::out_of_range aus NetworkStream::Fill
+         *          weitergereicht.
+         */
+        virtual bool Read(FrameView& frame) LU_THROWS(socket_error, std::length_error, std::out_of_range);
+
+        /*!
+         * Liest den nächsten Frame in einen eigenen Vektor.
+         *
+         * \sa Read(FrameView&)
+         */
+        virtual bool Read(Vector<Byte>& frame) LU_THROWS(socket_error, std::length_error, std::out_of_range);
+
+        /*!
+         * Ruft Write(frame, 0, frame.size()) auf.
+         */
+        virtual void Write(const Vector<Byte>& frame) LU_THROWS(socket_error, std::length_error);
+
+        /*!
+         * Schreibt einen Frame in den Schreib-Buffer des Streams.
+         *
+         * \param[in]   frame   Vektor mit den Daten.
+         * \param[in]   offset  Der Beginn des Frames im Vektor.
+         * \param[in]   size    Die Größe des Frames.
+         */
+        virtual void Write(const Vector<Byte>& frame, U32 offset, U32 size) LU_THROWS(socket_error, std::length_error, std::out_of_range);
+
+        /*!
+         * Schreibt die Kette als Frame in den Schreib-Buffer des Streams.
+         * Findet der Datenstrom keinen Block für seinen Buffer, dann wird
+         * std::out_of_range aus NetworkStream::Reserve weitergereicht.
+         *
+         * \param[in]   frame   Die Kette mit den Daten.
+         */
+        virtual void Write(const BufferChain& frame) LU_THROWS(socket_error, std::length_error, std::out_of_range);
+
+        /*!
+         * Sendet alle geschriebenen Frames.
+         */
+        virtual void Flush() LU_THROWS(socket_error);
+
+        /*!
+         * Stellt der Kette das Längenpräfix voran. Zusammen mit
+         * Socket::Send(const BufferChain&) lässt sich ein Frame ohne
+         * NetworkStream und ohne Kopie der Nutzdaten senden.
+         *
+         * \param[in,out]   frame   Die Kette mit den Daten.
+         * \param[in]       prefix  Die Art des Längenpräfix.
+         */
+        static void Encode(BufferChain& frame, FramePrefix prefix) LU_THROWS(std::bad_alloc, std::length_error);
+
+        /*!
+         * Trennt den ersten vollständigen Frame von den empfangenen Daten ab.
+         * Der Frame teilt sich den Speicher mit den empfangenen Buffern und
+         * kann ohne Kopie an mehrere Sockets weitergereicht werden.
+         *
+         * \param[in,out]   input   Die bisher empfangenen Daten, bspw aus
+         *                          Socket::Receive(BufferChain&).
+         * \param[in]       prefix  Die Art des Längenpräfix.
+         * \param[in]       maxSize Maximale Größe eines Frames ohne Präfix.
+         * \param[out]      frame   Der Frame ohne Präfix.
+         *
+         * \returns TRUE wenn ein vollständiger Frame abgetrennt wurde.
+         */
+        static bool Decode(BufferChain& input, FramePrefix prefix, U32 maxSize, BufferChain& frame) LU_THROWS(std::length_error);
+
+    private:
+
+        //! Standardkonstruktor ist nicht erlaubt.
+        FrameCodec() = delete;
+
+        Pointer<NetworkStream> mStream;
+        FramePrefix mPrefix;
+        U32 mMaxSize;
+        Vector<Byte> mHeader;
+        // Frame der größer als der Lese-Buffer ist und zusammengesetzt wird.
+        Vector<Byte> mLarge;
+        U32 mLargeSize = 0;
+        U32 mLargeFilled = 0;
+        bool mLargeActive = false;
+    };
+
+    typedef Pointer<FrameCodec> FrameCodecPtr;
+}
@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+
+namespace Lupus {
+    class Socket;
+    class UnixEndPoint;
+
+    /*!
+     * Übergibt wartende Sockets (und optional untätige Verbindungen) beim
+     * Neustart eines Dienstes an den nachfolgenden Prozess. Die Übergabe
+     * erfolgt über einen AF_UNIX Socket am angegebenen Pfad.
+     *
+     * Da der Kernel-Socket während der gesamten Übergabe geöffnet bleibt,
+     * werden eingehende Verbindungen zu keinem Zeitpunkt abgewiesen. Der alte
+     * Prozess schließt seine Kopien erst nachdem der Nachfolger die Übernahme
+     * bestätigt hat und kann danach seine restlichen Verbindungen abarbeiten.
+     *
+     * \warning Wird unter Windows nicht unterstützt.
+     */
+    class LUPUS_API HotRestart : public ReferenceType
+    {
+    public:
+
+        /*!
+         * Erstellt eine neue Übergabestelle.
+         *
+         * \param[in]   path    Dateipfad des AF_UNIX Sockets.
+         */
+        explicit HotRestart(const String& path) LU_THROWS(std::invalid_argument);
+        virtual ~HotRestart();
+
+        /*!
+         * Fügt einen Socket hinzu, der beim nächsten Handoff übergeben wird.
+         *
+         * \param[in]   socket  Ein wartender oder verbundener Socket.
+         */
+        virtual void Add(Pointer<Socket> socket) LU_THROWS(null_pointer);
+
+        /*!
+         * \returns Die Sockets die beim nächsten Handoff übergeben werden.
+         */
+        virtual const Vector<Pointer<Socket>>& Sockets() const NOEXCEPT;
+
+        /*!
+         * Wartet im angegebenen Zeitintervall auf einen Nachfolger und
+         * übergibt ihm alle hinzugefügten Sockets. Beim ersten Aufruf wird
+         * der AF_UNIX Socket am Pfad erstellt, ein Aufruf mit 0 Millisekunden
+         * überprüft also lediglich ob ein Nachfolger wartet.
+         *
+         * Nach einer bestätigten Übergabe werden die lokalen Kopien
+         * geschlossen und Draining liefert TRUE. Bricht der Nachfolger die
+         * Übergabe ab, dann bleiben alle Sockets unverändert.
+         *
+         * \param[in]   milliSeconds    Der Zeitintervall in dem gewartet
+         *                              werden soll.
+         *
+         * \returns TRUE wenn die Sockets übergeben wurden, ansonsten FALSE.
+         */
+        virtual bool Handoff(U32 milliSeconds) LU_THROWS(socket_error);
+
+        /*!
+         * \returns TRUE wenn die Sockets bereits übergeben wurden und der
+         *          Prozess nur noch seine bestehenden Verbindungen abarbeiten
+         *          soll.
+         */
+        virtual bool Draining() const NOEXCEPT;
+
+        /*!
+         * Übernimmt die Sockets eines laufenden Vorgängers. Existiert der
+         * Pfad nicht oder wartet dort niemand (ENOENT bzw ECONNREFUSED), dann
+         * wird ein leerer Vektor retouniert und der Aufrufer erstellt seine
+         * Sockets wie gewohnt. Andere Fehler beim Verbinden werden als
+         * socket_error weitergereicht, ebenso mehr als 1024 angekündigte
+         * Sockets.
+         *
+         * \param[in]   path            Dateipfad des AF_UNIX Sockets.
+         * \param[in]   milliSeconds    Maximale Wartezeit auf den Kopf und
+         *                              auf jeden einzelnen Socket.
+         *
+         * \returns Die übernommenen Sockets in der Reihenfolge in der sie
+         *          hinzugefügt wurden.
+         */
+        static Vector<Pointer<Socket>> Inherit(const String& path, U32 milliSeconds) LU_THROWS(socket_error, std::invalid_argument);
+
+    private:
+
+        //! Standardkonstruktor ist nicht erlaubt.
+        HotRestart() = delete;
+
+        Pointer<UnixEndPoint> mEndPoint;
+        Pointer<Socket> mListener;
+        Vector<Pointer<Socket>> mSockets;
+        bool mDraining = false;
+    };
+
+    typedef Pointer<HotRestart> HotRestartPtr;
+}
@@ -26,7 +26,7 @@ namespace Lupus {
          *
          * \param[in]   ipv6    Die IPv6 Adresse in Netzwerkformat.
          */
-        IPAddress(const Vector<Byte>& ipv6) throw(std::length_error);
+        IPAddress(const Vector<Byte>& ipv6) LU_THROWS(std::length_error);
 
         /*!
          * Erstellt eine IP-Adresse anhand eines Byte-Buffers. Der Byte-Buffer
@@ -39,12 +39,12 @@ namespace Lupus {
          * \param[in]   ipv6    Die IPv6 Adresse in Netzwerkformat.
          * \param[in]   scopeid Der Scope Identifier der IPv6 Adresse.
          */
-        IPAddress(const Vector<Byte>& ipv6, U32 scopeid) throw(std::length_error);
+        IPAddress(const Vector<Byte>& ipv6, U32 scopeid) LU_THROWS(std::length_error);
 
         /*!
          * \sa IPAddress::IPAddress(const Vector<Byte>&, U32)
          */
-        IPAddress(std::initializer_list<Byte> ilist) throw(std::length_error);
+        IPAddress(std::initializer_list<Byte> ilist) LU_THROWS(std::length_error);
         virtual ~IPAddress() = default;
 
         /*!
@@ -77,14 +77,14 @@ namespace Lupus {
         /*!
          * \returns Den Scope Identifier der IPv6 Adresse.
          */
-        virtual U32 ScopeId() const throw(socket_error);
+        virtual U32 ScopeId() const LU_THROWS(socket_error);
 
         /*!
          * Setzt den Scope Identifier der IPv6 Adresse.
          *
          * \param[in]   value   Der neue Wert des Scope Identifiers.
          */
-        virtual void ScopeId(U32 value) throw(socket_error);
+        virtual void ScopeId(U32 value) LU_THROWS(socket_error);
 
         /*!
          * \returns Das Präsentationsformat der IP-Adresse.
@@ -105,7 +105,7 @@ namespace Lupus {
          *
          * \param[in]   ipString    Das Präsentationsformat der IP-Adresse.
          */
-        static Pointer<IPAddress> Parse(const String& ipString) throw(std::invalid_argument);
+        static Pointer<IPAddress> Parse(const String& ipString) LU_THROWS(std::invalid_argument);
 
         /*!
          * Ähnlich wie \sa IPAddress::Parse konvertiert diese Methode eine 
@@ -1,12 +1,12 @@
 ﻿#pragma once
 
-#include <Lupus/Network/Enum.h>
+#include <Lupus/Network/EndPoint.h>
 
 namespace Lupus {
     class IPAddress;
 
     //! Repräsentiert einen Endpunkt mit dem Kommuniziert werden kann.
-    class LUPUS_API IPEndPoint : public ReferenceType
+    class LUPUS_API IPEndPoint : public EndPoint
     {
     public:
         
@@ -29,20 +29,25 @@ namespace Lupus {
          * \param[in]   address Eine gültige IP-Adresse für diesen Endpunkt.
          * \param[in]   port    Die Portnummer.
          */
-        IPEndPoint(Pointer<IPAddress> address, U16 port) throw(null_pointer);
+        IPEndPoint(Pointer<IPAddress> address, U16 port) LU_THROWS(null_pointer);
 
         /*!
          * Erstellt einen IP-Endpunkt anhand von serialisierten Daten.
          *
          * \param[in]   buffer  Serialisierte Daten.
          */
-        IPEndPoint(const Vector<Byte>& buffer) throw(std::invalid_argument);
+        IPEndPoint(const Vector<Byte>& buffer) LU_THROWS(std::invalid_argument);
         virtual ~IPEndPoint() = default;
 
         /*!
          * \returns Die Adressfamilie des Endpunkts.
          */
-        virtual AddressFamily Family() const NOEXCEPT;
+        virtual AddressFamily Family() const NOEXCEPT override;
+
+        /*!
+         * \returns Die Größe von AddrIn bzw AddrIn6.
+         */
+        virtual U32 Length() const NOEXCEPT override;
 
         /*!
          * \returns Die IP-Adresse des Endpunkts.
@@ -53,7 +58,7 @@ namespace Lupus {
          *
          * \param[in]   address Eine gültige IP-Adresse.
          */
-        virtual void Address(Pointer<IPAddress> address) throw(null_pointer);
+        virtual void Address(Pointer<IPAddress> address) LU_THROWS(null_pointer);
 
         /*!
          * \returns Die Portnummer des Endpunkts.
@@ -74,7 +79,7 @@ namespace Lupus {
          *
          * \returns Interne Daten in Form eines Byte-Buffers.
          */
-        virtual Vector<Byte> Serialize() const NOEXCEPT;
+        virtual Vector<Byte> Serialize() const NOEXCEPT override;
 
     private:
 
@@ -0,0 +1,235 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+
+namespace Lupus {
+    class BuddyAllocator;
+    class Socket;
+
+    //! Gepufferter Datenstrom über einen verbundenen Stream-Socket.
+    class LUPUS_API NetworkStream : public ReferenceType
+    {
+    public:
+
+        /*!
+         * Erstellt einen neuen Datenstrom mit jeweils 8 KiB Lese- und
+         * Schreib-Buffer.
+         *
+         * \sa NetworkStream::NetworkStream(Pointer<Socket>, U32, U32)
+         */
+        NetworkStream(Pointer<Socket> socket) LU_THROWS(null_pointer, std::invalid_argument, std::bad_alloc);
+
+        /*!
+         * Erstellt einen neuen Datenstrom über den angegebenen Socket. Der
+         * Socket muss ein verbundener Stream-Socket sein.
+         *
+         * Kleine Schreiboperationen werden im Schreib-Buffer gesammelt und
+         * erst mit Flush oder einem vollen Buffer in einem einzigen Aufruf
+         * gesendet. Leseoperationen füllen den Lese-Buffer mit so vielen
+         * Daten wie der Socket auf einmal liefert.
+         *
+         * \param[in]   socket          Der zu verwendende Socket.
+         * \param[in]   readBufferSize  Größe des Lese-Buffers in Bytes.
+         * \param[in]   writeBufferSize Größe des Schreib-Buffers in Bytes.
+         */
+        NetworkStream(Pointer<Socket> socket, U32 readBufferSize, U32 writeBufferSize) LU_THROWS(null_pointer, std::invalid_argument, std::bad_alloc);
+
+        /*!
+         * Erstellt einen neuen Datenstrom dessen Buffer aus dem angegebenen
+         * BuddyAllocator stammen und mit dem Verkehr wachsen und schrumpfen.
+         * Beide Buffer beginnen mit MinBlockSize.
+         *
+         * Ist der Lese-Buffer bei Fill voll, dann wird er verdoppelt, ist er
+         * leer, dann schrumpft er wieder auf MinBlockSize. Reserve vergrößert
+         * den Schreib-Buffer bei Bedarf, Flush gibt den zusätzlichen Platz
+         * wieder frei. Keiner der Buffer wird größer als MaxBlockSize. Ist
+         * die Arena voll, dann bleibt der aktuelle Buffer erhalten und Fill
+         * liest nur in den freien Platz bzw Reserve wirft std::out_of_range.
+         * Ein Flush innerhalb von Write oder Reserve schrumpft den Buffer
+         * nicht.
+         *
+         * \param[in]   socket      Der zu verwendende Socket.
+         * \param[in]   allocator   Der Allocator für die Buffer, kann von
+         *                          mehreren Datenströmen geteilt werden.
+         */
+        NetworkStream(Pointer<Socket> socket, Pointer<BuddyAllocator> allocator) LU_THROWS(null_pointer, std::invalid_argument, std::bad_alloc);
+
+        /*!
+         * Sendet noch ausstehende Daten. Fehler beim Senden werden dabei
+         * ignoriert.
+         */
+        virtual ~NetworkStream();
+
+        /*!
+         * \returns Den Socket über den der Datenstrom läuft.
+         */
+        virtual Pointer<Socket> Client() const NOEXCEPT;
+
+        /*!
+         * Überprüft ob Daten zum Lesen vorhanden sind, entweder im Lese-Buffer
+         * oder im Empfangs-Buffer des Sockets.
+         *
+         * \returns TRUE wenn Daten gelesen werden können, ansonsten FALSE.
+         */
+        virtual bool DataAvailable() const LU_THROWS(socket_error);
+
+        /*!
+         * \returns Die Anzahl der Bytes die bereits im Lese-Buffer liegen.
+         */
+        virtual U32 Buffered() const NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der Bytes die noch im Schreib-Buffer auf das
+         *          Senden warten.
+         */
+        virtual U32 Pending() const NOEXCEPT;
+
+        /*!
+         * \returns Die aktuelle Größe des Lese-Buffers.
+         */
+        virtual U32 ReadBufferSize() const NOEXCEPT;
+
+        /*!
+         * \returns Die aktuelle Größe des Schreib-Buffers.
+         */
+        virtual U32 WriteBufferSize() const NOEXCEPT;
+
+        /*!
+         * Retouniert einen Zeiger auf die bereits gelesenen Daten im
+         * Lese-Buffer, ohne sie zu entnehmen. Es sind Buffered() Bytes
+         * gültig. Der Zeiger bleibt bis zum nächsten Fill bzw Read gültig.
+         */
+        virtual const Byte* Peek() const NOEXCEPT;
+
+        /*!
+         * Entnimmt Daten aus dem Lese-Buffer ohne sie zu kopieren. Die Daten
+         * bleiben bis zum nächsten Fill bzw Read über Peek erreichbar.
+         *
+         * \param[in]   count   Anzahl der Bytes, höchstens Buffered().
+         */
+        virtual void Consume(U32 count) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Schiebt die noch nicht entnommenen Daten an den Anfang des
+         * Lese-Buffers und füllt den restlichen Platz mit einem einzigen
+         * Aufruf von Socket::Receive auf. Ausstehende Schreibdaten werden
+         * vorher gesendet.
+         *
+         * \returns Die Anzahl der neu gelesenen Bytes. Null wenn die
+         *          Verbindung geschlossen wurde. Ist der Buffer voll und kann
+         *          nicht wachsen, dann wird std::out_of_range geworfen.
+         */
+        virtual S32 Fill() LU_THROWS(socket_error, std::out_of_range);
+
+        /*!
+         * Ruft Read(buffer, 0, buffer.size()) auf.
+         *
+         * \sa Read(Vector<Byte>&, U32, U32)
+         */
+        virtual S32 Read(Vector<Byte>& buffer) LU_THROWS(socket_error);
+
+        /*!
+         * Liest Daten aus dem Datenstrom. Zuerst wird der Lese-Buffer
+         * geleert. Ist dieser leer, dann werden ausstehende Schreibdaten
+         * gesendet und der Buffer mit einem einzigen Aufruf neu befüllt.
+         * Anfragen die größer als der Lese-Buffer sind werden direkt in den
+         * Vektor gelesen.
+         *
+         * \param[in,out]   buffer  Der Vektor in dem die Daten gespeichert
+         *                          werden.
+         * \param[in]       offset  Der offset für den Vektor.
+         * \param[in]       size    Die maximal zu lesende Größe.
+         *
+         * \returns Die Anzahl der gelesenen Bytes. Null wenn die Verbindung
+         *          geschlossen wurde.
+         */
+        virtual S32 Read(Vector<Byte>& buffer, U32 offset, U32 size) LU_THROWS(socket_error, std::out_of_range);
+
+        /*!
+         * Ruft Write(buffer, 0, buffer.size()) auf.
+         *
+         * \sa Write(const Vector<Byte>&, U32, U32)
+         */
+        virtual void Write(const Vector<Byte>& buffer) LU_THROWS(socket_error);
+
+        /*!
+         * Schreibt Daten in den Datenstrom. Die Daten werden im
+         * Schreib-Buffer gesammelt und erst gesendet wenn dieser voll ist
+         * oder Flush aufgerufen wird. Anfragen die größer als der
+         * Schreib-Buffer sind werden direkt gesendet.
+         *
+         * \param[in]   buffer  Vektor mit den Daten zum Schreiben.
+         * \param[in]   offset  Der offset ab dem geschrieben wird.
+         * \param[in]   size    Die zu schreibende Größe.
+         */
+        virtual void Write(const Vector<Byte>& buffer, U32 offset, U32 size) LU_THROWS(socket_error, std::out_of_range);
+
+        /*!
+         * Stellt sicher dass mindestens size Bytes im Schreib-Buffer frei
+         * sind und retouniert einen Zeiger auf den freien Bereich. Es sind
+         * WriteBufferSize() - Pending() Bytes beschreibbar. Die beschriebenen
+         * Bytes werden erst mit Commit in den Datenstrom übernommen.
+         *
+         * \param[in]   size    Mindestanzahl an freien Bytes.
+         *
+         * \returns Zeiger auf den freien Bereich im Schreib-Buffer.
+         */
+        virtual Byte* Reserve(U32 size) LU_THROWS(socket_error, std::out_of_range);
+
+        /*!
+         * Übernimmt die direkt in den Schreib-Buffer geschriebenen Bytes.
+         *
+         * \param[in]   count   Anzahl der Bytes, höchstens der freie Platz.
+         */
+        virtual void Commit(U32 count) LU_THROWS(std::out_of_range);
+
+        /*!
+         * Sendet alle Daten im Schreib-Buffer.
+         */
+        virtual void Flush() LU_THROWS(socket_error);
+
+        /*!
+         * Sendet alle ausstehenden Daten und schließt den Socket.
+         */
+        virtual void Close() LU_THROWS(socket_error);
+
+    protected:
+
+        /*!
+         * Sendet den gesamten Bereich. Teilweise Schreiboperationen des
+         * Sockets werden wiederholt bis alles gesendet wurde.
+         */
+        virtual void SendAll(const Vector<Byte>& buffer, U32 offset, U32 size) LU_THROWS(socket_error);
+
+        /*!
+         * \sa SendAll(const Vector<Byte>&, U32, U32)
+         */
+        virtual void SendAll(const Byte* buffer, U32 size) LU_THROWS(socket_error);
+
+    private:
+
+        //! Standardkonstruktor ist nicht erlaubt.
+        NetworkStream() = delete;
+
+        void SendBuffered() LU_THROWS(socket_error);
+        void Validate(Pointer<Socket> socket) const LU_THROWS(null_pointer, std::invalid_argument);
+        Byte* Acquire(U32 size) LU_THROWS(std::bad_alloc);
+        void Release(Byte* buffer) NOEXCEPT;
+        void ResizeReadBuffer(U32 size) LU_THROWS(std::bad_alloc);
+        void ResizeWriteBuffer(U32 size) LU_THROWS(std::bad_alloc);
+        void ShrinkReadBuffer() NOEXCEPT;
+        void ShrinkWriteBuffer() NOEXCEPT;
+
+        Pointer<Socket> mSocket;
+        Pointer<BuddyAllocator> mAllocator;
+        Byte* mReadBuffer = nullptr;
+        U32 mReadSize = 0;
+        U32 mReadPosition = 0;
+        U32 mReadLength = 0;
+        Byte* mWriteBuffer = nullptr;
+        U32 mWriteSize = 0;
+        U32 mWriteLength = 0;
+    };
+
+    typedef Pointer<NetworkStream> NetworkStreamPtr;
+}
@@ -0,0 +1,116 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+#include <Lupus/Memory/BufferChain.h>
+
+namespace Lupus {
+    class EventLoop;
+    class Socket;
+
+    /*!
+     * Sendewarteschlange eines Sockets der zu einem EventLoop gehört. Beliebig
+     * viele Threads dürfen gleichzeitig Buffer einreihen, ohne dass dafür ein
+     * Mutex benötigt wird. Der erste Buffer nach einem Durchlauf meldet die
+     * Warteschlange bei ihrer Schleife an und weckt diese, weitere Buffer
+     * bis zum nächsten Durchlauf lösen kein erneutes Wecken aus.
+     *
+     * Die Schleife sendet alle eingereihten Buffer mit so wenigen
+     * Systemaufrufen wie möglich als Scatter/Gather Operation. Kann der Socket
+     * nicht alles aufnehmen, dann wartet die Schleife selbstständig auf Write
+     * und sendet den Rest später.
+     *
+     * Erstellt wird eine Warteschlange mit EventLoop::Queue. Nach dem
+     * Entfernen des Sockets aus der Schleife nimmt sie keine Buffer mehr an.
+     *
+     * \warning Die Schleife muss länger existieren als alle Threads die
+     *          Buffer einreihen. Der Socket sollte nicht blockierend sein.
+     */
+    class LUPUS_API SendQueue : public ReferenceType
+    {
+    public:
+
+        virtual ~SendQueue();
+
+        /*!
+         * Reiht einen Buffer ein. Darf aus jedem Thread aufgerufen werden.
+         *
+         * \param[in]   buffer  Die zu sendenden Daten.
+         *
+         * \returns FALSE wenn die Warteschlange bereits geschlossen wurde,
+         *          ansonsten TRUE.
+         */
+        virtual bool Enqueue(Vector<Byte> buffer) LU_THROWS(std::bad_alloc);
+
+        /*!
+         * Reiht eine Kette ein, ohne die Daten zu kopieren. Die selbe Kette
+         * kann dadurch in die Warteschlangen mehrerer Sockets eingereiht
+         * werden. Die Ausschnitte werden beim Senden direkt als Segmente
+         * übergeben.
+         *
+         * \param[in]   buffer  Die zu sendenden Daten.
+         *
+         * \returns FALSE wenn die Warteschlange bereits geschlossen wurde,
+         *          ansonsten TRUE.
+         */
+        virtual bool Enqueue(BufferChain buffer) LU_THROWS(std::bad_alloc);
+
+        /*!
+         * \returns Die Anzahl der eingereihten Bytes die noch nicht gesendet
+         *          wurden.
+         */
+        virtual U64 Queued() const NOEXCEPT;
+
+        /*!
+         * \returns TRUE wenn die Warteschlange keine Buffer mehr annimmt.
+         */
+        virtual bool IsClosed() const NOEXCEPT;
+
+        /*!
+         * \returns Den Socket über den gesendet wird.
+         */
+        virtual Pointer<Socket> Target() const NOEXCEPT;
+
+    private:
+
+        friend class EventLoop;
+
+        struct Node;
+
+        //! Buffer der gesendet wird, entweder ein eigener Vektor oder ein
+        //! Ausschnitt aus einer Kette.
+        struct Entry
+        {
+            Vector<Byte> Owned;
+            BufferSlice Shared;
+
+            Byte* Data() NOEXCEPT
+            {
+                return Owned.empty() ? Shared.Data() : Owned.data();
+            }
+
+            U32 Size() const NOEXCEPT
+            {
+                return Owned.empty() ? Shared.Size : (U32)Owned.size();
+            }
+        };
+
+        SendQueue(EventLoop* loop, Pointer<Socket> socket) NOEXCEPT;
+
+        bool Push(Node* node, U64 size) NOEXCEPT;
+        bool Flush() LU_THROWS(socket_error);
+        bool Close() NOEXCEPT;
+        void Discard() NOEXCEPT;
+
+        EventLoop* mLoop;
+        Pointer<Socket> mSocket;
+        Atomic<Node*> mHead;
+        Deque<Entry> mPending;
+        U32 mOffset = 0;
+        Atomic<U64> mQueued;
+        Atomic<bool> mScheduled;
+        Atomic<bool> mClosed;
+        SendQueue* mNextSubmitted = nullptr;
+    };
+
+    typedef Pointer<SendQueue> SendQueuePtr;
+}
@@ -0,0 +1,167 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+
+namespace Lupus {
+    class Socket;
+
+    namespace Internal {
+        class SharedRing;
+    }
+
+    /*!
+     * Nachrichtenkanal zwischen zwei Prozessen auf demselben Host über
+     * geteilten Speicher. Jede Richtung besitzt einen eigenen
+     * Single-Producer/Single-Consumer Ring, eine Nachricht wird dadurch nur
+     * einmal in den Ring und einmal heraus kopiert und benötigt im
+     * Normalfall keinen Systemaufruf.
+     *
+     * Ein wartender Empfänger prüft den Ring zuerst eine kurze Zeit aktiv
+     * und legt sich erst danach auf einem eventfd schlafen. Der Sender
+     * weckt ihn nur, wenn er tatsächlich schläft. Für einen vollen Ring gilt
+     * dasselbe in umgekehrter Richtung. Senden und Empfangen dürfen
+     * gleichzeitig aus je einem Thread erfolgen, Close auch während beide
+     * laufen.
+     *
+     * Der Aufbau erfolgt über einen verbundenen AF_UNIX Socket, über den
+     * der Speicher und die eventfds übergeben werden. Der Socket dient
+     * danach nur noch dazu das Ende des anderen Prozesses zu erkennen und
+     * darf nicht mehr anderweitig gelesen werden.
+     *
+     * \warning Wird nur unter Linux unterstützt.
+     */
+    class LUPUS_API SharedMemoryChannel : public ReferenceType
+    {
+    public:
+        virtual ~SharedMemoryChannel();
+
+        /*!
+         * Erstellt den geteilten Speicher und übergibt ihn an den Prozess am
+         * anderen Ende des Sockets. Dieser muss Accept aufrufen.
+         *
+         * \param[in]   channel     Verbundener AF_UNIX Socket.
+         * \param[in]   capacity    Größe jedes Rings in Bytes. Wird auf die
+         *                          nächste Zweierpotenz aufgerundet.
+         *
+         * \returns Zeiger auf den erstellten Kanal.
+         */
+        static Pointer<SharedMemoryChannel> Create(Pointer<Socket> channel, U32 capacity) LU_THROWS(null_pointer, socket_error);
+
+        /*!
+         * Übernimmt einen mit Create erstellten Kanal. Diese Methode
+         * blockiert bis der Speicher empfangen wurde.
+         *
+         * \param[in]   channel Verbundener AF_UNIX Socket.
+         *
+         * \returns Zeiger auf den übernommenen Kanal.
+         */
+        static Pointer<SharedMemoryChannel> Accept(Pointer<Socket> channel) LU_THROWS(null_pointer, socket_error);
+
+        /*!
+         * \returns Die Größe jedes Rings in Bytes. Nachrichten dürfen
+         *          höchstens Capacity() - 4 Bytes groß sein.
+         */
+        virtual U32 Capacity() const NOEXCEPT;
+
+        /*!
+         * \returns Die Größe der nächsten Nachricht oder Null wenn keine
+         *          Nachricht vorhanden ist.
+         */
+        virtual U32 Available() const NOEXCEPT;
+
+        /*!
+         * \returns TRUE wenn Send und Receive blockieren. Standardwert ist
+         *          TRUE.
+         */
+        virtual bool Blocking() const NOEXCEPT;
+
+        /*!
+         * Entscheidet ob Send und Receive blockieren.
+         */
+        virtual void Blocking(bool) NOEXCEPT;
+
+        /*!
+         * \returns TRUE solange keine Seite den Kanal geschlossen hat.
+         */
+        virtual bool IsConnected() const NOEXCEPT;
+
+        /*!
+         * Ruft Send(buffer, 0, buffer.size()) auf.
+         *
+         * \sa Send(const Vector<Byte>&, U32, U32)
+         */
+        virtual S32 Send(const Vector<Byte>& buffer) LU_THROWS(socket_error, std::invalid_argument);
+
+        /*!
+         * Sendet den Bereich als eine Nachricht. Ist der Ring voll, dann
+         * wird gewartet bis der Empfänger Platz geschaffen hat.
+         *
+         * \param[in]   buffer  Vektor mit den Daten zum senden.
+         * \param[in]   offset  Der offset ab dem gesendet wird.
+         * \param[in]   size    Die zu sendende Größe.
+         *
+         * Leere Nachrichten sind nicht erlaubt, da Receive mit Null das
+         * Schließen des Kanals meldet.
+         *
+         * \returns Die Anzahl der gesendeten Bytes oder -1 wenn der Kanal
+         *          nicht blockiert und der Ring voll ist.
+         */
+        virtual S32 Send(const Vector<Byte>& buffer, U32 offset, U32 size) LU_THROWS(socket_error, std::out_of_range, std::invalid_argument);
+
+        /*!
+         * Ruft Receive(buffer, 0, buffer.size()) auf.
+         *
+         * \sa Receive(Vector<Byte>&, U32, U32)
+         */
+        virtual S32 Receive(Vector<Byte>& buffer) LU_THROWS(socket_error);
+
+        /*!
+         * Empfängt die nächste Nachricht. Wie bei Datagram-Sockets wird
+         * eine Nachricht die größer als size ist abgeschnitten, der Rest
+         * geht verloren. Available liefert die benötigte Größe.
+         *
+         * \param[in,out]   buffer  Der Vektor in dem die Daten gespeichert
+         *                          werden.
+         * \param[in]       offset  Der offset für den Vektor.
+         * \param[in]       size    Die maximal zu lesende Größe.
+         *
+         * \returns Die Anzahl der erhaltenen Bytes. Null wenn der Kanal
+         *          geschlossen wurde und keine Nachrichten mehr vorhanden
+         *          sind, -1 wenn der Kanal nicht blockiert und der Ring leer
+         *          ist.
+         */
+        virtual S32 Receive(Vector<Byte>& buffer, U32 offset, U32 size) LU_THROWS(socket_error, std::out_of_range);
+
+        /*!
+         * Schließt den Kanal. Bereits gesendete Nachrichten können vom
+         * anderen Prozess noch gelesen werden. Wartende Aufrufe von Send
+         * und Receive in anderen Threads werden geweckt, der Speicher wird
+         * erst freigegeben wenn alle zurückgekehrt sind.
+         */
+        virtual void Close() NOEXCEPT;
+
+    private:
+
+        SharedMemoryChannel() NOEXCEPT;
+
+        void Wait(S32 handle) LU_THROWS(socket_error);
+        void Wake(S32 handle) NOEXCEPT;
+
+        Byte* mMemory = nullptr;
+        U64 mMemorySize = 0;
+        Pointer<Internal::SharedRing> mSend;
+        Pointer<Internal::SharedRing> mReceive;
+        Pointer<Socket> mChannel;
+        // Eigene eventfds auf denen gewartet wird und die des Partners.
+        S32 mDataWait = -1;
+        S32 mSpaceWait = -1;
+        S32 mDataSignal = -1;
+        S32 mSpaceSignal = -1;
+        bool mBlocking = true;
+        // Anzahl der Aufrufer in Send, Receive und den Abfragen.
+        mutable Atomic<U32> mUsers;
+        Atomic<bool> mClosing;
+    };
+
+    typedef Pointer<SharedMemoryChannel> SharedMemoryChannelPtr;
+}
@@ -4,16 +4,23 @@
 
 namespace Lupus {
     struct SocketInformation;
+    class EndPoint;
     class IPEndPoint;
     class IPAddress;
+    class PooledBuffer;
+    class BufferChain;
 
     namespace Internal {
         class SocketState;
+        struct DelayedClose;
     }
 
     class LUPUS_API Socket : public ReferenceType
     {
     public:
+
+        static const U32 MaxSegments = 64; //!< Ausschnitte pro Scatter/Gather Aufruf.
+
         /*!
          * Erstellt einen neuen Socket anhand von serialisierten Daten eines 
          * anderen Sockets. Falls der zuvor serialisierte Socket bereits
@@ -22,7 +29,7 @@ namespace Lupus {
          *
          * \param[in]   socketInformatoin   Die serialisierten Socketdaten
          */
-        Socket(const SocketInformation& socketInformation) throw(std::invalid_argument, socket_error);
+        Socket(const SocketInformation& socketInformation) LU_THROWS(std::invalid_argument, socket_error);
 
         /*!
          * Erstellt einen Socket anhand der Domäne, des zu verwendenden
@@ -32,7 +39,7 @@ namespace Lupus {
          * \param[in]   type        Der zu verwendende Sockettyp.
          * \param[in]   protocol    Das zu verwendende Protokoll.
          */
-        Socket(AddressFamily family, SocketType type, ProtocolType protocol) throw(socket_error);
+        Socket(AddressFamily family, SocketType type, ProtocolType protocol) LU_THROWS(socket_error);
         virtual ~Socket();
 
         /*!
@@ -42,49 +49,58 @@ namespace Lupus {
          *
          * \returns Zeiger auf den erstellten Socket der Remote-Verbindung.
          */
-        virtual Pointer<Socket> Accept() throw (socket_error);
+        virtual Pointer<Socket> Accept() LU_THROWS(socket_error);
 
         /*!
-         * Bindet diesen Socket an einen lokalen IP-Endpunkt. Diese Methode
+         * Bindet diesen Socket an einen lokalen Endpunkt. Diese Methode
          * funktioniert nur für lokale IP-Adressen, da sie den Datenverkehr der
          * Verbindung abfängt. Der Socket hat keinen exklusiven Zugang, was es
          * ermöglicht auch weitere Sockets an diesen Endpunkt zu binden.
          *
+         * Ein UnixEndPoint im Dateisystem erstellt die Datei am Pfad, diese
+         * muss vorher entfernt werden falls sie bereits existiert.
+         *
          * \param[in]   localEndPoint   Lokaler Endpunkt an den sich der Socket
          *                              binden soll.
          */
-        virtual void Bind(Pointer<IPEndPoint> localEndPoint) throw(socket_error);
+        virtual void Bind(Pointer<EndPoint> localEndPoint) LU_THROWS(socket_error);
 
         /*!
          * Schließt die Socketverbindung.
          */
-        virtual void Close() throw(socket_error);
+        virtual void Close() LU_THROWS(socket_error);
 
         /*!
          * Schließt die Socketverbindung frühestens nach den angegebenen
          * Sekunden in timeout. Bis dahin sind noch weiterhin alle gültigen
-         * Operationen erlaubt.
+         * Operationen erlaubt. Der Zeitgeber läuft in EventLoop::Shared() und
+         * verfällt wenn der Socket vorher geschlossen oder zerstört wird.
+         * Zustandswechsel, bspw durch Connect, heben ihn nicht auf.
          *
          * \param[in]   timeout Der Zeitintervall bis zum schließen, angegeben
          *                      in Sekunden.
          */
-        virtual void Close(U32 timeout) throw(socket_error);
+        virtual void Close(U32 timeout) LU_THROWS(socket_error);
 
         /*!
          * Verbindet diesen Socket zu einen Remote-Endpunkt. Sobald die
          * Verbindung aufgebaut ist, können Lese- und Schreiboperationen
          * ausgeführt werden.
+         *
+         * Ein nicht blockierender Socket kehrt sofort zurück und gilt bereits
+         * als verbunden. Der Aufbau ist abgeschlossen sobald der Socket
+         * schreibbar ist, ein Fehler wird dann über SO_ERROR gemeldet.
          * 
-         * \param[in]   remoteEndPoint  Der IP-Endpunkt mit dem sich verbunden
+         * \param[in]   remoteEndPoint  Der Endpunkt mit dem sich verbunden
          *                              wird.
          */
-        virtual void Connect(Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, null_pointer);
+        virtual void Connect(Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, null_pointer);
 
         /*!
-         * Ruft Connect(Pointer<IPEndPoint>) auf.
-         * \sa Connect(Pointer<IPEndPoint>)
+         * Ruft Connect(Pointer<EndPoint>) auf.
+         * \sa Connect(Pointer<EndPoint>)
          */
-        virtual void Connect(Pointer<IPAddress> address, U16 port) throw(socket_error, null_pointer);
+        virtual void Connect(Pointer<IPAddress> address, U16 port) LU_THROWS(socket_error, null_pointer);
 
         /*!
          * Versucht eine Verbindung zu einem der angegebenen Endpunkte
@@ -100,13 +116,13 @@ namespace Lupus {
          * \param[in]   endPoints   Endpunkte mit denen sich Verbunden werden
          *                          soll.
          */
-        virtual void Connect(const Vector<Pointer<IPEndPoint>>& endPoints) throw(null_pointer);
+        virtual void Connect(const Vector<Pointer<IPEndPoint>>& endPoints) LU_THROWS(null_pointer);
 
         /*!
-         * Ruft Connect(Pointer<IPEndPoint>) auf.
-         * \sa Connect(Pointer<IPEndPoint>)
+         * Ruft Connect(Pointer<EndPoint>) auf.
+         * \sa Connect(Pointer<EndPoint>)
          */
-        virtual void Connect(const String& host, U16 port) throw(socket_error, std::invalid_argument);
+        virtual void Connect(const String& host, U16 port) LU_THROWS(socket_error, std::invalid_argument);
 
         /*!
          * Serialisiert den Socket und schließt in anschließend. Die
@@ -114,7 +130,38 @@ namespace Lupus {
          *
          * \returns Serialisierte Socketdaten.
          */
-        virtual SocketInformation DuplicateAndClose() throw(null_pointer, socket_error);
+        virtual SocketInformation DuplicateAndClose() LU_THROWS(null_pointer, socket_error);
+
+        /*!
+         * Übergibt den nativen Handle über einen verbundenen AF_UNIX Socket
+         * an einen anderen Prozess und schließt den Socket anschließend
+         * lokal. Im Gegensatz zu DuplicateAndClose() bleibt der Kernel-Socket
+         * erhalten, eine bestehende Verbindung samt ihrer Buffer wird also
+         * ohne erneuten Verbindungsaufbau übernommen.
+         *
+         * Die serialisierten Socketdaten werden als Metadaten mitgesendet.
+         * Der empfangende Prozess erhält den Socket mit ReceiveDuplicate.
+         *
+         * \warning Wird unter Windows nicht unterstützt.
+         *
+         * \param[in]   channel Verbundener AF_UNIX Socket zum Zielprozess.
+         *
+         * \returns Serialisierte Socketdaten.
+         */
+        virtual SocketInformation DuplicateAndClose(Pointer<Socket> channel) LU_THROWS(null_pointer, socket_error);
+
+        /*!
+         * Übergibt eine Kopie des nativen Handles wie
+         * DuplicateAndClose(Pointer<Socket>), schließt den Socket jedoch
+         * nicht. Beide Prozesse teilen sich danach denselben Kernel-Socket.
+         *
+         * \warning Wird unter Windows nicht unterstützt.
+         *
+         * \param[in]   channel Verbundener AF_UNIX Socket zum Zielprozess.
+         *
+         * \returns Serialisierte Socketdaten.
+         */
+        virtual SocketInformation Duplicate(Pointer<Socket> channel) LU_THROWS(null_pointer, socket_error);
 
         /*!
          * Nach dem sich der Socket an eine lokale Adresse gebunden hat, wartet
@@ -122,7 +169,7 @@ namespace Lupus {
          * 
          * \param[in]   backlog Die maximale Anzahl an Verbindungen im Queue.
          */
-        virtual void Listen(U32 backlog) throw(socket_error);
+        virtual void Listen(U32 backlog) LU_THROWS(socket_error);
 
         /*!
          * Überprüft im angegebenen Zeitintervall den Socket. Gültige Modi sind
@@ -138,7 +185,7 @@ namespace Lupus {
          *
          * \returns Das Resultat der Operation.
          */
-        virtual SocketPollFlags Poll(U32 milliSeconds, SocketPollFlags mode) throw(socket_error);
+        virtual SocketPollFlags Poll(U32 milliSeconds, SocketPollFlags mode) LU_THROWS(socket_error);
 
         /*!
          * Ruft Receive(buffer, 0, buffer.size(), SocketFlags::None, error) 
@@ -146,7 +193,7 @@ namespace Lupus {
          *
          * \sa Receive(Vector<Byte>&, U32, U32, SocketFlags, SocketError&)
          */
-        virtual S32 Receive(Vector<Byte>& buffer) throw(socket_error);
+        virtual S32 Receive(Vector<Byte>& buffer) LU_THROWS(socket_error);
 
         /*!
          * Ruft Receive(buffer, offset, buffer.size(), SocketFlags::None, 
@@ -154,21 +201,21 @@ namespace Lupus {
          *
          * \sa Receive(Vector<Byte>&, U32, U32, SocketFlags, SocketError&)
          */
-        virtual S32 Receive(Vector<Byte>& buffer, U32 offset) throw(socket_error, std::out_of_range);
+        virtual S32 Receive(Vector<Byte>& buffer, U32 offset) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Ruft Receive(buffer, offset, size, SocketFlags::None, error) auf.
          *
          * \sa Receive(Vector<Byte>&, U32, U32, SocketFlags, SocketError&)
          */
-        virtual S32 Receive(Vector<Byte>& buffer, U32 offset, U32 size) throw(socket_error, std::out_of_range);
+        virtual S32 Receive(Vector<Byte>& buffer, U32 offset, U32 size) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Ruft Receive(buffer, offset, size, socketFlats, error) auf.
          *
          * \sa Receive(Vector<Byte>&, U32, U32, SocketFlags, SocketError&)
          */
-        virtual S32 Receive(Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags) throw(socket_error, std::out_of_range);
+        virtual S32 Receive(Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Liest Daten aus dem Empfangs-Buffer. Diese Methode ist blockiert
@@ -193,31 +240,31 @@ namespace Lupus {
          *          geschlossen wurde dann Null. Oder einen Fehlercode, wenn
          *          ein Fehler aufgetreten ist.
          */
-        virtual S32 Receive(Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) throw(socket_error, std::out_of_range);
+        virtual S32 Receive(Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Ruft ReceiveFrom(buffer, 0, buffer.size(), SocketFlags::None, 
          * remoteEndPoint) auf.
          *
-         * \sa ReceiveFrom(Vector<Byte>&, U32, U32, SocketFlags, Pointer<IPEndPoint>&)
+         * \sa ReceiveFrom(Vector<Byte>&, U32, U32, SocketFlags, Pointer<EndPoint>&)
          */
-        virtual S32 ReceiveFrom(Vector<Byte>& buffer, Pointer<IPEndPoint>& remoteEndPoint) throw(socket_error);
+        virtual S32 ReceiveFrom(Vector<Byte>& buffer, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error);
 
         /*!
          * Ruft ReceiveFrom(buffer, 0, size, SocketFlags::None, remoteEndPoint)
          * auf.
          *
-         * \sa ReceiveFrom(Vector<Byte>&, U32, U32, SocketFlags, Pointer<IPEndPoint>&)
+         * \sa ReceiveFrom(Vector<Byte>&, U32, U32, SocketFlags, Pointer<EndPoint>&)
          */
-        virtual S32 ReceiveFrom(Vector<Byte>& buffer, U32 offset, Pointer<IPEndPoint>& remoteEndPoint) throw(socket_error, std::out_of_range);
+        virtual S32 ReceiveFrom(Vector<Byte>& buffer, U32 offset, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Ruft ReceiveFrom(buffer, 0, size, SocketFlags::None, remoteEndPoint)
          * auf.
          *
-         * \sa ReceiveFrom(Vector<Byte>&, U32, U32, SocketFlags, Pointer<IPEndPoint>&)
+         * \sa ReceiveFrom(Vector<Byte>&, U32, U32, SocketFlags, Pointer<EndPoint>&)
          */
-        virtual S32 ReceiveFrom(Vector<Byte>& buffer, U32 offset, U32 size, Pointer<IPEndPoint>& remoteEndPoint) throw(socket_error, std::out_of_range);
+        virtual S32 ReceiveFrom(Vector<Byte>& buffer, U32 offset, U32 size, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Liest eingehende Daten aus. Diese Daten können von einen belieben
@@ -238,20 +285,88 @@ namespace Lupus {
          * \param[in]       offset          Der offset für den Vektor.
          * \param[in]       size            Die zu lesende Größe.
          * \param[in]       socktFlags      Die zu vewendenden Flags.
-         * \param[out]      remoteEndPoint  Der sendende Endpunkt.
+         * \param[out]      remoteEndPoint  Der sendende Endpunkt. Ein
+         *                                  Nullzeiger falls der Sender ein
+         *                                  unbenannter AF_UNIX Socket ist.
          *
          * \returns Die Anzahl der erhaltenen Bytes. Falls die Verbindung
          *          geschlossen wurde dann Null. Oder einen Fehlercode, wenn
          *          ein Fehler aufgetreten ist.
          */
-        virtual S32 ReceiveFrom(Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint>& remoteEndPoint) throw(socket_error, std::out_of_range);
+        virtual S32 ReceiveFrom(Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error, std::out_of_range);
+
+        /*!
+         * Ruft Receive(buffer, SocketFlags::None, error) auf.
+         *
+         * \sa Receive(PooledBuffer&, SocketFlags, SocketError&)
+         */
+        virtual S32 Receive(PooledBuffer& buffer) LU_THROWS(socket_error);
+
+        /*!
+         * Liest Daten in einen Buffer aus einem BufferPool, wodurch für den
+         * Empfang kein Speicher angefordert werden muss. Ist der Verweis
+         * leer oder wird der Buffer noch mit anderen geteilt, dann wird ein
+         * neuer Buffer aus BufferPool::Shared() geliehen. Stream-Sockets
+         * erhalten dabei einen Buffer mit BufferPool::MediumSize, alle
+         * anderen einen mit BufferPool::LargeSize damit kein Datagramm
+         * abgeschnitten wird.
+         *
+         * Es wird höchstens Capacity() gelesen, Size() des Buffers enthält
+         * danach die Anzahl der erhaltenen Bytes.
+         *
+         * \param[in,out]   buffer      Der Buffer für die Daten.
+         * \param[in]       socketFlags Die zu verwendenden Flags.
+         * \param[out]      errorCode   Fehlercode im Fehlerfall.
+         *
+         * \returns Die Anzahl der erhaltenen Bytes. Falls die Verbindung
+         *          geschlossen wurde dann Null. Oder einen Fehlercode, wenn
+         *          ein Fehler aufgetreten ist.
+         */
+        virtual S32 Receive(PooledBuffer& buffer, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error);
+
+        /*!
+         * Liest ein Datagramm in einen Buffer aus einem BufferPool.
+         *
+         * \sa Receive(PooledBuffer&, SocketFlags, SocketError&)
+         * \sa ReceiveFrom(Vector<Byte>&, U32, U32, SocketFlags, Pointer<EndPoint>&)
+         */
+        virtual S32 ReceiveFrom(PooledBuffer& buffer, Pointer<EndPoint>& remoteEndPoint) LU_THROWS(socket_error);
+
+        /*!
+         * Ruft Receive(buffer, SocketFlags::None, error) auf.
+         *
+         * \sa Receive(BufferChain&, SocketFlags, SocketError&)
+         */
+        virtual S32 Receive(BufferChain& buffer) LU_THROWS(socket_error);
+
+        /*!
+         * Liest Daten in einen neuen Buffer aus BufferPool::Shared() und
+         * hängt diesen an die Kette an. Die Kette kann danach ohne Kopie
+         * zerlegt und weitergesendet werden.
+         *
+         * \sa Receive(PooledBuffer&, SocketFlags, SocketError&)
+         */
+        virtual S32 Receive(BufferChain& buffer, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error);
+
+        /*!
+         * Liest Daten direkt in einen vom Aufrufer verwalteten Speicher,
+         * bspw einen Block aus einem BuddyAllocator.
+         *
+         * \param[out]  buffer  Zeiger auf den Speicher.
+         * \param[in]   size    Die maximal zu lesende Größe.
+         *
+         * \returns Die Anzahl der erhaltenen Bytes. Falls die Verbindung
+         *          geschlossen wurde dann Null. Oder einen Fehlercode, wenn
+         *          ein Fehler aufgetreten ist.
+         */
+        virtual S32 Receive(Byte* buffer, U32 size) LU_THROWS(socket_error);
 
         /*!
          * Ruft Send(buffer, 0, buffer.size(), SocketFlags::None, error) auf.
          *
          * \sa Send(const Vector<Byte>&, U32, U32, SocketFlags, SocketError&)
          */
-        virtual S32 Send(const Vector<Byte>& buffer) throw(socket_error);
+        virtual S32 Send(const Vector<Byte>& buffer) LU_THROWS(socket_error);
 
         /*!
          * Ruft Send(buffer, offset, buffer.size(), SocketFlags::None, error) 
@@ -259,21 +374,21 @@ namespace Lupus {
          *
          * \sa Send(const Vector<Byte>&, U32, U32, SocketFlags, SocketError&)
          */
-        virtual S32 Send(const Vector<Byte>& buffer, U32 offset) throw(socket_error, std::out_of_range);
+        virtual S32 Send(const Vector<Byte>& buffer, U32 offset) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Ruft Send(buffer, offset, size, SocketFlags::None, error) auf.
          *
          * \sa Send(const Vector<Byte>&, U32, U32, SocketFlags, SocketError&)
          */
-        virtual S32 Send(const Vector<Byte>& buffer, U32 offset, U32 size) throw(socket_error, std::out_of_range);
+        virtual S32 Send(const Vector<Byte>& buffer, U32 offset, U32 size) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Ruft Send(buffer, offset, size, socketFlags, error) auf.
          *
          * \sa Send(const Vector<Byte>&, U32, U32, SocketFlags, SocketError&)
          */
-        virtual S32 Send(const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags) throw(socket_error, std::out_of_range);
+        virtual S32 Send(const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Schreibt Daten zu den verbundenen Endpunkt. Wenn der Socket
@@ -291,31 +406,66 @@ namespace Lupus {
          *          geschlossen wurde dann Null. Oder einen Fehlercode, wenn
          *          ein Fehler aufgetreten ist.
          */
-        virtual S32 Send(const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) throw(socket_error, std::out_of_range);
+        virtual S32 Send(const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error, std::out_of_range);
+
+        /*!
+         * Ruft Send(buffer, SocketFlags::None, error) auf.
+         *
+         * \sa Send(const BufferChain&, SocketFlags, SocketError&)
+         */
+        virtual S32 Send(const BufferChain& buffer) LU_THROWS(socket_error);
+
+        /*!
+         * Sendet die Ausschnitte der Kette mit einem einzigen Scatter/Gather
+         * Aufruf, ohne sie vorher zusammenzufassen. Pro Aufruf werden
+         * höchstens die ersten MaxSegments Ausschnitte berücksichtigt. Wie
+         * bei den anderen Send Methoden können weniger Bytes gesendet werden
+         * als angefordert, der gesendete Teil wird mit BufferChain::Consume
+         * entfernt und der Rest mit einem weiteren Aufruf gesendet.
+         *
+         * \param[in]   buffer      Die zu sendende Kette.
+         * \param[in]   socketFlags Die zu verwendenden Flags.
+         * \param[out]  errorCode   Fehlercode im Fehlerfall.
+         *
+         * \returns Die Anzahl der gesendeten Bytes oder einen Fehlercode,
+         *          wenn ein Fehler aufgetreten ist.
+         */
+        virtual S32 Send(const BufferChain& buffer, SocketFlags socketFlags, SocketError& errorCode) LU_THROWS(socket_error);
+
+        /*!
+         * Sendet Daten aus einem vom Aufrufer verwalteten Speicher.
+         *
+         * \param[in]   buffer  Zeiger auf die Daten.
+         * \param[in]   size    Die zu sendende Größe.
+         *
+         * \returns Die Anzahl der gesendeten Bytes oder einen Fehlercode,
+         *          wenn ein Fehler aufgetreten ist.
+         */
+        virtual S32 Send(const Byte* buffer, U32 size) LU_THROWS(socket_error);
 
         /*!
          * Ruft SendTo(buffer, 0, buffer.size(), SocketFlags::None,
          * remoteEndPoint) auf.
          *
-         * \sa SendTo(const Vector<Byte>&, U32, U32, SocketFlags, Pointer<IPEndPoint>)
+         * \sa SendTo(const Vector<Byte>&, U32, U32, SocketFlags, Pointer<EndPoint>)
          */
-        virtual S32 SendTo(const Vector<Byte>& buffer, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error);
+        virtual S32 SendTo(const Vector<Byte>& buffer, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error);
 
         /*!
          * Ruft SendTo(buffer, offset, buffer.size(), SocketFlags::None,
          * remoteEndPoint) auf.
          *
-         * \sa SendTo(const Vector<Byte>&, U32, U32, SocketFlags, Pointer<IPEndPoint>)
+         * \sa SendTo(const Vector<Byte>&, U32, U32, SocketFlags, Pointer<EndPoint>)
          */
-        virtual S32 SendTo(const Vector<Byte>& buffer, U32 offset, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, std::out_of_range);
+        virtual S32 SendTo(const Vector<Byte>& buffer, U32 offset, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Ruft SendTo(buffer, offset, size, SocketFlags::None remoteEndPoint)
          * auf.
          *
-         * \sa SendTo(const Vector<Byte>&, U32, U32, SocketFlags, Pointer<IPEndPoint>)
+         * \sa SendTo(const Vector<Byte>&, U32, U32, SocketFlags, Pointer<EndPoint>)
          */
-        virtual S32 SendTo(const Vector<Byte>& buffer, U32 offset, U32 size, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, std::out_of_range);
+        virtual S32 SendTo(const Vector<Byte>& buffer, U32 offset, U32 size, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Sendet Daten an einen gewissen Endpunkt. Falls die Daten nicht
@@ -333,7 +483,7 @@ namespace Lupus {
          *          geschlossen wurde dann Null. Oder einen Fehlercode, wenn
          *          ein Fehler aufgetreten ist.
          */
-        virtual S32 SendTo(const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint> remoteEndPoint) throw(socket_error, std::out_of_range);
+        virtual S32 SendTo(const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint) LU_THROWS(socket_error, std::out_of_range);
 
         /*!
          * Schließt die Verbindung nicht komplett, sondern lediglich den
@@ -342,7 +492,7 @@ namespace Lupus {
          *
          * \param[in]   how Teil der beendet wird.
          */
-        virtual void Shutdown(SocketShutdown how) throw(socket_error);
+        virtual void Shutdown(SocketShutdown how) LU_THROWS(socket_error);
 
         /*!
          * \returns Den nativen Socket-Handle
@@ -369,22 +519,31 @@ namespace Lupus {
          * \returns TRUE wenn der Socket auf Verbindungen wartet, ansonsten
          *          FALSE.
          */
-        virtual bool IsListening() const throw(socket_error);
+        virtual bool IsListening() const LU_THROWS(socket_error);
 
         /*!
+         * Der Wert wird beim Erstellen des Sockets zwischengespeichert und
+         * benötigt keinen Systemaufruf.
+         *
          * \returns Die Domäne des Sockets.
          */
-        virtual AddressFamily Family() const throw(socket_error);
+        virtual AddressFamily Family() const NOEXCEPT;
 
         /*!
+         * Der Wert wird beim Erstellen des Sockets zwischengespeichert und
+         * benötigt keinen Systemaufruf.
+         *
          * \returns Das Protokoll des Sockets.
          */
-        virtual ProtocolType Protocol() const throw(socket_error);
+        virtual ProtocolType Protocol() const NOEXCEPT;
 
         /*!
+         * Der Wert wird beim Erstellen des Sockets zwischengespeichert und
+         * benötigt keinen Systemaufruf.
+         *
          * \returns Den Typ des Sockets.
          */
-        virtual SocketType Type() const throw(socket_error);
+        virtual SocketType Type() const NOEXCEPT;
 
         /*!
          * Überprüft ob es Daten zum lesen gibt und retouniert die Anzahl an
@@ -392,7 +551,7 @@ namespace Lupus {
          *
          * \returns Die Byteanzahl zum lesen.
          */
-        virtual U32 Available() const throw(socket_error);
+        virtual U32 Available() const LU_THROWS(socket_error);
 
         /*!
          * Überprüft ob der Socket auf Anfragen wartet. Standardwert ist TRUE.
@@ -405,41 +564,41 @@ namespace Lupus {
          * Entscheidet ob der Socket blockt oder nicht. TRUE wenn der Socket
          * blocken soll, ansonsten FALSE. Standardwert ist TRUE.
          */
-        virtual void Blocking(bool) throw(socket_error);
+        virtual void Blocking(bool) LU_THROWS(socket_error);
 
         /*!
          * Retouniert den lokalen Endpunkt an den der Socket gebunden ist, oder
          * einen Nullzeiger wenn der Socket keine spezifische lokale Verbindung
          * besitzt.
          */
-        virtual Pointer<IPEndPoint> LocalEndPoint() const NOEXCEPT;
+        virtual Pointer<EndPoint> LocalEndPoint() const NOEXCEPT;
 
         /*!
          * Retouniert den Remote-Endpunkt mit dem der Socket verbunden ist,
          * oder einen Nullzeiger wenn der Socket keine Remote-Verbindung
          * besitzt.
          */
-        virtual Pointer<IPEndPoint> RemoteEndPoint() const NOEXCEPT;
+        virtual Pointer<EndPoint> RemoteEndPoint() const NOEXCEPT;
 
         /*!
          * \returns Die Größe des Schreib-Buffers.
          */
-        virtual S32 SendBuffer() const throw(socket_error);
+        virtual S32 SendBuffer() const LU_THROWS(socket_error);
 
         /*!
          * Setzt die Größe des Schreib-Buffers.
          */
-        virtual void SendBuffer(S32) throw(socket_error);
+        virtual void SendBuffer(S32) LU_THROWS(socket_error);
 
         /*!
          * \returns Die Größe des Lese-Buffers.
          */
-        virtual S32 ReceiveBuffer() const throw(socket_error);
+        virtual S32 ReceiveBuffer() const LU_THROWS(socket_error);
 
         /*!
          * Setzt die Größe des Lese-Buffers.
          */
-        virtual void ReceiveBuffer(S32) throw(socket_error);
+        virtual void ReceiveBuffer(S32) LU_THROWS(socket_error);
 
         /*!
          * Retouniert den Timeout für das blocken von Schreibbefehlen.
@@ -447,9 +606,11 @@ namespace Lupus {
         virtual S32 SendTimeout() const NOEXCEPT;
 
         /*!
-         * Setzt den Timeout für das blocken von Schreibbefehlen.
+         * Setzt den Timeout für das blocken von Schreibbefehlen. Wirkt nur auf
+         * blockierende Sockets, für nicht blockierende Sockets siehe
+         * EventLoop::Deadline.
          */
-        virtual void SendTimeout(S32) throw(socket_error);
+        virtual void SendTimeout(S32) LU_THROWS(socket_error);
 
         /*!
          * Retouniert den Timeout für das blocken von Lesebefehlen.
@@ -457,29 +618,69 @@ namespace Lupus {
         virtual S32 ReceiveTimeout() const NOEXCEPT;
 
         /*!
-         * Setzt den Timeout für das blocken von Lesebefehlen.
+         * Setzt den Timeout für das blocken von Lesebefehlen. Wirkt nur auf
+         * blockierende Sockets, für nicht blockierende Sockets siehe
+         * EventLoop::Deadline.
          */
-        virtual void ReceiveTimeout(S32) throw(socket_error);
+        virtual void ReceiveTimeout(S32) LU_THROWS(socket_error);
 
         /*!
          * \warning Noch nicht implementiert.
          */
-        static void Select(const Vector<Pointer<Socket>>& checkRead, const Vector<Pointer<Socket>>& checkWrite, const Vector<Pointer<Socket>>& checkError, U32 microSeconds) throw(socket_error);
+        static void Select(const Vector<Pointer<Socket>>& checkRead, const Vector<Pointer<Socket>>& checkWrite, const Vector<Pointer<Socket>>& checkError, U32 microSeconds) LU_THROWS(socket_error);
+
+        /*!
+         * Erstellt ein Paar miteinander verbundener AF_UNIX Sockets ohne
+         * Namen. Die Sockets eignen sich bspw für die Kommunikation mit
+         * einem Kindprozess oder als Kanal für DuplicateAndClose.
+         *
+         * \warning Unter Windows wird nur SocketType::Stream unterstützt und
+         *          das Paar besteht aus zwei IPv4 Loopback-Sockets.
+         *
+         * \param[in]   type    SocketType::Stream, SocketType::Datagram oder
+         *                      SocketType::SeqPacket.
+         * \param[out]  first   Das eine Ende der Verbindung.
+         * \param[out]  second  Das andere Ende der Verbindung.
+         */
+        static void CreatePair(SocketType type, Pointer<Socket>& first, Pointer<Socket>& second) LU_THROWS(socket_error);
+
+        /*!
+         * Empfängt einen Socket der mit DuplicateAndClose(Pointer<Socket>)
+         * übergeben wurde. Diese Methode blockiert bis ein Socket eintrifft.
+         * Der Zustand (verbunden, gebunden oder wartend) wird vom
+         * übergebenen Socket übernommen.
+         *
+         * \warning Wird unter Windows nicht unterstützt.
+         *
+         * \param[in]   channel Verbundener AF_UNIX Socket zum Quellprozess.
+         *
+         * \returns Zeiger auf den übernommenen Socket.
+         */
+        static Pointer<Socket> ReceiveDuplicate(Pointer<Socket> channel) LU_THROWS(null_pointer, socket_error);
 
     private:
 
         Socket() = default;
 
+        void PrepareBuffer(PooledBuffer& buffer) const LU_THROWS(std::bad_alloc);
+
+        // Häufig gelesene Werte liegen zusammen am Anfang des Objekts. Domäne,
+        // Typ und Protokoll werden bei der Erstellung bzw beim Akzeptieren
+        // einmalig ermittelt und ändern sich danach nicht mehr.
         SocketHandle mHandle = INVALID_SOCKET;
-        S32 mSendTime = 0; // Windows support
-        S32 mRecvTime = 0; // Windows support
+        U16 mFamily = 0;
+        U16 mType = 0;
+        U16 mProtocol = 0;
         bool mBlocking = true;
-        Pointer<IPEndPoint> mLocal;
-        Pointer<IPEndPoint> mRemote;
         bool mBound = false;
         bool mConnected = false;
+        S32 mSendTime = 0; // Windows support
+        S32 mRecvTime = 0; // Windows support
+        Pointer<EndPoint> mLocal;
+        Pointer<EndPoint> mRemote;
 
         Pointer<Internal::SocketState> mState;
+        Pointer<Internal::DelayedClose> mDelayedClose;
 
         friend Internal::SocketState;
     };
@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include <Lupus/ByteWriter.h>
+#include <Lupus/Network/Enum.h>
+
+namespace Lupus {
+    class NetworkStream;
+
+    /*!
+     * ByteWriter der direkt in den Schreib-Buffer eines NetworkStream
+     * schreibt. Ist der Buffer voll, dann wird er gesendet und weiter
+     * beschrieben, eine Nachricht darf daher größer als der Buffer sein.
+     *
+     * Die geschriebenen Bytes werden erst mit Commit bzw im Destruktor in
+     * den Stream übernommen. Bis dahin darf nicht anderweitig in den
+     * Stream geschrieben werden.
+     */
+    class LUPUS_API StreamWriter : public ByteWriter
+    {
+    public:
+
+        /*!
+         * Erstellt einen Writer über den Schreib-Buffer des Streams.
+         *
+         * \param[in]   stream  Der zu beschreibende Stream.
+         */
+        StreamWriter(Pointer<NetworkStream> stream) LU_THROWS(null_pointer);
+        virtual ~StreamWriter();
+
+        /*!
+         * \returns Den zugrunde liegenden Stream.
+         */
+        virtual Pointer<NetworkStream> Stream() const NOEXCEPT;
+
+        /*!
+         * Übernimmt die bisher geschriebenen Bytes in den Stream. Danach
+         * kann der Stream wieder direkt verwendet werden.
+         */
+        virtual void Commit() NOEXCEPT;
+
+    protected:
+
+        virtual bool Next(U32 size) LU_THROWS(socket_error) override;
+
+    private:
+
+        Pointer<NetworkStream> mStream;
+    };
+
+    typedef Pointer<StreamWriter> StreamWriterPtr;
+}
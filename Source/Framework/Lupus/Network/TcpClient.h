@@ -8,40 +8,201 @@ namespace Lupus {
     class IPEndPoint;
     class Socket;
 
-    class TcpClient : public ReferenceType
+    /*!
+     * Einfacher TCP-Client der einen Stream-Socket verwaltet. Socketoptionen
+     * werden beim ersten Lesen bzw beim Setzen zwischengespeichert, damit
+     * nicht jeder Aufruf eines Getters einen Systemaufruf auslöst.
+     */
+    class LUPUS_API TcpClient : public ReferenceType
     {
     public:
 
-        TcpClient() NOEXCEPT;
-        TcpClient(AddressFamily family) throw(std::invalid_argument);
-        TcpClient(Pointer<IPEndPoint> endPoint) throw(null_pointer);
-        TcpClient(const String& hostname, U16 port) throw(socket_error);
+        /*!
+         * Erstellt einen IPv4 TCP-Client.
+         */
+        TcpClient() LU_THROWS(socket_error);
 
+        /*!
+         * Erstellt einen TCP-Client für die angegebene Adressfamilie.
+         *
+         * \param[in]   family  Entweder InterNetwork oder InterNetworkV6.
+         */
+        TcpClient(AddressFamily family) LU_THROWS(std::invalid_argument, socket_error);
+
+        /*!
+         * Erstellt einen TCP-Client und bindet ihn an den angegebenen lokalen
+         * Endpunkt.
+         *
+         * \param[in]   localEndPoint   Der lokale Endpunkt.
+         */
+        TcpClient(Pointer<IPEndPoint> localEndPoint) LU_THROWS(null_pointer, socket_error);
+
+        /*!
+         * Erstellt einen TCP-Client und verbindet ihn mit dem angegebenen
+         * Host.
+         *
+         * \param[in]   hostname    IP-Adresse des Hosts.
+         * \param[in]   port        Die Portnummer.
+         */
+        TcpClient(const String& hostname, U16 port) LU_THROWS(socket_error, std::invalid_argument);
+        virtual ~TcpClient();
+
+        /*!
+         * \returns TRUE wenn eine aktive Verbindung besteht.
+         */
         virtual bool Active() const NOEXCEPT;
+
+        /*!
+         * Setzt ob eine aktive Verbindung besteht.
+         */
         virtual void Active(bool) NOEXCEPT;
-        virtual U32 Available() const throw(socket_error);
+
+        /*!
+         * \returns Die Anzahl der Bytes die ohne zu blockieren gelesen werden
+         *          können, inklusive der Bytes im Lese-Buffer des Streams.
+         */
+        virtual U32 Available() const LU_THROWS(socket_error);
+
+        /*!
+         * \returns Den zugrunde liegenden Socket.
+         */
         virtual Pointer<Socket> Client() const NOEXCEPT;
-        virtual void Client(Pointer<Socket>) throw(null_pointer);
+
+        /*!
+         * Setzt den zugrunde liegenden Socket. Zwischengespeicherte
+         * Socketoptionen und ein vorhandener Stream werden verworfen.
+         */
+        virtual void Client(Pointer<Socket>) LU_THROWS(null_pointer);
+
+        /*!
+         * \returns TRUE wenn der Socket verbunden ist, ansonsten FALSE.
+         */
         virtual bool IsConnected() const NOEXCEPT;
-        virtual bool ExclusiveAddressUse() const throw(socket_error);
-        virtual void ExclusiveAddressUse() throw(socket_error);
-        virtual bool NoDelay() const NOEXCEPT;
-        virtual void NoDelay(bool) NOEXCEPT;
-        virtual S32 SendBuffer() const throw(socket_error);
-        virtual void SendBuffer(S32) throw(socket_error);
-        virtual S32 ReceiveBuffer() const throw(socket_error);
-        virtual void ReceiveBuffer(S32) throw(socket_error);
+
+        /*!
+         * \returns TRUE wenn nur dieser Socket an die Adresse gebunden werden
+         *          darf.
+         */
+        virtual bool ExclusiveAddressUse() const LU_THROWS(socket_error);
+
+        /*!
+         * Setzt ob nur dieser Socket an die Adresse gebunden werden darf.
+         *
+         * Unter Windows entspricht das SO_EXCLUSIVEADDRUSE. Andere Systeme
+         * kennen diese Option nicht, dort binden Sockets ohne SO_REUSEADDR
+         * bereits exklusiv. FALSE setzt daher SO_REUSEADDR, TRUE löscht es.
+         * SO_REUSEPORT bleibt unberührt, da es fremden Prozessen erlauben
+         * würde denselben Port zu binden.
+         */
+        virtual void ExclusiveAddressUse(bool) LU_THROWS(socket_error);
+
+        /*!
+         * \returns TRUE wenn der Nagle-Algorithmus deaktiviert ist.
+         */
+        virtual bool NoDelay() const LU_THROWS(socket_error);
+
+        /*!
+         * Deaktiviert bzw aktiviert den Nagle-Algorithmus. Da der Stream
+         * Schreiboperationen selbst zusammenfasst, ist das Deaktivieren in
+         * der Regel unbedenklich.
+         */
+        virtual void NoDelay(bool) LU_THROWS(socket_error);
+
+        /*!
+         * \returns Die Größe des Schreib-Buffers des Sockets.
+         */
+        virtual S32 SendBuffer() const LU_THROWS(socket_error);
+
+        /*!
+         * Setzt die Größe des Schreib-Buffers des Sockets. Der tatsächlich
+         * vom System verwendete Wert wird danach einmalig gelesen.
+         */
+        virtual void SendBuffer(S32) LU_THROWS(socket_error);
+
+        /*!
+         * \returns Die Größe des Lese-Buffers des Sockets.
+         */
+        virtual S32 ReceiveBuffer() const LU_THROWS(socket_error);
+
+        /*!
+         * Setzt die Größe des Lese-Buffers des Sockets. Der tatsächlich vom
+         * System verwendete Wert wird danach einmalig gelesen.
+         */
+        virtual void ReceiveBuffer(S32) LU_THROWS(socket_error);
+
+        /*!
+         * \returns Den Timeout für das blocken von Schreibbefehlen.
+         */
         virtual S32 SendTimeout() const NOEXCEPT;
-        virtual void SendTimeout(S32) throw(socket_error);
+
+        /*!
+         * Setzt den Timeout für das blocken von Schreibbefehlen.
+         */
+        virtual void SendTimeout(S32) LU_THROWS(socket_error);
+
+        /*!
+         * \returns Den Timeout für das blocken von Lesebefehlen.
+         */
         virtual S32 ReceiveTimeout() const NOEXCEPT;
-        virtual void ReceiveTimeout(S32) throw(socket_error);
 
-        virtual void Close() throw(socket_error);
-        virtual void Connect(Pointer<IPEndPoint>) throw(null_pointer, socket_error);
-        virtual void Connect(Pointer<IPAddress>, U16 port) throw(null_pointer, socket_error);
-        virtual void Connect(const Vector<Pointer<IPEndPoint>>& endPoints) throw(null_pointer);
-        virtual void Connect(const String& host, U16 port) throw(socket_error, std::invalid_argument);
+        /*!
+         * Setzt den Timeout für das blocken von Lesebefehlen.
+         */
+        virtual void ReceiveTimeout(S32) LU_THROWS(socket_error);
+
+        /*!
+         * Sendet ausstehende Daten des Streams und schließt die Verbindung.
+         */
+        virtual void Close() LU_THROWS(socket_error);
+
+        /*!
+         * Verbindet den Client mit dem angegebenen Endpunkt.
+         *
+         * \param[in]   remoteEndPoint  Der Remote-Endpunkt.
+         */
+        virtual void Connect(Pointer<IPEndPoint> remoteEndPoint) LU_THROWS(null_pointer, socket_error);
+
+        /*!
+         * Ruft Connect(Pointer<IPEndPoint>) auf.
+         * \sa Connect(Pointer<IPEndPoint>)
+         */
+        virtual void Connect(Pointer<IPAddress> address, U16 port) LU_THROWS(null_pointer, socket_error);
 
-        virtual Pointer<NetworkStream> GetStream() const NOEXCEPT;
+        /*!
+         * Verbindet den Client mit dem ersten erreichbaren Endpunkt.
+         *
+         * \sa Socket::Connect(const Vector<Pointer<IPEndPoint>>&)
+         */
+        virtual void Connect(const Vector<Pointer<IPEndPoint>>& endPoints) LU_THROWS(null_pointer, socket_error);
+
+        /*!
+         * Ruft Connect(Pointer<IPEndPoint>) auf.
+         * \sa Connect(Pointer<IPEndPoint>)
+         */
+        virtual void Connect(const String& host, U16 port) LU_THROWS(socket_error, std::invalid_argument);
+
+        /*!
+         * Retouniert den gepufferten Datenstrom der Verbindung. Der Stream
+         * wird beim ersten Aufruf erstellt.
+         *
+         * \returns Zeiger auf den Datenstrom.
+         */
+        virtual Pointer<NetworkStream> GetStream() LU_THROWS(socket_error);
+
+    private:
+
+        void ResetOptionCache() NOEXCEPT;
+
+        Pointer<Socket> mClient;
+        Pointer<NetworkStream> mStream;
+        bool mActive = false;
+
+        // Zwischengespeicherte Socketoptionen. -1 bedeutet unbekannt.
+        mutable S32 mSendBuffer = -1;
+        mutable S32 mReceiveBuffer = -1;
+        mutable S8 mNoDelay = -1;
+        mutable S8 mExclusiveAddressUse = -1;
     };
+
+    typedef Pointer<TcpClient> TcpClientPtr;
 }
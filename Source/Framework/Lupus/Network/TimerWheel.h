@@ -0,0 +1,154 @@
+﻿#pragma once
+
+#include <Lupus/Network/Enum.h>
+
+namespace Lupus {
+    class TimerWheel;
+
+    /*!
+     * Ein Zeitgeber der in einem TimerWheel registriert werden kann. Der
+     * Zeitgeber gehört dem Aufrufer und kann beliebig oft neu gestartet
+     * werden, ohne dass dabei Speicher angefordert wird. Wird er zerstört
+     * während er läuft, dann wird er automatisch aus dem Rad entfernt.
+     */
+    class LUPUS_API Timer : public ReferenceType
+    {
+    public:
+
+        /*!
+         * Erstellt einen Zeitgeber ohne Callback.
+         */
+        Timer() = default;
+
+        /*!
+         * Erstellt einen Zeitgeber mit dem angegebenen Callback.
+         *
+         * \param[in]   callback    Wird beim Ablaufen aufgerufen.
+         */
+        explicit Timer(Function<void()> callback) NOEXCEPT;
+        virtual ~Timer();
+
+        /*!
+         * Setzt den Callback der beim Ablaufen aufgerufen wird.
+         */
+        virtual void Callback(Function<void()> callback) NOEXCEPT;
+
+        /*!
+         * \returns TRUE wenn der Zeitgeber in einem Rad läuft.
+         */
+        virtual bool IsPending() const NOEXCEPT;
+
+        /*!
+         * \returns Den Tick an dem der Zeitgeber abläuft.
+         */
+        virtual U64 Expires() const NOEXCEPT;
+
+    private:
+
+        friend class TimerWheel;
+
+        Function<void()> mCallback;
+        TimerWheel* mWheel = nullptr;
+        Timer** mSlot = nullptr;
+        Timer* mPrevious = nullptr;
+        Timer* mNext = nullptr;
+        U64 mExpires = 0;
+        bool mOwned = false;
+    };
+
+    /*!
+     * Hierarchisches Zeitgeberrad mit vier Ebenen zu je 256 Feldern. Ein
+     * Tick entspricht der vom Aufrufer gewählten Zeiteinheit, bei einer
+     * Millisekunde deckt das Rad knapp 50 Tage ab. Starten und Stoppen
+     * eines Zeitgebers benötigt konstante Zeit, beim Weiterdrehen werden
+     * nur die Felder angefasst die tatsächlich fällig sind.
+     *
+     * Das Rad ist nicht threadsicher und gehört normalerweise einem
+     * EventLoop.
+     */
+    class LUPUS_API TimerWheel : public ReferenceType
+    {
+    public:
+
+        //! Anzahl der Felder pro Ebene.
+        static const U32 SlotCount = 256;
+
+        //! Anzahl der Ebenen.
+        static const U32 LevelCount = 4;
+
+        /*!
+         * Erstellt ein leeres Rad das bei Tick Null beginnt.
+         */
+        TimerWheel() NOEXCEPT;
+
+        /*!
+         * Entfernt alle laufenden Zeitgeber ohne sie aufzurufen.
+         */
+        virtual ~TimerWheel();
+
+        /*!
+         * \returns Den zuletzt verarbeiteten Tick.
+         */
+        virtual U64 Now() const NOEXCEPT;
+
+        /*!
+         * \returns Die Anzahl der laufenden Zeitgeber.
+         */
+        virtual U32 Count() const NOEXCEPT;
+
+        /*!
+         * Startet den Zeitgeber. Läuft er bereits, dann wird er neu
+         * gestartet.
+         *
+         * \param[in]   timer   Der zu startende Zeitgeber.
+         * \param[in]   delay   Die Anzahl der Ticks bis zum Ablaufen,
+         *                      mindestens jedoch ein Tick.
+         */
+        virtual void Start(Timer& timer, U64 delay) NOEXCEPT;
+
+        /*!
+         * Stoppt den Zeitgeber falls er in diesem Rad läuft.
+         */
+        virtual void Stop(Timer& timer) NOEXCEPT;
+
+        /*!
+         * Startet einen einmaligen Zeitgeber der dem Rad gehört und nach
+         * dem Ablaufen freigegeben wird.
+         *
+         * \param[in]   delay       Die Anzahl der Ticks bis zum Ablaufen.
+         * \param[in]   callback    Wird beim Ablaufen aufgerufen.
+         */
+        virtual void Schedule(U64 delay, Function<void()> callback) LU_THROWS(std::bad_alloc);
+
+        /*!
+         * Dreht das Rad bis zum angegebenen Tick weiter und ruft alle
+         * abgelaufenen Zeitgeber auf. Callbacks dürfen Zeitgeber starten und
+         * stoppen.
+         *
+         * \param[in]   now Der aktuelle Tick.
+         *
+         * \returns Die Anzahl der aufgerufenen Zeitgeber.
+         */
+        virtual U32 Advance(U64 now);
+
+        /*!
+         * \returns Die Anzahl der Ticks bis das Rad das nächste Mal
+         *          weitergedreht werden muss, oder den größten U64 Wert wenn
+         *          kein Zeitgeber läuft.
+         */
+        virtual U64 NextExpiration() const NOEXCEPT;
+
+    private:
+
+        void Insert(Timer* timer) NOEXCEPT;
+        void Unlink(Timer* timer) NOEXCEPT;
+        void Cascade(U32 level, U32 index) NOEXCEPT;
+
+        Timer* mSlots[LevelCount][SlotCount];
+        U64 mNow = 0;
+        U32 mCount = 0;
+    };
+
+    typedef Pointer<Timer> TimerPtr;
+    typedef Pointer<TimerWheel> TimerWheelPtr;
+}
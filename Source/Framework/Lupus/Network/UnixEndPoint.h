@@ -0,0 +1,81 @@
+﻿#pragma once
+
+#include <Lupus/Network/EndPoint.h>
+
+namespace Lupus {
+    /*!
+     * Endpunkt für die Kommunikation zwischen Prozessen auf demselben Host.
+     * Die Daten laufen dabei nicht durch den TCP/IP-Stack.
+     *
+     * Der Endpunkt ist entweder ein Pfad im Dateisystem oder ein Name im
+     * abstrakten Namensraum. Abstrakte Namen hinterlassen keine Datei und
+     * werden nur unter Linux unterstützt.
+     */
+    class LUPUS_API UnixEndPoint : public EndPoint
+    {
+    public:
+
+        /*!
+         * Erstellt einen Endpunkt mit einem Pfad im Dateisystem.
+         *
+         * \param[in]   path    Dateipfad des Sockets.
+         */
+        explicit UnixEndPoint(const String& path) LU_THROWS(std::invalid_argument);
+
+        /*!
+         * Erstellt einen Endpunkt mit einem Pfad im Dateisystem oder einem
+         * Namen im abstrakten Namensraum.
+         *
+         * \param[in]   path        Dateipfad bzw Name des Sockets.
+         * \param[in]   abstract    TRUE für den abstrakten Namensraum.
+         */
+        UnixEndPoint(const String& path, bool abstract) LU_THROWS(std::invalid_argument);
+
+        /*!
+         * Erstellt einen Endpunkt anhand von serialisierten Daten.
+         *
+         * \param[in]   buffer  Serialisierte Daten in der Größe von
+         *                      AddrStorage.
+         * \param[in]   length  Die Anzahl der gültigen Bytes.
+         */
+        UnixEndPoint(const Vector<Byte>& buffer, U32 length) LU_THROWS(std::invalid_argument);
+        virtual ~UnixEndPoint() = default;
+
+        /*!
+         * \returns AddressFamily::UNIX
+         */
+        virtual AddressFamily Family() const NOEXCEPT override;
+
+        /*!
+         * \returns Die Anzahl der gültigen Bytes der Socketadresse.
+         */
+        virtual U32 Length() const NOEXCEPT override;
+
+        /*!
+         * \returns Den Dateipfad bzw den Namen ohne führendes Nullbyte. Bei
+         *          unbenannten Sockets (bspw aus Socket::CreatePair) ist der
+         *          String leer.
+         */
+        virtual String Path() const NOEXCEPT;
+
+        /*!
+         * \returns TRUE wenn der Name im abstrakten Namensraum liegt.
+         */
+        virtual bool IsAbstract() const NOEXCEPT;
+
+        /*!
+         * \sa EndPoint::Serialize
+         */
+        virtual Vector<Byte> Serialize() const NOEXCEPT override;
+
+    private:
+
+        //! Standardkonstruktor ist nicht erlaubt.
+        UnixEndPoint() = delete;
+
+        AddrStorage mAddrStorage;
+        U32 mLength = 0;
+    };
+
+    typedef Pointer<UnixEndPoint> UnixEndPointPtr;
+}
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <Lupus/ByteOrder.h>
 #include <Lupus/Network/Enum.h>
 
 namespace Lupus {
@@ -49,6 +50,52 @@ namespace Lupus {
      */
     LUPUS_API U64 NetworkToHostOrder(U64 network) NOEXCEPT;
 
+    /*!
+     * Inline Variante von HostToNetworkOrder für häufige Aufrufe, bspw beim
+     * Kodieren von Adressen und Ports. Die exportierten Funktionen bleiben
+     * für bestehende Binärdateien erhalten.
+     *
+     * \returns Der Wert in Netzwerk Byteorder.
+     */
+    inline U16 ToNetworkOrder(U16 host) NOEXCEPT
+    {
+        return Internal::ConvertByteOrder(host);
+    }
+
+    //! \sa ToNetworkOrder(U16)
+    inline U32 ToNetworkOrder(U32 host) NOEXCEPT
+    {
+        return Internal::ConvertByteOrder(host);
+    }
+
+    //! \sa ToNetworkOrder(U16)
+    inline U64 ToNetworkOrder(U64 host) NOEXCEPT
+    {
+        return Internal::ConvertByteOrder(host);
+    }
+
+    /*!
+     * Inline Variante von NetworkToHostOrder.
+     *
+     * \returns Der Wert in Host Byteorder.
+     */
+    inline U16 ToHostOrder(U16 network) NOEXCEPT
+    {
+        return Internal::ConvertByteOrder(network);
+    }
+
+    //! \sa ToHostOrder(U16)
+    inline U32 ToHostOrder(U32 network) NOEXCEPT
+    {
+        return Internal::ConvertByteOrder(network);
+    }
+
+    //! \sa ToHostOrder(U16)
+    inline U64 ToHostOrder(U64 network) NOEXCEPT
+    {
+        return Internal::ConvertByteOrder(network);
+    }
+
     /*!
      * Diese Funktion ruft GetAddressInformation(node, service, 
      * AddressFamily::Unspecified, SocketType::Unspecified, 
@@ -56,7 +103,7 @@ namespace Lupus {
      *
      * \sa GetAddressInformation(const String&, const String&, AddressFamily, SocketType, ProtocolType)
      */
-    LUPUS_API Vector<Pointer<IPEndPoint>> GetAddressInformation(const String& node, const String& service) throw(std::runtime_error);
+    LUPUS_API Vector<Pointer<IPEndPoint>> GetAddressInformation(const String& node, const String& service) LU_THROWS(std::runtime_error);
 
     /*!
      * Diese Funktion ruft GetAddressInformation(node, service,
@@ -64,7 +111,7 @@ namespace Lupus {
      *
      * \sa GetAddressInformation(const String&, const String&, AddressFamily, SocketType, ProtocolType)
      */
-    LUPUS_API Vector<Pointer<IPEndPoint>> GetAddressInformation(const String& node, const String& service, AddressFamily family) throw(std::runtime_error);
+    LUPUS_API Vector<Pointer<IPEndPoint>> GetAddressInformation(const String& node, const String& service, AddressFamily family) LU_THROWS(std::runtime_error);
 
     /*!
      * Diese Funktion ruft GetAddressInformation(node, service,
@@ -72,7 +119,7 @@ namespace Lupus {
      *
      * \sa GetAddressInformation(const String&, const String&, AddressFamily, SocketType, ProtocolType)
      */
-    LUPUS_API Vector<Pointer<IPEndPoint>> GetAddressInformation(const String& node, const String& service, SocketType type) throw(std::runtime_error);
+    LUPUS_API Vector<Pointer<IPEndPoint>> GetAddressInformation(const String& node, const String& service, SocketType type) LU_THROWS(std::runtime_error);
 
     /*!
      * Diese Funktion ruft GetAddressInformation(node, service,
@@ -80,7 +127,7 @@ namespace Lupus {
      *
      * \sa GetAddressInformation(const String&, const String&, AddressFamily, SocketType, ProtocolType)
      */
-    LUPUS_API Vector<Pointer<IPEndPoint>> GetAddressInformation(const String& node, const String& service, ProtocolType protocol) throw(std::runtime_error);
+    LUPUS_API Vector<Pointer<IPEndPoint>> GetAddressInformation(const String& node, const String& service, ProtocolType protocol) LU_THROWS(std::runtime_error);
 
     /*!
      * Liest die Adressinformation des angegebenen Knotens mit dem
@@ -114,5 +161,5 @@ namespace Lupus {
         SocketType type, 
         ProtocolType protocol
         ) 
-        throw(std::runtime_error, std::invalid_argument);
+        LU_THROWS(std::runtime_error, std::invalid_argument);
 }
@@ -0,0 +1,574 @@
+﻿#pragma once
+
+#include <Lupus/ISerializable.h>
+
+/*!
+ * Beschreibt ein Feld für eine Layout-Deklaration.
+ *
+ * \sa Lupus::Fields
+ */
+#define LUPUS_FIELD(Class, Name) ::Lupus::Field<decltype(&Class::Name), &Class::Name>
+
+namespace Lupus {
+    template <typename Member, Member Pointer>
+    struct Field;
+
+    //! Ein Feld einer Klasse, beschrieben über den Member-Zeiger.
+    template <typename Class, typename Type, Type Class::*Pointer>
+    struct Field<Type Class::*, Pointer>
+    {
+        typedef Class ClassType;
+        typedef Type ValueType;
+
+        static inline Type& Get(Class& object) NOEXCEPT
+        {
+            return object.*Pointer;
+        }
+
+        static inline const Type& Get(const Class& object) NOEXCEPT
+        {
+            return object.*Pointer;
+        }
+    };
+
+    /*!
+     * Liste der zu serialisierenden Felder einer Klasse. Die Reihenfolge
+     * bestimmt das Format.
+     *
+     * \code
+     * struct Point
+     * {
+     *     S32 X;
+     *     S32 Y;
+     *     Vector<U16> Samples;
+     *
+     *     typedef Fields<LUPUS_FIELD(Point, X), LUPUS_FIELD(Point, Y), LUPUS_FIELD(Point, Samples)> Layout;
+     * };
+     * \endcode
+     *
+     * Klassen die nicht verändert werden können spezialisieren stattdessen
+     * Reflection<T> mit dem selben Layout-Typ.
+     */
+    template <typename... List>
+    struct Fields;
+
+    /*!
+     * Liefert das Layout eines Typs. Standardmäßig wird T::Layout verwendet,
+     * der Typ kann aber auch explizit spezialisiert werden.
+     */
+    template <typename T, typename Enable = void>
+    struct Reflection
+    {
+    };
+
+    namespace Internal {
+        template <typename T>
+        struct AlwaysVoid
+        {
+            typedef void Type;
+        };
+
+        //! TRUE für Zahlentypen deren Größe auf allen Plattformen gleich ist.
+        template <typename T>
+        struct IsFixedWidth
+        {
+            static const bool value =
+                std::is_same<T, char>::value || std::is_same<T, S8>::value || std::is_same<T, U8>::value ||
+                std::is_same<T, S16>::value || std::is_same<T, U16>::value ||
+                std::is_same<T, S32>::value || std::is_same<T, U32>::value ||
+                std::is_same<T, S64>::value || std::is_same<T, U64>::value ||
+                std::is_same<T, float>::value || std::is_same<T, double>::value;
+        };
+    }
+
+    template <typename T>
+    struct Reflection<T, typename Internal::AlwaysVoid<typename T::Layout>::Type>
+    {
+        typedef typename T::Layout Layout;
+    };
+
+    /*!
+     * Kodiert einen einzelnen Typ. Jede Spezialisierung liefert:
+     *
+     * - Fixed: TRUE wenn die Größe zur Kompilierzeit feststeht.
+     * - Size: Die feste Größe in Bytes, sonst 0.
+     * - Store/Load: Kodierung ohne Grenzprüfung, nur für feste Typen.
+     * - Write/Read: Kodierung über ByteWriter bzw ByteReader.
+     *
+     * Das Format entspricht ByteWriter und ist damit plattformunabhängig.
+     */
+    template <typename T, typename Enable = void>
+    struct Codec;
+
+    //! Ganz- und Gleitkommazahlen in Netzwerk Byteorder. Typen wie long,
+    //! wchar_t oder long double sind je nach Plattform unterschiedlich groß
+    //! und daher nicht erlaubt.
+    template <typename T>
+    struct Codec<T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type>
+    {
+        static_assert(Internal::IsFixedWidth<T>::value, "T must be a fixed-width type like S32, U64 or double");
+
+        static const bool Fixed = true;
+        static const U32 Size = sizeof(T);
+
+        static inline void Store(Byte* target, const T& value) NOEXCEPT
+        {
+            Internal::StoreNetworkOrder(target, value);
+        }
+
+        static inline void Load(const Byte* source, T& value) NOEXCEPT
+        {
+            value = Internal::LoadNetworkOrder<T>(source);
+        }
+
+        static inline void Write(ByteWriter& writer, const T& value)
+        {
+            writer.Write(value);
+        }
+
+        static inline void Read(ByteReader& reader, T& value)
+        {
+            value = reader.Read<T>();
+        }
+    };
+
+    //! Wahrheitswerte als einzelnes Byte.
+    template <>
+    struct Codec<bool>
+    {
+        static const bool Fixed = true;
+        static const U32 Size = 1;
+
+        static inline void Store(Byte* target, const bool& value) NOEXCEPT
+        {
+            *target = value ? 1 : 0;
+        }
+
+        static inline void Load(const Byte* source, bool& value) NOEXCEPT
+        {
+            value = (*source != 0);
+        }
+
+        static inline void Write(ByteWriter& writer, const bool& value)
+        {
+            writer.Write(value);
+        }
+
+        static inline void Read(ByteReader& reader, bool& value)
+        {
+            value = reader.Read<bool>();
+        }
+    };
+
+    //! Aufzählungen über ihren zugrunde liegenden Typ.
+    template <typename T>
+    struct Codec<T, typename std::enable_if<std::is_enum<T>::value>::type>
+    {
+        typedef typename std::underlying_type<T>::type Underlying;
+
+        static const bool Fixed = true;
+        static const U32 Size = sizeof(Underlying);
+
+        static inline void Store(Byte* target, const T& value) NOEXCEPT
+        {
+            Internal::StoreNetworkOrder(target, (Underlying)value);
+        }
+
+        static inline void Load(const Byte* source, T& value) NOEXCEPT
+        {
+            value = (T)Internal::LoadNetworkOrder<Underlying>(source);
+        }
+
+        static inline void Write(ByteWriter& writer, const T& value)
+        {
+            writer.Write((Underlying)value);
+        }
+
+        static inline void Read(ByteReader& reader, T& value)
+        {
+            value = (T)reader.Read<Underlying>();
+        }
+    };
+
+    //! Zeichenketten mit vorangestellter 32-Bit Länge.
+    template <>
+    struct Codec<String>
+    {
+        static const bool Fixed = false;
+        static const U32 Size = 0;
+
+        static inline void Write(ByteWriter& writer, const String& value)
+        {
+            writer.Write(value);
+        }
+
+        static inline void Read(ByteReader& reader, String& value)
+        {
+            value = reader.ReadString();
+        }
+    };
+
+    namespace Internal {
+        /*!
+         * Kodiert count Elemente fester Größe ohne Grenzprüfung. Einzelne
+         * Bytes werden mit memcpy kopiert, größere Zahlen ab BulkCount
+         * Elementen mit HostToNetworkOrder bzw NetworkToHostOrder für
+         * Arrays. Alle anderen Typen werden elementweise kodiert.
+         */
+        template <typename T, bool Fixed = Codec<T>::Fixed>
+        struct FixedStore
+        {
+            static const bool Number = (std::is_arithmetic<T>::value || std::is_enum<T>::value) && !std::is_same<T, bool>::value;
+            static const bool Copy = Number && sizeof(T) == 1;
+            static const bool Bulk = Number && sizeof(T) > 1;
+            static const U32 BulkCount = 8;
+
+            typedef typename ByteOrderType<Bulk ? sizeof(T) : 2>::Type Bits;
+
+            static inline void Store(Byte* target, const T* values, U32 count) NOEXCEPT
+            {
+                if (Copy) {
+                    memcpy(target, values, count);
+                    return;
+                } else if (Bulk && count >= BulkCount) {
+                    HostToNetworkOrder((const Bits*)values, (Bits*)target, count);
+                    return;
+                }
+
+                for (U32 i = 0; i < count; i++) {
+                    Codec<T>::Store(target + i * Codec<T>::Size, values[i]);
+                }
+            }
+
+            static inline void Load(const Byte* source, T* values, U32 count) NOEXCEPT
+            {
+                if (Copy) {
+                    memcpy(values, source, count);
+                    return;
+                } else if (Bulk && count >= BulkCount) {
+                    NetworkToHostOrder((const Bits*)source, (Bits*)values, count);
+                    return;
+                }
+
+                for (U32 i = 0; i < count; i++) {
+                    Codec<T>::Load(source + i * Codec<T>::Size, values[i]);
+                }
+            }
+        };
+
+        //! Typen ohne feste Größe werden nie direkt kodiert.
+        template <typename T>
+        struct FixedStore<T, false>
+        {
+            static inline void Store(Byte*, const T*, U32) NOEXCEPT
+            {
+            }
+
+            static inline void Load(const Byte*, T*, U32) NOEXCEPT
+            {
+            }
+        };
+
+        //! Kodiert count aufeinanderfolgende Elemente.
+        template <typename T>
+        struct BulkCodec
+        {
+            static inline void Write(ByteWriter& writer, const T* values, U32 count)
+            {
+                if (Codec<T>::Fixed && count > 0) {
+                    // Kann der Writer keinen zusammenhängenden Bereich
+                    // liefern, dann wird elementweise geschrieben.
+                    Byte* target = writer.Reserve(count * Codec<T>::Size);
+
+                    if (target) {
+                        FixedStore<T>::Store(target, values, count);
+                        return;
+                    }
+                }
+
+                for (U32 i = 0; i < count; i++) {
+                    Codec<T>::Write(writer, values[i]);
+                }
+            }
+
+            static inline void Read(ByteReader& reader, T* values, U32 count)
+            {
+                if (Codec<T>::Fixed) {
+                    FixedStore<T>::Load(reader.Borrow(count * Codec<T>::Size), values, count);
+                    return;
+                }
+
+                for (U32 i = 0; i < count; i++) {
+                    Codec<T>::Read(reader, values[i]);
+                }
+            }
+        };
+    }
+
+    //! Vektoren mit vorangestellter 32-Bit Anzahl an Elementen.
+    template <typename T>
+    struct Codec<Vector<T>>
+    {
+        static const bool Fixed = false;
+        static const U32 Size = 0;
+
+        static inline void Write(ByteWriter& writer, const Vector<T>& value)
+        {
+            if (value.size() > UINT32_MAX / (Codec<T>::Size > 0 ? Codec<T>::Size : 1)) {
+                throw std::out_of_range("vector is too long");
+            }
+
+            writer.Write((U32)value.size());
+            Internal::BulkCodec<T>::Write(writer, value.data(), (U32)value.size());
+        }
+
+        static inline void Read(ByteReader& reader, Vector<T>& value)
+        {
+            U32 count = reader.Read<U32>();
+
+            // Verhindert dass fehlerhafte Daten eine riesige Anforderung
+            // auslösen.
+            if (count > reader.Remaining() / (Codec<T>::Size > 0 ? Codec<T>::Size : 1)) {
+                throw std::out_of_range("reader has not enough data left");
+            }
+
+            value.resize(count);
+            Internal::BulkCodec<T>::Read(reader, value.data(), count);
+        }
+    };
+
+    //! Vector<bool> speichert Bits und bietet daher kein data(), jeder Wert
+    //! wird wie bei Codec<bool> als einzelnes Byte kodiert.
+    template <>
+    struct Codec<Vector<bool>>
+    {
+        static const bool Fixed = false;
+        static const U32 Size = 0;
+
+        static inline void Write(ByteWriter& writer, const Vector<bool>& value)
+        {
+            if (value.size() > UINT32_MAX) {
+                throw std::out_of_range("vector is too long");
+            }
+
+            writer.Write((U32)value.size());
+
+            for (bool item : value) {
+                writer.Write(item);
+            }
+        }
+
+        static inline void Read(ByteReader& reader, Vector<bool>& value)
+        {
+            U32 count = reader.Read<U32>();
+
+            if (count > reader.Remaining()) {
+                throw std::out_of_range("reader has not enough data left");
+            }
+
+            value.resize(count);
+
+            for (U32 i = 0; i < count; i++) {
+                value[i] = reader.Read<bool>();
+            }
+        }
+    };
+
+    //! Arrays fester Länge ohne Präfix.
+    template <typename T, size_t N>
+    struct Codec<T[N]>
+    {
+        static const bool Fixed = Codec<T>::Fixed;
+        static const U32 Size = Codec<T>::Size * N;
+
+        static inline void Store(Byte* target, const T (&value)[N]) NOEXCEPT
+        {
+            Internal::FixedStore<T>::Store(target, value, N);
+        }
+
+        static inline void Load(const Byte* source, T (&value)[N]) NOEXCEPT
+        {
+            Internal::FixedStore<T>::Load(source, value, N);
+        }
+
+        static inline void Write(ByteWriter& writer, const T (&value)[N])
+        {
+            Internal::BulkCodec<T>::Write(writer, value, N);
+        }
+
+        static inline void Read(ByteReader& reader, T (&value)[N])
+        {
+            Internal::BulkCodec<T>::Read(reader, value, N);
+        }
+    };
+
+    template <>
+    struct Fields<>
+    {
+        static const bool Fixed = true;
+        static const U32 Size = 0;
+
+        template <typename Class>
+        static inline void Store(Byte*, const Class&) NOEXCEPT
+        {
+        }
+
+        template <typename Class>
+        static inline void Load(const Byte*, Class&) NOEXCEPT
+        {
+        }
+
+        template <typename Class>
+        static inline void Write(ByteWriter&, const Class&)
+        {
+        }
+
+        template <typename Class>
+        static inline void Read(ByteReader&, Class&)
+        {
+        }
+    };
+
+    template <typename First, typename... Rest>
+    struct Fields<First, Rest...>
+    {
+        typedef Codec<typename First::ValueType> Head;
+        typedef Fields<Rest...> Tail;
+
+        static const bool Fixed = Head::Fixed && Tail::Fixed;
+        static const U32 Size = Fixed ? Head::Size + Tail::Size : 0;
+
+        template <typename Class>
+        static inline void Store(Byte* target, const Class& object) NOEXCEPT
+        {
+            Internal::FixedStore<typename First::ValueType>::Store(target, &First::Get(object), 1);
+            Tail::Store(target + Head::Size, object);
+        }
+
+        template <typename Class>
+        static inline void Load(const Byte* source, Class& object) NOEXCEPT
+        {
+            Internal::FixedStore<typename First::ValueType>::Load(source, &First::Get(object), 1);
+            Tail::Load(source + Head::Size, object);
+        }
+
+        template <typename Class>
+        static inline void Write(ByteWriter& writer, const Class& object)
+        {
+            Head::Write(writer, First::Get(object));
+            Tail::Write(writer, object);
+        }
+
+        template <typename Class>
+        static inline void Read(ByteReader& reader, Class& object)
+        {
+            Head::Read(reader, First::Get(object));
+            Tail::Read(reader, object);
+        }
+    };
+
+    /*!
+     * Klassen mit Layout. Besteht das Layout nur aus Feldern fester Größe,
+     * dann wird der gesamte Bereich mit einem einzigen Reserve bzw Borrow
+     * angefordert und ohne weitere Grenzprüfungen kodiert.
+     */
+    template <typename T>
+    struct Codec<T, typename Internal::AlwaysVoid<typename Reflection<T>::Layout>::Type>
+    {
+        typedef typename Reflection<T>::Layout Layout;
+
+        static const bool Fixed = Layout::Fixed;
+        static const U32 Size = Layout::Size;
+
+        static inline void Store(Byte* target, const T& value) NOEXCEPT
+        {
+            Layout::Store(target, value);
+        }
+
+        static inline void Load(const Byte* source, T& value) NOEXCEPT
+        {
+            Layout::Load(source, value);
+        }
+
+        static inline void Write(ByteWriter& writer, const T& value)
+        {
+            if (Fixed) {
+                Byte* target = writer.Reserve(Size);
+
+                if (target) {
+                    Layout::Store(target, value);
+                    return;
+                }
+            }
+
+            Layout::Write(writer, value);
+        }
+
+        static inline void Read(ByteReader& reader, T& value)
+        {
+            if (Fixed) {
+                Layout::Load(reader.Borrow(Size), value);
+            } else {
+                Layout::Read(reader, value);
+            }
+        }
+    };
+
+    /*!
+     * Serialisiert das Objekt anhand seines Layouts.
+     *
+     * \param[in]   writer  Das Ziel der serialisierten Daten.
+     * \param[in]   value   Das zu serialisierende Objekt.
+     */
+    template <typename T>
+    inline void Serialize(ByteWriter& writer, const T& value)
+    {
+        Codec<T>::Write(writer, value);
+    }
+
+    /*!
+     * Deserialisiert das Objekt anhand seines Layouts.
+     *
+     * \param[in]   reader  Das Objekt in serialisierter Form.
+     * \param[out]  value   Das zu befüllende Objekt.
+     */
+    template <typename T>
+    inline void Deserialize(ByteReader& reader, T& value) LU_THROWS(std::out_of_range)
+    {
+        Codec<T>::Read(reader, value);
+    }
+
+    /*!
+     * Implementiert ISerializable über das Layout der abgeleiteten Klasse.
+     *
+     * \code
+     * class Position : public Serializable<Position>
+     * {
+     * public:
+     *     float X, Y;
+     *
+     *     typedef Fields<LUPUS_FIELD(Position, X), LUPUS_FIELD(Position, Y)> Layout;
+     * };
+     * \endcode
+     */
+    template <typename Derived>
+    class Serializable : public ISerializable
+    {
+    public:
+
+        virtual ~Serializable() = default;
+
+        virtual void Serialize(ByteWriter& writer) const override
+        {
+            Codec<Derived>::Write(writer, static_cast<const Derived&>(*this));
+        }
+
+        virtual void Deserialize(ByteReader& reader) LU_THROWS(std::out_of_range, std::invalid_argument) override
+        {
+            Codec<Derived>::Read(reader, static_cast<Derived&>(*this));
+        }
+
+        using ISerializable::Serialize;
+        using ISerializable::Deserialize;
+    };
+}
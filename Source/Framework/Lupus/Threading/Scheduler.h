@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include <Lupus/Definitions.h>
+#include <condition_variable>
+
+namespace Lupus {
+    /*!
+     * Threadpool mit Work-Stealing. Jeder Worker besitzt eine eigene
+     * Chase-Lev Deque, aus der er zuletzt eingereihte Aufgaben zuerst
+     * ausführt, solange deren Daten noch im Cache liegen. Hat ein Worker
+     * nichts zu tun, dann stiehlt er die ältesten Aufgaben eines zufälligen
+     * anderen Workers. Dadurch gleichen sich ungleich verteilte Lasten von
+     * selbst aus, ohne dass eine gemeinsame Warteschlange zum Engpass wird.
+     *
+     * Aufgaben aus einem Worker landen in dessen Deque. Aufgaben von außen
+     * landen in einer gemeinsamen Warteschlange oder, wenn ein Worker
+     * angegeben wird, in dessen Eingang. Schlafende Worker werden nur
+     * geweckt wenn tatsächlich Arbeit ansteht.
+     */
+    class LUPUS_API Scheduler : public ReferenceType
+    {
+    public:
+
+        /*!
+         * Erstellt einen Worker pro Prozessorkern.
+         */
+        Scheduler() LU_THROWS(std::bad_alloc);
+
+        /*!
+         * Erstellt die angegebene Anzahl an Workern.
+         *
+         * \param[in]   workers Anzahl der Worker, mindestens einer.
+         */
+        Scheduler(U32 workers) LU_THROWS(std::invalid_argument, std::bad_alloc);
+
+        /*!
+         * Führt alle eingereihten Aufgaben aus und beendet danach die
+         * Worker.
+         */
+        virtual ~Scheduler();
+
+        /*!
+         * \returns Die Anzahl der Worker.
+         */
+        virtual U32 Workers() const NOEXCEPT;
+
+        /*!
+         * \returns Den Index des aufrufenden Workers oder -1 wenn der
+         *          aufrufende Thread nicht zu diesem Scheduler gehört.
+         */
+        virtual S32 Current() const NOEXCEPT;
+
+        /*!
+         * Reiht eine Aufgabe ein. Aus einem Worker heraus landet sie in
+         * dessen eigener Deque. Darf aus jedem Thread aufgerufen werden.
+         *
+         * Ausnahmen einer Aufgabe werden verworfen.
+         *
+         * \param[in]   task    Die auszuführende Aufgabe.
+         */
+        virtual void Submit(Function<void()> task) LU_THROWS(std::bad_alloc);
+
+        /*!
+         * Reiht eine Aufgabe bevorzugt beim angegebenen Worker ein, bspw
+         * damit alle Aufgaben einer Verbindung auf demselben Kern laufen.
+         * Andere Worker dürfen sie trotzdem stehlen wenn sie untätig sind.
+         *
+         * \param[in]   worker  Index des bevorzugten Workers. Wird modulo
+         *                      der Anzahl der Worker genommen.
+         * \param[in]   task    Die auszuführende Aufgabe.
+         */
+        virtual void Submit(U32 worker, Function<void()> task) LU_THROWS(std::bad_alloc);
+
+    private:
+
+        struct Worker;
+        typedef Function<void()> Task;
+
+        void Run(U32 index) NOEXCEPT;
+        Task* Find(Worker& worker) NOEXCEPT;
+        Task* Take(Mutex& mutex, Deque<Task*>& queue, bool steal) NOEXCEPT;
+        void Notify() NOEXCEPT;
+
+        Vector<Pointer<Worker>> mWorkers;
+        Mutex mMutex;
+        Deque<Task*> mInjected;
+        std::condition_variable mCondition;
+        Atomic<U32> mSleeping;
+        Atomic<U32> mPending;
+        Atomic<bool> mStopping;
+    };
+
+    typedef Pointer<Scheduler> SchedulerPtr;
+}
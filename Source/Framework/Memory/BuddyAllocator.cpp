@@ -0,0 +1,249 @@
+﻿#include <Lupus/Memory/BuddyAllocator.h>
+#include <Internal/Memory/PageMemory.h>
+#include <algorithm>
+
+namespace Lupus {
+    namespace Internal {
+        //! Freier Block, verkettet in der Liste seiner Ordnung.
+        struct BuddyBlock
+        {
+            BuddyBlock* Next;
+            BuddyBlock* Previous;
+        };
+    }
+
+    using Internal::BuddyBlock;
+
+    namespace {
+        const Byte FreeFlag = 0x80;
+        const Byte NoHead = 0xFF;
+
+        bool IsPowerOfTwo(U64 value)
+        {
+            return value != 0 && (value & (value - 1)) == 0;
+        }
+
+        U32 Log2(U64 value)
+        {
+            U32 result = 0;
+
+            while (value > 1) {
+                value >>= 1;
+                result++;
+            }
+
+            return result;
+        }
+    }
+
+    BuddyAllocator::BuddyAllocator(U64 capacity, U32 minBlockSize, U32 maxBlockSize, const MemoryBacking& backing)
+    {
+        if (!IsPowerOfTwo(minBlockSize) || !IsPowerOfTwo(maxBlockSize)) {
+            throw std::invalid_argument("block sizes must be powers of two");
+        } else if (minBlockSize < sizeof(BuddyBlock) || maxBlockSize < minBlockSize) {
+            throw std::invalid_argument("invalid block sizes");
+        } else if (capacity == 0) {
+            throw std::invalid_argument("capacity must be greater than zero");
+        }
+
+        mMinBlockSize = minBlockSize;
+        mMinShift = Log2(minBlockSize);
+        mOrders = Log2(maxBlockSize) - mMinShift + 1;
+        mCapacity = (capacity + maxBlockSize - 1) & ~(U64)(maxBlockSize - 1);
+        mArena = Internal::AllocatePages((size_t)mCapacity, backing, mReserved);
+        mHeads.assign((size_t)(mCapacity >> mMinShift), NoHead);
+        mRequested.assign(mHeads.size(), 0);
+
+        for (U32 i = 0; i < MaxOrders; i++) {
+            mFree[i] = nullptr;
+            mFreeCount[i] = 0;
+        }
+
+        // Zu Beginn besteht die Arena aus freien Blöcken der größten Ordnung.
+        const size_t step = (size_t)1 << (mOrders - 1);
+
+        for (size_t index = 0; index < mHeads.size(); index += step) {
+            Push(index, mOrders - 1);
+        }
+    }
+
+    BuddyAllocator::~BuddyAllocator()
+    {
+        Internal::FreePages(mArena, mReserved);
+    }
+
+    void* BuddyAllocator::Allocate(U32 bytes) NOEXCEPT
+    {
+        U32 order = 0;
+
+        while (order < mOrders && ((U64)mMinBlockSize << order) < bytes) {
+            order++;
+        }
+
+        if (order == mOrders) {
+            return nullptr;
+        }
+
+        LockGuard<Mutex> lock(mMutex);
+        U32 current = order;
+
+        while (current < mOrders && !mFree[current]) {
+            current++;
+        }
+
+        if (current == mOrders) {
+            return nullptr;
+        }
+
+        size_t index = (size_t)(((Byte*)mFree[current] - mArena) >> mMinShift);
+
+        Remove(index, current);
+
+        // Die obere Hälfte jeder Teilung bleibt frei.
+        while (current > order) {
+            current--;
+            Push(index + ((size_t)1 << current), current);
+        }
+
+        mHeads[index] = (Byte)order;
+        mRequested[index] = bytes;
+        mRequestedBytes += bytes;
+        mBlocks++;
+        return mArena + (index << mMinShift);
+    }
+
+    void BuddyAllocator::Free(void* block)
+    {
+        if (!block) {
+            return;
+        }
+
+        LockGuard<Mutex> lock(mMutex);
+        size_t index = Index(block);
+        U32 order = mHeads[index];
+
+        mRequestedBytes -= mRequested[index];
+        mRequested[index] = 0;
+        mBlocks--;
+
+        while (order + 1 < mOrders) {
+            size_t buddy = index ^ ((size_t)1 << order);
+
+            if (mHeads[buddy] != (FreeFlag | order)) {
+                break;
+            }
+
+            Remove(buddy, order);
+            mHeads[std::max(index, buddy)] = NoHead;
+            index = std::min(index, buddy);
+            order++;
+        }
+
+        Push(index, order);
+    }
+
+    U32 BuddyAllocator::BlockSize(const void* block) const
+    {
+        LockGuard<Mutex> lock(mMutex);
+
+        return mMinBlockSize << mHeads[Index(block)];
+    }
+
+    bool BuddyAllocator::Owns(const void* block) const NOEXCEPT
+    {
+        return (const Byte*)block >= mArena && (const Byte*)block < mArena + mCapacity;
+    }
+
+    U32 BuddyAllocator::MinBlockSize() const NOEXCEPT
+    {
+        return mMinBlockSize;
+    }
+
+    U32 BuddyAllocator::MaxBlockSize() const NOEXCEPT
+    {
+        return mMinBlockSize << (mOrders - 1);
+    }
+
+    BuddyStatistics BuddyAllocator::Statistics() const NOEXCEPT
+    {
+        BuddyStatistics result;
+        LockGuard<Mutex> lock(mMutex);
+
+        result.Capacity = mCapacity;
+        result.FreeBytes = mFreeBytes;
+        result.RequestedBytes = mRequestedBytes;
+        result.Blocks = mBlocks;
+        result.FreeBlocks.assign(mFreeCount, mFreeCount + mOrders);
+
+        for (U32 order = mOrders; order > 0; order--) {
+            if (mFree[order - 1]) {
+                result.LargestFreeBlock = (U64)mMinBlockSize << (order - 1);
+                break;
+            }
+        }
+
+        if (mFreeBytes > 0) {
+            result.ExternalFragmentation = 1.0f - (float)((double)result.LargestFreeBlock / (double)mFreeBytes);
+        }
+
+        U64 used = mCapacity - mFreeBytes;
+
+        if (used > 0) {
+            result.InternalFragmentation = 1.0f - (float)((double)mRequestedBytes / (double)used);
+        }
+
+        return result;
+    }
+
+    size_t BuddyAllocator::Index(const void* block) const
+    {
+        const Byte* data = (const Byte*)block;
+
+        if (!Owns(block) || ((size_t)(data - mArena) & (mMinBlockSize - 1)) != 0) {
+            throw std::invalid_argument("block does not belong to the allocator");
+        }
+
+        size_t index = (size_t)(data - mArena) >> mMinShift;
+
+        if (mHeads[index] == NoHead || (mHeads[index] & FreeFlag) != 0) {
+            throw std::invalid_argument("block is not allocated");
+        }
+
+        return index;
+    }
+
+    void BuddyAllocator::Push(size_t index, U32 order) NOEXCEPT
+    {
+        BuddyBlock* block = (BuddyBlock*)(mArena + (index << mMinShift));
+
+        block->Previous = nullptr;
+        block->Next = mFree[order];
+
+        if (block->Next) {
+            block->Next->Previous = block;
+        }
+
+        mFree[order] = block;
+        mFreeCount[order]++;
+        mFreeBytes += (U64)mMinBlockSize << order;
+        mHeads[index] = FreeFlag | (Byte)order;
+    }
+
+    void BuddyAllocator::Remove(size_t index, U32 order) NOEXCEPT
+    {
+        BuddyBlock* block = (BuddyBlock*)(mArena + (index << mMinShift));
+
+        if (block->Previous) {
+            block->Previous->Next = block->Next;
+        } else {
+            mFree[order] = block->Next;
+        }
+
+        if (block->Next) {
+            block->Next->Previous = block->Previous;
+        }
+
+        mFreeCount[order]--;
+        mFreeBytes -= (U64)mMinBlockSize << order;
+    }
+}
@@ -0,0 +1,376 @@
+﻿#include <Lupus/Memory/BufferChain.h>
+#include <Lupus/ByteWriter.h>
+#include <algorithm>
+
+namespace Lupus {
+    BufferChain::BufferChain() NOEXCEPT
+    {
+    }
+
+    BufferChain::BufferChain(const PooledBuffer& buffer)
+    {
+        Append(buffer);
+    }
+
+    BufferChain::BufferChain(const BufferChain& chain) :
+        mSlices(chain.mSlices),
+        mSize(chain.mSize)
+    {
+    }
+
+    BufferChain::BufferChain(BufferChain&& chain) NOEXCEPT :
+        mSlices(std::move(chain.mSlices)),
+        mSize(chain.mSize)
+    {
+        chain.mSlices.clear();
+        chain.mSize = 0;
+    }
+
+    BufferChain& BufferChain::operator=(const BufferChain& chain)
+    {
+        if (this != &chain) {
+            mSlices = chain.mSlices;
+            mSize = chain.mSize;
+        }
+
+        return *this;
+    }
+
+    BufferChain& BufferChain::operator=(BufferChain&& chain) NOEXCEPT
+    {
+        if (this != &chain) {
+            mSlices = std::move(chain.mSlices);
+            mSize = chain.mSize;
+            chain.mSlices.clear();
+            chain.mSize = 0;
+        }
+
+        return *this;
+    }
+
+    bool BufferChain::IsEmpty() const NOEXCEPT
+    {
+        return (mSize == 0);
+    }
+
+    U32 BufferChain::Size() const NOEXCEPT
+    {
+        return mSize;
+    }
+
+    U32 BufferChain::SliceCount() const NOEXCEPT
+    {
+        return (U32)mSlices.size();
+    }
+
+    const BufferSlice& BufferChain::At(U32 index) const
+    {
+        if (index >= mSlices.size()) {
+            throw std::out_of_range("index is out of range");
+        }
+
+        return mSlices[index];
+    }
+
+    void BufferChain::Append(const PooledBuffer& buffer)
+    {
+        Append(buffer, 0, buffer.Size());
+    }
+
+    void BufferChain::Append(const PooledBuffer& buffer, U32 offset, U32 size)
+    {
+        if (offset > buffer.Size() || size > buffer.Size() - offset) {
+            throw std::out_of_range("offset and size does not match buffer size");
+        }
+
+        Grow(size);
+        Push(buffer, offset, size, false);
+    }
+
+    void BufferChain::Append(const BufferChain& chain)
+    {
+        if (this == &chain) {
+            Append(BufferChain(chain));
+            return;
+        }
+
+        Grow(chain.mSize);
+
+        for (const BufferSlice& slice : chain.mSlices) {
+            Push(slice.Buffer, slice.Offset, slice.Size, false);
+        }
+    }
+
+    void BufferChain::Append(const Byte* data, U32 size)
+    {
+        if (!data && size > 0) {
+            throw null_pointer("data points to NULL");
+        }
+
+        Grow(size);
+
+        while (size > 0) {
+            BufferSlice* tail = mSlices.empty() ? nullptr : &mSlices.back();
+
+            // Hinter dem letzten Ausschnitt darf nur geschrieben werden, wenn
+            // niemand sonst den Buffer kennt und dort noch nichts steht.
+            if (!tail || tail->Buffer.References() != 1 || tail->Offset + tail->Size != tail->Buffer.Size() ||
+                tail->Buffer.Size() == tail->Buffer.Capacity()) {
+                BufferSlice slice;
+
+                slice.Buffer = BufferPool::Shared()->Lease(std::min(size, BufferPool::LargeSize));
+                mSlices.push_back(std::move(slice));
+                tail = &mSlices.back();
+            }
+
+            U32 used = tail->Buffer.Size();
+            U32 count = std::min(size, tail->Buffer.Capacity() - used);
+
+            memcpy(tail->Buffer.Data() + used, data, count);
+            tail->Buffer.Size(used + count);
+            tail->Size += count;
+            mSize += count;
+            data += count;
+            size -= count;
+        }
+    }
+
+    void BufferChain::Prepend(const PooledBuffer& buffer)
+    {
+        Prepend(buffer, 0, buffer.Size());
+    }
+
+    void BufferChain::Prepend(const PooledBuffer& buffer, U32 offset, U32 size)
+    {
+        if (offset > buffer.Size() || size > buffer.Size() - offset) {
+            throw std::out_of_range("offset and size does not match buffer size");
+        }
+
+        Grow(size);
+        Push(buffer, offset, size, true);
+    }
+
+    void BufferChain::Prepend(const BufferChain& chain)
+    {
+        if (this == &chain) {
+            Prepend(BufferChain(chain));
+            return;
+        }
+
+        Grow(chain.mSize);
+
+        for (auto it = chain.mSlices.rbegin(); it != chain.mSlices.rend(); ++it) {
+            Push(it->Buffer, it->Offset, it->Size, true);
+        }
+    }
+
+    void BufferChain::Prepend(const Byte* data, U32 size)
+    {
+        if (!data && size > 0) {
+            throw null_pointer("data points to NULL");
+        } else if (size == 0) {
+            return;
+        }
+
+        Grow(size);
+
+        BufferSlice* head = mSlices.empty() ? nullptr : &mSlices.front();
+
+        if (!head || head->Buffer.References() != 1 || head->Offset < size) {
+            PooledBuffer buffer = BufferPool::Shared()->Lease(size);
+            BufferSlice slice;
+
+            // Der Ausschnitt liegt am Ende des Buffers, der freie Platz davor
+            // nimmt weitere Header auf.
+            buffer.Size(buffer.Capacity());
+            slice.Offset = buffer.Capacity();
+            slice.Buffer = std::move(buffer);
+            mSlices.push_front(std::move(slice));
+            head = &mSlices.front();
+        }
+
+        head->Offset -= size;
+        head->Size += size;
+        memcpy(head->Data(), data, size);
+        mSize += size;
+    }
+
+    BufferChain BufferChain::Slice(U32 offset, U32 size) const
+    {
+        if (offset > mSize || size > mSize - offset) {
+            throw std::out_of_range("offset and size does not match chain size");
+        }
+
+        BufferChain result;
+
+        for (auto it = mSlices.begin(); it != mSlices.end() && size > 0; ++it) {
+            if (offset >= it->Size) {
+                offset -= it->Size;
+                continue;
+            }
+
+            U32 count = std::min(size, it->Size - offset);
+
+            result.Push(it->Buffer, it->Offset + offset, count, false);
+            offset = 0;
+            size -= count;
+        }
+
+        return result;
+    }
+
+    BufferChain BufferChain::Split(U32 size)
+    {
+        if (size > mSize) {
+            throw std::out_of_range("size is greater than the chain size");
+        }
+
+        BufferChain result;
+
+        // Ganze Ausschnitte wandern ohne Änderung der Verweise.
+        while (size > 0 && mSlices.front().Size <= size) {
+            size -= mSlices.front().Size;
+            mSize -= mSlices.front().Size;
+            result.mSize += mSlices.front().Size;
+            result.mSlices.push_back(std::move(mSlices.front()));
+            mSlices.pop_front();
+        }
+
+        if (size > 0) {
+            BufferSlice& head = mSlices.front();
+
+            result.Push(head.Buffer, head.Offset, size, false);
+            head.Offset += size;
+            head.Size -= size;
+            mSize -= size;
+        }
+
+        return result;
+    }
+
+    void BufferChain::Consume(U32 size)
+    {
+        if (size > mSize) {
+            throw std::out_of_range("size is greater than the chain size");
+        }
+
+        mSize -= size;
+
+        while (size > 0) {
+            BufferSlice& head = mSlices.front();
+
+            if (size < head.Size) {
+                head.Offset += size;
+                head.Size -= size;
+                break;
+            }
+
+            size -= head.Size;
+            mSlices.pop_front();
+        }
+    }
+
+    void BufferChain::Clear() NOEXCEPT
+    {
+        mSlices.clear();
+        mSize = 0;
+    }
+
+    void BufferChain::CopyTo(Byte* target, U32 offset, U32 size) const
+    {
+        if (!target && size > 0) {
+            throw null_pointer("target points to NULL");
+        } else if (offset > mSize || size > mSize - offset) {
+            throw std::out_of_range("offset and size does not match chain size");
+        }
+
+        for (auto it = mSlices.begin(); it != mSlices.end() && size > 0; ++it) {
+            if (offset >= it->Size) {
+                offset -= it->Size;
+                continue;
+            }
+
+            U32 count = std::min(size, it->Size - offset);
+
+            memcpy(target, it->Data() + offset, count);
+            target += count;
+            offset = 0;
+            size -= count;
+        }
+    }
+
+    const Byte* BufferChain::Coalesce()
+    {
+        if (mSlices.size() > 1) {
+            BufferSlice slice;
+
+            slice.Buffer = BufferPool::Shared()->Lease(mSize);
+            slice.Size = mSize;
+            CopyTo(slice.Buffer.Data(), 0, mSize);
+            slice.Buffer.Size(mSize);
+            mSlices.clear();
+            mSlices.push_back(std::move(slice));
+        }
+
+        return mSlices.empty() ? nullptr : mSlices.front().Data();
+    }
+
+    U32 BufferChain::Segments(ByteSegment* segments, U32 count) const NOEXCEPT
+    {
+        U32 result = std::min(count, (U32)mSlices.size());
+
+        for (U32 i = 0; i < result; i++) {
+            segments[i].Data = mSlices[i].Data();
+            segments[i].Size = mSlices[i].Size;
+        }
+
+        return result;
+    }
+
+    void BufferChain::Grow(U32 size)
+    {
+        if (size > UINT32_MAX - mSize) {
+            throw std::length_error("chain exceeds the maximum size");
+        }
+    }
+
+    void BufferChain::Push(const PooledBuffer& buffer, U32 offset, U32 size, bool front)
+    {
+        if (size == 0) {
+            return;
+        }
+
+        // Aneinander grenzende Ausschnitte des selben Buffers werden
+        // zusammengelegt, bspw nach Split und erneutem Append.
+        if (!mSlices.empty()) {
+            BufferSlice& neighbour = front ? mSlices.front() : mSlices.back();
+
+            if (neighbour.Buffer.Data() == buffer.Data()) {
+                if (!front && neighbour.Offset + neighbour.Size == offset) {
+                    neighbour.Size += size;
+                    mSize += size;
+                    return;
+                } else if (front && offset + size == neighbour.Offset) {
+                    neighbour.Offset = offset;
+                    neighbour.Size += size;
+                    mSize += size;
+                    return;
+                }
+            }
+        }
+
+        BufferSlice slice;
+
+        slice.Buffer = buffer;
+        slice.Offset = offset;
+        slice.Size = size;
+
+        if (front) {
+            mSlices.push_front(std::move(slice));
+        } else {
+            mSlices.push_back(std::move(slice));
+        }
+
+        mSize += size;
+    }
+}
@@ -0,0 +1,384 @@
+﻿#include <Lupus/Memory/BufferPool.h>
+#include <Internal/Threading/ThreadSlot.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace Lupus {
+    namespace {
+        const U32 ClassCount = 3;
+        const U32 Unpooled = ClassCount;
+        const U32 ClassSizes[ClassCount] = { BufferPool::SmallSize, BufferPool::MediumSize, BufferPool::LargeSize };
+        const U32 SlabBlocks[ClassCount] = { 32, 8, 4 };
+
+        //! Größe des Headers vor den Daten, damit diese auf einer
+        //! Cache-Line beginnen.
+        const U32 HeaderSize = 64;
+
+        //! Maximale Anzahl an Threads mit eigenem Cache.
+        const U32 MaxCaches = Internal::MaxThreadSlots;
+
+        //! Maximale Anzahl an Buffern je Größenklasse im Cache eines Threads.
+        const U32 CacheCapacity = 32;
+
+        // Die oberen Bits des Listenkopfs zählen jede Entnahme mit. Zeiger im
+        // Benutzeradressraum belegen auf 64-Bit Systemen höchstens 48 Bits.
+        const U32 TagShift = (sizeof(void*) == 4) ? 32 : 48;
+        const U64 PointerMask = ((U64)1 << TagShift) - 1;
+
+        std::once_flag SharedFlag;
+        BufferPoolPtr* SharedPool = nullptr;
+
+        U32 GetClass(U32 size)
+        {
+            for (U32 i = 0; i < ClassCount; i++) {
+                if (size <= ClassSizes[i]) {
+                    return i;
+                }
+            }
+
+            return Unpooled;
+        }
+    }
+
+    namespace Internal {
+        //! Header eines Buffers. In der globalen Liste kennt der erste Block
+        //! eines Stapels die Anzahl seiner Blöcke und den nächsten Stapel.
+        struct BufferBlock
+        {
+            Atomic<U32> References;
+            U32 Class;
+            U32 Capacity;
+            U32 Size;
+            BufferPool* Pool;
+            BufferBlock* Next;
+            BufferBlock* NextBatch;
+            U32 Count;
+
+            Byte* Data()
+            {
+                return (Byte*)this + HeaderSize;
+            }
+        };
+
+        struct BufferCache
+        {
+            U32 Count[ClassCount];
+            BufferBlock* Blocks[ClassCount][CacheCapacity];
+            Byte Padding[64];
+        };
+    }
+
+    using Internal::BufferBlock;
+    using Internal::BufferCache;
+
+    PooledBuffer::PooledBuffer() NOEXCEPT
+    {
+    }
+
+    PooledBuffer::PooledBuffer(BufferBlock* block) NOEXCEPT :
+        mBlock(block)
+    {
+    }
+
+    PooledBuffer::PooledBuffer(const PooledBuffer& buffer) NOEXCEPT :
+        mBlock(buffer.mBlock)
+    {
+        if (mBlock) {
+            mBlock->References.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    PooledBuffer::PooledBuffer(PooledBuffer&& buffer) NOEXCEPT :
+        mBlock(buffer.mBlock)
+    {
+        buffer.mBlock = nullptr;
+    }
+
+    PooledBuffer::~PooledBuffer()
+    {
+        Reset();
+    }
+
+    PooledBuffer& PooledBuffer::operator=(const PooledBuffer& buffer) NOEXCEPT
+    {
+        if (buffer.mBlock) {
+            buffer.mBlock->References.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Reset();
+        mBlock = buffer.mBlock;
+        return *this;
+    }
+
+    PooledBuffer& PooledBuffer::operator=(PooledBuffer&& buffer) NOEXCEPT
+    {
+        if (this != &buffer) {
+            Reset();
+            mBlock = buffer.mBlock;
+            buffer.mBlock = nullptr;
+        }
+
+        return *this;
+    }
+
+    bool PooledBuffer::IsEmpty() const NOEXCEPT
+    {
+        return (mBlock == nullptr);
+    }
+
+    Byte* PooledBuffer::Data() const NOEXCEPT
+    {
+        return mBlock ? mBlock->Data() : nullptr;
+    }
+
+    U32 PooledBuffer::Capacity() const NOEXCEPT
+    {
+        return mBlock ? mBlock->Capacity : 0;
+    }
+
+    U32 PooledBuffer::Size() const NOEXCEPT
+    {
+        return mBlock ? mBlock->Size : 0;
+    }
+
+    void PooledBuffer::Size(U32 size)
+    {
+        if (size > Capacity()) {
+            throw std::out_of_range("size is greater than the capacity");
+        }
+
+        if (mBlock) {
+            mBlock->Size = size;
+        }
+    }
+
+    U32 PooledBuffer::References() const NOEXCEPT
+    {
+        return mBlock ? mBlock->References.load(std::memory_order_relaxed) : 0;
+    }
+
+    void PooledBuffer::Reset() NOEXCEPT
+    {
+        BufferBlock* block = mBlock;
+
+        mBlock = nullptr;
+
+        if (block && block->References.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            block->Pool->Return(block);
+        }
+    }
+
+    const U32 BufferPool::SmallSize;
+    const U32 BufferPool::MediumSize;
+    const U32 BufferPool::LargeSize;
+
+    BufferPool::BufferPool() :
+        mReserved(0)
+    {
+        for (U32 i = 0; i < ClassCount; i++) {
+            mReturned[i] = 0;
+        }
+
+        mCaches = new BufferCache[MaxCaches];
+        memset(mCaches, 0, sizeof(BufferCache) * MaxCaches);
+
+        try {
+            Internal::AttachSlotOwner(this, &BufferPool::ReleaseCache);
+        } catch (...) {
+            delete[] mCaches;
+            throw;
+        }
+    }
+
+    BufferPool::~BufferPool()
+    {
+        Internal::DetachSlotOwner(this);
+
+        for (Byte* slab : mSlabs) {
+            delete[] slab;
+        }
+
+        delete[] mCaches;
+    }
+
+    PooledBuffer BufferPool::Lease(U32 size)
+    {
+        U32 index = GetClass(size);
+        BufferBlock* block;
+
+        if (index == Unpooled) {
+            if (size > 0xFFFFFFFF - HeaderSize) {
+                throw std::length_error("size is too large");
+            }
+
+            block = new (new Byte[HeaderSize + size]) BufferBlock();
+            block->Class = Unpooled;
+            block->Capacity = size;
+            block->Pool = this;
+        } else {
+            BufferCache* cache = CurrentCache();
+
+            if (cache && cache->Count[index] > 0) {
+                block = cache->Blocks[index][--cache->Count[index]];
+            } else {
+                block = Refill(index, cache);
+            }
+        }
+
+        block->References.store(1, std::memory_order_relaxed);
+        block->Size = 0;
+        block->Next = nullptr;
+        return PooledBuffer(block);
+    }
+
+    U64 BufferPool::Reserved() const NOEXCEPT
+    {
+        return mReserved.load(std::memory_order_relaxed);
+    }
+
+    BufferPoolPtr BufferPool::Shared() NOEXCEPT
+    {
+        std::call_once(SharedFlag, []() {
+            // Der Pool lebt bis zum Prozessende, da seine Buffer in
+            // beliebigen Objekten gehalten werden können.
+            SharedPool = new BufferPoolPtr(new BufferPool());
+        });
+
+        return *SharedPool;
+    }
+
+    void BufferPool::Return(BufferBlock* block) NOEXCEPT
+    {
+        if (block->Class == Unpooled) {
+            delete[] (Byte*)block;
+            return;
+        }
+
+        BufferCache* cache = CurrentCache();
+        U32 index = block->Class;
+
+        if (!cache) {
+            block->Next = nullptr;
+            Push(index, block, 1);
+            return;
+        }
+
+        // Ein voller Cache gibt seine obere Hälfte als Stapel ab.
+        if (cache->Count[index] == CacheCapacity) {
+            cache->Count[index] -= CacheCapacity / 2;
+            Push(index, Link(&cache->Blocks[index][cache->Count[index]], CacheCapacity / 2), CacheCapacity / 2);
+        }
+
+        cache->Blocks[index][cache->Count[index]++] = block;
+    }
+
+    BufferBlock* BufferPool::Refill(U32 index, BufferCache* cache)
+    {
+        BufferBlock* batch = Pop(index);
+
+        if (!batch) {
+            LockGuard<Mutex> lock(mMutex);
+            const U32 stride = HeaderSize + ClassSizes[index];
+            const U32 count = SlabBlocks[index];
+            Byte* slab = new Byte[stride * count + HeaderSize];
+            Byte* base = (Byte*)(((UIntPtr)slab + HeaderSize - 1) & ~(UIntPtr)(HeaderSize - 1));
+
+            mSlabs.push_back(slab);
+            mReserved.fetch_add(stride * count + HeaderSize, std::memory_order_relaxed);
+
+            for (U32 i = count; i > 0; i--) {
+                BufferBlock* block = new (base + (i - 1) * stride) BufferBlock();
+
+                block->Class = index;
+                block->Capacity = ClassSizes[index];
+                block->Pool = this;
+                block->Next = batch;
+                batch = block;
+            }
+
+            batch->Count = count;
+        }
+
+        // Der erste Block geht an den Aufrufer, der Rest in den leeren
+        // Cache. Ohne Cache geht der Rest als Ganzes zurück.
+        BufferBlock* result = batch;
+        BufferBlock* rest = batch->Next;
+        U32 count = batch->Count - 1;
+
+        while (cache && count > 0 && cache->Count[index] < CacheCapacity) {
+            cache->Blocks[index][cache->Count[index]++] = rest;
+            rest = rest->Next;
+            count--;
+        }
+
+        if (count > 0) {
+            Push(index, rest, count);
+        }
+
+        return result;
+    }
+
+    BufferBlock* BufferPool::Pop(U32 index) NOEXCEPT
+    {
+        U64 head = mReturned[index].load(std::memory_order_acquire);
+
+        while (true) {
+            BufferBlock* top = (BufferBlock*)(UIntPtr)(head & PointerMask);
+
+            if (!top) {
+                return nullptr;
+            }
+
+            // Die Slabs werden nie vorzeitig freigegeben, ein veralteter
+            // Kopf kann daher gelesen werden. Der Zähler lässt den Tausch
+            // dann scheitern.
+            U64 next = (((head >> TagShift) + 1) << TagShift) | (UIntPtr)top->NextBatch;
+
+            if (mReturned[index].compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+                return top;
+            }
+        }
+    }
+
+    void BufferPool::Push(U32 index, BufferBlock* batch, U32 count) NOEXCEPT
+    {
+        U64 head = mReturned[index].load(std::memory_order_relaxed);
+
+        batch->Count = count;
+
+        do {
+            batch->NextBatch = (BufferBlock*)(UIntPtr)(head & PointerMask);
+        } while (!mReturned[index].compare_exchange_weak(head, (head & ~PointerMask) | (UIntPtr)batch, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    BufferBlock* BufferPool::Link(BufferBlock** blocks, U32 count) NOEXCEPT
+    {
+        for (U32 i = 0; i < count - 1; i++) {
+            blocks[i]->Next = blocks[i + 1];
+        }
+
+        blocks[count - 1]->Next = nullptr;
+        return blocks[0];
+    }
+
+    void BufferPool::ReleaseCache(void* owner, U32 slot) NOEXCEPT
+    {
+        BufferPool* pool = (BufferPool*)owner;
+        BufferCache* cache = &pool->mCaches[slot - 1];
+
+        for (U32 i = 0; i < ClassCount; i++) {
+            if (cache->Count[i] > 0) {
+                pool->Push(i, Link(cache->Blocks[i], cache->Count[i]), cache->Count[i]);
+                cache->Count[i] = 0;
+            }
+        }
+    }
+
+    BufferCache* BufferPool::CurrentCache() const NOEXCEPT
+    {
+        U32 slot = Internal::CurrentThreadSlot();
+
+        return (slot > 0) ? &mCaches[slot - 1] : nullptr;
+    }
+}
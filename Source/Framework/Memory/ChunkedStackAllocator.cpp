@@ -0,0 +1,165 @@
+﻿#include <Lupus/Memory/ChunkedStackAllocator.h>
+#include <algorithm>
+#include <new>
+
+namespace Lupus {
+    namespace {
+        //! Größe des Headers vor den Daten eines Blocks.
+        const size_t HeaderSize = 16;
+    }
+
+    namespace Internal {
+        struct StackChunk
+        {
+            //! Der darunter liegende Block bzw der nächste freie Block.
+            StackChunk* Previous;
+            size_t Size;
+
+            Byte* Data()
+            {
+                return (Byte*)this + HeaderSize;
+            }
+        };
+    }
+
+    using Internal::StackChunk;
+
+    ChunkedStackAllocator::ChunkedStackAllocator(U32 chunkBytes) :
+        mChunkSize(chunkBytes)
+    {
+        Grow(0, 1);
+    }
+
+    ChunkedStackAllocator::~ChunkedStackAllocator()
+    {
+        Trim();
+
+        while (mCurrent) {
+            StackChunk* previous = mCurrent->Previous;
+
+            delete[] (Byte*)mCurrent;
+            mCurrent = previous;
+        }
+    }
+
+    void* ChunkedStackAllocator::AllocateBytes(size_t bytes, size_t alignment)
+    {
+        void* ptr = (void*)mHead;
+        size_t space = mSize;
+
+        if (std::align(alignment, bytes, ptr, space)) {
+            mHead = (Byte*)ptr + bytes;
+            mSize = space - bytes;
+            return ptr;
+        }
+
+        return Grow(bytes, alignment);
+    }
+
+    UIntPtr ChunkedStackAllocator::GetMarker() const NOEXCEPT
+    {
+        return (UIntPtr)mHead;
+    }
+
+    void ChunkedStackAllocator::FreeToMarker(UIntPtr marker)
+    {
+        StackChunk* chunk = mCurrent;
+
+        // Die Markierung kann nur in einem Block unterhalb des Kopfes liegen.
+        while (chunk && (marker < (UIntPtr)chunk->Data() || marker > (UIntPtr)chunk->Data() + chunk->Size)) {
+            chunk = chunk->Previous;
+        }
+
+        if (!chunk) {
+            throw std::out_of_range("Given marker is out of range");
+        }
+
+        while (mCurrent != chunk) {
+            StackChunk* previous = mCurrent->Previous;
+
+            mCurrent->Previous = mFree;
+            mFree = mCurrent;
+            mCurrent = previous;
+        }
+
+        mHead = (Byte*)marker;
+        mSize = (size_t)(chunk->Data() + chunk->Size - mHead);
+    }
+
+    void ChunkedStackAllocator::Clear() NOEXCEPT
+    {
+        while (mCurrent->Previous) {
+            StackChunk* previous = mCurrent->Previous;
+
+            mCurrent->Previous = mFree;
+            mFree = mCurrent;
+            mCurrent = previous;
+        }
+
+        Enter(mCurrent);
+    }
+
+    void ChunkedStackAllocator::Trim() NOEXCEPT
+    {
+        while (mFree) {
+            StackChunk* next = mFree->Previous;
+
+            mReserved -= HeaderSize + mFree->Size;
+            mChunkCount--;
+            delete[] (Byte*)mFree;
+            mFree = next;
+        }
+    }
+
+    U64 ChunkedStackAllocator::Reserved() const NOEXCEPT
+    {
+        return mReserved;
+    }
+
+    U32 ChunkedStackAllocator::ChunkCount() const NOEXCEPT
+    {
+        return mChunkCount;
+    }
+
+    void* ChunkedStackAllocator::Grow(size_t bytes, size_t align)
+    {
+        const size_t needed = bytes + align - 1;
+        StackChunk** link = &mFree;
+
+        // Der erste freie Block der groß genug ist wird wiederverwendet.
+        while (*link && (*link)->Size < needed) {
+            link = &(*link)->Previous;
+        }
+
+        StackChunk* chunk = *link;
+
+        if (chunk) {
+            *link = chunk->Previous;
+        } else {
+            const size_t size = std::max<size_t>(mChunkSize, needed);
+
+            chunk = new (new Byte[HeaderSize + size]) StackChunk();
+            chunk->Size = size;
+            mReserved += HeaderSize + size;
+            mChunkCount++;
+        }
+
+        chunk->Previous = mCurrent;
+        Enter(chunk);
+
+        void* ptr = (void*)mHead;
+        size_t space = mSize;
+
+        std::align(align, bytes, ptr, space);
+        mHead = (Byte*)ptr + bytes;
+        mSize = space - bytes;
+        return ptr;
+    }
+
+    void ChunkedStackAllocator::Enter(StackChunk* chunk) NOEXCEPT
+    {
+        mCurrent = chunk;
+        mHead = chunk->Data();
+        mSize = chunk->Size;
+    }
+}
@@ -0,0 +1,62 @@
+﻿#include <Lupus/Memory/ConcurrentStackAllocator.h>
+
+namespace Lupus {
+    ConcurrentStackAllocator::ConcurrentStackAllocator(U32 maxBytes) NOEXCEPT :
+        mMaxSize(maxBytes),
+        mOffset(0)
+    {
+        // Der Kopf bleibt immer an Granularity ausgerichtet, daher muss es
+        // auch die Basis sein.
+        mStorage = new Byte[maxBytes + Granularity];
+        mBlock = (Byte*)(((UIntPtr)mStorage + Granularity - 1) & ~(UIntPtr)(Granularity - 1));
+    }
+
+    ConcurrentStackAllocator::~ConcurrentStackAllocator()
+    {
+        if (mStorage) {
+            delete[] mStorage;
+        }
+    }
+
+    UIntPtr ConcurrentStackAllocator::GetMarker() const NOEXCEPT
+    {
+        return (UIntPtr)mBlock + std::min<size_t>(mOffset.load(std::memory_order_relaxed), mMaxSize);
+    }
+
+    void ConcurrentStackAllocator::FreeToMarker(UIntPtr marker)
+    {
+        if (marker < (UIntPtr)mBlock || marker > (UIntPtr)mBlock + mMaxSize) {
+            throw std::out_of_range("Given marker is out of range");
+        }
+
+        mOffset.store((size_t)(marker - (UIntPtr)mBlock), std::memory_order_relaxed);
+    }
+
+    void ConcurrentStackAllocator::Clear() NOEXCEPT
+    {
+        mOffset.store(0, std::memory_order_relaxed);
+    }
+
+    void* ConcurrentStackAllocator::AllocateAligned(size_t bytes, size_t align) NOEXCEPT
+    {
+        size_t offset = mOffset.load(std::memory_order_relaxed);
+        UIntPtr start;
+        size_t end;
+
+        do {
+            if (offset > mMaxSize) {
+                return nullptr;
+            }
+
+            start = ((UIntPtr)mBlock + offset + align - 1) & ~(UIntPtr)(align - 1);
+            end = (size_t)(start - (UIntPtr)mBlock) + bytes;
+            end = (end + Granularity - 1) & ~(size_t)(Granularity - 1);
+
+            if (end > mMaxSize || end < offset) {
+                return nullptr;
+            }
+        } while (!mOffset.compare_exchange_weak(offset, end, std::memory_order_relaxed));
+
+        return (void*)start;
+    }
+}
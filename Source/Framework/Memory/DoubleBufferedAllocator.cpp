@@ -2,12 +2,24 @@
 #include <Lupus/Memory/StackAllocator.h>
 
 namespace Lupus {
-        DoubleBufferAllocator::DoubleBufferAllocator(U32 stackBytes)
+        DoubleBufferAllocator::DoubleBufferAllocator(U32 stackBytes) NOEXCEPT
         {
             mStackAllocator[0] = new StackAllocator(stackBytes);
             mStackAllocator[1] = new StackAllocator(stackBytes);
         }
 
+        DoubleBufferAllocator::DoubleBufferAllocator(U32 stackBytes, const MemoryBacking& backing)
+        {
+            mStackAllocator[0] = new StackAllocator(stackBytes, backing);
+
+            try {
+                mStackAllocator[1] = new StackAllocator(stackBytes, backing);
+            } catch (...) {
+                delete mStackAllocator[0];
+                throw;
+            }
+        }
+
         DoubleBufferAllocator::~DoubleBufferAllocator()
         {
             if (mStackAllocator[0]) {
@@ -21,13 +33,45 @@ namespace Lupus {
             }
         }
 
-        void DoubleBufferAllocator::Swap()
+        void DoubleBufferAllocator::Swap() NOEXCEPT
         {
+            mStackAllocator[mCurrent]->NextFrame();
             (++mCurrent) %= 2;
         }
 
-        void DoubleBufferAllocator::Clear()
+        void DoubleBufferAllocator::Clear() NOEXCEPT
         {
             mStackAllocator[mCurrent]->Clear();
         }
+
+        void* DoubleBufferAllocator::AllocateBytes(size_t bytes, size_t alignment) NOEXCEPT
+        {
+            return mStackAllocator[mCurrent]->AllocateBytes(bytes, alignment);
+        }
+
+        UIntPtr DoubleBufferAllocator::GetMarker() const NOEXCEPT
+        {
+            return mStackAllocator[mCurrent]->GetMarker();
+        }
+
+        void DoubleBufferAllocator::FreeToMarker(UIntPtr marker)
+        {
+            mStackAllocator[mCurrent]->FreeToMarker(marker);
+        }
+
+        AllocatorStatistics DoubleBufferAllocator::Statistics() const NOEXCEPT
+        {
+            AllocatorStatistics active = mStackAllocator[mCurrent]->Statistics();
+            AllocatorStatistics previous = mStackAllocator[(mCurrent + 1) % 2]->Statistics();
+            AllocatorStatistics result;
+
+            result.BytesInUse = active.BytesInUse + previous.BytesInUse;
+            result.FramePeak = active.FramePeak;
+            result.LastFramePeak = previous.LastFramePeak;
+            result.Peak = std::max(active.Peak, previous.Peak);
+            result.Allocations = active.Allocations + previous.Allocations;
+            result.Failures = active.Failures + previous.Failures;
+            result.AlignmentWaste = active.AlignmentWaste + previous.AlignmentWaste;
+            return result;
+        }
 }
@@ -0,0 +1,253 @@
+﻿#include <Lupus/Memory/PoolAllocator.h>
+#include <Internal/Threading/ThreadSlot.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Lupus {
+    namespace {
+        //! Maximale Anzahl an Threads mit eigenem Cache.
+        const U32 MaxCaches = Internal::MaxThreadSlots;
+
+        // Die oberen Bits des Listenkopfs zählen jede Entnahme mit. Zeiger im
+        // Benutzeradressraum belegen auf 64-Bit Systemen höchstens 48 Bits.
+        const U32 TagShift = (sizeof(void*) == 4) ? 32 : 48;
+        const U64 PointerMask = ((U64)1 << TagShift) - 1;
+    }
+
+    namespace Internal {
+        //! Freier Block. Der erste Block eines Magazins kennt die Anzahl
+        //! seiner Blöcke und das nächste Magazin in der globalen Liste.
+        struct PoolBlock
+        {
+            PoolBlock* Next;
+            PoolBlock* NextMagazine;
+            U32 Count;
+        };
+
+        struct PoolCache
+        {
+            PoolBlock* Loaded;
+            PoolBlock* Previous;
+            U32 LoadedCount;
+            U32 PreviousCount;
+            Byte Padding[64];
+        };
+    }
+
+    using Internal::PoolBlock;
+    using Internal::PoolCache;
+
+    const U32 FixedSizePool::CacheLineSize;
+    const U32 FixedSizePool::MagazineSize;
+    const U32 FixedSizePool::PageSize;
+
+    FixedSizePool::FixedSizePool(U32 blockSize, U32 alignment) :
+        mMagazines(0),
+        mReserved(0)
+    {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            throw std::invalid_argument("alignment must be a power of two");
+        }
+
+        mAlignment = std::max<U32>(alignment, (U32)std::alignment_of<PoolBlock>::value);
+        mBlockSize = std::max<U32>(blockSize, (U32)sizeof(PoolBlock));
+        mBlockSize = (mBlockSize + mAlignment - 1) & ~(mAlignment - 1);
+
+        mCaches = new PoolCache[MaxCaches];
+        memset(mCaches, 0, sizeof(PoolCache) * MaxCaches);
+
+        try {
+            Internal::AttachSlotOwner(this, &FixedSizePool::ReleaseCache);
+        } catch (...) {
+            delete[] mCaches;
+            throw;
+        }
+    }
+
+    FixedSizePool::~FixedSizePool()
+    {
+        Internal::DetachSlotOwner(this);
+
+        for (Byte* page : mPages) {
+            delete[] page;
+        }
+
+        delete[] mCaches;
+    }
+
+    void* FixedSizePool::AllocateBlock()
+    {
+        PoolCache* cache = CurrentCache();
+
+        if (!cache) {
+            PoolBlock* magazine = Pop();
+
+            if (!magazine) {
+                magazine = Refill();
+            }
+
+            if (magazine->Count > 1) {
+                Push(magazine->Next, magazine->Count - 1);
+            }
+
+            return magazine;
+        }
+
+        if (cache->LoadedCount == 0) {
+            if (cache->PreviousCount > 0) {
+                std::swap(cache->Loaded, cache->Previous);
+                std::swap(cache->LoadedCount, cache->PreviousCount);
+            } else {
+                PoolBlock* magazine = Pop();
+
+                if (!magazine) {
+                    magazine = Refill();
+                }
+
+                cache->Loaded = magazine;
+                cache->LoadedCount = magazine->Count;
+            }
+        }
+
+        PoolBlock* block = cache->Loaded;
+
+        cache->Loaded = block->Next;
+        cache->LoadedCount--;
+        return block;
+    }
+
+    void FixedSizePool::FreeBlock(void* block) NOEXCEPT
+    {
+        if (!block) {
+            return;
+        }
+
+        PoolBlock* freed = (PoolBlock*)block;
+        PoolCache* cache = CurrentCache();
+
+        if (!cache) {
+            Push(freed, 1);
+            return;
+        }
+
+        // Das zweite Magazin ist immer voll oder leer. Erst wenn beide voll
+        // sind geht eines an die globale Liste.
+        if (cache->LoadedCount == MagazineSize) {
+            if (cache->PreviousCount == MagazineSize) {
+                Push(cache->Previous, MagazineSize);
+            }
+
+            cache->Previous = cache->Loaded;
+            cache->PreviousCount = cache->LoadedCount;
+            cache->LoadedCount = 0;
+        }
+
+        freed->Next = cache->Loaded;
+        cache->Loaded = freed;
+        cache->LoadedCount++;
+    }
+
+    U32 FixedSizePool::BlockSize() const NOEXCEPT
+    {
+        return mBlockSize;
+    }
+
+    U64 FixedSizePool::Reserved() const NOEXCEPT
+    {
+        return mReserved.load(std::memory_order_relaxed);
+    }
+
+    PoolBlock* FixedSizePool::Refill()
+    {
+        const U32 size = std::max<U32>(PageSize, mBlockSize * MagazineSize) + mAlignment;
+        Byte* page;
+
+        {
+            LockGuard<Mutex> lock(mMutex);
+
+            page = new Byte[size];
+            mPages.push_back(page);
+        }
+
+        mReserved.fetch_add(size, std::memory_order_relaxed);
+
+        Byte* base = (Byte*)(((UIntPtr)page + mAlignment - 1) & ~(UIntPtr)(mAlignment - 1));
+        U32 count = (U32)((page + size - base) / mBlockSize);
+        PoolBlock* result = nullptr;
+
+        // Die Seite wird in Magazine zerlegt, das erste erhält der Aufrufer.
+        for (U32 first = 0; first < count; first += MagazineSize) {
+            U32 blocks = std::min(count - first, MagazineSize);
+            PoolBlock* magazine = (PoolBlock*)(base + (size_t)first * mBlockSize);
+
+            for (U32 i = 0; i < blocks - 1; i++) {
+                ((PoolBlock*)(base + (size_t)(first + i) * mBlockSize))->Next = (PoolBlock*)(base + (size_t)(first + i + 1) * mBlockSize);
+            }
+
+            if (!result) {
+                result = magazine;
+                result->Count = blocks;
+            } else {
+                Push(magazine, blocks);
+            }
+        }
+
+        return result;
+    }
+
+    PoolBlock* FixedSizePool::Pop() NOEXCEPT
+    {
+        U64 head = mMagazines.load(std::memory_order_acquire);
+
+        while (true) {
+            PoolBlock* top = (PoolBlock*)(UIntPtr)(head & PointerMask);
+
+            if (!top) {
+                return nullptr;
+            }
+
+            // Die Seiten werden nie vorzeitig freigegeben, ein veralteter
+            // Kopf kann daher gelesen werden. Der Zähler lässt den Tausch
+            // dann scheitern.
+            U64 next = (((head >> TagShift) + 1) << TagShift) | (UIntPtr)top->NextMagazine;
+
+            if (mMagazines.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+                return top;
+            }
+        }
+    }
+
+    void FixedSizePool::Push(PoolBlock* magazine, U32 count) NOEXCEPT
+    {
+        U64 head = mMagazines.load(std::memory_order_relaxed);
+
+        magazine->Count = count;
+
+        do {
+            magazine->NextMagazine = (PoolBlock*)(UIntPtr)(head & PointerMask);
+        } while (!mMagazines.compare_exchange_weak(head, (head & ~PointerMask) | (UIntPtr)magazine, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void FixedSizePool::ReleaseCache(void* owner, U32 slot) NOEXCEPT
+    {
+        FixedSizePool* pool = (FixedSizePool*)owner;
+        PoolCache* cache = &pool->mCaches[slot - 1];
+
+        if (cache->LoadedCount > 0) {
+            pool->Push(cache->Loaded, cache->LoadedCount);
+        }
+
+        if (cache->PreviousCount > 0) {
+            pool->Push(cache->Previous, cache->PreviousCount);
+        }
+
+        memset(cache, 0, sizeof(PoolCache));
+    }
+
+    PoolCache* FixedSizePool::CurrentCache() const NOEXCEPT
+    {
+        U32 slot = Internal::CurrentThreadSlot();
+
+        return (slot > 0) ? &mCaches[slot - 1] : nullptr;
+    }
+}
@@ -1,20 +1,48 @@
 ﻿#include <Lupus/Memory/StackAllocator.h>
+#include <Internal/Memory/PageMemory.h>
 
 namespace Lupus {
-    StackAllocator::StackAllocator(U32 maxBytes)
+    StackAllocator::StackAllocator(U32 maxBytes) NOEXCEPT
     {
         mMaxSize = mSize = maxBytes;
         mHead = mBlock = new Byte[maxBytes];
     }
 
+    StackAllocator::StackAllocator(U32 maxBytes, const MemoryBacking& backing)
+    {
+        mMaxSize = mSize = maxBytes;
+        mHead = mBlock = Internal::AllocatePages(maxBytes, backing, mReserved);
+    }
+
     StackAllocator::~StackAllocator()
     {
-        if (mBlock) {
+        if (mBlock && mReserved > 0) {
+            Internal::FreePages(mBlock, mReserved);
+        } else if (mBlock) {
             delete[] mBlock;
         }
     }
 
-    UIntPtr StackAllocator::GetMarker() const
+    void* StackAllocator::AllocateBytes(size_t bytes, size_t alignment) NOEXCEPT
+    {
+        void* ptr = (void*)mHead;
+
+        if (std::align(alignment, bytes, ptr, mSize)) {
+#ifdef LUPUS_ALLOCATOR_STATISTICS
+            mStatistics.Allocated(mMaxSize - mSize + bytes, (U64)((Byte*)ptr - mHead));
+#endif
+            mHead = (Byte*)ptr + bytes;
+            mSize -= bytes;
+            return ptr;
+        }
+
+#ifdef LUPUS_ALLOCATOR_STATISTICS
+        mStatistics.Failed();
+#endif
+        return nullptr;
+    }
+
+    UIntPtr StackAllocator::GetMarker() const NOEXCEPT
     {
         return (UIntPtr)mHead;
     }
@@ -27,11 +55,30 @@ namespace Lupus {
 
         Byte* head = mHead;
         mHead = (Byte*)marker;
-        mSize += (U32)(head - mHead);
+        mSize += (size_t)(head - mHead);
+#ifdef LUPUS_ALLOCATOR_STATISTICS
+        mStatistics.Released(mMaxSize - mSize);
+#endif
     }
 
-    void StackAllocator::Clear()
+    void StackAllocator::Clear() NOEXCEPT
     {
         mHead = mBlock;
+        mSize = mMaxSize;
+#ifdef LUPUS_ALLOCATOR_STATISTICS
+        mStatistics.Released(0);
+#endif
+    }
+
+    void StackAllocator::NextFrame() NOEXCEPT
+    {
+#ifdef LUPUS_ALLOCATOR_STATISTICS
+        mStatistics.NextFrame();
+#endif
+    }
+
+    AllocatorStatistics StackAllocator::Statistics() const NOEXCEPT
+    {
+        return mStatistics.Snapshot();
     }
 }
@@ -0,0 +1,528 @@
+﻿#include <Lupus/Network/DatagramBatcher.h>
+#include <Lupus/Network/EndPoint.h>
+#include <Lupus/Network/Socket.h>
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
+namespace Lupus {
+    namespace Internal {
+        //! Vergleichbare Teile einer Socketadresse, ohne Füllbytes.
+        struct AddressKey
+        {
+            Byte Data[sizeof(AddrStorage)];
+            U32 Length;
+            U64 Hash;
+        };
+
+        struct BatchPeer
+        {
+            AddrStorage Address;
+            U32 Length;
+            AddressKey Key;
+            bool Active;
+        };
+
+        struct BatchMessage
+        {
+            U32 Peer;
+            Byte* Data;
+            U32 Size;
+        };
+
+        struct BatchState
+        {
+            Deque<BatchPeer> Peers;
+            std::unordered_multimap<U64, U32> Lookup;
+            Vector<BatchMessage> Outgoing;
+            AddrStorage Senders[DatagramBatcher::BatchSize];
+            AddrLength Lengths[DatagramBatcher::BatchSize];
+            U32 Sizes[DatagramBatcher::BatchSize];
+#ifdef __linux__
+            mmsghdr Headers[DatagramBatcher::BatchSize];
+            iovec Buffers[DatagramBatcher::BatchSize];
+#endif
+        };
+    }
+
+    using Internal::AddressKey;
+    using Internal::BatchMessage;
+    using Internal::BatchPeer;
+    using Internal::BatchState;
+
+    namespace {
+        void Append(AddressKey& key, const void* data, size_t size)
+        {
+            memcpy(key.Data + key.Length, data, size);
+            key.Length += (U32)size;
+        }
+
+        // Empfangene Adressen unterscheiden sich von serialisierten
+        // Endpunkten unter Umständen in den Füllbytes.
+        void MakeKey(const Byte* address, U32 length, AddressKey& key)
+        {
+            const Addr* addr = (const Addr*)address;
+
+            key.Length = 0;
+
+            if (addr->sa_family == AF_INET && length >= sizeof(AddrIn)) {
+                const AddrIn* in = (const AddrIn*)address;
+
+                Append(key, &in->sin_family, sizeof(in->sin_family));
+                Append(key, &in->sin_port, sizeof(in->sin_port));
+                Append(key, &in->sin_addr, sizeof(in->sin_addr));
+            } else if (addr->sa_family == AF_INET6 && length >= sizeof(AddrIn6)) {
+                const AddrIn6* in6 = (const AddrIn6*)address;
+
+                Append(key, &in6->sin6_family, sizeof(in6->sin6_family));
+                Append(key, &in6->sin6_port, sizeof(in6->sin6_port));
+                Append(key, &in6->sin6_addr, sizeof(in6->sin6_addr));
+                Append(key, &in6->sin6_scope_id, sizeof(in6->sin6_scope_id));
+            } else {
+                Append(key, address, std::min<size_t>(length, sizeof(AddrStorage)));
+            }
+
+            // FNV-1a
+            key.Hash = 14695981039346656037ULL;
+
+            for (U32 i = 0; i < key.Length; i++) {
+                key.Hash = (key.Hash ^ key.Data[i]) * 1099511628211ULL;
+            }
+        }
+
+        bool IsWouldBlock()
+        {
+#ifdef _MSC_VER
+            return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+        }
+
+        // Fehler die nur das aktuelle Datagramm betreffen, bspw eine zu
+        // große Nachricht oder eine unerreichbare Gegenstelle. Die übrigen
+        // Datagramme können trotzdem gesendet werden.
+        bool IsDatagramError()
+        {
+#ifdef _MSC_VER
+            switch (WSAGetLastError()) {
+                case WSAEMSGSIZE:
+                case WSAEHOSTUNREACH:
+                case WSAENETUNREACH:
+                case WSAECONNRESET:
+                case WSAEACCES:
+                case WSAEADDRNOTAVAIL:
+                case WSAEAFNOSUPPORT:
+                    return true;
+
+                default:
+                    return false;
+            }
+#else
+            switch (errno) {
+                case EMSGSIZE:
+                case EHOSTUNREACH:
+                case ENETUNREACH:
+                case ECONNREFUSED:
+                case EACCES:
+                case EPERM:
+                case EINVAL:
+                case EADDRNOTAVAIL:
+                case EAFNOSUPPORT:
+                    return true;
+
+                default:
+                    return false;
+            }
+#endif
+        }
+
+        // Empfängt bis zu count Datagramme in aufeinander folgende Slots.
+        // Retouniert die Anzahl oder SOCKET_ERROR wenn nichts empfangen
+        // wurde.
+        S32 ReceiveBatch(SocketHandle handle, BatchState& state, Byte* block, U32 slotSize, U32 count, U64& calls)
+        {
+#ifdef __linux__
+            for (U32 i = 0; i < count; i++) {
+                state.Buffers[i].iov_base = block + (size_t)i * slotSize;
+                state.Buffers[i].iov_len = slotSize;
+                memset(&state.Headers[i], 0, sizeof(mmsghdr));
+                state.Headers[i].msg_hdr.msg_name = &state.Senders[i];
+                state.Headers[i].msg_hdr.msg_namelen = sizeof(AddrStorage);
+                state.Headers[i].msg_hdr.msg_iov = &state.Buffers[i];
+                state.Headers[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            calls++;
+            int result = recvmmsg(handle, state.Headers, count, MSG_DONTWAIT, nullptr);
+
+            for (int i = 0; i < result; i++) {
+                state.Sizes[i] = state.Headers[i].msg_len;
+                state.Lengths[i] = state.Headers[i].msg_hdr.msg_namelen;
+            }
+
+            return (S32)result;
+#else
+            U32 received = 0;
+
+            while (received < count) {
+                AddrLength length = sizeof(AddrStorage);
+
+                calls++;
+                int result = recvfrom(handle, (char*)block + (size_t)received * slotSize, (int)slotSize, 0, (Addr*)&state.Senders[received], &length);
+
+#ifdef _MSC_VER
+                // Ein ICMP Port Unreachable einer früheren Sendung wird unter
+                // Windows als Fehler des nächsten Empfangs gemeldet.
+                if (result < 0 && WSAGetLastError() == WSAECONNRESET) {
+                    continue;
+                } else if (result < 0 && WSAGetLastError() == WSAEMSGSIZE) {
+                    result = (int)slotSize;
+                }
+#endif
+
+                if (result < 0) {
+                    return (received > 0) ? (S32)received : SOCKET_ERROR;
+                }
+
+                state.Sizes[received] = (U32)result;
+                state.Lengths[received] = length;
+                received++;
+            }
+
+            return (S32)received;
+#endif
+        }
+
+        // Sendet bis zu count Datagramme ab first. Retouniert die Anzahl
+        // oder SOCKET_ERROR wenn nichts gesendet wurde.
+        S32 SendBatch(SocketHandle handle, BatchState& state, U32 first, U32 count, U64& calls)
+        {
+#ifdef __linux__
+            for (U32 i = 0; i < count; i++) {
+                const BatchMessage& message = state.Outgoing[first + i];
+                BatchPeer& peer = state.Peers[message.Peer];
+
+                state.Buffers[i].iov_base = message.Data;
+                state.Buffers[i].iov_len = message.Size;
+                memset(&state.Headers[i], 0, sizeof(mmsghdr));
+                state.Headers[i].msg_hdr.msg_name = &peer.Address;
+                state.Headers[i].msg_hdr.msg_namelen = (socklen_t)peer.Length;
+                state.Headers[i].msg_hdr.msg_iov = &state.Buffers[i];
+                state.Headers[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            calls++;
+            return (S32)sendmmsg(handle, state.Headers, count, 0);
+#else
+            U32 sent = 0;
+
+            for (; sent < count; sent++) {
+                const BatchMessage& message = state.Outgoing[first + sent];
+                const BatchPeer& peer = state.Peers[message.Peer];
+
+                calls++;
+
+                if (sendto(handle, (const char*)message.Data, (int)message.Size, 0, (const Addr*)&peer.Address, (AddrLength)peer.Length) < 0) {
+                    return (sent > 0) ? (S32)sent : SOCKET_ERROR;
+                }
+            }
+
+            return (S32)sent;
+#endif
+        }
+    }
+
+    const U32 DatagramBatcher::InvalidPeer;
+    const U32 DatagramBatcher::BatchSize;
+
+    DatagramBatcher::DatagramBatcher(Pointer<Socket> socket, U32 frameBytes, U32 maxDatagrams, U32 maxDatagramSize) :
+        mSocket(socket),
+        mArena(frameBytes),
+        mMaxDatagrams(maxDatagrams)
+    {
+        if (!socket) {
+            throw null_pointer("socket points to NULL");
+        } else if (socket->Type() != SocketType::Datagram) {
+            throw std::invalid_argument("socket is not a datagram socket");
+        } else if (maxDatagrams == 0 || maxDatagramSize == 0) {
+            throw std::invalid_argument("maxDatagrams and maxDatagramSize must not be zero");
+        }
+
+        mMaxDatagramSize = maxDatagramSize;
+        mSlotSize = (maxDatagramSize + 7) & ~7U;
+        mSocket->Blocking(false);
+        mReceived.reserve(maxDatagrams);
+        mState = new BatchState();
+        mState->Outgoing.reserve(maxDatagrams);
+    }
+
+    DatagramBatcher::~DatagramBatcher()
+    {
+        delete mState;
+    }
+
+    U32 DatagramBatcher::AddPeer(Pointer<EndPoint> endPoint)
+    {
+        if (!endPoint) {
+            throw null_pointer("endPoint points to NULL");
+        }
+
+        Vector<Byte> address = endPoint->Serialize();
+
+        return Register(address.data(), endPoint->Length());
+    }
+
+    U32 DatagramBatcher::AddPeer(const Datagram& datagram)
+    {
+        if (!datagram.Address) {
+            throw std::invalid_argument("datagram has no sender address");
+        }
+
+        return Register(datagram.Address, datagram.Length);
+    }
+
+    void DatagramBatcher::RemovePeer(U32 peer) NOEXCEPT
+    {
+        if (peer >= mState->Peers.size() || !mState->Peers[peer].Active) {
+            return;
+        }
+
+        auto range = mState->Lookup.equal_range(mState->Peers[peer].Key.Hash);
+
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == peer) {
+                mState->Lookup.erase(it);
+                break;
+            }
+        }
+
+        mState->Peers[peer].Active = false;
+    }
+
+    Byte* DatagramBatcher::Write(U32 peer, U32 size)
+    {
+        if (peer >= mState->Peers.size() || !mState->Peers[peer].Active) {
+            throw std::out_of_range("peer is not registered");
+        } else if (size > mMaxDatagramSize) {
+            throw std::out_of_range("size is greater than the maximum datagram size");
+        } else if (mState->Outgoing.size() >= mMaxDatagrams) {
+            return nullptr;
+        }
+
+        Byte* data = (Byte*)mArena.AllocateBytes(size, 8);
+
+        if (data) {
+            BatchMessage message = { peer, data, size };
+            mState->Outgoing.push_back(message);
+        }
+
+        return data;
+    }
+
+    bool DatagramBatcher::Send(U32 peer, const Byte* data, U32 size)
+    {
+        Byte* target = Write(peer, size);
+
+        if (!target) {
+            return false;
+        }
+
+        memcpy(target, data, size);
+        return true;
+    }
+
+    U32 DatagramBatcher::Receive()
+    {
+        U32 received = 0;
+
+        while (mReceived.size() < mMaxDatagrams) {
+            U32 count = std::min<U32>(BatchSize, mMaxDatagrams - (U32)mReceived.size());
+            UIntPtr marker = mArena.GetMarker();
+            Byte* block = nullptr;
+
+            while (count > 0 && !(block = (Byte*)mArena.AllocateBytes((size_t)count * mSlotSize, 8))) {
+                count /= 2;
+            }
+
+            if (!block) {
+                break;
+            }
+
+            S32 result = ReceiveBatch(mSocket->Handle(), *mState, block, mSlotSize, count, mSystemCalls);
+
+            if (result <= 0) {
+                mArena.FreeToMarker(marker);
+
+                if (result < 0 && !IsWouldBlock()) {
+                    throw socket_error(GetLastSocketErrorString);
+                }
+
+                break;
+            }
+
+            // Nur die belegten Slots bleiben im Frame.
+            mArena.FreeToMarker((UIntPtr)block + (UIntPtr)result * mSlotSize);
+
+            for (S32 i = 0; i < result; i++) {
+                const Byte* sender = (const Byte*)&mState->Senders[i];
+                Datagram datagram;
+
+                datagram.Data = block + (size_t)i * mSlotSize;
+                datagram.Size = mState->Sizes[i];
+                datagram.Peer = FindPeer(sender, (U32)mState->Lengths[i]);
+
+                if (datagram.Peer != InvalidPeer) {
+                    datagram.Address = (const Byte*)&mState->Peers[datagram.Peer].Address;
+                    datagram.Length = mState->Peers[datagram.Peer].Length;
+                } else if (Byte* copy = (Byte*)mArena.AllocateBytes(mState->Lengths[i], 8)) {
+                    memcpy(copy, sender, mState->Lengths[i]);
+                    datagram.Address = copy;
+                    datagram.Length = (U32)mState->Lengths[i];
+                }
+
+                mReceived.push_back(datagram);
+            }
+
+            received += (U32)result;
+
+            if ((U32)result < count) {
+                break;
+            }
+        }
+
+        return received;
+    }
+
+    const Vector<Datagram>& DatagramBatcher::Received() const NOEXCEPT
+    {
+        return mReceived;
+    }
+
+    U32 DatagramBatcher::Flush()
+    {
+        Vector<BatchMessage>& outgoing = mState->Outgoing;
+        const char* error = nullptr;
+        U32 position = 0;
+        U32 sent = 0;
+
+        while (position < outgoing.size()) {
+            U32 count = std::min<U32>(BatchSize, (U32)outgoing.size() - position);
+            S32 result = SendBatch(mSocket->Handle(), *mState, position, count, mSystemCalls);
+
+            if (result > 0) {
+                position += (U32)result;
+                sent += (U32)result;
+            } else if (result < 0 && IsDatagramError()) {
+                // Das erste Datagramm des Batches wurde abgelehnt, der Rest
+                // folgt mit dem nächsten Aufruf.
+                position++;
+                mDropped++;
+            } else {
+                if (result < 0 && !IsWouldBlock()) {
+                    error = GetLastSocketErrorString;
+                }
+
+                break;
+            }
+        }
+
+        outgoing.erase(outgoing.begin(), outgoing.begin() + position);
+
+        if (error) {
+            throw socket_error(error);
+        }
+
+        return sent;
+    }
+
+    U32 DatagramBatcher::Tick()
+    {
+        U32 sent;
+
+        try {
+            sent = Flush();
+        } catch (...) {
+            EndFrame();
+            throw;
+        }
+
+        EndFrame();
+        return sent;
+    }
+
+    U32 DatagramBatcher::Pending() const NOEXCEPT
+    {
+        return (U32)mState->Outgoing.size();
+    }
+
+    U64 DatagramBatcher::Dropped() const NOEXCEPT
+    {
+        return mDropped;
+    }
+
+    U64 DatagramBatcher::SystemCalls() const NOEXCEPT
+    {
+        return mSystemCalls;
+    }
+
+    const DoubleBufferAllocator& DatagramBatcher::Arena() const NOEXCEPT
+    {
+        return mArena;
+    }
+
+    void DatagramBatcher::EndFrame() NOEXCEPT
+    {
+        mArena.Swap();
+        mArena.Clear();
+        mState->Outgoing.clear();
+        mReceived.clear();
+    }
+
+    U32 DatagramBatcher::Register(const Byte* address, U32 length)
+    {
+        if (length == 0 || length > sizeof(AddrStorage)) {
+            throw std::invalid_argument("invalid socket address");
+        }
+
+        U32 existing = FindPeer(address, length);
+
+        if (existing != InvalidPeer) {
+            return existing;
+        }
+
+        BatchPeer peer;
+        U32 id = (U32)mState->Peers.size();
+
+        memset(&peer.Address, 0, sizeof(AddrStorage));
+        memcpy(&peer.Address, address, length);
+        peer.Length = length;
+        peer.Active = true;
+        MakeKey(address, length, peer.Key);
+        mState->Peers.push_back(peer);
+        mState->Lookup.insert(std::make_pair(peer.Key.Hash, id));
+        return id;
+    }
+
+    U32 DatagramBatcher::FindPeer(const Byte* address, U32 length) const NOEXCEPT
+    {
+        AddressKey key;
+
+        MakeKey(address, length, key);
+
+        auto range = mState->Lookup.equal_range(key.Hash);
+
+        for (auto it = range.first; it != range.second; ++it) {
+            const AddressKey& other = mState->Peers[it->second].Key;
+
+            if (other.Length == key.Length && memcmp(other.Data, key.Data, key.Length) == 0) {
+                return it->second;
+            }
+        }
+
+        return InvalidPeer;
+    }
+}
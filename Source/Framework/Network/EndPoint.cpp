@@ -0,0 +1,24 @@
+﻿#include <Lupus/Network/EndPoint.h>
+#include <Lupus/Network/IPEndPoint.h>
+#include <Lupus/Network/UnixEndPoint.h>
+
+namespace Lupus {
+    EndPointPtr EndPoint::Create(const Vector<Byte>& buffer, U32 length)
+    {
+        if (buffer.size() != sizeof(AddrStorage)) {
+            throw std::invalid_argument("buffer contains invalid data");
+        }
+
+        switch (((const AddrStorage*)buffer.data())->ss_family) {
+            case AF_INET:
+            case AF_INET6:
+                return IPEndPointPtr(new IPEndPoint(buffer));
+
+            case AF_UNIX:
+                return UnixEndPointPtr(new UnixEndPoint(buffer, length));
+
+            default:
+                throw std::invalid_argument("buffer contains an unsupported address family");
+        }
+    }
+}
@@ -0,0 +1,607 @@
+﻿#include <Lupus/Network/EventLoop.h>
+#include <Lupus/Network/Socket.h>
+#include <Lupus/Network/SendQueue.h>
+#include <Lupus/Network/TimerWheel.h>
+#include <Lupus/Threading/Scheduler.h>
+#include <cstring>
+
+namespace Lupus {
+    namespace {
+        static const U32 DeadlineCount = 3;
+
+        std::once_flag SharedFlag;
+        EventLoopPtr* SharedLoop = nullptr;
+    }
+
+    struct EventLoop::Connection
+    {
+        Pointer<Socket> Target;
+        SocketHandle Handle;
+        Handler Callback;
+        SocketPollFlags Requested;
+        SocketPollFlags Events;
+        Pointer<SendQueue> Queue;
+        bool Busy;
+        U32 Limits[DeadlineCount];
+        U64 Activity[DeadlineCount];
+        Timer Timers[DeadlineCount];
+    };
+
+    EventLoop::EventLoop() :
+        mTimers(new TimerWheel()),
+        mStart(std::chrono::steady_clock::now()),
+        mWakePending(false),
+        mSubmitted(nullptr),
+        mStopped(false),
+        mThread(std::thread::id())
+    {
+        Socket::CreatePair(SocketType::Stream, mWakeRead, mWakeWrite);
+        mWakeRead->Blocking(false);
+        mWakeWrite->Blocking(false);
+
+        pollfd fd = { mWakeRead->Handle(), LU_POLLIN, 0 };
+        Pointer<Connection> entry(new Connection());
+
+        entry->Target = mWakeRead;
+        entry->Handle = mWakeRead->Handle();
+        entry->Requested = SocketPollFlags::Read;
+        entry->Events = SocketPollFlags::Read;
+        entry->Busy = false;
+        mPollDescriptors.push_back(fd);
+        mEntries.push_back(entry);
+        mIndices[mWakeRead->Handle()] = 0;
+    }
+
+    EventLoop::~EventLoop()
+    {
+        for (const Pointer<Connection>& entry : mEntries) {
+            if (entry->Queue) {
+                entry->Queue->Close();
+            }
+        }
+    }
+
+    void EventLoop::Add(Pointer<Socket> socket, SocketPollFlags events, Handler handler)
+    {
+        if (!socket) {
+            throw null_pointer("socket points to NULL");
+        } else if (mIndices.find(socket->Handle()) != std::end(mIndices)) {
+            throw std::invalid_argument("socket is already registered");
+        }
+
+        pollfd fd = { socket->Handle(), (short)events, 0 };
+        Pointer<Connection> entry(new Connection());
+
+        entry->Target = socket;
+        entry->Handle = socket->Handle();
+        entry->Callback = handler;
+        entry->Requested = events;
+        entry->Events = events;
+        entry->Busy = false;
+        memset(entry->Limits, 0, sizeof(entry->Limits));
+        memset(entry->Activity, 0, sizeof(entry->Activity));
+
+        mIndices[socket->Handle()] = (U32)mEntries.size();
+        mPollDescriptors.push_back(fd);
+        mEntries.push_back(entry);
+        Update(*entry);
+    }
+
+    void EventLoop::Modify(Pointer<Socket> socket, SocketPollFlags events)
+    {
+        auto it = socket ? mIndices.find(socket->Handle()) : std::end(mIndices);
+
+        if (it == std::end(mIndices) || it->second == 0) {
+            throw std::invalid_argument("socket is not registered");
+        }
+
+        mEntries[it->second]->Requested = events;
+        Update(*mEntries[it->second]);
+    }
+
+    void EventLoop::Remove(Pointer<Socket> socket) NOEXCEPT
+    {
+        auto it = socket ? mIndices.find(socket->Handle()) : std::end(mIndices);
+
+        if (it == std::end(mIndices) || it->second == 0) {
+            return;
+        }
+
+        // Der letzte Eintrag rückt an die freie Stelle.
+        U32 index = it->second;
+        U32 last = (U32)mEntries.size() - 1;
+
+        // Bereits gesammelte Fristen verwirft RunExpired.
+        for (Timer& timer : mEntries[index]->Timers) {
+            mTimers->Stop(timer);
+        }
+
+        // Eine angemeldete Warteschlange bleibt bis RunQueues bestehen.
+        if (Pointer<SendQueue> queue = mEntries[index]->Queue) {
+            if (queue->Close()) {
+                mRetired[queue.get()] = queue;
+            }
+
+            queue->Discard();
+        }
+
+        mIndices.erase(it);
+
+        if (index != last) {
+            mPollDescriptors[index] = mPollDescriptors[last];
+            mEntries[index] = mEntries[last];
+            mIndices[mEntries[index]->Handle] = index;
+        }
+
+        mPollDescriptors.pop_back();
+        mEntries.pop_back();
+    }
+
+    U32 EventLoop::Deadline(Pointer<Socket> socket, SocketDeadline type) const
+    {
+        return Find(socket)->Limits[(U32)type];
+    }
+
+    void EventLoop::Deadline(Pointer<Socket> socket, SocketDeadline type, U32 milliSeconds)
+    {
+        Pointer<Connection> connection = Find(socket);
+
+        connection->Limits[(U32)type] = milliSeconds;
+        Arm(*connection, type, Now());
+    }
+
+    Pointer<SendQueue> EventLoop::Queue(Pointer<Socket> socket)
+    {
+        Pointer<Connection> connection = Find(socket);
+
+        if (!connection->Queue) {
+            connection->Queue = SendQueuePtr(new SendQueue(this, socket));
+        }
+
+        return connection->Queue;
+    }
+
+    Pointer<Scheduler> EventLoop::Dispatcher() const NOEXCEPT
+    {
+        return mDispatcher;
+    }
+
+    void EventLoop::Dispatcher(Pointer<Scheduler> scheduler) NOEXCEPT
+    {
+        mDispatcher = scheduler;
+    }
+
+    void EventLoop::Expired(ExpiredHandler handler) NOEXCEPT
+    {
+        mExpiredHandler = handler;
+    }
+
+    U32 EventLoop::Count() const NOEXCEPT
+    {
+        return (U32)mEntries.size() - 1;
+    }
+
+    U64 EventLoop::Now() const NOEXCEPT
+    {
+        return (U64)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mStart).count();
+    }
+
+    Pointer<TimerWheel> EventLoop::Timers() const NOEXCEPT
+    {
+        return mTimers;
+    }
+
+    void EventLoop::Post(Function<void()> task)
+    {
+        {
+            LockGuard<Mutex> lock(mMutex);
+            mPosted.push_back(task);
+        }
+
+        Wake();
+    }
+
+    void EventLoop::Schedule(U64 milliSeconds, Function<void()> callback)
+    {
+        if (mThread.load() == std::this_thread::get_id()) {
+            // Das Rad steht seit dem letzten Advance, die Wartezeit beginnt
+            // aber jetzt.
+            mTimers->Schedule(milliSeconds + (Now() - mTimers->Now()), callback);
+            return;
+        }
+
+        // Die Wartezeit beginnt beim Aufruf und nicht erst im Thread der
+        // Schleife.
+        U64 due = Now() + milliSeconds;
+
+        Post([this, due, callback]() {
+            U64 wheel = mTimers->Now();
+            mTimers->Schedule((due > wheel) ? due - wheel : 0, callback);
+        });
+    }
+
+    U32 EventLoop::RunOnce(S32 milliSeconds)
+    {
+        U64 next = mTimers->NextExpiration();
+        S32 timeout = milliSeconds;
+        U32 count = 0;
+        S32 result;
+        U64 now;
+
+        mThread.store(std::this_thread::get_id());
+
+        if (next != (U64)-1 && (timeout < 0 || next < (U64)timeout)) {
+            timeout = (next > 0x7FFFFFFF) ? 0x7FFFFFFF : (S32)next;
+        }
+
+        if ((result = poll(mPollDescriptors.data(), (U32)mPollDescriptors.size(), timeout)) == SOCKET_ERROR) {
+#ifndef _MSC_VER
+            if (errno == EINTR) {
+                return 0;
+            }
+#endif
+            throw socket_error(GetLastSocketErrorString);
+        }
+
+        now = Now();
+        mReady.clear();
+
+        if (result > 0) {
+            // Handler dürfen Sockets hinzufügen und entfernen, daher werden
+            // die Ereignisse vorher gesammelt.
+            for (const pollfd& fd : mPollDescriptors) {
+                if (fd.revents == 0) {
+                    continue;
+                }
+
+                auto it = mIndices.find(fd.fd);
+                SocketPollFlags events = (SocketPollFlags)fd.revents;
+
+                mReady.push_back(std::make_pair(fd.fd, fd.revents));
+
+                if (it == std::end(mIndices) || it->second == 0) {
+                    continue;
+                }
+
+                // Nur der Zeitstempel wird erneuert, der Zeitgeber prüft ihn
+                // erst beim Ablauf.
+                Connection& entry = *mEntries[it->second];
+
+                if ((short)(events & (SocketPollFlags::Read | SocketPollFlags::Error | SocketPollFlags::HungUp)) != 0) {
+                    entry.Activity[(U32)SocketDeadline::ReadIdle] = now;
+                }
+
+                if ((short)(events & SocketPollFlags::Write) != 0) {
+                    entry.Activity[(U32)SocketDeadline::WriteStall] = now;
+                }
+            }
+        }
+
+        // Das Rad wird vor den Handlern nachgezogen, damit darin gestartete
+        // Zeitgeber von der aktuellen Zeit aus laufen. Die Fristen der
+        // bereiten Sockets sehen dabei bereits deren neue Zeitstempel.
+        count += mTimers->Advance(now);
+
+        for (const auto& ready : mReady) {
+            auto it = mIndices.find(ready.first);
+
+            if (it == std::end(mIndices)) {
+                continue;
+            } else if (it->second == 0) {
+                Vector<Byte> buffer(64);
+
+                // Erst nach dem Leeren darf Wake wieder ein Byte senden.
+                // Ein vorher gesendetes Byte würde hier mitgelesen, das Flag
+                // bliebe gesetzt und jeder weitere Wake-Aufruf ginge verloren.
+                // Aufträge aus der Zwischenzeit führen RunPosted und RunQueues
+                // weiter unten noch in diesem Durchlauf aus.
+                while (mWakeRead->Receive(buffer) > 0) {
+                }
+
+                mWakePending.store(false);
+                continue;
+            }
+
+            Pointer<Connection> entry = mEntries[it->second];
+            SocketPollFlags events = (SocketPollFlags)ready.second;
+
+            // Eingereihte Daten werden vor dem Handler gesendet. Schlägt das
+            // fehl, dann hat der Handler bereits Error erhalten.
+            if (entry->Queue && (short)(events & SocketPollFlags::Write) != 0 && !Flush(entry)) {
+                count++;
+                continue;
+            }
+
+            SocketPollFlags delivered = events & (entry->Requested | SocketPollFlags::Error | SocketPollFlags::HungUp | SocketPollFlags::Invalid);
+
+            if ((short)delivered == 0) {
+            } else if (mDispatcher) {
+                Dispatch(entry, delivered);
+            } else {
+                entry->Callback(entry->Target, delivered);
+            }
+
+            count++;
+        }
+
+        count += RunExpired();
+        count += RunPosted();
+        count += RunQueues();
+        return count;
+    }
+
+    void EventLoop::Run()
+    {
+        while (!mStopped.exchange(false)) {
+            RunOnce(-1);
+        }
+    }
+
+    void EventLoop::Stop() NOEXCEPT
+    {
+        mStopped.store(true);
+        Wake();
+    }
+
+    EventLoopPtr EventLoop::Shared()
+    {
+        std::call_once(SharedFlag, []() {
+            // Die Schleife lebt bis zum Prozessende, ihr Thread wird nie
+            // beendet.
+            SharedLoop = new EventLoopPtr(new EventLoop());
+
+            Thread([]() {
+                for (;;) {
+                    try {
+                        (*SharedLoop)->Run();
+                    } catch (std::exception&) {
+                    }
+                }
+            }).detach();
+        });
+
+        return *SharedLoop;
+    }
+
+    Pointer<EventLoop::Connection> EventLoop::Find(Pointer<Socket> socket) const
+    {
+        auto it = socket ? mIndices.find(socket->Handle()) : std::end(mIndices);
+
+        if (it == std::end(mIndices) || it->second == 0) {
+            throw std::invalid_argument("socket is not registered");
+        }
+
+        return mEntries[it->second];
+    }
+
+    void EventLoop::Arm(Connection& connection, SocketDeadline type, U64 now) NOEXCEPT
+    {
+        U32 index = (U32)type;
+        U32 limit = connection.Limits[index];
+        Timer& timer = connection.Timers[index];
+
+        connection.Activity[index] = now;
+
+        if (limit == 0 || (type == SocketDeadline::WriteStall && (short)(connection.Events & SocketPollFlags::Write) == 0)) {
+            mTimers->Stop(timer);
+            return;
+        }
+
+        // Zeitstempel sind in Now() angegeben, das Rad kann bis zum nächsten
+        // Advance hinterherhinken.
+        U64 wheel = mTimers->Now();
+        U64 due = now + limit;
+        Connection* target = &connection;
+
+        timer.Callback([this, target, type]() {
+            U32 index = (U32)type;
+            U64 now = Now();
+            U64 due = target->Activity[index] + target->Limits[index];
+
+            if (type != SocketDeadline::Lifetime && due > now) {
+                mTimers->Start(target->Timers[index], due - mTimers->Now());
+                return;
+            }
+
+            auto it = mIndices.find(target->Handle);
+
+            if (it != std::end(mIndices) && mEntries[it->second].get() == target) {
+                mExpired.push_back(std::make_pair(mEntries[it->second], type));
+            }
+        });
+
+        mTimers->Start(timer, (due > wheel) ? due - wheel : 0);
+    }
+
+    void EventLoop::Update(Connection& connection) NOEXCEPT
+    {
+        SocketPollFlags events = connection.Requested;
+        auto it = mIndices.find(connection.Handle);
+
+        if (connection.Queue && !connection.Queue->mPending.empty()) {
+            events |= SocketPollFlags::Write;
+        }
+
+        // Während ein Worker den Handler ausführt wird der Socket nicht
+        // überwacht, sonst würde poll dasselbe Ereignis erneut melden. Ohne
+        // Ereignisse würde poll HungUp und Error dauerhaft melden.
+        if (it != std::end(mIndices) && mEntries[it->second].get() == &connection) {
+            mPollDescriptors[it->second].fd = (connection.Busy || (short)events == 0) ? INVALID_SOCKET : connection.Handle;
+            mPollDescriptors[it->second].events = (short)events;
+        }
+
+        Watch(connection, events);
+    }
+
+    void EventLoop::Dispatch(Pointer<Connection> connection, SocketPollFlags events)
+    {
+        connection->Busy = true;
+        Update(*connection);
+
+        // Dieselbe Verbindung landet bevorzugt immer beim selben Worker.
+        mDispatcher->Submit((U32)std::hash<SocketHandle>()(connection->Handle), [this, connection, events]() {
+            try {
+                connection->Callback(connection->Target, events);
+            } catch (...) {
+            }
+
+            Post([this, connection]() {
+                connection->Busy = false;
+
+                auto it = mIndices.find(connection->Handle);
+
+                // RunQueues überspringt die Warteschlange solange der Handler
+                // läuft. Ein entfernter Socket wird nicht mehr gesendet.
+                if (it == std::end(mIndices) || mEntries[it->second] != connection) {
+                } else if (connection->Queue) {
+                    Flush(connection);
+                } else {
+                    Update(*connection);
+                }
+            });
+        });
+    }
+
+    bool EventLoop::Flush(Pointer<Connection> connection)
+    {
+        Pointer<SendQueue> queue = connection->Queue;
+
+        try {
+            queue->Flush();
+        } catch (socket_error&) {
+            // Ohne Verbindung können die restlichen Daten nicht mehr
+            // gesendet werden, der Handler erfährt es über Error. Mit einem
+            // Dispatcher läuft er auch dafür in einem Worker.
+            queue->Discard();
+            Update(*connection);
+
+            if (!connection->Callback) {
+            } else if (mDispatcher) {
+                Dispatch(connection, SocketPollFlags::Error);
+            } else {
+                connection->Callback(connection->Target, SocketPollFlags::Error);
+            }
+
+            return false;
+        }
+
+        Update(*connection);
+        return true;
+    }
+
+    void EventLoop::Submit(SendQueue* queue) NOEXCEPT
+    {
+        queue->mNextSubmitted = mSubmitted.load();
+
+        while (!mSubmitted.compare_exchange_weak(queue->mNextSubmitted, queue)) {
+        }
+
+        Wake();
+    }
+
+    void EventLoop::Watch(Connection& connection, SocketPollFlags events) NOEXCEPT
+    {
+        bool before = (short)(connection.Events & SocketPollFlags::Write) != 0;
+        bool after = (short)(events & SocketPollFlags::Write) != 0;
+
+        connection.Events = events;
+
+        if (before != after) {
+            Arm(connection, SocketDeadline::WriteStall, Now());
+        }
+    }
+
+    void EventLoop::Wake() NOEXCEPT
+    {
+        if (!mWakePending.exchange(true)) {
+            Byte signal = 1;
+
+            send(mWakeWrite->Handle(), (const char*)&signal, 1, 0);
+        }
+    }
+
+    U32 EventLoop::RunExpired()
+    {
+        Vector<std::pair<Pointer<Connection>, SocketDeadline>> expired;
+
+        expired.swap(mExpired);
+
+        for (const auto& item : expired) {
+            auto it = mIndices.find(item.first->Handle);
+
+            // Ein vorheriger Handler kann den Socket bereits entfernt haben.
+            if (it == std::end(mIndices) || mEntries[it->second] != item.first) {
+                continue;
+            }
+
+            if (mExpiredHandler) {
+                mExpiredHandler(item.first->Target, item.second);
+            } else {
+                Remove(item.first->Target);
+
+                try {
+                    item.first->Target->Close();
+                } catch (socket_error&) {
+                }
+            }
+        }
+
+        return (U32)expired.size();
+    }
+
+    U32 EventLoop::RunQueues()
+    {
+        SendQueue* queue = mSubmitted.exchange(nullptr);
+        SendQueue* reversed = nullptr;
+        U32 count = 0;
+
+        // Die Warteschlangen in der Reihenfolge ihrer Anmeldung senden.
+        while (queue) {
+            SendQueue* next = queue->mNextSubmitted;
+
+            queue->mNextSubmitted = reversed;
+            reversed = queue;
+            queue = next;
+        }
+
+        while ((queue = reversed) != nullptr) {
+            reversed = queue->mNextSubmitted;
+
+            if (queue->mClosed.load()) {
+                queue->Discard();
+                mRetired.erase(queue);
+                continue;
+            }
+
+            auto it = mIndices.find(queue->mSocket->Handle());
+
+            queue->mScheduled.store(false);
+
+            // Solange ein Worker den Handler ausführt wird nicht gesendet,
+            // sonst könnte ein Fehler den Handler ein zweites Mal starten.
+            // Das Ende des Handlers holt das Senden nach.
+            if (it != std::end(mIndices) && mEntries[it->second]->Queue.get() == queue && !mEntries[it->second]->Busy) {
+                Flush(mEntries[it->second]);
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+    U32 EventLoop::RunPosted()
+    {
+        Vector<Function<void()>> tasks;
+
+        {
+            LockGuard<Mutex> lock(mMutex);
+            tasks.swap(mPosted);
+        }
+
+        for (const Function<void()>& task : tasks) {
+            task();
+        }
+
+        return (U32)tasks.size();
+    }
+}
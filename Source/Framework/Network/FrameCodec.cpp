@@ -0,0 +1,254 @@
+﻿#include <Lupus/Network/FrameCodec.h>
+#include <Lupus/Network/NetworkStream.h>
+#include <Lupus/Memory/BufferChain.h>
+#include <algorithm>
+
+namespace Lupus {
+    namespace {
+        static const U32 MaxHeaderSize = 5;
+
+        /*!
+         * Liest das Präfix. Liefert die Anzahl der Präfixbytes oder Null wenn
+         * noch nicht genug Daten vorhanden sind.
+         */
+        U32 DecodePrefix(FramePrefix prefix, const Byte* data, U32 length, U32& size)
+        {
+            if (prefix == FramePrefix::Fixed32) {
+                if (length < 4) {
+                    return 0;
+                }
+
+                size = ((U32)data[0] << 24) | ((U32)data[1] << 16) | ((U32)data[2] << 8) | (U32)data[3];
+                return 4;
+            }
+
+            size = 0;
+
+            for (U32 i = 0; i < MaxHeaderSize; i++) {
+                if (i == length) {
+                    return 0;
+                } else if (i == MaxHeaderSize - 1 && data[i] > 0x0F) {
+                    // Das fünfte Byte trägt nur noch die obersten 4 Bits.
+                    throw std::length_error("varint prefix exceeds 32 bits");
+                }
+
+                size |= (U32)(data[i] & 0x7F) << (7 * i);
+
+                if ((data[i] & 0x80) == 0) {
+                    return i + 1;
+                }
+            }
+
+            throw std::length_error("varint prefix is longer than 5 bytes");
+        }
+
+        U32 EncodePrefix(FramePrefix prefix, U32 size, Byte* data)
+        {
+            if (prefix == FramePrefix::Fixed32) {
+                data[0] = (Byte)(size >> 24);
+                data[1] = (Byte)(size >> 16);
+                data[2] = (Byte)(size >> 8);
+                data[3] = (Byte)size;
+                return 4;
+            }
+
+            U32 length = 0;
+
+            while (size >= 0x80) {
+                data[length++] = (Byte)(size | 0x80);
+                size >>= 7;
+            }
+
+            data[length++] = (Byte)size;
+            return length;
+        }
+    }
+
+    FrameCodec::FrameCodec(Pointer<NetworkStream> stream) :
+        FrameCodec(stream, FramePrefix::Fixed32, DefaultMaxSize)
+    {
+    }
+
+    FrameCodec::FrameCodec(Pointer<NetworkStream> stream, FramePrefix prefix, U32 maxSize) :
+        mPrefix(prefix),
+        mMaxSize(maxSize),
+        mHeader(MaxHeaderSize)
+    {
+        if (!stream) {
+            throw null_pointer("stream points to NULL");
+        }
+
+        mStream = stream;
+    }
+
+    Pointer<NetworkStream> FrameCodec::Stream() const NOEXCEPT
+    {
+        return mStream;
+    }
+
+    FramePrefix FrameCodec::Prefix() const NOEXCEPT
+    {
+        return mPrefix;
+    }
+
+    U32 FrameCodec::MaxSize() const NOEXCEPT
+    {
+        return mMaxSize;
+    }
+
+    bool FrameCodec::TryRead(FrameView& frame)
+    {
+        if (!mLargeActive) {
+            U32 size, header;
+
+            if ((header = DecodePrefix(mPrefix, mStream->Peek(), mStream->Buffered(), size)) == 0) {
+                return false;
+            } else if (size > mMaxSize) {
+                throw std::length_error("frame exceeds the maximum size");
+            }
+
+            // Der Frame liegt vollständig im Lese-Buffer. Präfix und Größe
+            // werden in 64 Bit addiert, da maxSize bis 0xFFFFFFFF reicht.
+            if ((U64)header + size <= mStream->Buffered()) {
+                frame.Data = mStream->Peek() + header;
+                frame.Size = size;
+                mStream->Consume(header + size);
+                return true;
+            }
+
+            // Passt er nach dem Verschieben durch Fill hinein, dann wird
+            // darauf gewartet.
+            if ((U64)header + size <= mStream->ReadBufferSize()) {
+                return false;
+            }
+
+            mStream->Consume(header);
+
+            if (mLarge.size() < size) {
+                mLarge.resize(size);
+            }
+
+            mLargeSize = size;
+            mLargeFilled = 0;
+            mLargeActive = true;
+        }
+
+        U32 count = std::min(mStream->Buffered(), mLargeSize - mLargeFilled);
+
+        memcpy(mLarge.data() + mLargeFilled, mStream->Peek(), count);
+        mStream->Consume(count);
+        mLargeFilled += count;
+
+        if (mLargeFilled < mLargeSize) {
+            return false;
+        }
+
+        frame.Data = mLarge.data();
+        frame.Size = mLargeSize;
+        mLargeActive = false;
+        return true;
+    }
+
+    bool FrameCodec::Read(FrameView& frame)
+    {
+        while (!TryRead(frame)) {
+            if (mStream->Fill() == 0) {
+                if (mStream->Buffered() > 0 || mLargeActive) {
+                    throw socket_error("connection closed inside a frame");
+                }
+
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool FrameCodec::Read(Vector<Byte>& frame)
+    {
+        FrameView view;
+
+        if (!Read(view)) {
+            return false;
+        }
+
+        frame.assign(view.Data, view.Data + view.Size);
+        return true;
+    }
+
+    void FrameCodec::Write(const Vector<Byte>& frame)
+    {
+        Write(frame, 0, (U32)frame.size());
+    }
+
+    void FrameCodec::Write(const Vector<Byte>& frame, U32 offset, U32 size)
+    {
+        if (offset > frame.size() || size > frame.size() - offset) {
+            throw std::out_of_range("offset and size does not match buffer size");
+        } else if (size > mMaxSize) {
+            throw std::length_error("frame exceeds the maximum size");
+        }
+
+        mStream->Write(mHeader, 0, EncodePrefix(mPrefix, size, mHeader.data()));
+        mStream->Write(frame, offset, size);
+    }
+
+    void FrameCodec::Write(const BufferChain& frame)
+    {
+        if (frame.Size() > mMaxSize) {
+            throw std::length_error("frame exceeds the maximum size");
+        }
+
+        mStream->Write(mHeader, 0, EncodePrefix(mPrefix, frame.Size(), mHeader.data()));
+
+        // Die Ausschnitte werden direkt in den Schreib-Buffer kopiert, ohne
+        // die Kette vorher zusammenzufassen. Reserve sendet erst wenn kein
+        // Byte mehr frei ist, danach wird der gesamte freie Platz genutzt.
+        for (U32 i = 0; i < frame.SliceCount(); i++) {
+            const BufferSlice& slice = frame.At(i);
+
+            for (U32 offset = 0; offset < slice.Size;) {
+                Byte* target = mStream->Reserve(1);
+                U32 count = std::min(slice.Size - offset, mStream->WriteBufferSize() - mStream->Pending());
+
+                memcpy(target, slice.Data() + offset, count);
+                mStream->Commit(count);
+                offset += count;
+            }
+        }
+    }
+
+    void FrameCodec::Flush()
+    {
+        mStream->Flush();
+    }
+
+    void FrameCodec::Encode(BufferChain& frame, FramePrefix prefix)
+    {
+        Byte header[MaxHeaderSize];
+
+        frame.Prepend(header, EncodePrefix(prefix, frame.Size(), header));
+    }
+
+    bool FrameCodec::Decode(BufferChain& input, FramePrefix prefix, U32 maxSize, BufferChain& frame)
+    {
+        Byte header[MaxHeaderSize];
+        U32 length = std::min(input.Size(), MaxHeaderSize);
+        U32 size;
+
+        // Das Präfix kann über zwei Ausschnitte verteilt sein.
+        input.CopyTo(header, 0, length);
+
+        if ((length = DecodePrefix(prefix, header, length, size)) == 0) {
+            return false;
+        } else if (size > maxSize) {
+            throw std::length_error("frame exceeds the maximum size");
+        } else if (input.Size() - length < size) {
+            return false;
+        }
+
+        input.Consume(length);
+        frame = input.Split(size);
+        return true;
+    }
+}
@@ -0,0 +1,249 @@
+﻿#include <Lupus/Network/HotRestart.h>
+#include <Lupus/Network/Socket.h>
+#include <Lupus/Network/UnixEndPoint.h>
+#include <Lupus/Network/SocketInformation.h>
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_MSC_VER) && !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace Lupus {
+    namespace {
+        //! Wartezeit auf die Bestätigung des Nachfolgers in Millisekunden.
+        static const U32 AcknowledgeTimeout = 10000;
+
+        //! Obergrenze für die vom Vorgänger angekündigte Anzahl an Sockets.
+        static const U32 MaxInheritedSockets = 1024;
+
+        bool WaitForRead(Pointer<Socket> socket, U32 milliSeconds)
+        {
+            return (socket->Poll(milliSeconds, SocketPollFlags::Read) != SocketPollFlags::Timeout);
+        }
+
+#ifndef _MSC_VER
+        // Ein während der Übergabe beendeter Partner darf den Prozess nicht
+        // mit SIGPIPE beenden. Wo MSG_NOSIGNAL fehlt, wird SO_NOSIGPIPE am
+        // Kanal gesetzt.
+#ifdef SO_NOSIGPIPE
+        void IgnoreBrokenPipe(Pointer<Socket> channel)
+        {
+            int yes = 1;
+
+            if (setsockopt(channel->Handle(), SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(int)) != 0) {
+                throw socket_error(GetLastSocketErrorString);
+            }
+        }
+#else
+        void IgnoreBrokenPipe(Pointer<Socket>)
+        {
+        }
+#endif
+
+        bool SendExactly(Pointer<Socket> channel, const Byte* data, U32 size)
+        {
+            while (size > 0) {
+                ssize_t result = send(channel->Handle(), data, size, MSG_NOSIGNAL);
+
+                if (result < 0 && errno == EINTR) {
+                    continue;
+                } else if (result <= 0) {
+                    return false;
+                }
+
+                data += result;
+                size -= (U32)result;
+            }
+
+            return true;
+        }
+
+        // Der Kanal des Nachfolgers wird direkt über den Handle verbunden,
+        // sein Zustand bleibt daher unverbunden und es wird ebenfalls direkt
+        // über den Handle gelesen.
+        void ReceiveExactly(Pointer<Socket> channel, Vector<Byte>& buffer)
+        {
+            U32 offset = 0;
+
+            while (offset < buffer.size()) {
+                ssize_t result = recv(channel->Handle(), buffer.data() + offset, buffer.size() - offset, 0);
+
+                if (result < 0 && errno == EINTR) {
+                    continue;
+                } else if (result <= 0) {
+                    throw socket_error("Hot restart channel was closed");
+                }
+
+                offset += (U32)result;
+            }
+        }
+#endif
+    }
+
+    HotRestart::HotRestart(const String& path) :
+        mEndPoint(new UnixEndPoint(path))
+    {
+    }
+
+    HotRestart::~HotRestart()
+    {
+        if (mListener) {
+            mListener.reset();
+
+            // Nach einer Übergabe gehört der Pfad dem Nachfolger.
+            if (!mDraining) {
+                std::remove(mEndPoint->Path().c_str());
+            }
+        }
+    }
+
+#ifdef _MSC_VER
+    bool HotRestart::Handoff(U32 milliSeconds)
+    {
+        throw socket_error("Hot restart is not supported on this platform");
+    }
+
+    Vector<Pointer<Socket>> HotRestart::Inherit(const String& path, U32 milliSeconds)
+    {
+        throw socket_error("Hot restart is not supported on this platform");
+    }
+#else
+    bool HotRestart::Handoff(U32 milliSeconds)
+    {
+        if (mDraining) {
+            return false;
+        }
+
+        if (!mListener) {
+            SocketPtr listener(new Socket(AddressFamily::UNIX, SocketType::Stream, ProtocolType::Unspecified));
+
+            std::remove(mEndPoint->Path().c_str());
+            listener->Bind(mEndPoint);
+            listener->Listen(1);
+            mListener = listener;
+        }
+
+        if (!WaitForRead(mListener, milliSeconds)) {
+            return false;
+        }
+
+        SocketPtr channel = mListener->Accept();
+
+        try {
+            U32 count = (U32)mSockets.size();
+            Vector<Byte> ack(1);
+
+            IgnoreBrokenPipe(channel);
+
+            if (!SendExactly(channel, (const Byte*)&count, 4)) {
+                return false;
+            }
+
+            for (const SocketPtr& socket : mSockets) {
+                socket->Duplicate(channel);
+            }
+
+            if (!WaitForRead(channel, AcknowledgeTimeout)) {
+                return false;
+            }
+
+            ReceiveExactly(channel, ack);
+
+            if (ack[0] != 1) {
+                return false;
+            }
+        } catch (socket_error&) {
+            // Der Nachfolger hat abgebrochen, die Sockets bleiben hier.
+            return false;
+        }
+
+        // Der Kernel-Socket lebt im Nachfolger weiter, hier wird lediglich
+        // der eigene Handle geschlossen.
+        for (const SocketPtr& socket : mSockets) {
+            socket->Close();
+        }
+
+        mSockets.clear();
+        mDraining = true;
+        mListener.reset();
+        return true;
+    }
+
+    Vector<Pointer<Socket>> HotRestart::Inherit(const String& path, U32 milliSeconds)
+    {
+        UnixEndPointPtr endPoint(new UnixEndPoint(path));
+        SocketPtr channel(new Socket(AddressFamily::UNIX, SocketType::Stream, ProtocolType::Unspecified));
+        Vector<Pointer<Socket>> sockets;
+        Vector<Byte> header(4);
+        Vector<Byte> address = endPoint->Serialize();
+
+        // Der Fehlercode wird direkt nach connect gesichert. Nur ein
+        // fehlender oder verwaister Pfad bedeutet dass kein Vorgänger läuft,
+        // bei allen anderen Fehlern (bspw EACCES oder EMFILE) würde sonst ein
+        // zweiter Listener gestartet.
+        if (connect(channel->Handle(), (const Addr*)address.data(), (AddrLength)endPoint->Length()) != 0) {
+            S32 error = errno;
+
+            if (error == ENOENT || error == ECONNREFUSED) {
+                return sockets;
+            }
+
+            throw socket_error(std::strerror(error));
+        }
+
+        IgnoreBrokenPipe(channel);
+
+        if (!WaitForRead(channel, milliSeconds)) {
+            throw socket_error("Predecessor did not hand off its sockets in time");
+        }
+
+        ReceiveExactly(channel, header);
+
+        U32 count = *((U32*)header.data());
+
+        if (count > MaxInheritedSockets) {
+            throw socket_error("Predecessor announced too many sockets");
+        }
+
+        sockets.reserve(count);
+
+        for (U32 i = 0; i < count; i++) {
+            if (!WaitForRead(channel, milliSeconds)) {
+                throw socket_error("Predecessor did not hand off its sockets in time");
+            }
+
+            sockets.push_back(Socket::ReceiveDuplicate(channel));
+        }
+
+        // Ohne Bestätigung behält der Vorgänger seine Sockets, die Kopien
+        // hier werden mit dem Vektor geschlossen.
+        const Byte ack = 1;
+
+        if (!SendExactly(channel, &ack, 1)) {
+            throw socket_error("Could not acknowledge the hot restart handoff");
+        }
+
+        return sockets;
+    }
+#endif
+
+    void HotRestart::Add(Pointer<Socket> socket)
+    {
+        if (!socket) {
+            throw null_pointer("socket points to NULL");
+        }
+
+        mSockets.push_back(socket);
+    }
+
+    const Vector<Pointer<Socket>>& HotRestart::Sockets() const NOEXCEPT
+    {
+        return mSockets;
+    }
+
+    bool HotRestart::Draining() const NOEXCEPT
+    {
+        return mDraining;
+    }
+}
@@ -2,10 +2,10 @@
 #include <Lupus/Network/Utility.h>
 
 namespace Lupus {
-	IPAddress::IPAddress(U32 ipv4) :
+	IPAddress::IPAddress(U32 ipv4) NOEXCEPT :
         mFamily(AddressFamily::InterNetwork)
 	{
-        ipv4 = HostToNetworkOrder(ipv4);
+        ipv4 = ToNetworkOrder(ipv4);
         mAddress.insert(std::end(mAddress), (Byte*)&ipv4, (Byte*)&ipv4 + 4);
 	}
 
@@ -30,27 +30,27 @@ namespace Lupus {
     {
     }
 
-	Vector<Byte> IPAddress::Bytes() const 
+	Vector<Byte> IPAddress::Bytes() const NOEXCEPT 
 	{
         return mAddress;
 	}
 	
-	AddressFamily IPAddress::Family() const 
+	AddressFamily IPAddress::Family() const NOEXCEPT 
 	{
         return mFamily;
 	}
 	
-	bool IPAddress::IsIPv6LinkLocal() const 
+	bool IPAddress::IsIPv6LinkLocal() const NOEXCEPT 
 	{
 		return false;
 	}
 	
-	bool IPAddress::IsIPv6Multicast() const 
+	bool IPAddress::IsIPv6Multicast() const NOEXCEPT 
 	{
 		return false;
 	}
 	
-	bool IPAddress::IsIPv6SiteLocal() const 
+	bool IPAddress::IsIPv6SiteLocal() const NOEXCEPT 
 	{
 		return false;
 	}
@@ -90,7 +90,7 @@ namespace Lupus {
         return str;
     }
 
-	bool IPAddress::IsLoopback(IPAddressPtr address) 
+	bool IPAddress::IsLoopback(IPAddressPtr address) NOEXCEPT 
 	{
         Vector<Byte> addressBytes = address->Bytes();
         Vector<Byte> comparer;
@@ -133,7 +133,7 @@ namespace Lupus {
         address->mAddress.clear();
 
         if (inet_pton(AF_INET, ipString.c_str(), &(addr.sin_addr)) == 1) {
-            address = new IPAddress(NetworkToHostOrder(*((U32*)&addr.sin_addr)));
+            address = new IPAddress(ToHostOrder(*((U32*)&addr.sin_addr)));
         } else if (inet_pton(AF_INET6, ipString.c_str(), &(addr6.sin6_addr)) == 1) {
             Byte* begin = (Byte*)&addr6.sin6_addr;
             address = new IPAddress(0);
@@ -150,7 +150,7 @@ namespace Lupus {
         return Pointer<IPAddress>(address);
 	}
 	
-	bool IPAddress::TryParse(const String& ipString, IPAddressPtr& address) 
+	bool IPAddress::TryParse(const String& ipString, IPAddressPtr& address) NOEXCEPT 
 	{
 		try {
 			address = IPAddress::Parse(ipString);
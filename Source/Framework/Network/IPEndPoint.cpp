@@ -3,7 +3,7 @@
 #include <Lupus/Network/Utility.h>
 
 namespace Lupus {
-	IPEndPoint::IPEndPoint(U32 address, U16 port) :
+	IPEndPoint::IPEndPoint(U32 address, U16 port) NOEXCEPT :
         IPEndPoint(IPAddressPtr(new IPAddress(address)), port)
     {
 	}
@@ -23,14 +23,14 @@ namespace Lupus {
             case AddressFamily::InterNetwork:
                 addr = (AddrIn*)&mAddrStorage;
                 addr->sin_family = AF_INET;
-                addr->sin_port = HostToNetworkOrder(port);
+                addr->sin_port = ToNetworkOrder(port);
                 memcpy(&addr->sin_addr, address->Bytes().data(), 4);
                 break;
 
             case AddressFamily::InterNetworkV6:
                 addr6 = (AddrIn6*)&mAddrStorage;
-                addr6->sin6_family = AF_INET;
-                addr6->sin6_port = HostToNetworkOrder(port);
+                addr6->sin6_family = AF_INET6;
+                addr6->sin6_port = ToNetworkOrder(port);
                 memcpy(&addr6->sin6_addr, address->Bytes().data(), 16);
                 break;
         }
@@ -46,14 +46,35 @@ namespace Lupus {
 
         memset(&mAddrStorage, 0, sizeof(AddrStorage));
         memcpy(&mAddrStorage, buffer.data(), sizeof(AddrStorage));
+
+        AddrIn* addr = (AddrIn*)&mAddrStorage;
+        AddrIn6* addr6 = (AddrIn6*)&mAddrStorage;
+
+        switch (mAddrStorage.ss_family) {
+            case AF_INET:
+                mAddress = IPAddressPtr(new IPAddress(ToHostOrder(*((U32*)&addr->sin_addr))));
+                break;
+
+            case AF_INET6:
+                mAddress = IPAddressPtr(new IPAddress(Vector<Byte>((Byte*)&addr6->sin6_addr, (Byte*)&addr6->sin6_addr + 16), addr6->sin6_scope_id));
+                break;
+
+            default:
+                throw std::invalid_argument("buffer contains an unsupported address family");
+        }
     }
 
-	AddressFamily IPEndPoint::Family() const
+	AddressFamily IPEndPoint::Family() const NOEXCEPT
 	{
 		return mAddress->Family();
 	}
+
+    U32 IPEndPoint::Length() const NOEXCEPT
+    {
+        return (mAddrStorage.ss_family == AF_INET6) ? sizeof(AddrIn6) : sizeof(AddrIn);
+    }
 	
-	IPAddressPtr IPEndPoint::Address() const
+	IPAddressPtr IPEndPoint::Address() const NOEXCEPT
 	{
 		return mAddress;
 	}
@@ -74,14 +95,14 @@ namespace Lupus {
             case AddressFamily::InterNetwork:
                 addr = (AddrIn*)&mAddrStorage;
                 addr->sin_family = AF_INET;
-                addr->sin_port = HostToNetworkOrder(port);
+                addr->sin_port = ToNetworkOrder(port);
                 memcpy(&addr->sin_addr, address->Bytes().data(), 4);
                 break;
 
             case AddressFamily::InterNetworkV6:
                 addr6 = (AddrIn6*)&mAddrStorage;
-                addr6->sin6_family = AF_INET;
-                addr6->sin6_port = HostToNetworkOrder(port);
+                addr6->sin6_family = AF_INET6;
+                addr6->sin6_port = ToNetworkOrder(port);
                 memcpy(&addr6->sin6_addr, address->Bytes().data(), 16);
                 break;
         }
@@ -89,31 +110,33 @@ namespace Lupus {
         mAddress = address;
 	}
 	
-	U16 IPEndPoint::Port() const
+	U16 IPEndPoint::Port() const NOEXCEPT
 	{
         switch (mAddrStorage.ss_family) {
             case AF_INET:
-                return NetworkToHostOrder(((AddrIn*)&mAddrStorage)->sin_port);
+                return ToHostOrder(((AddrIn*)&mAddrStorage)->sin_port);
             
             case AF_INET6:
-                return NetworkToHostOrder(((AddrIn6*)&mAddrStorage)->sin6_port);
+                return ToHostOrder(((AddrIn6*)&mAddrStorage)->sin6_port);
         }
 
         return 0;
 	}
 	
-	void IPEndPoint::Port(U16 port)
+	void IPEndPoint::Port(U16 port) NOEXCEPT
     {
         switch (mAddrStorage.ss_family) {
             case AF_INET:
-                ((AddrIn*)&mAddrStorage)->sin_port = HostToNetworkOrder(port);
+                ((AddrIn*)&mAddrStorage)->sin_port = ToNetworkOrder(port);
+                break;
 
             case AF_INET6:
-                ((AddrIn6*)&mAddrStorage)->sin6_port = HostToNetworkOrder(port);
+                ((AddrIn6*)&mAddrStorage)->sin6_port = ToNetworkOrder(port);
+                break;
         }
 	}
 
-    Vector<Byte> IPEndPoint::Serialize() const
+    Vector<Byte> IPEndPoint::Serialize() const NOEXCEPT
     {
         return Vector<Byte>((Byte*)&mAddrStorage, (Byte*)&mAddrStorage + sizeof(AddrStorage));
     }
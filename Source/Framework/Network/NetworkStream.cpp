@@ -0,0 +1,399 @@
+﻿#include <Lupus/Network/NetworkStream.h>
+#include <Lupus/Network/Socket.h>
+#include <Lupus/Memory/BuddyAllocator.h>
+#include <algorithm>
+
+namespace Lupus {
+    NetworkStream::NetworkStream(Pointer<Socket> socket) :
+        NetworkStream(socket, 8 * KiB, 8 * KiB)
+    {
+    }
+
+    NetworkStream::NetworkStream(Pointer<Socket> socket, U32 readBufferSize, U32 writeBufferSize)
+    {
+        Validate(socket);
+
+        if (readBufferSize == 0 || writeBufferSize == 0) {
+            throw std::invalid_argument("buffer sizes must be greater than zero");
+        }
+
+        mSocket = socket;
+
+        try {
+            ResizeReadBuffer(readBufferSize);
+            ResizeWriteBuffer(writeBufferSize);
+        } catch (...) {
+            Release(mReadBuffer);
+            throw;
+        }
+    }
+
+    NetworkStream::NetworkStream(Pointer<Socket> socket, Pointer<BuddyAllocator> allocator)
+    {
+        Validate(socket);
+
+        if (!allocator) {
+            throw null_pointer("allocator points to NULL");
+        }
+
+        mSocket = socket;
+        mAllocator = allocator;
+
+        try {
+            ResizeReadBuffer(allocator->MinBlockSize());
+            ResizeWriteBuffer(allocator->MinBlockSize());
+        } catch (...) {
+            Release(mReadBuffer);
+            throw;
+        }
+    }
+
+    NetworkStream::~NetworkStream()
+    {
+        try {
+            Flush();
+        } catch (socket_error&) {
+        }
+
+        Release(mReadBuffer);
+        Release(mWriteBuffer);
+    }
+
+    Pointer<Socket> NetworkStream::Client() const NOEXCEPT
+    {
+        return mSocket;
+    }
+
+    bool NetworkStream::DataAvailable() const
+    {
+        return (mReadLength > 0) || (mSocket->Available() > 0);
+    }
+
+    U32 NetworkStream::Buffered() const NOEXCEPT
+    {
+        return mReadLength;
+    }
+
+    U32 NetworkStream::Pending() const NOEXCEPT
+    {
+        return mWriteLength;
+    }
+
+    U32 NetworkStream::ReadBufferSize() const NOEXCEPT
+    {
+        return mReadSize;
+    }
+
+    U32 NetworkStream::WriteBufferSize() const NOEXCEPT
+    {
+        return mWriteSize;
+    }
+
+    const Byte* NetworkStream::Peek() const NOEXCEPT
+    {
+        return mReadBuffer + mReadPosition;
+    }
+
+    void NetworkStream::Consume(U32 count)
+    {
+        if (count > mReadLength) {
+            throw std::out_of_range("count is greater than the buffered data");
+        }
+
+        mReadPosition += count;
+        mReadLength -= count;
+    }
+
+    S32 NetworkStream::Fill()
+    {
+        S32 result;
+
+        Flush();
+
+        if (mReadPosition > 0) {
+            memmove(mReadBuffer, mReadBuffer + mReadPosition, mReadLength);
+            mReadPosition = 0;
+        }
+
+        if (mAllocator) {
+            if (mReadLength == mReadSize && mReadSize < mAllocator->MaxBlockSize()) {
+                // Ohne freien Block bleibt der aktuelle Buffer erhalten.
+                try {
+                    ResizeReadBuffer(std::max(mReadSize * 2, mAllocator->MinBlockSize()));
+                } catch (std::bad_alloc&) {
+                }
+            } else if (mReadLength == 0 && mReadSize > mAllocator->MinBlockSize()) {
+                ShrinkReadBuffer();
+            }
+        }
+
+        // Null bleibt dem Schließen der Verbindung vorbehalten.
+        if (mReadLength == mReadSize) {
+            throw std::out_of_range("no free space in the read buffer");
+        } else if ((result = mSocket->Receive(mReadBuffer + mReadLength, mReadSize - mReadLength)) < 0) {
+            throw socket_error(GetLastSocketErrorString);
+        }
+
+        mReadLength += (U32)result;
+        return result;
+    }
+
+    S32 NetworkStream::Read(Vector<Byte>& buffer)
+    {
+        return Read(buffer, 0, (U32)buffer.size());
+    }
+
+    S32 NetworkStream::Read(Vector<Byte>& buffer, U32 offset, U32 size)
+    {
+        if (offset > buffer.size() || size > buffer.size() - offset) {
+            throw std::out_of_range("offset and size does not match buffer size");
+        } else if (size == 0) {
+            return 0;
+        }
+
+        if (mReadLength == 0) {
+            S32 result;
+
+            // Ausstehende Anfragen müssen beim Peer sein bevor auf eine
+            // Antwort gewartet wird.
+            Flush();
+
+            if (size >= mReadSize) {
+                if ((result = mSocket->Receive(buffer, offset, size)) < 0) {
+                    throw socket_error(GetLastSocketErrorString);
+                }
+
+                return result;
+            }
+
+            if ((result = mSocket->Receive(mReadBuffer, mReadSize)) < 0) {
+                throw socket_error(GetLastSocketErrorString);
+            } else if (result == 0) {
+                return 0;
+            }
+
+            mReadPosition = 0;
+            mReadLength = (U32)result;
+        }
+
+        U32 count = std::min(size, mReadLength);
+
+        memcpy(buffer.data() + offset, mReadBuffer + mReadPosition, count);
+        mReadPosition += count;
+        mReadLength -= count;
+        return (S32)count;
+    }
+
+    void NetworkStream::Write(const Vector<Byte>& buffer)
+    {
+        Write(buffer, 0, (U32)buffer.size());
+    }
+
+    void NetworkStream::Write(const Vector<Byte>& buffer, U32 offset, U32 size)
+    {
+        if (offset > buffer.size() || size > buffer.size() - offset) {
+            throw std::out_of_range("offset and size does not match buffer size");
+        }
+
+        if (size > mWriteSize - mWriteLength) {
+            SendBuffered();
+        }
+
+        // Ein bei voller Arena freigegebener Buffer wird erneut angefordert,
+        // gelingt das nicht, dann wird direkt gesendet.
+        if (!mWriteBuffer && mAllocator) {
+            try {
+                ResizeWriteBuffer(mAllocator->MinBlockSize());
+            } catch (std::bad_alloc&) {
+            }
+        }
+
+        if (size >= mWriteSize) {
+            SendAll(buffer, offset, size);
+            return;
+        }
+
+        memcpy(mWriteBuffer + mWriteLength, buffer.data() + offset, size);
+        mWriteLength += size;
+    }
+
+    Byte* NetworkStream::Reserve(U32 size)
+    {
+        if (size > mWriteSize - mWriteLength) {
+            SendBuffered();
+        }
+
+        // Nach dem Senden ist der ganze Buffer frei. Reicht er nicht oder
+        // fehlt er, weil die Arena beim letzten Flush voll war, dann wird
+        // er angefordert.
+        if (size > mWriteSize || !mWriteBuffer) {
+            if (!mAllocator || size > mAllocator->MaxBlockSize()) {
+                throw std::out_of_range("size is greater than the write buffer");
+            }
+
+            U32 grown = std::max(mWriteSize, mAllocator->MinBlockSize());
+
+            while (grown < size) {
+                grown *= 2;
+            }
+
+            // Ohne freien Block bleibt der aktuelle Buffer erhalten.
+            try {
+                ResizeWriteBuffer(grown);
+            } catch (std::bad_alloc&) {
+                throw std::out_of_range("no free block for the requested size");
+            }
+        }
+
+        return mWriteBuffer + mWriteLength;
+    }
+
+    void NetworkStream::Commit(U32 count)
+    {
+        if (count > mWriteSize - mWriteLength) {
+            throw std::out_of_range("count is greater than the free write buffer");
+        }
+
+        mWriteLength += count;
+    }
+
+    void NetworkStream::Flush()
+    {
+        if (mWriteLength == 0) {
+            return;
+        }
+
+        SendBuffered();
+
+        if (mAllocator && mWriteSize > mAllocator->MinBlockSize()) {
+            ShrinkWriteBuffer();
+        }
+    }
+
+    void NetworkStream::Close()
+    {
+        Flush();
+        mSocket->Close();
+    }
+
+    void NetworkStream::SendAll(const Vector<Byte>& buffer, U32 offset, U32 size)
+    {
+        SendAll(buffer.data() + offset, size);
+    }
+
+    void NetworkStream::SendAll(const Byte* buffer, U32 size)
+    {
+        while (size > 0) {
+            S32 result = mSocket->Send(buffer, size);
+
+            if (result < 0) {
+                throw socket_error(GetLastSocketErrorString);
+            }
+
+            buffer += result;
+            size -= (U32)result;
+        }
+    }
+
+    void NetworkStream::SendBuffered()
+    {
+        U32 length = mWriteLength;
+
+        mWriteLength = 0;
+        SendAll(mWriteBuffer, length);
+    }
+
+    void NetworkStream::Validate(Pointer<Socket> socket) const
+    {
+        if (!socket) {
+            throw null_pointer("socket points to NULL");
+        } else if (!socket->IsConnected()) {
+            throw std::invalid_argument("socket is not connected");
+        } else if (socket->Type() != SocketType::Stream) {
+            throw std::invalid_argument("socket is not a stream socket");
+        }
+    }
+
+    Byte* NetworkStream::Acquire(U32 size)
+    {
+        if (!mAllocator) {
+            return new Byte[size];
+        }
+
+        Byte* buffer = (Byte*)mAllocator->Allocate(size);
+
+        if (!buffer) {
+            throw std::bad_alloc();
+        }
+
+        return buffer;
+    }
+
+    void NetworkStream::Release(Byte* buffer) NOEXCEPT
+    {
+        if (mAllocator) {
+            mAllocator->Free(buffer);
+        } else {
+            delete[] buffer;
+        }
+    }
+
+    void NetworkStream::ResizeReadBuffer(U32 size)
+    {
+        Byte* buffer = Acquire(size);
+
+        if (mReadLength > 0) {
+            memcpy(buffer, mReadBuffer + mReadPosition, mReadLength);
+        }
+
+        Release(mReadBuffer);
+        mReadBuffer = buffer;
+        mReadSize = size;
+        mReadPosition = 0;
+    }
+
+    void NetworkStream::ResizeWriteBuffer(U32 size)
+    {
+        Byte* buffer = Acquire(size);
+
+        if (mWriteLength > 0) {
+            memcpy(buffer, mWriteBuffer, mWriteLength);
+        }
+
+        Release(mWriteBuffer);
+        mWriteBuffer = buffer;
+        mWriteSize = size;
+    }
+
+    void NetworkStream::ShrinkReadBuffer() NOEXCEPT
+    {
+        // Der leere Buffer wird zuerst freigegeben, damit der kleinste Block
+        // auch bei voller Arena aus ihm entstehen kann.
+        Release(mReadBuffer);
+        mReadBuffer = nullptr;
+        mReadSize = 0;
+        mReadPosition = 0;
+
+        // Kam ein anderer Datenstrom zuvor, dann versucht es der nächste
+        // Fill erneut.
+        try {
+            mReadBuffer = Acquire(mAllocator->MinBlockSize());
+            mReadSize = mAllocator->MinBlockSize();
+        } catch (std::bad_alloc&) {
+        }
+    }
+
+    void NetworkStream::ShrinkWriteBuffer() NOEXCEPT
+    {
+        Release(mWriteBuffer);
+        mWriteBuffer = nullptr;
+        mWriteSize = 0;
+
+        // Ohne Buffer sendet Write direkt und Reserve fordert erneut an.
+        try {
+            mWriteBuffer = Acquire(mAllocator->MinBlockSize());
+            mWriteSize = mAllocator->MinBlockSize();
+        } catch (std::bad_alloc&) {
+        }
+    }
+}
@@ -0,0 +1,236 @@
+﻿#include <Lupus/Network/SendQueue.h>
+#include <Lupus/Network/EventLoop.h>
+#include <Lupus/Network/Socket.h>
+#include <algorithm>
+
+#ifndef _MSC_VER
+#include <climits>
+#include <sys/uio.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+namespace Lupus {
+    namespace {
+        //! Maximale Anzahl an Buffern pro Systemaufruf.
+        static const U32 GatherCount = 64;
+    }
+
+    struct SendQueue::Node
+    {
+        Vector<Byte> Buffer;
+        BufferChain Chain;
+        Node* Next;
+    };
+
+    SendQueue::SendQueue(EventLoop* loop, Pointer<Socket> socket) NOEXCEPT :
+        mLoop(loop),
+        mSocket(socket),
+        mHead(nullptr),
+        mQueued(0),
+        mScheduled(false),
+        mClosed(false)
+    {
+    }
+
+    SendQueue::~SendQueue()
+    {
+        Discard();
+    }
+
+    bool SendQueue::Enqueue(Vector<Byte> buffer)
+    {
+        if (mClosed.load()) {
+            return false;
+        } else if (buffer.empty()) {
+            return true;
+        }
+
+        Node* node = new Node();
+        U64 size = buffer.size();
+
+        node->Buffer = std::move(buffer);
+        return Push(node, size);
+    }
+
+    bool SendQueue::Enqueue(BufferChain buffer)
+    {
+        if (mClosed.load()) {
+            return false;
+        } else if (buffer.IsEmpty()) {
+            return true;
+        }
+
+        Node* node = new Node();
+        U64 size = buffer.Size();
+
+        node->Chain = std::move(buffer);
+        return Push(node, size);
+    }
+
+    bool SendQueue::Push(Node* node, U64 size) NOEXCEPT
+    {
+        mQueued.fetch_add(size);
+        node->Next = mHead.load();
+
+        while (!mHead.compare_exchange_weak(node->Next, node)) {
+        }
+
+        // Nur der erste Buffer seit dem letzten Durchlauf weckt die Schleife.
+        if (!mScheduled.exchange(true)) {
+            mLoop->Submit(this);
+        }
+
+        return true;
+    }
+
+    U64 SendQueue::Queued() const NOEXCEPT
+    {
+        return mQueued.load();
+    }
+
+    bool SendQueue::IsClosed() const NOEXCEPT
+    {
+        return mClosed.load();
+    }
+
+    Pointer<Socket> SendQueue::Target() const NOEXCEPT
+    {
+        return mSocket;
+    }
+
+    bool SendQueue::Flush()
+    {
+        // Die Knoten liegen in umgekehrter Reihenfolge im Stapel.
+        Node* node = mHead.exchange(nullptr);
+        Node* reversed = nullptr;
+
+        while (node) {
+            Node* next = node->Next;
+
+            node->Next = reversed;
+            reversed = node;
+            node = next;
+        }
+
+        while (reversed) {
+            Node* next = reversed->Next;
+
+            if (reversed->Chain.IsEmpty()) {
+                mPending.push_back(Entry());
+                mPending.back().Owned = std::move(reversed->Buffer);
+            } else {
+                for (U32 i = 0; i < reversed->Chain.SliceCount(); i++) {
+                    mPending.push_back(Entry());
+                    mPending.back().Shared = reversed->Chain.At(i);
+                }
+            }
+
+            delete reversed;
+            reversed = next;
+        }
+
+        while (!mPending.empty()) {
+            U32 count = (U32)std::min<size_t>(mPending.size(), GatherCount);
+            U64 requested = 0;
+            U64 sent;
+
+#ifdef _MSC_VER
+            WSABUF buffers[GatherCount];
+            DWORD result = 0;
+
+            for (U32 i = 0; i < count; i++) {
+                U32 offset = (i == 0) ? mOffset : 0;
+
+                buffers[i].buf = (char*)mPending[i].Data() + offset;
+                buffers[i].len = (ULONG)(mPending[i].Size() - offset);
+                requested += buffers[i].len;
+            }
+
+            if (WSASend(mSocket->Handle(), buffers, count, &result, 0, nullptr, nullptr) != 0) {
+                if (WSAGetLastError() == WSAEWOULDBLOCK) {
+                    return false;
+                }
+
+                throw socket_error(GetLastSocketErrorString);
+            }
+#else
+            iovec buffers[GatherCount];
+            msghdr message;
+            ssize_t result;
+
+            for (U32 i = 0; i < count; i++) {
+                U32 offset = (i == 0) ? mOffset : 0;
+
+                buffers[i].iov_base = mPending[i].Data() + offset;
+                buffers[i].iov_len = mPending[i].Size() - offset;
+                requested += buffers[i].iov_len;
+            }
+
+            memset(&message, 0, sizeof(message));
+            message.msg_iov = buffers;
+            message.msg_iovlen = count;
+
+            while ((result = sendmsg(mSocket->Handle(), &message, MSG_NOSIGNAL | MSG_DONTWAIT)) < 0 && errno == EINTR) {
+            }
+
+            if (result < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return false;
+                }
+
+                throw socket_error(GetLastSocketErrorString);
+            }
+#endif
+
+            sent = (U64)result;
+            mQueued.fetch_sub(sent);
+
+            while (sent > 0) {
+                U64 rest = mPending.front().Size() - mOffset;
+
+                if (sent < rest) {
+                    mOffset += (U32)sent;
+                    break;
+                }
+
+                sent -= rest;
+                mOffset = 0;
+                mPending.pop_front();
+            }
+
+            // Teilweise geschrieben, der Socket ist voll.
+            if ((U64)result < requested) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool SendQueue::Close() NOEXCEPT
+    {
+        mClosed.store(true);
+
+        // Danach meldet kein Thread die Warteschlange mehr an.
+        return mScheduled.exchange(true);
+    }
+
+    void SendQueue::Discard() NOEXCEPT
+    {
+        Node* node = mHead.exchange(nullptr);
+
+        while (node) {
+            Node* next = node->Next;
+
+            delete node;
+            node = next;
+        }
+
+        mPending.clear();
+        mOffset = 0;
+        mQueued.store(0);
+    }
+}
@@ -0,0 +1,403 @@
+﻿#include <Lupus/Network/SharedMemoryChannel.h>
+#include <Lupus/Network/Socket.h>
+#include <Internal/Network/SharedRing.h>
+#include <Internal/Network/HandleTransfer.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace Lupus {
+    namespace {
+        //! Anzahl der aktiven Prüfungen bevor sich ein Aufrufer schlafen legt.
+        //! Auf einem einzelnen Kern würde das den Partner nur ausbremsen.
+        static const U32 SpinCount = (std::thread::hardware_concurrency() > 1) ? 4096 : 0;
+        static const U32 MinimumCapacity = 4 * KiB;
+        static const U32 MaximumCapacity = 1 * GiB;
+
+        U32 RoundCapacity(U32 capacity)
+        {
+            U32 result = MinimumCapacity;
+
+            while (result < capacity && result < MaximumCapacity) {
+                result <<= 1;
+            }
+
+            return result;
+        }
+
+        //! Zählt einen Aufrufer bis zum Verlassen des Bereichs.
+        class UseGuard
+        {
+        public:
+
+            UseGuard(Atomic<U32>& users) :
+                mUsers(users)
+            {
+                mUsers.fetch_add(1);
+            }
+
+            ~UseGuard()
+            {
+                mUsers.fetch_sub(1);
+            }
+
+        private:
+
+            Atomic<U32>& mUsers;
+        };
+    }
+
+    SharedMemoryChannel::SharedMemoryChannel() NOEXCEPT :
+        mUsers(0),
+        mClosing(false)
+    {
+    }
+
+#ifndef __linux__
+    SharedMemoryChannel::~SharedMemoryChannel()
+    {
+    }
+
+    SharedMemoryChannelPtr SharedMemoryChannel::Create(Pointer<Socket> channel, U32 capacity)
+    {
+        throw socket_error("Shared memory channels are not supported on this platform");
+    }
+
+    SharedMemoryChannelPtr SharedMemoryChannel::Accept(Pointer<Socket> channel)
+    {
+        throw socket_error("Shared memory channels are not supported on this platform");
+    }
+
+    void SharedMemoryChannel::Close()
+    {
+    }
+
+    void SharedMemoryChannel::Wait(S32 handle)
+    {
+        throw socket_error("Shared memory channels are not supported on this platform");
+    }
+
+    void SharedMemoryChannel::Wake(S32 handle)
+    {
+    }
+#else
+    SharedMemoryChannel::~SharedMemoryChannel()
+    {
+        Close();
+    }
+
+    SharedMemoryChannelPtr SharedMemoryChannel::Create(Pointer<Socket> channel, U32 capacity)
+    {
+        if (!channel) {
+            throw null_pointer("channel points to NULL");
+        } else if (channel->Family() != AddressFamily::UNIX) {
+            throw socket_error("channel must be an AF_UNIX socket");
+        }
+
+        SharedMemoryChannelPtr result(new SharedMemoryChannel());
+        U32 ringCapacity = RoundCapacity(capacity);
+        U32 ringSize = Internal::SharedRing::Size(ringCapacity);
+        S32 memory = memfd_create("lupus-channel", MFD_CLOEXEC);
+        String message;
+
+        result->mChannel = channel;
+        result->mMemorySize = 2 * (U64)ringSize;
+        result->mDataWait = eventfd(0, EFD_CLOEXEC);
+        result->mSpaceWait = eventfd(0, EFD_CLOEXEC);
+        result->mDataSignal = eventfd(0, EFD_CLOEXEC);
+        result->mSpaceSignal = eventfd(0, EFD_CLOEXEC);
+
+        if (memory < 0 || result->mDataWait < 0 || result->mSpaceWait < 0 || result->mDataSignal < 0 || result->mSpaceSignal < 0 ||
+            ftruncate(memory, (off_t)result->mMemorySize) != 0) {
+            message = GetLastSocketErrorString;
+        } else if ((result->mMemory = (Byte*)mmap(nullptr, (size_t)result->mMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, memory, 0)) == (Byte*)MAP_FAILED) {
+            result->mMemory = nullptr;
+            message = GetLastSocketErrorString;
+        } else {
+            // Ring 0 schreibt der Ersteller, Ring 1 der übernehmende Prozess.
+            result->mSend = Pointer<Internal::SharedRing>(new Internal::SharedRing(result->mMemory, ringCapacity));
+            result->mReceive = Pointer<Internal::SharedRing>(new Internal::SharedRing(result->mMemory + ringSize, ringCapacity));
+            result->mSend->Initialize();
+            result->mReceive->Initialize();
+
+            try {
+                Vector<SocketHandle> handles = { memory, result->mDataSignal, result->mSpaceSignal, result->mDataWait, result->mSpaceWait };
+
+                Internal::SendHandles(channel->Handle(), handles, Vector<Byte>((Byte*)&ringCapacity, (Byte*)&ringCapacity + 4));
+            } catch (std::exception& e) {
+                message = e.what();
+            }
+        }
+
+        if (memory >= 0) {
+            close(memory);
+        }
+
+        if (!message.empty()) {
+            throw socket_error(message);
+        }
+
+        return result;
+    }
+
+    SharedMemoryChannelPtr SharedMemoryChannel::Accept(Pointer<Socket> channel)
+    {
+        if (!channel) {
+            throw null_pointer("channel points to NULL");
+        } else if (channel->Family() != AddressFamily::UNIX) {
+            throw socket_error("channel must be an AF_UNIX socket");
+        }
+
+        SharedMemoryChannelPtr result(new SharedMemoryChannel());
+        Vector<SocketHandle> handles;
+        Vector<Byte> payload;
+
+        Internal::ReceiveHandles(channel->Handle(), handles, payload);
+
+        if (handles.size() != 5 || payload.size() != 4) {
+            for (SocketHandle handle : handles) {
+                close(handle);
+            }
+
+            throw socket_error("Received invalid shared memory channel");
+        }
+
+        U32 ringCapacity = *((U32*)payload.data());
+        U32 ringSize = Internal::SharedRing::Size(ringCapacity);
+
+        // Die Signal-Handles des Erstellers sind die eigenen Wartehandles.
+        result->mChannel = channel;
+        result->mDataWait = handles[1];
+        result->mSpaceWait = handles[2];
+        result->mDataSignal = handles[3];
+        result->mSpaceSignal = handles[4];
+        result->mMemorySize = 2 * (U64)ringSize;
+        result->mMemory = (Byte*)mmap(nullptr, (size_t)result->mMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, handles[0], 0);
+        close(handles[0]);
+
+        if (result->mMemory == (Byte*)MAP_FAILED) {
+            result->mMemory = nullptr;
+            throw socket_error(GetLastSocketErrorString);
+        }
+
+        result->mSend = Pointer<Internal::SharedRing>(new Internal::SharedRing(result->mMemory + ringSize, ringCapacity));
+        result->mReceive = Pointer<Internal::SharedRing>(new Internal::SharedRing(result->mMemory, ringCapacity));
+        return result;
+    }
+
+    void SharedMemoryChannel::Close() NOEXCEPT
+    {
+        if (mClosing.exchange(true)) {
+            return;
+        }
+
+        if (mMemory) {
+            mSend->Header()->Closed.store(1);
+            mReceive->Header()->Closed.store(1);
+            // Weckt den Partner und eigene wartende Threads.
+            Wake(mDataSignal);
+            Wake(mSpaceSignal);
+            Wake(mDataWait);
+            Wake(mSpaceWait);
+
+            while (mUsers.load() > 0) {
+                std::this_thread::yield();
+            }
+
+            munmap(mMemory, (size_t)mMemorySize);
+            mMemory = nullptr;
+        }
+
+        for (S32* handle : { &mDataWait, &mSpaceWait, &mDataSignal, &mSpaceSignal }) {
+            if (*handle >= 0) {
+                close(*handle);
+                *handle = -1;
+            }
+        }
+    }
+
+    void SharedMemoryChannel::Wait(S32 handle)
+    {
+        pollfd fds[2] = {
+            { handle, POLLIN, 0 },
+            { mChannel->Handle(), POLLIN, 0 }
+        };
+
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                return;
+            }
+
+            throw socket_error(GetLastSocketErrorString);
+        }
+
+        if (fds[0].revents & POLLIN) {
+            U64 count;
+
+            if (read(handle, &count, 8) != 8 && errno != EAGAIN) {
+                throw socket_error(GetLastSocketErrorString);
+            }
+        }
+
+        // Der Setup-Socket wird nur geschlossen wenn der andere Prozess
+        // beendet wurde, der Kanal gilt dann ebenfalls als geschlossen.
+        if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+            mSend->Header()->Closed.store(1);
+            mReceive->Header()->Closed.store(1);
+        }
+    }
+
+    void SharedMemoryChannel::Wake(S32 handle) NOEXCEPT
+    {
+        U64 one = 1;
+
+        if (write(handle, &one, 8) != 8) {
+            // Der Zähler kann nicht überlaufen, ein Fehler bedeutet dass der
+            // Partner bereits beendet wurde.
+        }
+    }
+#endif
+
+    U32 SharedMemoryChannel::Capacity() const NOEXCEPT
+    {
+        return mSend ? mSend->Capacity() : 0;
+    }
+
+    U32 SharedMemoryChannel::Available() const NOEXCEPT
+    {
+        UseGuard guard(mUsers);
+
+        return (mMemory && !mClosing.load()) ? mReceive->Peek() : 0;
+    }
+
+    bool SharedMemoryChannel::Blocking() const NOEXCEPT
+    {
+        return mBlocking;
+    }
+
+    void SharedMemoryChannel::Blocking(bool value) NOEXCEPT
+    {
+        mBlocking = value;
+    }
+
+    bool SharedMemoryChannel::IsConnected() const NOEXCEPT
+    {
+        UseGuard guard(mUsers);
+
+        return mMemory && !mClosing.load() && !mSend->Header()->Closed.load() && !mReceive->Header()->Closed.load();
+    }
+
+    S32 SharedMemoryChannel::Send(const Vector<Byte>& buffer)
+    {
+        return Send(buffer, 0, (U32)buffer.size());
+    }
+
+    S32 SharedMemoryChannel::Send(const Vector<Byte>& buffer, U32 offset, U32 size)
+    {
+        if (offset > buffer.size() || size > buffer.size() - offset) {
+            throw std::out_of_range("offset and size does not match buffer size");
+        } else if (size == 0) {
+            throw std::invalid_argument("Empty messages are not allowed");
+        }
+
+        UseGuard guard(mUsers);
+
+        if (!mMemory || mClosing.load()) {
+            throw socket_error("Channel is closed");
+        } else if ((U64)size + 4 > mSend->Capacity()) {
+            throw socket_error("Message is larger than the ring capacity");
+        }
+
+        Internal::SharedRingHeader* header = mSend->Header();
+        const Byte* data = buffer.data() + offset;
+
+        for (U32 spin = 0;; spin++) {
+            if (header->Closed.load(std::memory_order_relaxed)) {
+                throw socket_error("Channel was closed by the peer");
+            } else if (mSend->TryWrite(data, size)) {
+                if (header->ReaderWaiting.load() && header->ReaderWaiting.exchange(0)) {
+                    Wake(mDataSignal);
+                }
+
+                return (S32)size;
+            } else if (!mBlocking) {
+                return -1;
+            } else if (spin < SpinCount) {
+                continue;
+            }
+
+            // Das Flag muss vor der erneuten Prüfung sichtbar sein, sonst
+            // könnte der Empfänger Platz schaffen ohne uns zu wecken.
+            header->WriterWaiting.store(1);
+
+            if (mSend->TryWrite(data, size)) {
+                header->WriterWaiting.store(0);
+
+                if (header->ReaderWaiting.load() && header->ReaderWaiting.exchange(0)) {
+                    Wake(mDataSignal);
+                }
+
+                return (S32)size;
+            }
+
+            Wait(mSpaceWait);
+            spin = 0;
+        }
+    }
+
+    S32 SharedMemoryChannel::Receive(Vector<Byte>& buffer)
+    {
+        return Receive(buffer, 0, (U32)buffer.size());
+    }
+
+    S32 SharedMemoryChannel::Receive(Vector<Byte>& buffer, U32 offset, U32 size)
+    {
+        if (offset > buffer.size() || size > buffer.size() - offset) {
+            throw std::out_of_range("offset and size does not match buffer size");
+        }
+
+        UseGuard guard(mUsers);
+
+        if (!mMemory || mClosing.load()) {
+            throw socket_error("Channel is closed");
+        }
+
+        Internal::SharedRingHeader* header = mReceive->Header();
+        Byte* data = buffer.data() + offset;
+
+        for (U32 spin = 0;; spin++) {
+            S32 result = mReceive->TryRead(data, size);
+
+            if (result >= 0) {
+                if (header->WriterWaiting.load() && header->WriterWaiting.exchange(0)) {
+                    Wake(mSpaceSignal);
+                }
+
+                return result;
+            } else if (header->Closed.load()) {
+                // Nachrichten vor dem Schließen werden noch zugestellt.
+                if (!mReceive->Empty()) {
+                    continue;
+                }
+
+                return 0;
+            } else if (!mBlocking) {
+                return -1;
+            } else if (spin < SpinCount) {
+                continue;
+            }
+
+            header->ReaderWaiting.store(1);
+
+            if (!mReceive->Empty() || header->Closed.load()) {
+                header->ReaderWaiting.store(0);
+                continue;
+            }
+
+            Wait(mDataWait);
+            spin = 0;
+        }
+    }
+}
@@ -2,13 +2,18 @@
 #include <Lupus/Network/SocketInformation.h>
 #include <Lupus/Network/Utility.h>
 #include <Lupus/Network/IPAddress.h>
+#include <Lupus/Network/EndPoint.h>
 #include <Lupus/Network/IPEndPoint.h>
+#include <Lupus/Network/UnixEndPoint.h>
+#include <Lupus/Memory/BufferChain.h>
+#include <Lupus/ByteWriter.h>
 #include <Internal/Network/SocketState.h>
+#include <cstdio>
 
 namespace Lupus {
 	Socket::Socket(const SocketInformation& socketInformation)
 	{
-		if (socketInformation.ProtocolInformation.size() != sizeof(AddrStorage) + 12) {
+		if (socketInformation.ProtocolInformation.size() != sizeof(AddrStorage) + 16) {
 			throw std::invalid_argument("socketInformatoin has not the right size");
 		}
 
@@ -17,35 +22,51 @@ namespace Lupus {
         S32 type = *((S32*)(information.data() + 4));
         S32 protocol = *((S32*)(information.data() + 8));
 		AddrStorage storage;
-		int addrsize = 0;
+        AddrLength addrsize = (AddrLength)*((U32*)(information.data() + 12 + sizeof(AddrStorage)));
+        EndPointPtr endPoint;
 
         memset(&storage, 0, sizeof(storage));
         memcpy(&storage, socketInformation.ProtocolInformation.data() + 12, sizeof(storage));
 
-		if ((mHandle = socket((int)family, (int)type, (int)protocol)) == INVALID_SOCKET) {
-			throw socket_error(GetLastSocketErrorString);
-		}
-
 		switch (family) {
             case AF_INET:
-			    addrsize = sizeof(AddrIn);
-			    break;
-
             case AF_INET6:
-			    addrsize = sizeof(AddrIn6);
+            case AF_UNIX:
 			    break;
 
 		    default:
                 throw std::invalid_argument("Address family is not supported");
         }
 
+        if (socketInformation.Options != SocketInformationOption::None) {
+            endPoint = EndPoint::Create(Vector<Byte>((Byte*)&storage, (Byte*)&storage + sizeof(AddrStorage)), (U32)addrsize);
+        }
+
+        // Der Pfad gehört noch dem geschlossenen Socket und muss für ein
+        // erneutes Binden entfernt werden.
+        if (family == AF_UNIX && socketInformation.Options == SocketInformationOption::Bound) {
+            UnixEndPointPtr unixEndPoint = std::static_pointer_cast<UnixEndPoint>(endPoint);
+
+            if (!unixEndPoint->IsAbstract() && !unixEndPoint->Path().empty()) {
+                std::remove(unixEndPoint->Path().c_str());
+            }
+        }
+
+		if ((mHandle = socket((int)family, (int)type, (int)protocol)) == INVALID_SOCKET) {
+			throw socket_error(GetLastSocketErrorString);
+		}
+
+        mFamily = (U16)family;
+        mType = (U16)type;
+        mProtocol = (U16)(protocol != 0 ? protocol : Internal::GetSocketProtocol(mHandle));
+
 		switch (socketInformation.Options) {
             case SocketInformationOption::Connected:
                 if (connect(mHandle, (Addr*)&storage, addrsize) != 0) {
                     throw socket_error(GetLastSocketErrorString);
                 }
 
-			    mState.reset(new Internal::SocketConnected(this));
+			    mState.reset(new Internal::SocketConnected(this, endPoint));
 			    break;
 
             case SocketInformationOption::Bound:
@@ -53,7 +74,7 @@ namespace Lupus {
                     throw socket_error(GetLastSocketErrorString);
                 }
 
-			    mState.reset(new Internal::SocketBound(this));
+			    mState.reset(new Internal::SocketBound(this, endPoint));
 			    break;
 
 		    default:
@@ -68,11 +89,20 @@ namespace Lupus {
 			throw socket_error(GetLastSocketErrorString);
 		}
 
+        mFamily = (U16)family;
+        mType = (U16)type;
+        // Das System wählt bei einem unspezifizierten Protokoll selbst.
+        mProtocol = (U16)(protocol != ProtocolType::Unspecified ? (S32)protocol : Internal::GetSocketProtocol(mHandle));
         mState.reset(new Internal::SocketReady(this));
 	}
 
 	Socket::~Socket()
 	{
+        if (mDelayedClose) {
+            LockGuard<Mutex> lock(mDelayedClose->Lock);
+            mDelayedClose->Target = nullptr;
+        }
+
 		if (mHandle != INVALID_SOCKET) {
 			closesocket(mHandle);
 		}
@@ -83,7 +113,7 @@ namespace Lupus {
 		return mState->Accept(this);
 	}
 
-	void Socket::Bind(Pointer<IPEndPoint> localEndPoint)
+	void Socket::Bind(Pointer<EndPoint> localEndPoint)
 	{
 		mState->Bind(this, localEndPoint);
 	}
@@ -98,7 +128,7 @@ namespace Lupus {
 		mState->Close(this, timeout);
 	}
 
-	void Socket::Connect(Pointer<IPEndPoint> remoteEndPoint)
+	void Socket::Connect(Pointer<EndPoint> remoteEndPoint)
 	{
 		mState->Connect(this, remoteEndPoint);
 	}
@@ -130,6 +160,16 @@ namespace Lupus {
         return mState->DuplicateAndClose(this);
     }
 
+    SocketInformation Socket::DuplicateAndClose(Pointer<Socket> channel)
+    {
+        return mState->DuplicateAndClose(this, channel);
+    }
+
+    SocketInformation Socket::Duplicate(Pointer<Socket> channel)
+    {
+        return mState->Duplicate(this, channel);
+    }
+
 	void Socket::Listen(U32 backlog)
 	{
 		mState->Listen(this, backlog);
@@ -176,26 +216,85 @@ namespace Lupus {
 		return mState->Receive(this, buffer, offset, size, socketFlags, errorCode);
 	}
 
-	S32 Socket::ReceiveFrom(Vector<Byte>& buffer, Pointer<IPEndPoint>& remoteEndPoint)
+	S32 Socket::ReceiveFrom(Vector<Byte>& buffer, Pointer<EndPoint>& remoteEndPoint)
 	{
 		return mState->ReceiveFrom(this, buffer, 0, buffer.size(), SocketFlags::None, remoteEndPoint);
 	}
 
-	S32 Socket::ReceiveFrom(Vector<Byte>& buffer, U32 offset, Pointer<IPEndPoint>& remoteEndPoint)
+	S32 Socket::ReceiveFrom(Vector<Byte>& buffer, U32 offset, Pointer<EndPoint>& remoteEndPoint)
 	{
 		return mState->ReceiveFrom(this, buffer, offset, buffer.size() - offset, SocketFlags::None, remoteEndPoint);
 	}
 
-	S32 Socket::ReceiveFrom(Vector<Byte>& buffer, U32 offset, U32 size, Pointer<IPEndPoint>& remoteEndPoint)
+	S32 Socket::ReceiveFrom(Vector<Byte>& buffer, U32 offset, U32 size, Pointer<EndPoint>& remoteEndPoint)
 	{
 		return mState->ReceiveFrom(this, buffer, offset, size, SocketFlags::None, remoteEndPoint);
 	}
 
-	S32 Socket::ReceiveFrom(Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint>& remoteEndPoint)
+	S32 Socket::ReceiveFrom(Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint>& remoteEndPoint)
 	{
 		return mState->ReceiveFrom(this, buffer, offset, size, socketFlags, remoteEndPoint);
 	}
 
+    S32 Socket::Receive(PooledBuffer& buffer)
+    {
+        SocketError errorCode;
+        return Receive(buffer, SocketFlags::None, errorCode);
+    }
+
+    S32 Socket::Receive(PooledBuffer& buffer, SocketFlags socketFlags, SocketError& errorCode)
+    {
+        PrepareBuffer(buffer);
+
+        S32 result = mState->Receive(this, buffer.Data(), buffer.Capacity(), socketFlags, errorCode);
+
+        buffer.Size((result > 0) ? (U32)result : 0);
+        return result;
+    }
+
+    S32 Socket::ReceiveFrom(PooledBuffer& buffer, Pointer<EndPoint>& remoteEndPoint)
+    {
+        PrepareBuffer(buffer);
+
+        S32 result = mState->ReceiveFrom(this, buffer.Data(), buffer.Capacity(), SocketFlags::None, remoteEndPoint);
+
+        buffer.Size((result > 0) ? (U32)result : 0);
+        return result;
+    }
+
+    S32 Socket::Receive(BufferChain& buffer)
+    {
+        SocketError errorCode;
+        return Receive(buffer, SocketFlags::None, errorCode);
+    }
+
+    S32 Socket::Receive(BufferChain& buffer, SocketFlags socketFlags, SocketError& errorCode)
+    {
+        PooledBuffer received;
+        S32 result = Receive(received, socketFlags, errorCode);
+
+        if (result > 0) {
+            buffer.Append(received);
+        }
+
+        return result;
+    }
+
+    S32 Socket::Receive(Byte* buffer, U32 size)
+    {
+        SocketError errorCode;
+        return mState->Receive(this, buffer, size, SocketFlags::None, errorCode);
+    }
+
+    void Socket::PrepareBuffer(PooledBuffer& buffer) const
+    {
+        // In einen geteilten Buffer darf nicht geschrieben werden, da andere
+        // Verweise noch die alten Daten lesen.
+        if (buffer.IsEmpty() || buffer.References() > 1) {
+            buffer = BufferPool::Shared()->Lease((mType == SOCK_STREAM) ? BufferPool::MediumSize : BufferPool::LargeSize);
+        }
+    }
+
 	S32 Socket::Send(const Vector<Byte>& buffer)
 	{
 		SocketError errorCode;
@@ -225,22 +324,46 @@ namespace Lupus {
 		return mState->Send(this, buffer, offset, size, socketFlags, errorCode);
 	}
 
-	S32 Socket::SendTo(const Vector<Byte>& buffer, Pointer<IPEndPoint> remoteEndPoint)
+    S32 Socket::Send(const BufferChain& buffer)
+    {
+        SocketError errorCode;
+        return Send(buffer, SocketFlags::None, errorCode);
+    }
+
+    S32 Socket::Send(const BufferChain& buffer, SocketFlags socketFlags, SocketError& errorCode)
+    {
+        ByteSegment segments[MaxSegments];
+        U32 count = buffer.Segments(segments, MaxSegments);
+
+        return mState->Send(this, segments, count, socketFlags, errorCode);
+    }
+
+    S32 Socket::Send(const Byte* buffer, U32 size)
+    {
+        SocketError errorCode;
+        ByteSegment segment;
+
+        segment.Data = (Byte*)buffer;
+        segment.Size = size;
+        return mState->Send(this, &segment, 1, SocketFlags::None, errorCode);
+    }
+
+	S32 Socket::SendTo(const Vector<Byte>& buffer, Pointer<EndPoint> remoteEndPoint)
 	{
 		return mState->SendTo(this, buffer, 0, buffer.size(), SocketFlags::None, remoteEndPoint);
 	}
 
-	S32 Socket::SendTo(const Vector<Byte>& buffer, U32 offset, Pointer<IPEndPoint> remoteEndPoint)
+	S32 Socket::SendTo(const Vector<Byte>& buffer, U32 offset, Pointer<EndPoint> remoteEndPoint)
 	{
 		return mState->SendTo(this, buffer, offset, buffer.size() - offset, SocketFlags::None, remoteEndPoint);
 	}
 
-	S32 Socket::SendTo(const Vector<Byte>& buffer, U32 offset, U32 size, Pointer<IPEndPoint> remoteEndPoint)
+	S32 Socket::SendTo(const Vector<Byte>& buffer, U32 offset, U32 size, Pointer<EndPoint> remoteEndPoint)
 	{
 		return mState->SendTo(this, buffer, offset, size, SocketFlags::None, remoteEndPoint);
 	}
 
-	S32 Socket::SendTo(const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<IPEndPoint> remoteEndPoint)
+	S32 Socket::SendTo(const Vector<Byte>& buffer, U32 offset, U32 size, SocketFlags socketFlags, Pointer<EndPoint> remoteEndPoint)
 	{
 		return mState->SendTo(this, buffer, offset, size, socketFlags, remoteEndPoint);
 	}
@@ -250,17 +373,17 @@ namespace Lupus {
 		mState->Shutdown(this, how);
 	}
 
-	SocketHandle Socket::Handle() const
+	SocketHandle Socket::Handle() const NOEXCEPT
 	{
 		return mHandle;
 	}
 
-	bool Socket::IsConnected() const
+	bool Socket::IsConnected() const NOEXCEPT
 	{
         return mConnected;
 	}
 
-	bool Socket::IsBound() const
+	bool Socket::IsBound() const NOEXCEPT
 	{
         return mBound;
 	}
@@ -269,32 +392,26 @@ namespace Lupus {
     {
         S32 result, length = 4;
 
-        if (getsockopt(mHandle, SOL_SOCKET, SO_ACCEPTCONN, (char*)&result, (int*)&length) != 0) {
+        if (getsockopt(mHandle, SOL_SOCKET, SO_ACCEPTCONN, (char*)&result, (AddrLength*)&length) != 0) {
             throw socket_error(GetLastSocketErrorString);
         }
         
         return (result == 1);
 	}
 
-	AddressFamily Socket::Family() const
+	AddressFamily Socket::Family() const NOEXCEPT
 	{
-        return (AddressFamily)Internal::GetSocketDomain(mHandle);
+        return (AddressFamily)mFamily;
 	}
 	
-	ProtocolType Socket::Protocol() const
+	ProtocolType Socket::Protocol() const NOEXCEPT
 	{
-        return (ProtocolType)Internal::GetSocketProtocol(mHandle);
+        return (ProtocolType)mProtocol;
 	}
 	
-	SocketType Socket::Type() const
+	SocketType Socket::Type() const NOEXCEPT
 	{
-		S32 result, length = 4;
-
-		if (getsockopt(mHandle, SOL_SOCKET, SO_TYPE, (char*)&result, (int*)&length) != 0) {
-			throw socket_error(GetLastSocketErrorString);
-		}
-
-		return (SocketType)result;
+        return (SocketType)mType;
 	}
 
 	U32 Socket::Available() const
@@ -308,14 +425,14 @@ namespace Lupus {
 		return (U32)arg;
 	}
 
-	bool Socket::Blocking() const
+	bool Socket::Blocking() const NOEXCEPT
 	{
 		return mBlocking;
 	}
 
 	void Socket::Blocking(bool value)
 	{
-		u_long arg = value ? 1 : 0;
+		u_long arg = value ? 0 : 1;
 		mBlocking = value;
 
 		if (ioctlsocket(mHandle, FIONBIO, &(arg)) != 0) {
@@ -323,12 +440,12 @@ namespace Lupus {
 		}
     }
 
-    Pointer<IPEndPoint> Socket::LocalEndPoint() const
+    Pointer<EndPoint> Socket::LocalEndPoint() const NOEXCEPT
     {
         return mLocal;
     }
 
-    Pointer<IPEndPoint> Socket::RemoteEndPoint() const
+    Pointer<EndPoint> Socket::RemoteEndPoint() const NOEXCEPT
     {
         return mRemote;
     }
@@ -337,7 +454,7 @@ namespace Lupus {
 	{
 		S32 result, length = 4;
 		
-		if (getsockopt(mHandle, SOL_SOCKET, SO_SNDBUF, (char*)&result, (int*)&length) != 0) {
+		if (getsockopt(mHandle, SOL_SOCKET, SO_SNDBUF, (char*)&result, (AddrLength*)&length) != 0) {
 			throw socket_error(GetLastSocketErrorString);
 		}
 
@@ -355,7 +472,7 @@ namespace Lupus {
 	{
 		S32 result, length = 4;
 
-		if (getsockopt(mHandle, SOL_SOCKET, SO_RCVBUF, (char*)&result, (int*)&length) != 0) {
+		if (getsockopt(mHandle, SOL_SOCKET, SO_RCVBUF, (char*)&result, (AddrLength*)&length) != 0) {
 			throw socket_error(GetLastSocketErrorString);
 		}
 
@@ -369,7 +486,7 @@ namespace Lupus {
 		}
 	}
 	
-	S32 Socket::SendTimeout() const
+	S32 Socket::SendTimeout() const NOEXCEPT
 	{
 		return mSendTime;
 	}
@@ -383,7 +500,7 @@ namespace Lupus {
 		mSendTime = value;
 	}
 	
-	S32 Socket::ReceiveTimeout() const
+	S32 Socket::ReceiveTimeout() const NOEXCEPT
 	{
 		return mRecvTime;
 	}
@@ -397,6 +514,58 @@ namespace Lupus {
 		mRecvTime = value;
 	}
 
+    void Socket::CreatePair(SocketType type, Pointer<Socket>& first, Pointer<Socket>& second)
+    {
+#ifdef _MSC_VER
+        if (type != SocketType::Stream) {
+            throw socket_error("Only stream socket pairs are supported on this platform");
+        }
+
+        // Windows kennt kein socketpair, das Paar wird über eine
+        // Loopback-Verbindung hergestellt.
+        SocketPtr listener(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+        AddrStorage storage;
+        AddrLength length = sizeof(AddrStorage);
+
+        listener->Bind(IPEndPointPtr(new IPEndPoint(0x7F000001, 0)));
+        listener->Listen(1);
+        memset(&storage, 0, sizeof(AddrStorage));
+
+        if (getsockname(listener->Handle(), (Addr*)&storage, &length) != 0) {
+            throw socket_error(GetLastSocketErrorString);
+        }
+
+        first = SocketPtr(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+        first->Connect(EndPoint::Create(Vector<Byte>((Byte*)&storage, (Byte*)&storage + sizeof(AddrStorage)), (U32)length));
+        second = listener->Accept();
+#else
+        SocketHandle handles[2];
+
+        if (socketpair(AF_UNIX, (int)type, 0, handles) != 0) {
+            throw socket_error(GetLastSocketErrorString);
+        }
+
+        Socket* sockets[2] = { new Socket(), new Socket() };
+
+        first = SocketPtr(sockets[0]);
+        second = SocketPtr(sockets[1]);
+
+        // Beide Enden sind unbenannt und besitzen daher keine Endpunkte.
+        for (U32 i = 0; i < 2; i++) {
+            sockets[i]->mHandle = handles[i];
+            sockets[i]->mFamily = AF_UNIX;
+            sockets[i]->mType = (U16)type;
+            sockets[i]->mProtocol = 0;
+            sockets[i]->mState.reset(new Internal::SocketConnected(sockets[i]));
+        }
+#endif
+    }
+
+    Pointer<Socket> Socket::ReceiveDuplicate(Pointer<Socket> channel)
+    {
+        return Internal::SocketState::ReceiveDuplicate(channel);
+    }
+
 	void Socket::Select(const Vector<Pointer<Socket>>& checkRead, const Vector<Pointer<Socket>>& checkWrite, const Vector<Pointer<Socket>>& checkError, U32 microSeconds)
 	{
 		throw socket_error("Select is not implemented");
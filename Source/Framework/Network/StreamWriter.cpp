@@ -0,0 +1,45 @@
+﻿#include <Lupus/Network/StreamWriter.h>
+#include <Lupus/Network/NetworkStream.h>
+
+namespace Lupus {
+    StreamWriter::StreamWriter(Pointer<NetworkStream> stream) :
+        ByteWriter((Byte*)nullptr, 0)
+    {
+        if (!stream) {
+            throw null_pointer("stream points to NULL");
+        }
+
+        mStream = stream;
+    }
+
+    StreamWriter::~StreamWriter()
+    {
+        Commit();
+    }
+
+    Pointer<NetworkStream> StreamWriter::Stream() const NOEXCEPT
+    {
+        return mStream;
+    }
+
+    void StreamWriter::Commit() NOEXCEPT
+    {
+        // Used ist nie größer als der bei Next freie Platz.
+        mStream->Commit(Used());
+        Span(nullptr, 0);
+    }
+
+    bool StreamWriter::Next(U32 size)
+    {
+        if (size > mStream->WriteBufferSize()) {
+            return false;
+        }
+
+        mStream->Commit(Used());
+
+        Byte* buffer = mStream->Reserve(size);
+
+        Span(buffer, mStream->WriteBufferSize() - mStream->Pending());
+        return true;
+    }
+}
@@ -0,0 +1,275 @@
+﻿#include <Lupus/Network/TcpClient.h>
+#include <Lupus/Network/NetworkStream.h>
+#include <Lupus/Network/Socket.h>
+#include <Lupus/Network/IPAddress.h>
+#include <Lupus/Network/IPEndPoint.h>
+
+namespace Lupus {
+    TcpClient::TcpClient() :
+        TcpClient(AddressFamily::InterNetwork)
+    {
+    }
+
+    TcpClient::TcpClient(AddressFamily family)
+    {
+        if (family != AddressFamily::InterNetwork && family != AddressFamily::InterNetworkV6) {
+            throw std::invalid_argument("family must be either InterNetwork or InterNetworkV6");
+        }
+
+        mClient = SocketPtr(new Socket(family, SocketType::Stream, ProtocolType::TCP));
+    }
+
+    TcpClient::TcpClient(Pointer<IPEndPoint> localEndPoint)
+    {
+        if (!localEndPoint) {
+            throw null_pointer("localEndPoint points to NULL");
+        }
+
+        mClient = SocketPtr(new Socket(localEndPoint->Family(), SocketType::Stream, ProtocolType::TCP));
+        mClient->Bind(localEndPoint);
+    }
+
+    TcpClient::TcpClient(const String& hostname, U16 port)
+    {
+        IPAddressPtr address = IPAddress::Parse(hostname);
+
+        mClient = SocketPtr(new Socket(address->Family(), SocketType::Stream, ProtocolType::TCP));
+        Connect(address, port);
+    }
+
+    TcpClient::~TcpClient()
+    {
+        // Der Stream sendet ausstehende Daten in seinem Destruktor.
+        mStream.reset();
+    }
+
+    bool TcpClient::Active() const NOEXCEPT
+    {
+        return mActive;
+    }
+
+    void TcpClient::Active(bool value) NOEXCEPT
+    {
+        mActive = value;
+    }
+
+    U32 TcpClient::Available() const
+    {
+        return mClient->Available() + (mStream ? mStream->Buffered() : 0);
+    }
+
+    Pointer<Socket> TcpClient::Client() const NOEXCEPT
+    {
+        return mClient;
+    }
+
+    void TcpClient::Client(Pointer<Socket> socket)
+    {
+        if (!socket) {
+            throw null_pointer("socket points to NULL");
+        }
+
+        mClient = socket;
+        mStream.reset();
+        mActive = socket->IsConnected();
+        ResetOptionCache();
+    }
+
+    bool TcpClient::IsConnected() const NOEXCEPT
+    {
+        return mClient && mClient->IsConnected();
+    }
+
+    bool TcpClient::ExclusiveAddressUse() const
+    {
+        if (mExclusiveAddressUse < 0) {
+#ifdef _MSC_VER
+            S32 result = 0, length = 4;
+
+            if (getsockopt(mClient->Handle(), SOL_SOCKET, SO_EXCLUSIVEADDRUSE, (char*)&result, (AddrLength*)&length) != 0) {
+                throw socket_error(GetLastSocketErrorString);
+            }
+
+            mExclusiveAddressUse = (result != 0) ? 1 : 0;
+#else
+            S32 result = 0;
+            AddrLength length = 4;
+
+            // Ohne SO_EXCLUSIVEADDRUSE ist eine Adresse exklusiv gebunden
+            // solange SO_REUSEADDR nicht gesetzt ist.
+            if (getsockopt(mClient->Handle(), SOL_SOCKET, SO_REUSEADDR, (char*)&result, &length) != 0) {
+                throw socket_error(GetLastSocketErrorString);
+            }
+
+            mExclusiveAddressUse = (result != 0) ? 0 : 1;
+#endif
+        }
+
+        return (mExclusiveAddressUse == 1);
+    }
+
+    void TcpClient::ExclusiveAddressUse(bool value)
+    {
+#ifdef _MSC_VER
+        S32 arg = value ? 1 : 0;
+
+        if (setsockopt(mClient->Handle(), SOL_SOCKET, SO_EXCLUSIVEADDRUSE, (const char*)&arg, 4) != 0) {
+            throw socket_error(GetLastSocketErrorString);
+        }
+#else
+        S32 arg = value ? 0 : 1;
+
+        if (setsockopt(mClient->Handle(), SOL_SOCKET, SO_REUSEADDR, (const char*)&arg, 4) != 0) {
+            throw socket_error(GetLastSocketErrorString);
+        }
+#endif
+
+        mExclusiveAddressUse = value ? 1 : 0;
+    }
+
+    bool TcpClient::NoDelay() const
+    {
+        if (mNoDelay < 0) {
+            S32 result = 0, length = 4;
+
+            if (getsockopt(mClient->Handle(), IPPROTO_TCP, TCP_NODELAY, (char*)&result, (AddrLength*)&length) != 0) {
+                throw socket_error(GetLastSocketErrorString);
+            }
+
+            mNoDelay = (result != 0) ? 1 : 0;
+        }
+
+        return (mNoDelay == 1);
+    }
+
+    void TcpClient::NoDelay(bool value)
+    {
+        S32 arg = value ? 1 : 0;
+
+        if (setsockopt(mClient->Handle(), IPPROTO_TCP, TCP_NODELAY, (const char*)&arg, 4) != 0) {
+            throw socket_error(GetLastSocketErrorString);
+        }
+
+        mNoDelay = (S8)arg;
+    }
+
+    S32 TcpClient::SendBuffer() const
+    {
+        if (mSendBuffer < 0) {
+            mSendBuffer = mClient->SendBuffer();
+        }
+
+        return mSendBuffer;
+    }
+
+    void TcpClient::SendBuffer(S32 value)
+    {
+        mClient->SendBuffer(value);
+        // Das System darf den Wert anpassen (Linux verdoppelt ihn bspw).
+        mSendBuffer = mClient->SendBuffer();
+    }
+
+    S32 TcpClient::ReceiveBuffer() const
+    {
+        if (mReceiveBuffer < 0) {
+            mReceiveBuffer = mClient->ReceiveBuffer();
+        }
+
+        return mReceiveBuffer;
+    }
+
+    void TcpClient::ReceiveBuffer(S32 value)
+    {
+        mClient->ReceiveBuffer(value);
+        mReceiveBuffer = mClient->ReceiveBuffer();
+    }
+
+    S32 TcpClient::SendTimeout() const NOEXCEPT
+    {
+        return mClient->SendTimeout();
+    }
+
+    void TcpClient::SendTimeout(S32 value)
+    {
+        mClient->SendTimeout(value);
+    }
+
+    S32 TcpClient::ReceiveTimeout() const NOEXCEPT
+    {
+        return mClient->ReceiveTimeout();
+    }
+
+    void TcpClient::ReceiveTimeout(S32 value)
+    {
+        mClient->ReceiveTimeout(value);
+    }
+
+    void TcpClient::Close()
+    {
+        if (mStream) {
+            mStream->Close();
+            mStream.reset();
+        } else {
+            mClient->Close();
+        }
+
+        mActive = false;
+        ResetOptionCache();
+    }
+
+    void TcpClient::Connect(Pointer<IPEndPoint> remoteEndPoint)
+    {
+        if (!remoteEndPoint) {
+            throw null_pointer("remoteEndPoint points to NULL");
+        }
+
+        mClient->Connect(remoteEndPoint);
+        mActive = true;
+    }
+
+    void TcpClient::Connect(Pointer<IPAddress> address, U16 port)
+    {
+        if (!address) {
+            throw null_pointer("address points to NULL");
+        }
+
+        Connect(IPEndPointPtr(new IPEndPoint(address, port)));
+    }
+
+    void TcpClient::Connect(const Vector<Pointer<IPEndPoint>>& endPoints)
+    {
+        mClient->Connect(endPoints);
+
+        if (!mClient->IsConnected()) {
+            throw socket_error("Could not connect to any of the given end points");
+        }
+
+        mActive = true;
+    }
+
+    void TcpClient::Connect(const String& host, U16 port)
+    {
+        Connect(IPAddress::Parse(host), port);
+    }
+
+    Pointer<NetworkStream> TcpClient::GetStream()
+    {
+        if (!IsConnected()) {
+            throw socket_error("Client is not connected");
+        }
+
+        if (!mStream) {
+            mStream = NetworkStreamPtr(new NetworkStream(mClient));
+        }
+
+        return mStream;
+    }
+
+    void TcpClient::ResetOptionCache() NOEXCEPT
+    {
+        mSendBuffer = -1;
+        mReceiveBuffer = -1;
+        mNoDelay = -1;
+        mExclusiveAddressUse = -1;
+    }
+}
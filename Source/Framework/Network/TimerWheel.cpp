@@ -0,0 +1,227 @@
+﻿#include <Lupus/Network/TimerWheel.h>
+
+namespace Lupus {
+    namespace {
+        static const U32 SlotBits = 8;
+        static const U32 SlotMask = TimerWheel::SlotCount - 1;
+        static const U64 MaximumDelay = 0xFFFFFFFFull;
+    }
+
+    Timer::Timer(Function<void()> callback) NOEXCEPT :
+        mCallback(callback)
+    {
+    }
+
+    Timer::~Timer()
+    {
+        if (mWheel) {
+            mWheel->Stop(*this);
+        }
+    }
+
+    void Timer::Callback(Function<void()> callback) NOEXCEPT
+    {
+        mCallback = callback;
+    }
+
+    bool Timer::IsPending() const NOEXCEPT
+    {
+        return (mWheel != nullptr);
+    }
+
+    U64 Timer::Expires() const NOEXCEPT
+    {
+        return mExpires;
+    }
+
+    TimerWheel::TimerWheel() NOEXCEPT
+    {
+        memset(mSlots, 0, sizeof(mSlots));
+    }
+
+    TimerWheel::~TimerWheel()
+    {
+        for (U32 level = 0; level < LevelCount; level++) {
+            for (U32 index = 0; index < SlotCount; index++) {
+                while (Timer* timer = mSlots[level][index]) {
+                    Unlink(timer);
+
+                    if (timer->mOwned) {
+                        delete timer;
+                    }
+                }
+            }
+        }
+    }
+
+    U64 TimerWheel::Now() const NOEXCEPT
+    {
+        return mNow;
+    }
+
+    U32 TimerWheel::Count() const NOEXCEPT
+    {
+        return mCount;
+    }
+
+    void TimerWheel::Start(Timer& timer, U64 delay) NOEXCEPT
+    {
+        if (timer.mWheel) {
+            timer.mWheel->Stop(timer);
+        }
+
+        // Ein Zeitgeber läuft frühestens beim nächsten Tick ab, damit ein
+        // Callback sich nicht endlos im aktuellen Feld neu starten kann.
+        timer.mExpires = mNow + ((delay > 0) ? delay : 1);
+        timer.mWheel = this;
+        Insert(&timer);
+        mCount++;
+    }
+
+    void TimerWheel::Stop(Timer& timer) NOEXCEPT
+    {
+        if (timer.mWheel != this) {
+            return;
+        }
+
+        Unlink(&timer);
+    }
+
+    void TimerWheel::Schedule(U64 delay, Function<void()> callback)
+    {
+        Timer* timer = new Timer(callback);
+
+        timer->mOwned = true;
+        Start(*timer, delay);
+    }
+
+    U32 TimerWheel::Advance(U64 now)
+    {
+        U32 fired = 0;
+
+        while (mNow < now) {
+            // Ohne laufende Zeitgeber muss kein Feld besucht werden.
+            if (mCount == 0) {
+                mNow = now;
+                break;
+            }
+
+            U32 index = (U32)(++mNow & SlotMask);
+
+            if (index == 0) {
+                for (U32 level = 1; level < LevelCount; level++) {
+                    U32 slot = (U32)((mNow >> (level * SlotBits)) & SlotMask);
+
+                    Cascade(level, slot);
+
+                    if (slot != 0) {
+                        break;
+                    }
+                }
+            }
+
+            while (Timer* timer = mSlots[0][index]) {
+                Unlink(timer);
+                fired++;
+
+                if (timer->mOwned) {
+                    UniquePointer<Timer> owned(timer);
+
+                    if (owned->mCallback) {
+                        owned->mCallback();
+                    }
+                } else if (timer->mCallback) {
+                    // Der Callback darf seinen eigenen Zeitgeber zerstören.
+                    Function<void()> callback = timer->mCallback;
+                    callback();
+                }
+            }
+        }
+
+        return fired;
+    }
+
+    U64 TimerWheel::NextExpiration() const NOEXCEPT
+    {
+        if (mCount == 0) {
+            return (U64)-1;
+        }
+
+        for (U64 delta = 1; delta <= SlotCount; delta++) {
+            U64 tick = mNow + delta;
+
+            // Beim Überlauf der ersten Ebene werden höhere Ebenen verteilt.
+            if ((tick & SlotMask) == 0 || mSlots[0][tick & SlotMask]) {
+                return delta;
+            }
+        }
+
+        return SlotCount;
+    }
+
+    void TimerWheel::Insert(Timer* timer) NOEXCEPT
+    {
+        U64 expires = timer->mExpires;
+        U64 delta = (expires > mNow) ? expires - mNow : 0;
+        U32 level = 0;
+
+        if (delta > MaximumDelay) {
+            expires = mNow + MaximumDelay;
+            delta = MaximumDelay;
+        }
+
+        while (level < LevelCount - 1 && delta >= ((U64)1 << ((level + 1) * SlotBits))) {
+            level++;
+        }
+
+        // Bereits fällige Zeitgeber landen im aktuellen Feld.
+        Timer** slot = &mSlots[level][(expires >> (level * SlotBits)) & SlotMask];
+
+        if (delta == 0) {
+            slot = &mSlots[0][mNow & SlotMask];
+        }
+
+        timer->mSlot = slot;
+        timer->mPrevious = nullptr;
+        timer->mNext = *slot;
+
+        if (*slot) {
+            (*slot)->mPrevious = timer;
+        }
+
+        *slot = timer;
+    }
+
+    void TimerWheel::Unlink(Timer* timer) NOEXCEPT
+    {
+        if (timer->mPrevious) {
+            timer->mPrevious->mNext = timer->mNext;
+        } else {
+            *timer->mSlot = timer->mNext;
+        }
+
+        if (timer->mNext) {
+            timer->mNext->mPrevious = timer->mPrevious;
+        }
+
+        timer->mWheel = nullptr;
+        timer->mSlot = nullptr;
+        timer->mPrevious = nullptr;
+        timer->mNext = nullptr;
+        mCount--;
+    }
+
+    void TimerWheel::Cascade(U32 level, U32 index) NOEXCEPT
+    {
+        Timer* timer = mSlots[level][index];
+
+        mSlots[level][index] = nullptr;
+
+        while (timer) {
+            Timer* next = timer->mNext;
+
+            Insert(timer);
+            timer = next;
+        }
+    }
+}
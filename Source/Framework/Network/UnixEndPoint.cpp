@@ -0,0 +1,82 @@
+﻿#include <Lupus/Network/UnixEndPoint.h>
+#include <cstddef>
+
+namespace Lupus {
+    UnixEndPoint::UnixEndPoint(const String& path) :
+        UnixEndPoint(path, false)
+    {
+    }
+
+    UnixEndPoint::UnixEndPoint(const String& path, bool abstract)
+    {
+        AddrUnix* addr = (AddrUnix*)&mAddrStorage;
+
+        if (path.empty()) {
+            throw std::invalid_argument("path must not be empty");
+        } else if (path.size() >= sizeof(addr->sun_path)) {
+            throw std::invalid_argument("path is too long");
+        } else if (path.find('\0') != String::npos) {
+            throw std::invalid_argument("path must not contain null characters");
+        }
+
+        memset(&mAddrStorage, 0, sizeof(AddrStorage));
+        addr->sun_family = AF_UNIX;
+
+        // Abstrakte Namen beginnen mit einem Nullbyte und sind nicht
+        // terminiert, die Länge bestimmt daher den Namen.
+        memcpy(addr->sun_path + (abstract ? 1 : 0), path.c_str(), path.size());
+        mLength = (U32)(offsetof(AddrUnix, sun_path) + path.size() + 1);
+    }
+
+    UnixEndPoint::UnixEndPoint(const Vector<Byte>& buffer, U32 length)
+    {
+        if (buffer.size() != sizeof(AddrStorage) || length > sizeof(AddrUnix)) {
+            throw std::invalid_argument("buffer contains invalid data");
+        }
+
+        memcpy(&mAddrStorage, buffer.data(), sizeof(AddrStorage));
+
+        if (mAddrStorage.ss_family != AF_UNIX) {
+            throw std::invalid_argument("buffer contains an unsupported address family");
+        }
+
+        // Unbenannte Sockets liefern lediglich die Adressfamilie.
+        mLength = (length < offsetof(AddrUnix, sun_path)) ? (U32)offsetof(AddrUnix, sun_path) : length;
+    }
+
+    AddressFamily UnixEndPoint::Family() const NOEXCEPT
+    {
+        return AddressFamily::UNIX;
+    }
+
+    U32 UnixEndPoint::Length() const NOEXCEPT
+    {
+        return mLength;
+    }
+
+    String UnixEndPoint::Path() const NOEXCEPT
+    {
+        const AddrUnix* addr = (const AddrUnix*)&mAddrStorage;
+        U32 size = mLength - (U32)offsetof(AddrUnix, sun_path);
+
+        if (size == 0) {
+            return String();
+        } else if (IsAbstract()) {
+            return String(addr->sun_path + 1, size - 1);
+        }
+
+        return String(addr->sun_path, strnlen(addr->sun_path, size));
+    }
+
+    bool UnixEndPoint::IsAbstract() const NOEXCEPT
+    {
+        const AddrUnix* addr = (const AddrUnix*)&mAddrStorage;
+
+        return (mLength > offsetof(AddrUnix, sun_path)) && (addr->sun_path[0] == '\0');
+    }
+
+    Vector<Byte> UnixEndPoint::Serialize() const NOEXCEPT
+    {
+        return Vector<Byte>((Byte*)&mAddrStorage, (Byte*)&mAddrStorage + sizeof(AddrStorage));
+    }
+}
@@ -3,36 +3,179 @@
 #include <Lupus/Network/IPEndPoint.h>
 #include <Lupus/Network/Socket.h>
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define LU_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LU_TARGET(isa)
+#else
+#define LU_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
 namespace Lupus {
-	U16 HostToNetworkOrder(U16 host)
-	{
-		return htons(host);
-	}
+    namespace {
+        // Shuffle-Masken die innerhalb von 16 Bytes jeden Wert umdrehen.
+        const Byte Mask16[16] = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+        const Byte Mask32[16] = { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+        const Byte Mask64[16] = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+#ifdef LU_X86
+        enum class SimdLevel { Unknown, None, SSSE3, AVX2 };
+
+        Atomic<SimdLevel> sSimdLevel(SimdLevel::Unknown);
+
+        SimdLevel DetectSimdLevel()
+        {
+#ifdef _MSC_VER
+            int info[4];
+            bool ssse3, avx2 = false;
+
+            __cpuid(info, 0);
+            int maximum = info[0];
+
+            __cpuid(info, 1);
+            ssse3 = (info[2] & (1 << 9)) != 0;
+
+            // AVX2 benötigt zusätzlich die Unterstützung des Betriebssystems
+            // für die YMM-Register.
+            if (maximum >= 7 && (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6) {
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            bool ssse3 = __builtin_cpu_supports("ssse3") != 0;
+            bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
 
-	U32 HostToNetworkOrder(U32 host)
-	{
-		return htonl(host);
-	}
+            return avx2 ? SimdLevel::AVX2 : (ssse3 ? SimdLevel::SSSE3 : SimdLevel::None);
+        }
 
-	U64 HostToNetworkOrder(U64 host)
-	{
-		return htonll(host);
-	}
+        LU_TARGET("ssse3")
+        size_t ShuffleSSSE3(const Byte* source, Byte* target, size_t size, const Byte* mask)
+        {
+            const __m128i shuffle = _mm_loadu_si128((const __m128i*)mask);
+            size_t i = 0;
 
-	U16 NetworkToHostOrder(U16 network)
-	{
-		return ntohs(network);
-	}
+            for (; i + 16 <= size; i += 16) {
+                __m128i value = _mm_loadu_si128((const __m128i*)(source + i));
+                _mm_storeu_si128((__m128i*)(target + i), _mm_shuffle_epi8(value, shuffle));
+            }
 
-	U32 NetworkToHostOrder(U32 network)
-	{
-		return ntohl(network);
-	}
+            return i;
+        }
 
-	U64 NetworkToHostOrder(U64 network)
-	{
-		return ntohll(network);
-	}
+        LU_TARGET("avx2")
+        size_t ShuffleAVX2(const Byte* source, Byte* target, size_t size, const Byte* mask)
+        {
+            // vpshufb arbeitet je 128-Bit Hälfte, daher genügt die doppelte
+            // 16 Byte Maske.
+            const __m128i half = _mm_loadu_si128((const __m128i*)mask);
+            const __m256i shuffle = _mm256_inserti128_si256(_mm256_castsi128_si256(half), half, 1);
+            size_t i = 0;
+
+            for (; i + 32 <= size; i += 32) {
+                __m256i value = _mm256_loadu_si256((const __m256i*)(source + i));
+                _mm256_storeu_si256((__m256i*)(target + i), _mm256_shuffle_epi8(value, shuffle));
+            }
+
+            return i;
+        }
+#endif
+
+        template <typename T>
+        void ConvertBulk(const T* source, T* target, U32 count, const Byte* mask)
+        {
+#ifdef LU_BIG_ENDIAN
+            if (source != target) {
+                memmove(target, source, count * sizeof(T));
+            }
+#else
+            size_t done = 0;
+
+#ifdef LU_X86
+            SimdLevel level = sSimdLevel.load(std::memory_order_relaxed);
+
+            if (level == SimdLevel::Unknown) {
+                level = DetectSimdLevel();
+                sSimdLevel.store(level, std::memory_order_relaxed);
+            }
+
+            if (level == SimdLevel::AVX2) {
+                done = ShuffleAVX2((const Byte*)source, (Byte*)target, count * sizeof(T), mask) / sizeof(T);
+            } else if (level == SimdLevel::SSSE3) {
+                done = ShuffleSSSE3((const Byte*)source, (Byte*)target, count * sizeof(T), mask) / sizeof(T);
+            }
+#endif
+
+            for (size_t i = done; i < count; i++) {
+                target[i] = Internal::ByteSwap(source[i]);
+            }
+#endif
+        }
+    }
+
+    U16 HostToNetworkOrder(U16 host) NOEXCEPT
+    {
+        return ToNetworkOrder(host);
+    }
+
+    U32 HostToNetworkOrder(U32 host) NOEXCEPT
+    {
+        return ToNetworkOrder(host);
+    }
+
+    U64 HostToNetworkOrder(U64 host) NOEXCEPT
+    {
+        return ToNetworkOrder(host);
+    }
+
+    U16 NetworkToHostOrder(U16 network) NOEXCEPT
+    {
+        return ToHostOrder(network);
+    }
+
+    U32 NetworkToHostOrder(U32 network) NOEXCEPT
+    {
+        return ToHostOrder(network);
+    }
+
+    U64 NetworkToHostOrder(U64 network) NOEXCEPT
+    {
+        return ToHostOrder(network);
+    }
+
+    void HostToNetworkOrder(const U16* source, U16* target, U32 count) NOEXCEPT
+    {
+        ConvertBulk(source, target, count, Mask16);
+    }
+
+    void HostToNetworkOrder(const U32* source, U32* target, U32 count) NOEXCEPT
+    {
+        ConvertBulk(source, target, count, Mask32);
+    }
+
+    void HostToNetworkOrder(const U64* source, U64* target, U32 count) NOEXCEPT
+    {
+        ConvertBulk(source, target, count, Mask64);
+    }
+
+    void NetworkToHostOrder(const U16* source, U16* target, U32 count) NOEXCEPT
+    {
+        ConvertBulk(source, target, count, Mask16);
+    }
+
+    void NetworkToHostOrder(const U32* source, U32* target, U32 count) NOEXCEPT
+    {
+        ConvertBulk(source, target, count, Mask32);
+    }
+
+    void NetworkToHostOrder(const U64* source, U64* target, U32 count) NOEXCEPT
+    {
+        ConvertBulk(source, target, count, Mask64);
+    }
 
     Vector<Pointer<IPEndPoint>> GetAddressInformation(const String& node, const String& service)
 	{
@@ -0,0 +1,220 @@
+﻿#include <Lupus/Threading/Scheduler.h>
+#include <Internal/Threading/WorkStealingDeque.h>
+#include <algorithm>
+
+namespace Lupus {
+    namespace {
+        // Scheduler und Index des Workers im aktuellen Thread.
+        LU_THREAD_LOCAL const void* CurrentScheduler = nullptr;
+        LU_THREAD_LOCAL U32 CurrentWorker = 0;
+    }
+
+    struct Scheduler::Worker
+    {
+        Internal::WorkStealingDeque<Task> Tasks;
+        Mutex InboxMutex;
+        Deque<Task*> Inbox;
+        U32 Seed;
+        Thread Handle;
+    };
+
+    Scheduler::Scheduler() :
+        Scheduler(std::max(Thread::hardware_concurrency(), 1U))
+    {
+    }
+
+    Scheduler::Scheduler(U32 workers) :
+        mSleeping(0),
+        mPending(0),
+        mStopping(false)
+    {
+        if (workers == 0) {
+            throw std::invalid_argument("workers must be greater than zero");
+        }
+
+        for (U32 i = 0; i < workers; i++) {
+            mWorkers.push_back(Pointer<Worker>(new Worker()));
+            mWorkers.back()->Seed = i * 2654435761U + 1;
+        }
+
+        // Erst starten wenn alle Worker existieren, Diebe greifen auf jeden
+        // Eintrag zu.
+        for (U32 i = 0; i < workers; i++) {
+            mWorkers[i]->Handle = Thread(&Scheduler::Run, this, i);
+        }
+    }
+
+    Scheduler::~Scheduler()
+    {
+        {
+            LockGuard<Mutex> lock(mMutex);
+            mStopping.store(true);
+        }
+
+        mCondition.notify_all();
+
+        for (Pointer<Worker>& worker : mWorkers) {
+            worker->Handle.join();
+        }
+    }
+
+    U32 Scheduler::Workers() const NOEXCEPT
+    {
+        return (U32)mWorkers.size();
+    }
+
+    S32 Scheduler::Current() const NOEXCEPT
+    {
+        return (CurrentScheduler == this) ? (S32)CurrentWorker : -1;
+    }
+
+    void Scheduler::Submit(Function<void()> task)
+    {
+        Task* item = new Task(std::move(task));
+
+        if (CurrentScheduler == this) {
+            mWorkers[CurrentWorker]->Tasks.Push(item);
+        } else {
+            LockGuard<Mutex> lock(mMutex);
+            mInjected.push_back(item);
+        }
+
+        mPending.fetch_add(1);
+        Notify();
+    }
+
+    void Scheduler::Submit(U32 worker, Function<void()> task)
+    {
+        Task* item = new Task(std::move(task));
+        Worker& target = *mWorkers[worker % mWorkers.size()];
+
+        if (CurrentScheduler == this && &target == mWorkers[CurrentWorker].get()) {
+            target.Tasks.Push(item);
+        } else {
+            LockGuard<Mutex> lock(target.InboxMutex);
+            target.Inbox.push_back(item);
+        }
+
+        mPending.fetch_add(1);
+        Notify();
+    }
+
+    void Scheduler::Run(U32 index) NOEXCEPT
+    {
+        Worker& worker = *mWorkers[index];
+
+        CurrentScheduler = this;
+        CurrentWorker = index;
+
+        for (;;) {
+            Task* task = Find(worker);
+
+            if (task) {
+                mPending.fetch_sub(1);
+
+                try {
+                    (*task)();
+                } catch (...) {
+                }
+
+                delete task;
+                continue;
+            }
+
+            std::unique_lock<Mutex> lock(mMutex);
+
+            // Zuerst als schlafend melden und danach erneut prüfen, sonst
+            // könnte eine gleichzeitig eingereihte Aufgabe verloren gehen.
+            mSleeping.fetch_add(1);
+
+            while (mPending.load() == 0 && !mStopping.load()) {
+                mCondition.wait(lock);
+            }
+
+            mSleeping.fetch_sub(1);
+
+            if (mStopping.load() && mPending.load() == 0) {
+                return;
+            }
+        }
+    }
+
+    Scheduler::Task* Scheduler::Find(Worker& worker) NOEXCEPT
+    {
+        Task* task;
+        U32 count = (U32)mWorkers.size();
+
+        if ((task = worker.Tasks.Pop()) != nullptr) {
+            return task;
+        }
+
+        // Der Eingang wird vollständig in die Deque übernommen, damit andere
+        // Worker davon stehlen können.
+        {
+            LockGuard<Mutex> lock(worker.InboxMutex);
+
+            while (!worker.Inbox.empty()) {
+                worker.Tasks.Push(worker.Inbox.front());
+                worker.Inbox.pop_front();
+            }
+        }
+
+        if ((task = worker.Tasks.Pop()) != nullptr) {
+            return task;
+        }
+
+        if ((task = Take(mMutex, mInjected, false)) != nullptr) {
+            return task;
+        }
+
+        // Opfer ab einer zufälligen Position durchgehen (xorshift).
+        worker.Seed ^= worker.Seed << 13;
+        worker.Seed ^= worker.Seed >> 17;
+        worker.Seed ^= worker.Seed << 5;
+
+        for (U32 i = 0, start = worker.Seed % count; i < count; i++) {
+            Worker& victim = *mWorkers[(start + i) % count];
+
+            if (&victim == &worker) {
+                continue;
+            } else if ((task = victim.Tasks.Steal()) != nullptr) {
+                return task;
+            } else if ((task = Take(victim.InboxMutex, victim.Inbox, true)) != nullptr) {
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Scheduler::Task* Scheduler::Take(Mutex& mutex, Deque<Task*>& queue, bool steal) NOEXCEPT
+    {
+        std::unique_lock<Mutex> lock(mutex, std::defer_lock);
+
+        // Fremde Eingänge werden nur ohne Warten durchsucht.
+        if (steal) {
+            if (!lock.try_lock()) {
+                return nullptr;
+            }
+        } else {
+            lock.lock();
+        }
+
+        if (queue.empty()) {
+            return nullptr;
+        }
+
+        Task* task = queue.front();
+
+        queue.pop_front();
+        return task;
+    }
+
+    void Scheduler::Notify() NOEXCEPT
+    {
+        if (mSleeping.load() > 0) {
+            LockGuard<Mutex> lock(mMutex);
+            mCondition.notify_one();
+        }
+    }
+}
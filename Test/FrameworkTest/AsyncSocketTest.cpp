@@ -0,0 +1,113 @@
+﻿#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/AsyncSocket.h>
+
+#ifdef LUPUS_COROUTINES
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(AsyncSocketTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(AsyncSocketTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(AsyncSocketTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        static Task<S32> Echo(EventLoop& loop, SocketPtr socket)
+        {
+            AsyncSocket client(loop, socket);
+            Vector<Byte> buffer(16);
+            S32 total = 0, result;
+
+            while ((result = co_await client.ReceiveAsync(buffer)) > 0) {
+                co_await client.SendAsync(buffer, 0, (U32)result);
+                total += result;
+            }
+
+            co_return total;
+        }
+
+        static Task<> Run(EventLoop& loop, SocketPtr socket, S32& total, bool& done)
+        {
+            total = co_await Echo(loop, socket);
+            done = true;
+        }
+
+        TEST_METHOD(AsyncSocket_Echo)
+        {
+            EventLoop loop;
+            SocketPtr first, second;
+            Vector<Byte> buffer(3);
+            S32 total = 0;
+            bool done = false;
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            Spawn(Run(loop, second, total, done));
+
+            // Die Koroutine wartet bereits im EventLoop.
+            Assert::AreEqual(1U, loop.Count());
+            first->Send(Vector<Byte>({ 1, 2, 3 }));
+            loop.RunOnce(1000);
+            Assert::AreEqual(3, first->Receive(buffer));
+            Assert::AreEqual<Byte>(3, buffer[2]);
+
+            first->Shutdown(SocketShutdown::Send);
+
+            while (!done) {
+                loop.RunOnce(1000);
+            }
+
+            Assert::AreEqual(3, total);
+            Assert::AreEqual(0U, loop.Count());
+        }
+
+        static Task<> ReceiveOnce(AsyncSocket& socket, S32& result)
+        {
+            Vector<Byte> buffer(16);
+
+            result = co_await socket.ReceiveAsync(buffer);
+        }
+
+        TEST_METHOD(AsyncSocket_KeepsRegistration)
+        {
+            EventLoop loop;
+            SocketPtr first, second;
+            S32 result = -1;
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+
+            AsyncSocket client(loop, second);
+
+            Assert::ExpectException<std::invalid_argument>([&]() { AsyncSocket(loop, second); });
+            loop.Deadline(second, SocketDeadline::ReadIdle, 10000);
+
+            // Zweimal warten, die Registrierung samt Frist bleibt bestehen.
+            for (U32 i = 0; i < 2; i++) {
+                result = -1;
+                Spawn(ReceiveOnce(client, result));
+                first->Send(Vector<Byte>({ 1 }));
+
+                while (result < 0) {
+                    loop.RunOnce(1000);
+                }
+
+                Assert::AreEqual(1, result);
+                Assert::AreEqual(1U, loop.Count());
+                Assert::AreEqual(10000U, loop.Deadline(second, SocketDeadline::ReadIdle));
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,243 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Memory/BuddyAllocator.h>
+#include <Lupus/Network/NetworkStream.h>
+#include <Lupus/Network/Socket.h>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(BuddyAllocatorTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(BuddyAllocatorTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(BuddyAllocatorTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        TEST_METHOD(BuddyAllocator_Constructor)
+        {
+            BuddyAllocator allocator(3 * MiB);
+
+            Assert::AreEqual(4U * KiB, allocator.MinBlockSize());
+            Assert::AreEqual(1U * MiB, allocator.MaxBlockSize());
+            Assert::AreEqual<U64>(3 * MiB, allocator.Statistics().FreeBytes);
+            Assert::ExpectException<std::invalid_argument>([] { BuddyAllocator(1 * MiB, 3 * KiB); });
+            Assert::ExpectException<std::invalid_argument>([] { BuddyAllocator(1 * MiB, 8 * KiB, 4 * KiB); });
+        }
+
+        TEST_METHOD(BuddyAllocator_SplitCoalesce)
+        {
+            BuddyAllocator allocator(64 * KiB, 4 * KiB, 64 * KiB);
+            Byte* first = (Byte*)allocator.Allocate(3000);
+            Byte* second = (Byte*)allocator.Allocate(4 * KiB);
+            Byte* third = (Byte*)allocator.Allocate(20 * KiB);
+
+            Assert::IsNotNull(third);
+            Assert::AreEqual(4U * KiB, allocator.BlockSize(first));
+            Assert::AreEqual(32U * KiB, allocator.BlockSize(third));
+            Assert::IsTrue(first + 4 * KiB == second);
+            Assert::IsNull(allocator.Allocate(32 * KiB));
+            Assert::IsNull(allocator.Allocate(128 * KiB));
+
+            BuddyStatistics statistics = allocator.Statistics();
+            Assert::AreEqual(3U, statistics.Blocks);
+            Assert::AreEqual<U64>(24 * KiB, statistics.FreeBytes);
+            Assert::AreEqual<U64>(3000 + 24 * KiB, statistics.RequestedBytes);
+            Assert::AreEqual(1U, statistics.FreeBlocks[1]);
+            Assert::AreEqual(1U, statistics.FreeBlocks[2]);
+
+            // Erst wenn beide Partner frei sind entsteht wieder ein Block.
+            allocator.Free(first);
+            Assert::AreEqual<U64>(16 * KiB, allocator.Statistics().LargestFreeBlock);
+            allocator.Free(second);
+            allocator.Free(third);
+            allocator.Free(nullptr);
+
+            statistics = allocator.Statistics();
+            Assert::AreEqual<U64>(64 * KiB, statistics.LargestFreeBlock);
+            Assert::AreEqual(0.0f, statistics.ExternalFragmentation);
+            Assert::AreEqual(1U, statistics.FreeBlocks[4]);
+            Assert::ExpectException<std::invalid_argument>([&] { allocator.Free(second); });
+            Assert::ExpectException<std::invalid_argument>([&] { allocator.Free(first + 1); });
+        }
+
+        TEST_METHOD(BuddyAllocator_Fragmentation)
+        {
+            BuddyAllocator allocator(64 * KiB, 4 * KiB, 64 * KiB);
+            Vector<void*> blocks;
+
+            for (U32 i = 0; i < 16; i++) {
+                blocks.push_back(allocator.Allocate(4 * KiB));
+            }
+
+            // Jeder zweite Block bleibt belegt, kein Partner kann verschmelzen.
+            for (U32 i = 0; i < 16; i += 2) {
+                allocator.Free(blocks[i]);
+            }
+
+            BuddyStatistics statistics = allocator.Statistics();
+            Assert::AreEqual<U64>(32 * KiB, statistics.FreeBytes);
+            Assert::AreEqual<U64>(4 * KiB, statistics.LargestFreeBlock);
+            Assert::AreEqual(0.875f, statistics.ExternalFragmentation);
+            Assert::IsNull(allocator.Allocate(8 * KiB));
+        }
+
+        TEST_METHOD(BuddyAllocator_Random)
+        {
+            BuddyAllocator allocator(4 * MiB);
+            std::mt19937 random(42);
+            Vector<std::pair<Byte*, U32>> blocks;
+
+            for (U32 i = 0; i < 20000; i++) {
+                if (blocks.empty() || random() % 3 != 0) {
+                    U32 size = 1 + random() % (256 * KiB);
+                    Byte* block = (Byte*)allocator.Allocate(size);
+
+                    if (block) {
+                        memset(block, (Byte)i, size);
+                        blocks.push_back(std::make_pair(block, size));
+                    }
+                } else {
+                    size_t index = random() % blocks.size();
+
+                    Assert::AreEqual(blocks[index].first[0], blocks[index].first[blocks[index].second - 1]);
+                    allocator.Free(blocks[index].first);
+                    blocks[index] = blocks.back();
+                    blocks.pop_back();
+                }
+            }
+
+            for (auto& block : blocks) {
+                allocator.Free(block.first);
+            }
+
+            BuddyStatistics statistics = allocator.Statistics();
+            Assert::AreEqual<U64>(4 * MiB, statistics.FreeBytes);
+            Assert::AreEqual(4U, statistics.FreeBlocks.back());
+            Assert::AreEqual<U64>(0, statistics.RequestedBytes);
+        }
+
+        TEST_METHOD(BuddyAllocator_NetworkStream)
+        {
+            BuddyAllocatorPtr allocator(new BuddyAllocator(1 * MiB, 4 * KiB, 64 * KiB));
+            SocketPtr first, second;
+            Vector<Byte> data(20 * KiB, 7);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+
+            NetworkStream writer(first, allocator);
+            NetworkStream reader(second, allocator);
+
+            // Reserve vergrößert den Schreib-Buffer, Flush gibt ihn wieder frei.
+            Byte* target = writer.Reserve(20 * KiB);
+            memcpy(target, data.data(), data.size());
+            writer.Commit(20 * KiB);
+            Assert::AreEqual(32U * KiB, writer.WriteBufferSize());
+            writer.Flush();
+            Assert::AreEqual(4U * KiB, writer.WriteBufferSize());
+
+            // Ein voller Lese-Buffer wächst bis die Daten hinein passen.
+            while (reader.Buffered() < 20 * KiB) {
+                Assert::IsTrue(reader.Fill() > 0);
+            }
+
+            Assert::IsTrue(reader.ReadBufferSize() >= 32 * KiB);
+            Assert::AreEqual<Byte>(7, reader.Peek()[20 * KiB - 1]);
+            reader.Consume(20 * KiB);
+
+            // Ist er leer, dann schrumpft er beim nächsten Fill.
+            writer.Write(Vector<Byte>(16, 1));
+            writer.Flush();
+            Assert::AreEqual(16, reader.Fill());
+            Assert::AreEqual(4U * KiB, reader.ReadBufferSize());
+            Assert::AreEqual(4U, allocator->Statistics().Blocks);
+            Assert::ExpectException<std::out_of_range>([&] { writer.Reserve(128 * KiB); });
+        }
+
+        TEST_METHOD(BuddyAllocator_NetworkStreamFull)
+        {
+            BuddyAllocatorPtr allocator(new BuddyAllocator(16 * KiB, 4 * KiB, 16 * KiB));
+            SocketPtr first, second;
+            Vector<Byte> buffer(16 * KiB);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+
+            NetworkStream stream(first, allocator);
+
+            // Der vergrößerte Schreib-Buffer und ein fremder Block füllen die
+            // Arena. Flush gibt den großen Block vor dem kleinen frei.
+            memset(stream.Reserve(8 * KiB), 5, 8 * KiB);
+            stream.Commit(8 * KiB);
+            Assert::IsNotNull(allocator->Allocate(4 * KiB));
+            Assert::AreEqual(0U, allocator->Statistics().FreeBlocks[0]);
+            stream.Flush();
+            Assert::AreEqual(4U * KiB, stream.WriteBufferSize());
+            Assert::AreEqual<S32>(8 * KiB, second->Receive(buffer));
+
+            // Ist die Arena voll, dann behalten Fill und Reserve den Buffer.
+            Assert::IsNotNull(allocator->Allocate(4 * KiB));
+            second->Send(Vector<Byte>(8 * KiB, 6));
+
+            while (stream.Buffered() < 4 * KiB) {
+                Assert::IsTrue(stream.Fill() > 0);
+            }
+
+            Assert::ExpectException<std::out_of_range>([&] { stream.Fill(); });
+            Assert::AreEqual(4U * KiB, stream.ReadBufferSize());
+            Assert::AreEqual<Byte>(6, stream.Peek()[4 * KiB - 1]);
+            Assert::ExpectException<std::out_of_range>([&] { stream.Reserve(8 * KiB); });
+            Assert::AreEqual(4U * KiB, stream.WriteBufferSize());
+        }
+
+        TEST_METHOD(BuddyAllocator_NetworkStreamReserve)
+        {
+            BuddyAllocatorPtr allocator(new BuddyAllocator(64 * KiB, 4 * KiB, 16 * KiB));
+            SocketPtr first, second;
+            Vector<Byte> buffer(32 * KiB);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+
+            NetworkStream stream(first, allocator);
+
+            // Ein von Reserve bzw Write ausgelöstes Senden behält den
+            // vergrößerten Buffer, erst Flush gibt ihn frei.
+            memset(stream.Reserve(8 * KiB), 1, 8 * KiB);
+            stream.Commit(8 * KiB);
+
+            Byte* target = stream.Reserve(8 * KiB);
+
+            Assert::AreEqual(0U, stream.Pending());
+            Assert::AreEqual(8U * KiB, stream.WriteBufferSize());
+            memset(target, 2, 8 * KiB);
+            stream.Commit(8 * KiB);
+
+            stream.Write(Vector<Byte>(4 * KiB, 3));
+            Assert::AreEqual(4U * KiB, stream.Pending());
+            Assert::AreEqual(8U * KiB, stream.WriteBufferSize());
+
+            stream.Flush();
+            Assert::AreEqual(4U * KiB, stream.WriteBufferSize());
+
+            U32 received = 0;
+
+            while (received < 20 * KiB) {
+                received += (U32)second->Receive(buffer, received, 20 * KiB - received);
+            }
+
+            Assert::AreEqual<Byte>(1, buffer[8 * KiB - 1]);
+            Assert::AreEqual<Byte>(2, buffer[16 * KiB - 1]);
+            Assert::AreEqual<Byte>(3, buffer[20 * KiB - 1]);
+        }
+    };
+}
@@ -0,0 +1,190 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Memory/BufferChain.h>
+#include <Lupus/Network/FrameCodec.h>
+#include <Lupus/Network/EventLoop.h>
+#include <Lupus/Network/SendQueue.h>
+#include <Lupus/Network/Socket.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(BufferChainTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(BufferChainTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(BufferChainTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        static PooledBuffer Create(const Vector<Byte>& bytes)
+        {
+            PooledBuffer buffer = BufferPool::Shared()->Lease((U32)bytes.size());
+
+            memcpy(buffer.Data(), bytes.data(), bytes.size());
+            buffer.Size((U32)bytes.size());
+            return buffer;
+        }
+
+        static Vector<Byte> ToVector(const BufferChain& chain)
+        {
+            Vector<Byte> result(chain.Size());
+
+            chain.CopyTo(result.data(), 0, chain.Size());
+            return result;
+        }
+
+        TEST_METHOD(BufferChain_AppendPrepend)
+        {
+            BufferChain chain;
+            PooledBuffer buffer = Create({ 3, 4, 5 });
+            Byte header[] = { 1, 2 };
+            Byte trailer[] = { 6 };
+
+            chain.Append(buffer);
+            chain.Prepend(header, 2);
+            chain.Append(trailer, 1);
+            Assert::AreEqual(6U, chain.Size());
+            Assert::AreEqual(3U, chain.SliceCount());
+            Assert::IsTrue(Vector<Byte>({ 1, 2, 3, 4, 5, 6 }) == ToVector(chain));
+
+            // Der Buffer wird geteilt und nicht kopiert.
+            Assert::IsTrue(buffer.Data() == chain.At(1).Data());
+            Assert::AreEqual(2U, buffer.References());
+
+            // Weitere Header landen vor dem ersten im selben Buffer.
+            chain.Prepend(header, 1);
+            Assert::AreEqual(3U, chain.SliceCount());
+            Assert::AreEqual<Byte>(1, chain.At(0).Data()[0]);
+            Assert::ExpectException<std::out_of_range>([&] { chain.Append(buffer, 2, 2); });
+        }
+
+        TEST_METHOD(BufferChain_SliceSplit)
+        {
+            BufferChain chain;
+
+            chain.Append(Create({ 1, 2, 3 }));
+            chain.Append(Create({ 4, 5, 6 }));
+
+            BufferChain slice = chain.Slice(2, 3);
+            Assert::IsTrue(Vector<Byte>({ 3, 4, 5 }) == ToVector(slice));
+            Assert::AreEqual(2U, slice.SliceCount());
+
+            BufferChain front = chain.Split(4);
+            Assert::IsTrue(Vector<Byte>({ 1, 2, 3, 4 }) == ToVector(front));
+            Assert::IsTrue(Vector<Byte>({ 5, 6 }) == ToVector(chain));
+            Assert::IsTrue(front.At(1).Data() + 1 == chain.At(0).Data());
+
+            // Aneinander grenzende Teile des selben Buffers werden verbunden.
+            front.Append(chain);
+            Assert::AreEqual(2U, front.SliceCount());
+
+            front.Consume(5);
+            Assert::IsTrue(Vector<Byte>({ 6 }) == ToVector(front));
+            Assert::ExpectException<std::out_of_range>([&] { front.Split(2); });
+        }
+
+        TEST_METHOD(BufferChain_Coalesce)
+        {
+            BufferChain chain;
+            PooledBuffer buffer = Create({ 1, 2 });
+
+            Assert::IsNull(chain.Coalesce());
+            chain.Append(buffer);
+            Assert::IsTrue(buffer.Data() == chain.Coalesce());
+
+            chain.Append(Create({ 3 }));
+            const Byte* data = chain.Coalesce();
+            Assert::AreEqual(1U, chain.SliceCount());
+            Assert::AreEqual<Byte>(3, data[2]);
+            Assert::AreEqual<Byte>(1, buffer.Data()[0]);
+            Assert::AreEqual(1U, buffer.References());
+        }
+
+        TEST_METHOD(BufferChain_SocketFanOut)
+        {
+            SocketPtr first, second, third, fourth;
+            BufferChain input, frame, output;
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            Socket::CreatePair(SocketType::Stream, third, fourth);
+
+            // Zwei Frames, das zweite Präfix liegt auf zwei Sends verteilt.
+            first->Send(Vector<Byte>({ 0, 0, 0, 2, 7, 8, 0, 0 }));
+            Assert::AreEqual(8, second->Receive(input));
+            Assert::IsTrue(FrameCodec::Decode(input, FramePrefix::Fixed32, 16, frame));
+            Assert::IsTrue(Vector<Byte>({ 7, 8 }) == ToVector(frame));
+            Assert::IsFalse(FrameCodec::Decode(input, FramePrefix::Fixed32, 16, frame));
+
+            first->Send(Vector<Byte>({ 0, 1, 9 }));
+            Assert::AreEqual(3, second->Receive(input));
+            Assert::IsTrue(FrameCodec::Decode(input, FramePrefix::Fixed32, 16, frame));
+            Assert::IsTrue(input.IsEmpty());
+            Assert::AreEqual<Byte>(9, frame.At(0).Data()[0]);
+
+            // Der selbe Frame geht ohne Kopie mit neuem Präfix an zwei Sockets.
+            BufferChain copy = frame;
+            FrameCodec::Encode(copy, FramePrefix::Varint);
+            Assert::AreEqual(2, third->Send(copy));
+            Assert::AreEqual(1, first->Send(frame));
+            Assert::AreEqual(2, fourth->Receive(output));
+            Assert::AreEqual(1, second->Receive(output));
+            Assert::IsTrue(Vector<Byte>({ 1, 9, 9 }) == ToVector(output));
+        }
+
+        TEST_METHOD(BufferChain_SendSegments)
+        {
+            SocketPtr first, second;
+            BufferChain chain;
+            Vector<Byte> buffer(128);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+
+            for (U32 i = 0; i < Socket::MaxSegments + 6; i++) {
+                chain.Append(Create({ (Byte)i }));
+            }
+
+            // Ein Aufruf sendet höchstens MaxSegments Ausschnitte.
+            Assert::AreEqual(Socket::MaxSegments + 6, chain.SliceCount());
+            Assert::AreEqual((S32)Socket::MaxSegments, first->Send(chain));
+            chain.Consume(Socket::MaxSegments);
+            Assert::AreEqual(6, first->Send(chain));
+            Assert::AreEqual((S32)Socket::MaxSegments + 6, second->Receive(buffer));
+            Assert::AreEqual<Byte>(69, buffer[69]);
+        }
+
+        TEST_METHOD(BufferChain_SendQueue)
+        {
+            EventLoop loop;
+            SocketPtr first, firstPeer, second, secondPeer;
+            BufferChain message(Create({ 1, 2, 3 }));
+            Vector<Byte> buffer(8);
+
+            Socket::CreatePair(SocketType::Stream, first, firstPeer);
+            Socket::CreatePair(SocketType::Stream, second, secondPeer);
+            loop.Add(first, SocketPollFlags::Read, [](SocketPtr, SocketPollFlags) {});
+            loop.Add(second, SocketPollFlags::Read, [](SocketPtr, SocketPollFlags) {});
+
+            // Beide Warteschlangen teilen sich den selben Buffer.
+            loop.Queue(first)->Enqueue(message);
+            loop.Queue(second)->Enqueue(message);
+            loop.Queue(second)->Enqueue(Vector<Byte>({ 4 }));
+            Assert::AreEqual(3U, message.At(0).Buffer.References());
+
+            loop.RunOnce(100);
+            Assert::AreEqual(3, firstPeer->Receive(buffer));
+            Assert::AreEqual(4, secondPeer->Receive(buffer));
+            Assert::AreEqual<Byte>(4, buffer[3]);
+            Assert::AreEqual(1U, message.At(0).Buffer.References());
+        }
+    };
+}
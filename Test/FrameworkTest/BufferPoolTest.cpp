@@ -0,0 +1,160 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Memory/BufferPool.h>
+#include <Lupus/Network/Socket.h>
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(BufferPoolTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(BufferPoolTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(BufferPoolTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        TEST_METHOD(BufferPool_Lease)
+        {
+            BufferPool pool;
+            PooledBuffer small = pool.Lease(100);
+            PooledBuffer large = pool.Lease(BufferPool::LargeSize + 1);
+            Byte* data = small.Data();
+
+            Assert::AreEqual(BufferPool::SmallSize, small.Capacity());
+            Assert::AreEqual(BufferPool::LargeSize + 1, large.Capacity());
+            Assert::AreEqual(0U, small.Size());
+            Assert::AreEqual(0, (S32)((UIntPtr)data % 64));
+            Assert::ExpectException<std::length_error>([&] { pool.Lease(0xFFFFFFFF); });
+
+            // Der freigegebene Buffer kommt aus dem Cache des Threads zurück.
+            small.Reset();
+            Assert::IsTrue(small.IsEmpty());
+            Assert::IsTrue(data == pool.Lease(1).Data());
+        }
+
+        TEST_METHOD(BufferPool_References)
+        {
+            BufferPool pool;
+            PooledBuffer first = pool.Lease(BufferPool::MediumSize);
+            PooledBuffer second = first;
+
+            first.Size(10);
+            Assert::AreEqual(2U, first.References());
+            Assert::AreEqual(10U, second.Size());
+            Assert::ExpectException<std::out_of_range>([&] { first.Size(BufferPool::MediumSize + 1); });
+
+            PooledBuffer third(std::move(second));
+            Assert::IsTrue(second.IsEmpty());
+            first.Reset();
+            Assert::AreEqual(1U, third.References());
+        }
+
+        TEST_METHOD(BufferPool_CrossThread)
+        {
+            BufferPool pool;
+            Vector<PooledBuffer> buffers;
+
+            for (U32 i = 0; i < 1000; i++) {
+                buffers.push_back(pool.Lease(BufferPool::SmallSize));
+            }
+
+            U64 reserved = pool.Reserved();
+
+            // Buffer die in einem anderen Thread freigegeben werden, gehen
+            // über dessen Cache bzw die globale Liste zurück. Der Cache des
+            // beendeten Threads wird dabei ebenfalls geleert.
+            Thread([&]() {
+                buffers.clear();
+            }).join();
+
+            for (U32 i = 0; i < 900; i++) {
+                buffers.push_back(pool.Lease(BufferPool::SmallSize));
+            }
+
+            Assert::AreEqual(reserved, pool.Reserved());
+        }
+
+        TEST_METHOD(BufferPool_ThreadExit)
+        {
+            BufferPool pool;
+            U64 reserved = 0;
+
+            // Mehr Threads als Caches, jeder füllt seinen Cache. Die Buffer
+            // beendeter Threads werden vom nächsten wiederverwendet.
+            for (U32 i = 0; i < 200; i++) {
+                Thread([&]() {
+                    Vector<PooledBuffer> buffers;
+
+                    for (U32 j = 0; j < 40; j++) {
+                        buffers.push_back(pool.Lease(BufferPool::SmallSize));
+                    }
+                }).join();
+
+                if (i == 0) {
+                    reserved = pool.Reserved();
+                }
+            }
+
+            Assert::AreEqual(reserved, pool.Reserved());
+        }
+
+        TEST_METHOD(BufferPool_SocketReceive)
+        {
+            SocketPtr first, second;
+            PooledBuffer buffer;
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            first->Send(Vector<Byte>({ 1, 2, 3 }));
+            Assert::AreEqual(3, second->Receive(buffer));
+            Assert::AreEqual(BufferPool::MediumSize, buffer.Capacity());
+            Assert::AreEqual(3U, buffer.Size());
+            Assert::AreEqual<Byte>(3, buffer.Data()[2]);
+
+            // Ein geteilter Buffer wird nicht überschrieben.
+            PooledBuffer shared = buffer;
+            first->Send(Vector<Byte>({ 4 }));
+            Assert::AreEqual(1, second->Receive(buffer));
+            Assert::AreEqual<Byte>(1, shared.Data()[0]);
+            Assert::AreEqual<Byte>(4, buffer.Data()[0]);
+        }
+
+        TEST_METHOD(BufferPool_Benchmark)
+        {
+            const S32 iterations = 100000;
+            BufferPool pool;
+            U32 sum = 0;
+
+            auto begin = std::chrono::high_resolution_clock::now();
+
+            for (S32 i = 0; i < iterations; i++) {
+                Vector<Byte> buffer(BufferPool::MediumSize);
+                sum += buffer[i % buffer.size()];
+            }
+
+            auto vector = std::chrono::high_resolution_clock::now() - begin;
+            begin = std::chrono::high_resolution_clock::now();
+
+            for (S32 i = 0; i < iterations; i++) {
+                PooledBuffer buffer = pool.Lease(BufferPool::MediumSize);
+                sum += buffer.Data()[i % buffer.Capacity()];
+            }
+
+            auto pooled = std::chrono::high_resolution_clock::now() - begin;
+            String message = "Vector<Byte>: " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(vector).count()) + "us, "
+                "BufferPool::Lease: " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(pooled).count()) + "us\n";
+
+            Logger::WriteMessage(message.c_str());
+        }
+    };
+}
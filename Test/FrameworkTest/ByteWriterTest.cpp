@@ -0,0 +1,163 @@
+﻿#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/ISerializable.h>
+#include <Lupus/Memory/StackAllocator.h>
+#include <Lupus/Network/NetworkStream.h>
+#include <Lupus/Network/Socket.h>
+#include <Lupus/Network/StreamWriter.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    class TestMessage : public ISerializable
+    {
+    public:
+
+        U32 Id = 0;
+        double Value = 0;
+        String Name;
+
+        virtual void Serialize(ByteWriter& writer) const override
+        {
+            writer.Write(Id);
+            writer.Write(Value);
+            writer.Write(Name);
+        }
+
+        virtual void Deserialize(ByteReader& reader) override
+        {
+            Id = reader.Read<U32>();
+            Value = reader.Read<double>();
+            Name = reader.ReadString();
+        }
+
+        using ISerializable::Serialize;
+        using ISerializable::Deserialize;
+    };
+
+    TEST_CLASS(ByteWriterTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(ByteWriterTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(ByteWriterTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        TEST_METHOD(ByteWriter_NetworkOrder)
+        {
+            Byte buffer[7];
+            ByteWriter writer(buffer, sizeof(buffer));
+
+            writer.Write((U16)0x0102);
+            writer.Write((U32)0x03040506);
+            writer.Write(true);
+            Assert::AreEqual(7U, writer.Written());
+            Assert::AreEqual<Byte>(1, buffer[0]);
+            Assert::AreEqual<Byte>(6, buffer[5]);
+            Assert::ExpectException<std::out_of_range>([&] { writer.Write((U8)0); });
+
+            ByteReader reader(buffer, sizeof(buffer));
+
+            Assert::AreEqual<U16>(0x0102, reader.Read<U16>());
+            Assert::AreEqual<U32>(0x03040506, reader.Read<U32>());
+            Assert::IsTrue(reader.Read<bool>());
+            Assert::ExpectException<std::out_of_range>([&] { reader.Read<U8>(); });
+        }
+
+        TEST_METHOD(ByteWriter_Segments)
+        {
+            Byte first[3], second[8];
+            ByteSegment segments[2] = { { first, 3 }, { second, 8 } };
+            ByteWriter writer(segments, 2);
+
+            // Die Zahl wird über die Segmentgrenze hinweg geschrieben.
+            writer.Write((U64)0x0102030405060708);
+            Assert::AreEqual(8U, writer.Written());
+            Assert::AreEqual<Byte>(3, first[2]);
+            Assert::AreEqual<Byte>(4, second[0]);
+            Assert::IsNotNull(writer.Reserve(3));
+            Assert::IsNull(writer.Reserve(1));
+        }
+
+        TEST_METHOD(ByteWriter_Counting)
+        {
+            ByteWriter counter;
+            Vector<Byte> large(64 * 1024);
+
+            counter.Write((U32)1);
+            counter.Write(large.data(), (U32)large.size());
+            counter.Write(String("lupus"));
+
+            // Ohne eigenen Speicher gibt es keinen zusammenhängenden Bereich.
+            Assert::IsNull(counter.Reserve(4));
+            Assert::AreEqual(4U + 64U * 1024U + 4U + 5U, counter.Written());
+        }
+
+        TEST_METHOD(ByteWriter_Serializable)
+        {
+            TestMessage message, copy;
+            StackAllocator stack(1024);
+
+            message.Id = 42;
+            message.Value = 0.5;
+            message.Name = "lupus";
+
+            ByteWriter counter;
+            message.Serialize(counter);
+
+            Byte* region = stack.Allocate<Byte>(counter.Written());
+            ByteWriter writer(region, counter.Written());
+            message.Serialize(writer);
+
+            ByteReader reader(region, writer.Written());
+            copy.Deserialize(reader);
+            Assert::AreEqual(42U, copy.Id);
+            Assert::AreEqual(0.5, copy.Value);
+            Assert::AreEqual(String("lupus"), copy.Name);
+            Assert::AreEqual(0U, reader.Remaining());
+
+            Vector<Byte> buffer = message.Serialize();
+            Assert::AreEqual<size_t>(counter.Written(), buffer.size());
+            buffer.pop_back();
+            Assert::ExpectException<std::invalid_argument>([&] { copy.Deserialize(buffer); });
+        }
+
+        TEST_METHOD(ByteWriter_Stream)
+        {
+            SocketPtr first, second;
+            TestMessage message, copy;
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            message.Name = String(100, 'x');
+
+            NetworkStreamPtr stream(new NetworkStream(first, 64, 64));
+            NetworkStream input(second);
+
+            {
+                // Die Nachricht ist größer als der Schreib-Buffer.
+                StreamWriter writer(stream);
+                message.Serialize(writer);
+                Assert::AreEqual(116U, writer.Written());
+            }
+
+            stream->Flush();
+
+            while (input.Buffered() < 116) {
+                Assert::IsTrue(input.Fill() > 0);
+            }
+
+            ByteReader reader(input.Peek(), input.Buffered());
+            copy.Deserialize(reader);
+            Assert::AreEqual(message.Name, copy.Name);
+        }
+    };
+}
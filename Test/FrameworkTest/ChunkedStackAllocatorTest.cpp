@@ -0,0 +1,83 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Memory/ChunkedStackAllocator.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(ChunkedStackAllocatorTest)
+    {
+    public:
+
+        TEST_METHOD(ChunkedStackAllocator_Allocate)
+        {
+            ChunkedStackAllocator allocator(1 * KiB);
+
+            for (U32 i = 0; i < 100; i++) {
+                U64* value = allocator.Allocate<U64>(16);
+
+                Assert::IsNotNull(value);
+                Assert::AreEqual(0, (S32)((UIntPtr)value % sizeof(U64)));
+            }
+
+            Assert::IsTrue(allocator.ChunkCount() > 1);
+
+            // Bisher haben alle Blöcke die selbe Größe samt Header.
+            U32 chunks = allocator.ChunkCount();
+            U64 reserved = allocator.Reserved();
+            U64 header = reserved / chunks - 1 * KiB;
+
+            Assert::AreEqual(reserved, chunks * (1 * KiB + header));
+
+            // Größere Anforderungen erhalten einen eigenen Block genau
+            // dieser Größe.
+            Assert::IsNotNull(allocator.Allocate<U8>(4 * KiB));
+            Assert::AreEqual(chunks + 1, allocator.ChunkCount());
+            Assert::AreEqual(reserved + header + 4 * KiB, allocator.Reserved());
+        }
+
+        TEST_METHOD(ChunkedStackAllocator_FreeToMarker)
+        {
+            ChunkedStackAllocator allocator(1 * KiB);
+            allocator.Allocate<U8>(100);
+            UIntPtr marker = allocator.GetMarker();
+
+            // Die Markierung liegt im ersten, der Kopf im dritten Block.
+            allocator.Allocate<U8>(1 * KiB);
+            allocator.Allocate<U8>(1 * KiB);
+            Assert::AreEqual(3U, allocator.ChunkCount());
+            UIntPtr inner = allocator.GetMarker();
+
+            allocator.FreeToMarker(marker);
+            Assert::AreEqual(marker, allocator.GetMarker());
+            Assert::ExpectException<std::out_of_range>([&]() { allocator.FreeToMarker(inner); });
+
+            // Die freien Blöcke werden wiederverwendet.
+            allocator.Allocate<U8>(1 * KiB);
+            allocator.Allocate<U8>(1 * KiB);
+            Assert::AreEqual(3U, allocator.ChunkCount());
+        }
+
+        TEST_METHOD(ChunkedStackAllocator_Clear)
+        {
+            ChunkedStackAllocator allocator(1 * KiB);
+            UIntPtr base = allocator.GetMarker();
+
+            for (U32 frame = 0; frame < 10; frame++) {
+                for (U32 i = 0; i < 10; i++) {
+                    allocator.Allocate<U8>(512);
+                }
+
+                allocator.Clear();
+                Assert::AreEqual(base, allocator.GetMarker());
+            }
+
+            Assert::AreEqual(5U, allocator.ChunkCount());
+
+            allocator.Trim();
+            Assert::AreEqual(1U, allocator.ChunkCount());
+        }
+    };
+}
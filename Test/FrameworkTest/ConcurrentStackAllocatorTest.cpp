@@ -0,0 +1,141 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Memory/ConcurrentStackAllocator.h>
+#include <Lupus/Memory/StackAllocator.h>
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(ConcurrentStackAllocatorTest)
+    {
+    public:
+
+        struct LU_ALIGN(64) Aligned
+        {
+            U64 Value;
+        };
+
+        TEST_METHOD(ConcurrentStackAllocator_Allocate)
+        {
+            ConcurrentStackAllocator allocator(1 * KiB);
+            U8* first = allocator.Allocate<U8>(3);
+            U64* second = allocator.Allocate<U64>(2);
+            Aligned* third = allocator.Allocate<Aligned>();
+
+            Assert::IsNotNull(first);
+            Assert::AreEqual(16, (S32)((Byte*)second - first));
+            Assert::AreEqual(0, (S32)((UIntPtr)third % 64));
+
+            // Eine zu große Anforderung verhindert keine kleineren.
+            Assert::IsNull(allocator.Allocate<U8>(2 * KiB));
+            Assert::IsNotNull(allocator.Allocate<U8>(16));
+        }
+
+        TEST_METHOD(ConcurrentStackAllocator_FreeToMarker)
+        {
+            ConcurrentStackAllocator allocator(32 * KiB);
+            UIntPtr marker = allocator.GetMarker();
+
+            allocator.Allocate<U32>(128);
+            Assert::AreNotEqual(marker, allocator.GetMarker());
+            allocator.FreeToMarker(marker);
+            Assert::AreEqual(marker, allocator.GetMarker());
+            Assert::ExpectException<std::out_of_range>([&]() { allocator.FreeToMarker(marker + 64 * KiB); });
+
+            while (allocator.Allocate<U64>(64)) {
+            }
+
+            allocator.Clear();
+            Assert::AreEqual(marker, allocator.GetMarker());
+            Assert::IsNotNull(allocator.Allocate<U8>(32 * KiB));
+        }
+
+        TEST_METHOD(ConcurrentStackAllocator_Threads)
+        {
+            const U32 threads = 4, count = 1000;
+            ConcurrentStackAllocator allocator(threads * count * 16);
+            Vector<Thread> workers;
+            Vector<Vector<U32*>> results(threads);
+
+            for (U32 i = 0; i < threads; i++) {
+                workers.push_back(Thread([&, i]() {
+                    for (U32 j = 0; j < count; j++) {
+                        U32* value = allocator.Allocate<U32>();
+
+                        *value = i * count + j;
+                        results[i].push_back(value);
+                    }
+                }));
+            }
+
+            for (Thread& worker : workers) {
+                worker.join();
+            }
+
+            // Kein Bereich wurde doppelt vergeben und der Stack ist voll.
+            for (U32 i = 0; i < threads; i++) {
+                for (U32 j = 0; j < count; j++) {
+                    Assert::AreEqual(i * count + j, *results[i][j]);
+                }
+            }
+
+            Assert::IsNull(allocator.Allocate<U8>());
+        }
+
+        TEST_METHOD(ConcurrentStackAllocator_Benchmark)
+        {
+            const U32 threads = 4, iterations = 100000;
+            ConcurrentStackAllocator concurrent(threads * iterations * 16);
+            StackAllocator single(threads * iterations * 16);
+            Mutex mutex;
+
+            auto run = [&](Function<void()> function) {
+                Vector<Thread> workers;
+                auto begin = std::chrono::high_resolution_clock::now();
+
+                for (U32 i = 0; i < threads; i++) {
+                    workers.push_back(Thread(function));
+                }
+
+                for (Thread& worker : workers) {
+                    worker.join();
+                }
+
+                return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+            };
+
+            // Ohne eigene Synchronisation muss ein geteilter StackAllocator
+            // mit einem Mutex geschützt werden.
+            auto locked = run([&]() {
+                for (U32 i = 0; i < iterations; i++) {
+                    LockGuard<Mutex> lock(mutex);
+                    single.Allocate<U64>();
+                }
+            });
+
+            auto atomic = run([&]() {
+                for (U32 i = 0; i < iterations; i++) {
+                    concurrent.Allocate<U64>();
+                }
+            });
+
+            single.Clear();
+            auto begin = std::chrono::high_resolution_clock::now();
+
+            for (U32 i = 0; i < threads * iterations; i++) {
+                single.Allocate<U64>();
+            }
+
+            auto serial = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+            String message = "StackAllocator + Mutex: " + std::to_string(locked) + "us, "
+                "ConcurrentStackAllocator: " + std::to_string(atomic) + "us, "
+                "StackAllocator (1 Thread): " + std::to_string(serial) + "us\n";
+
+            Logger::WriteMessage(message.c_str());
+            Assert::IsNull(concurrent.Allocate<U8>());
+        }
+    };
+}
@@ -0,0 +1,138 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/DatagramBatcher.h>
+#include <Lupus/Network/IPEndPoint.h>
+#include <Lupus/Network/Socket.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(DatagramBatcherTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(DatagramBatcherTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(DatagramBatcherTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        static SocketPtr CreateSocket(EndPointPtr& endPoint)
+        {
+            SocketPtr socket(new Socket(AddressFamily::InterNetwork, SocketType::Datagram, ProtocolType::UDP));
+            AddrStorage storage;
+            AddrLength length = sizeof(AddrStorage);
+
+            socket->Bind(IPEndPointPtr(new IPEndPoint(0x7F000001, 0)));
+            memset(&storage, 0, sizeof(AddrStorage));
+            getsockname(socket->Handle(), (Addr*)&storage, &length);
+            endPoint = EndPoint::Create(Vector<Byte>((Byte*)&storage, (Byte*)&storage + sizeof(AddrStorage)), (U32)length);
+            return socket;
+        }
+
+        static U32 ReceiveAll(DatagramBatcher& batcher, SocketPtr socket, U32 count)
+        {
+            while (batcher.Received().size() < count && socket->Poll(1000, SocketPollFlags::Read) != SocketPollFlags::Timeout) {
+                batcher.Receive();
+            }
+
+            return (U32)batcher.Received().size();
+        }
+
+        TEST_METHOD(DatagramBatcher_RoundTrip)
+        {
+            EndPointPtr serverEndPoint, clientEndPoint;
+            SocketPtr serverSocket = CreateSocket(serverEndPoint);
+            SocketPtr clientSocket = CreateSocket(clientEndPoint);
+            DatagramBatcher server(serverSocket, 64 * KiB, 128, 64);
+            DatagramBatcher client(clientSocket, 64 * KiB, 128, 64);
+            U32 peer = client.AddPeer(serverEndPoint);
+
+            Assert::AreEqual(peer, client.AddPeer(serverEndPoint));
+
+            for (U32 i = 0; i < 100; i++) {
+                Byte* data = client.Write(peer, 4);
+
+                memcpy(data, &i, sizeof(U32));
+            }
+
+            Assert::AreEqual(100U, client.Pending());
+            Assert::AreEqual(100U, client.Tick());
+            Assert::AreEqual(0U, client.Pending());
+#ifdef __linux__
+            Assert::AreEqual<U64>(2, client.SystemCalls());
+#endif
+
+            // Der Absender ist noch unbekannt und wird angemeldet.
+            Assert::AreEqual(100U, ReceiveAll(server, serverSocket, 100));
+            const Datagram& first = server.Received()[0];
+            Assert::AreEqual(DatagramBatcher::InvalidPeer, first.Peer);
+            Assert::AreEqual(4U, first.Size);
+            Assert::AreEqual(0U, *(U32*)first.Data);
+            Assert::AreEqual(99U, *(U32*)server.Received()[99].Data);
+
+            U32 sender = server.AddPeer(first);
+            Assert::IsTrue(server.Send(sender, (const Byte*)"pong", 4));
+            Assert::AreEqual(1U, server.Tick());
+            Assert::IsTrue(server.Received().empty());
+
+            Assert::AreEqual(1U, ReceiveAll(client, clientSocket, 1));
+            Assert::AreEqual(peer, client.Received()[0].Peer);
+            Assert::AreEqual(0, memcmp("pong", client.Received()[0].Data, 4));
+
+            server.RemovePeer(sender);
+            Assert::ExpectException<std::out_of_range>([&] { server.Write(sender, 4); });
+        }
+
+        TEST_METHOD(DatagramBatcher_FrameFull)
+        {
+            EndPointPtr serverEndPoint, clientEndPoint;
+            SocketPtr serverSocket = CreateSocket(serverEndPoint);
+            SocketPtr clientSocket = CreateSocket(clientEndPoint);
+            DatagramBatcher client(clientSocket, 1 * KiB, 4);
+            U32 peer = client.AddPeer(serverEndPoint);
+
+            Assert::IsNull(client.Write(peer, 1400));
+            Assert::ExpectException<std::out_of_range>([&] { client.Write(peer, 1501); });
+
+            for (U32 i = 0; i < 4; i++) {
+                Assert::IsNotNull(client.Write(peer, 8));
+            }
+
+            Assert::IsNull(client.Write(peer, 8));
+
+            // Nach dem Tick steht der andere Buffer vollständig zur Verfügung.
+            client.Tick();
+            Assert::IsNotNull(client.Write(peer, 512));
+            Assert::ExpectException<std::invalid_argument>([&] { DatagramBatcher(serverSocket, 1 * KiB, 0); });
+        }
+
+        TEST_METHOD(DatagramBatcher_Dropped)
+        {
+            EndPointPtr serverEndPoint, clientEndPoint;
+            SocketPtr serverSocket = CreateSocket(serverEndPoint);
+            SocketPtr clientSocket = CreateSocket(clientEndPoint);
+            DatagramBatcher server(serverSocket, 64 * KiB, 16);
+            DatagramBatcher client(clientSocket, 256 * KiB, 16, 70000);
+            U32 peer = client.AddPeer(serverEndPoint);
+
+            // Ein Datagramm über der UDP-Grenze wird abgelehnt, die
+            // folgenden werden trotzdem gesendet.
+            Assert::IsNotNull(client.Write(peer, 66000));
+            Assert::IsTrue(client.Send(peer, (const Byte*)"ping", 4));
+            Assert::AreEqual(1U, client.Tick());
+            Assert::AreEqual<U64>(1, client.Dropped());
+            Assert::AreEqual(0U, client.Pending());
+
+            Assert::AreEqual(1U, ReceiveAll(server, serverSocket, 1));
+            Assert::AreEqual(4U, server.Received()[0].Size);
+        }
+    };
+}
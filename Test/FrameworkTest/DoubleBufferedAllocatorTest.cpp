@@ -1,6 +1,6 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
-#include <Lupus\Memory\DoubleBufferedAllocator.h>
+#include <Lupus/Memory/DoubleBufferedAllocator.h>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Lupus;
@@ -29,6 +29,22 @@ namespace FrameworkTest
             Assert::IsNotNull(dba.Allocate<S32>(32));
         }
 
+        TEST_METHOD(DoubleBufferedAllocator_Backing)
+        {
+            MemoryBacking backing;
+
+            backing.Prefault = true;
+
+            DoubleBufferAllocator dba(32 * KiB, backing);
+            S32* first = dba.Allocate<S32>(32);
+            dba.Swap();
+            S32* second = dba.Allocate<S32>(32);
+
+            Assert::IsNotNull(first);
+            Assert::IsNotNull(second);
+            Assert::IsTrue(first != second);
+        }
+
         TEST_METHOD(DoubleBufferedAllocator_Swap)
         {
             DoubleBufferAllocator dba(32 * KiB);
@@ -40,5 +56,26 @@ namespace FrameworkTest
             DoubleBufferAllocator dba(32 * KiB);
             dba.Clear();
         }
+
+        TEST_METHOD(DoubleBufferedAllocator_Statistics)
+        {
+            DoubleBufferAllocator dba(1 * KiB);
+
+            dba.Allocate<U64>(8);
+            dba.Swap();
+            dba.Clear();
+            dba.Allocate<U64>(2);
+
+            AllocatorStatistics statistics = dba.Statistics();
+#ifdef LUPUS_ALLOCATOR_STATISTICS
+            Assert::AreEqual<U64>(80, statistics.BytesInUse);
+            Assert::AreEqual<U64>(16, statistics.FramePeak);
+            Assert::AreEqual<U64>(64, statistics.LastFramePeak);
+            Assert::AreEqual<U64>(64, statistics.Peak);
+            Assert::AreEqual<U64>(2, statistics.Allocations);
+#else
+            Assert::AreEqual<U64>(0, statistics.Peak);
+#endif
+        }
     };
 }
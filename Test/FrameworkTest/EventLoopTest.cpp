@@ -0,0 +1,185 @@
+﻿#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/EventLoop.h>
+#include <Lupus/Network/SendQueue.h>
+#include <Lupus/Network/Socket.h>
+#include <Lupus/Network/TimerWheel.h>
+#include <Lupus/Threading/Scheduler.h>
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(EventLoopTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(EventLoopTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(EventLoopTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        TEST_METHOD(EventLoop_Post)
+        {
+            EventLoop loop;
+            bool posted = false;
+
+            Thread([&]() { loop.Post([&]() { posted = true; }); }).join();
+            loop.RunOnce(1000);
+            Assert::IsTrue(posted);
+        }
+
+        TEST_METHOD(EventLoop_SendQueue)
+        {
+            const U32 producers = 4, messages = 1000;
+            EventLoop loop;
+            SocketPtr sender, receiver;
+            Vector<Thread> threads;
+            Vector<U32> next(producers);
+            Vector<Byte> buffer(5 * producers * messages);
+            U32 received = 0;
+
+            Socket::CreatePair(SocketType::Stream, sender, receiver);
+            sender->Blocking(false);
+            loop.Add(sender, SocketPollFlags::Read, [](SocketPtr, SocketPollFlags) {});
+            SendQueuePtr queue = loop.Queue(sender);
+
+            for (U32 i = 0; i < producers; i++) {
+                threads.push_back(Thread([=]() {
+                    for (U32 j = 0; j < messages; j++) {
+                        Vector<Byte> message(5);
+
+                        message[0] = (Byte)i;
+                        memcpy(message.data() + 1, &j, 4);
+                        queue->Enqueue(message);
+                    }
+                }));
+            }
+
+            for (Thread& thread : threads) {
+                thread.join();
+            }
+
+            while (received < buffer.size()) {
+                loop.RunOnce(100);
+                received += receiver->Receive(buffer, received, (U32)buffer.size() - received);
+            }
+
+            // Die Reihenfolge jedes einzelnen Threads bleibt erhalten.
+            for (U32 offset = 0; offset < buffer.size(); offset += 5) {
+                U32 index;
+
+                memcpy(&index, buffer.data() + offset + 1, 4);
+                Assert::AreEqual(next[buffer[offset]]++, index);
+            }
+
+            loop.Remove(sender);
+            Assert::IsFalse(queue->Enqueue(Vector<Byte>(1)));
+        }
+
+        TEST_METHOD(EventLoop_DispatchedQueue)
+        {
+            EventLoop loop;
+            SocketPtr local, remote;
+            SendQueuePtr queue;
+            Atomic<U32> running(0), overlaps(0);
+            Vector<Byte> reply(1);
+
+            Socket::CreatePair(SocketType::Stream, local, remote);
+            local->Blocking(false);
+            loop.Dispatcher(Pointer<Scheduler>(new Scheduler(2)));
+            loop.Add(local, SocketPollFlags::Read, [&](SocketPtr socket, SocketPollFlags) {
+                Vector<Byte> buffer(16);
+
+                if (running.fetch_add(1) != 0) {
+                    overlaps++;
+                }
+
+                socket->Receive(buffer);
+                queue->Enqueue(Vector<Byte>({ 7 }));
+
+                // RunQueues darf während des Handlers nicht senden.
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                running--;
+            });
+            queue = loop.Queue(local);
+            remote->Send(Vector<Byte>({ 1 }));
+
+            auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+            while (remote->Available() == 0 && std::chrono::steady_clock::now() < timeout) {
+                loop.RunOnce(10);
+            }
+
+            Assert::AreEqual(1, remote->Receive(reply));
+            Assert::AreEqual<Byte>(7, reply[0]);
+            Assert::AreEqual(0U, overlaps.load());
+
+            // Die Handler müssen vor der Schleife beendet sein.
+            while (running.load() != 0) {
+                loop.RunOnce(10);
+            }
+
+            loop.Dispatcher(nullptr);
+        }
+
+        TEST_METHOD(EventLoop_Deadline)
+        {
+            EventLoop loop;
+            SocketPtr idle, idlePeer, active, activePeer;
+            Vector<SocketDeadline> expired;
+            Vector<SocketPtr> sockets;
+            auto handler = [](SocketPtr socket, SocketPollFlags) {
+                Vector<Byte> buffer(16);
+                socket->Receive(buffer);
+            };
+
+            Socket::CreatePair(SocketType::Stream, idle, idlePeer);
+            Socket::CreatePair(SocketType::Stream, active, activePeer);
+            loop.Add(idlePeer, SocketPollFlags::Read, handler);
+            loop.Add(activePeer, SocketPollFlags::Read, handler);
+            loop.Deadline(idlePeer, SocketDeadline::ReadIdle, 50);
+            loop.Deadline(activePeer, SocketDeadline::ReadIdle, 50);
+            loop.Expired([&](SocketPtr socket, SocketDeadline type) {
+                expired.push_back(type);
+                sockets.push_back(socket);
+                loop.Remove(socket);
+            });
+
+            Assert::AreEqual(50U, loop.Deadline(idlePeer, SocketDeadline::ReadIdle));
+
+            auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+            while (loop.Count() == 2 && std::chrono::steady_clock::now() < timeout) {
+                active->Send(Vector<Byte>({ 1 }));
+                loop.RunOnce(10);
+            }
+
+            Assert::AreEqual<size_t>(1, expired.size());
+            Assert::IsTrue(expired[0] == SocketDeadline::ReadIdle);
+            Assert::IsTrue(sockets[0] == idlePeer);
+            Assert::AreEqual(0U, loop.Deadline(activePeer, SocketDeadline::Lifetime));
+        }
+
+        TEST_METHOD(EventLoop_CountsTimers)
+        {
+            EventLoop loop;
+            bool fired = false;
+
+            loop.Timers()->Schedule(0, [&]() {
+                fired = true;
+            });
+
+            Assert::AreEqual(1U, loop.RunOnce(10));
+            Assert::IsTrue(fired);
+        }
+    };
+}
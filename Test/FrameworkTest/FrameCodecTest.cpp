@@ -0,0 +1,91 @@
+﻿#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Memory/BufferChain.h>
+#include <Lupus/Network/FrameCodec.h>
+#include <Lupus/Network/NetworkStream.h>
+#include <Lupus/Network/Socket.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(FrameCodecTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(FrameCodecTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(FrameCodecTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        TEST_METHOD(FrameCodec_ReadWrite)
+        {
+            const FramePrefix prefixes[] = { FramePrefix::Fixed32, FramePrefix::Varint };
+
+            for (FramePrefix prefix : prefixes) {
+                SocketPtr first, second;
+
+                Socket::CreatePair(SocketType::Stream, first, second);
+
+                FrameCodec writer(NetworkStreamPtr(new NetworkStream(first)), prefix, 4096);
+                FrameCodec reader(NetworkStreamPtr(new NetworkStream(second, 64, 64)), prefix, 4096);
+                FrameView view;
+                Vector<Byte> large(1000, 7);
+
+                writer.Write(Vector<Byte>({ 1, 2, 3 }));
+                writer.Write(Vector<Byte>());
+                writer.Write(large);
+                writer.Flush();
+
+                // Kleine Frames zeigen direkt in den Lese-Buffer.
+                Assert::IsTrue(reader.Read(view));
+                Assert::AreEqual(3U, view.Size);
+                Assert::AreEqual<Byte>(3, view.Data[2]);
+                Assert::IsTrue(reader.Read(view));
+                Assert::AreEqual(0U, view.Size);
+                Assert::IsTrue(reader.Read(large));
+                Assert::AreEqual<size_t>(1000, large.size());
+                Assert::AreEqual<Byte>(7, large[999]);
+                Assert::IsFalse(reader.TryRead(view));
+            }
+        }
+
+        TEST_METHOD(FrameCodec_MaxSize)
+        {
+            SocketPtr first, second;
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+
+            FrameCodec writer(NetworkStreamPtr(new NetworkStream(first)), FramePrefix::Varint, 16);
+            FrameCodec reader(NetworkStreamPtr(new NetworkStream(second)), FramePrefix::Varint, 8);
+            FrameView view;
+
+            Assert::ExpectException<std::length_error>([&]() { writer.Write(Vector<Byte>(17)); });
+            writer.Write(Vector<Byte>(12));
+            writer.Flush();
+            Assert::ExpectException<std::length_error>([&]() { reader.Read(view); });
+        }
+
+        TEST_METHOD(FrameCodec_VarintOverflow)
+        {
+            const Byte overflow[] = { 0x80, 0x80, 0x80, 0x80, 0x10 };
+            const Byte maximum[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0x0F };
+            BufferChain input, frame;
+
+            input.Append(overflow, sizeof(overflow));
+            Assert::ExpectException<std::length_error>([&]() { FrameCodec::Decode(input, FramePrefix::Varint, 0xFFFFFFFF, frame); });
+
+            // 0xFFFFFFFF ist gültig, es fehlen nur noch die Daten.
+            input = BufferChain();
+            input.Append(maximum, sizeof(maximum));
+            Assert::IsFalse(FrameCodec::Decode(input, FramePrefix::Varint, 0xFFFFFFFF, frame));
+        }
+    };
+}
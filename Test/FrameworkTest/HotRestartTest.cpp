@@ -0,0 +1,125 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/HotRestart.h>
+#include <Lupus/Network/Socket.h>
+#include <Lupus/Network/IPEndPoint.h>
+#include <Lupus/Network/UnixEndPoint.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(HotRestartTest)
+    {
+    public:
+
+#ifndef _MSC_VER
+        static SocketPtr CreateListener()
+        {
+            SocketPtr listener(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+
+            listener->Bind(IPEndPointPtr(new IPEndPoint(0x7F000001, 0)));
+            listener->Listen(4);
+            return listener;
+        }
+
+        TEST_METHOD(HotRestart_Handoff)
+        {
+            const String path = "/tmp/lupus_hotrestart_handoff.sock";
+            SocketPtr listener = CreateListener();
+            HotRestart restart(path);
+            Vector<SocketPtr> inherited;
+            AddrStorage address;
+            AddrLength length = sizeof(AddrStorage);
+
+            getsockname(listener->Handle(), (Addr*)&address, &length);
+            restart.Add(listener);
+
+            // Erstellt den Kanal, es wartet noch kein Nachfolger.
+            Assert::IsFalse(restart.Handoff(0));
+
+            Thread successor([&]() {
+                inherited = HotRestart::Inherit(path, 5000);
+            });
+
+            Assert::IsTrue(restart.Handoff(5000));
+            successor.join();
+
+            Assert::IsTrue(restart.Draining());
+            Assert::IsTrue(restart.Sockets().empty());
+            Assert::IsTrue(listener->Handle() == INVALID_SOCKET);
+            Assert::AreEqual<size_t>(1, inherited.size());
+            Assert::IsTrue(inherited[0]->IsListening());
+
+            // Der Kernel-Socket ist derselbe, die Adresse bleibt erreichbar.
+            SocketPtr client(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+
+            client->Connect(EndPoint::Create(Vector<Byte>((Byte*)&address, (Byte*)&address + sizeof(AddrStorage)), (U32)length));
+            Assert::IsTrue(inherited[0]->Accept()->IsConnected());
+        }
+
+        TEST_METHOD(HotRestart_NoPredecessor)
+        {
+            Assert::IsTrue(HotRestart::Inherit("/tmp/lupus_hotrestart_missing.sock", 100).empty());
+
+            // Nur ein fehlender Vorgänger ist kein Fehler.
+            Assert::ExpectException<socket_error>([]() {
+                HotRestart::Inherit("/dev/null/lupus_hotrestart.sock", 100);
+            });
+        }
+
+        TEST_METHOD(HotRestart_SuccessorAborts)
+        {
+            const String path = "/tmp/lupus_hotrestart_abort.sock";
+            SocketPtr listener = CreateListener();
+            HotRestart restart(path);
+
+            restart.Add(listener);
+            Assert::IsFalse(restart.Handoff(0));
+
+            // Ein Nachfolger der sich sofort wieder beendet darf den Prozess
+            // nicht über SIGPIPE beenden.
+            SocketPtr successor(new Socket(AddressFamily::UNIX, SocketType::Stream, ProtocolType::Unspecified));
+
+            successor->Connect(UnixEndPointPtr(new UnixEndPoint(path)));
+            successor->Close();
+
+            Assert::IsFalse(restart.Handoff(1000));
+            Assert::IsFalse(restart.Draining());
+            Assert::AreEqual<size_t>(1, restart.Sockets().size());
+            Assert::IsTrue(listener->IsListening());
+        }
+
+        TEST_METHOD(HotRestart_InvalidPredecessor)
+        {
+            const String path = "/tmp/lupus_hotrestart_invalid.sock";
+            SocketPtr predecessor(new Socket(AddressFamily::UNIX, SocketType::Stream, ProtocolType::Unspecified));
+            U32 counts[] = { 0xFFFFFFFF, 1 };
+
+            std::remove(path.c_str());
+            predecessor->Bind(UnixEndPointPtr(new UnixEndPoint(path)));
+            predecessor->Listen(2);
+
+            // Eine unplausible Anzahl wird abgelehnt, eine angekündigte aber
+            // nie gesendete Socket läuft in die Wartezeit.
+            for (U32 count : counts) {
+                Thread thread([&]() {
+                    SocketPtr channel = predecessor->Accept();
+
+                    channel->Send(Vector<Byte>((Byte*)&count, (Byte*)&count + 4));
+                    channel->Poll(5000, SocketPollFlags::Read);
+                });
+
+                Assert::ExpectException<socket_error>([&]() {
+                    HotRestart::Inherit(path, 100);
+                });
+
+                thread.join();
+            }
+
+            std::remove(path.c_str());
+        }
+#endif
+    };
+}
@@ -1,6 +1,6 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
-#include <Lupus\Network\IPAddress.h>
+#include <Lupus/Network/IPAddress.h>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Lupus;
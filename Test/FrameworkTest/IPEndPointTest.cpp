@@ -1,7 +1,7 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
-#include <Lupus\Network\IPAddress.h>
-#include <Lupus\Network\IPEndPoint.h>
+#include <Lupus/Network/IPAddress.h>
+#include <Lupus/Network/IPEndPoint.h>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Lupus;
@@ -19,19 +19,19 @@ namespace FrameworkTest
         {
         }
 
-        IPAddressMock(const Vector<Byte>& ipv6) throw(std::length_error) :
+        IPAddressMock(const Vector<Byte>& ipv6) LU_THROWS(std::length_error) :
             IPAddress(ipv6)
         {
             mIpv6 = true;
         }
 
-        IPAddressMock(const Vector<Byte>& ipv6, U32 scopeid) throw(std::length_error) :
+        IPAddressMock(const Vector<Byte>& ipv6, U32 scopeid) LU_THROWS(std::length_error) :
             IPAddress(ipv6, scopeid)
         {
             mIpv6 = true;
         }
 
-        IPAddressMock(std::initializer_list<Byte> ilist) throw(std::length_error) :
+        IPAddressMock(std::initializer_list<Byte> ilist) LU_THROWS(std::length_error) :
             IPAddress(ilist)
         {
             mIpv6 = true;
@@ -117,5 +117,23 @@ namespace FrameworkTest
             Assert::IsTrue(54321 == point.Port());
             Assert::IsTrue(54321 == point6.Port());
         }
+
+        TEST_METHOD(IPEndPoint_Serialize)
+        {
+            IPEndPoint point(0x7F000001, 12345);
+            IPEndPoint point6(IPAddressPtr(new IPAddress({ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 })), 12345);
+            IPEndPoint copy(point.Serialize());
+            IPEndPoint copy6(point6.Serialize());
+
+            Assert::IsTrue(copy.Family() == AddressFamily::InterNetwork);
+            Assert::IsTrue(12345 == copy.Port());
+            Assert::AreEqual<String>("127.0.0.1", copy.Address()->ToString());
+            Assert::IsTrue(copy6.Family() == AddressFamily::InterNetworkV6);
+            Assert::IsTrue(12345 == copy6.Port());
+
+            Assert::ExpectException<std::invalid_argument>([](){
+                IPEndPoint(Vector<Byte>(4));
+            });
+        }
     };
 }
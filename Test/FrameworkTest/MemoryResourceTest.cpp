@@ -0,0 +1,78 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Memory/MemoryResource.h>
+
+#ifdef LUPUS_MEMORY_RESOURCE
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(MemoryResourceTest)
+    {
+    public:
+
+        TEST_METHOD(MemoryResource_StackResource)
+        {
+            StackAllocator allocator(4 * KiB);
+            StackResource resource(allocator);
+            UIntPtr base = allocator.GetMarker();
+
+            {
+                std::pmr::vector<U32> values(&resource);
+
+                for (U32 i = 0; i < 100; i++) {
+                    values.push_back(i);
+                }
+
+                Assert::IsTrue((UIntPtr)values.data() >= base && (UIntPtr)values.data() < base + 4 * KiB);
+                Assert::AreEqual(99U, values.back());
+            }
+
+            // Der Speicher wird erst mit Clear wieder verfügbar.
+            Assert::AreNotEqual(base, allocator.GetMarker());
+            allocator.Clear();
+
+            std::pmr::vector<Byte> large(&resource);
+            Assert::ExpectException<std::bad_alloc>([&]() { large.resize(8 * KiB); });
+        }
+
+        TEST_METHOD(MemoryResource_ChunkedStackResource)
+        {
+            ChunkedStackAllocator allocator(1 * KiB);
+            ChunkedStackResource resource(allocator);
+            std::pmr::map<U32, std::pmr::string> messages(&resource);
+
+            for (U32 i = 0; i < 100; i++) {
+                messages.emplace(i, "message with a string that does not fit into the small buffer");
+            }
+
+            Assert::AreEqual((size_t)100, messages.size());
+            Assert::IsTrue(allocator.ChunkCount() > 1);
+        }
+
+        TEST_METHOD(MemoryResource_DoubleBufferResource)
+        {
+            DoubleBufferAllocator allocator(4 * KiB);
+            DoubleBufferResource resource(allocator);
+            std::pmr::vector<Byte> previous(16, 1, &resource);
+
+            // Nach dem Wechsel kommt der Speicher aus dem anderen Stack, der
+            // vorherige Frame bleibt lesbar.
+            allocator.Swap();
+            allocator.Clear();
+
+            std::pmr::vector<Byte> current(16, 2, &resource);
+            Assert::IsTrue(previous.data() != current.data());
+            Assert::AreEqual<Byte>(1, previous[15]);
+            Assert::IsTrue(resource.is_equal(resource));
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/NetworkStream.h>
+#include <Lupus/Network/Socket.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(NetworkStreamTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(NetworkStreamTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(NetworkStreamTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        TEST_METHOD(NetworkStream_Constructor)
+        {
+            SocketPtr first, second;
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            Assert::ExpectException<null_pointer>([]() { NetworkStream(SocketPtr(nullptr)); });
+            Assert::ExpectException<std::invalid_argument>([&]() { NetworkStream(first, 0, 64); });
+            Assert::ExpectException<std::invalid_argument>([]() {
+                NetworkStream(SocketPtr(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP)));
+            });
+
+            NetworkStream stream(first, 32, 64);
+
+            Assert::AreEqual(32U, stream.ReadBufferSize());
+            Assert::AreEqual(64U, stream.WriteBufferSize());
+        }
+
+        TEST_METHOD(NetworkStream_Write)
+        {
+            SocketPtr first, second;
+            Vector<Byte> buffer(128);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            NetworkStream stream(first, 64, 64);
+
+            // Kleine Schreiboperationen werden gesammelt.
+            stream.Write(Vector<Byte>({ 1, 2, 3 }));
+            stream.Write(Vector<Byte>({ 4, 5 }));
+            Assert::AreEqual(5U, stream.Pending());
+            Assert::AreEqual(0U, second->Available());
+
+            stream.Flush();
+            Assert::AreEqual(0U, stream.Pending());
+            Assert::AreEqual(5, second->Receive(buffer));
+            Assert::AreEqual<Byte>(5, buffer[4]);
+
+            // Größere Anfragen umgehen den Buffer.
+            stream.Write(Vector<Byte>(100, 7));
+            Assert::AreEqual(0U, stream.Pending());
+            Assert::AreEqual(100, second->Receive(buffer));
+            Assert::ExpectException<std::out_of_range>([&]() { stream.Write(buffer, 100, 29); });
+        }
+
+        TEST_METHOD(NetworkStream_ReserveCommit)
+        {
+            SocketPtr first, second;
+            Vector<Byte> buffer(16);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            NetworkStream stream(first, 64, 64);
+            Byte* data = stream.Reserve(4);
+
+            data[0] = 9;
+            data[3] = 8;
+            stream.Commit(4);
+            Assert::AreEqual(4U, stream.Pending());
+            Assert::ExpectException<std::out_of_range>([&]() { stream.Commit(61); });
+            Assert::ExpectException<std::out_of_range>([&]() { stream.Reserve(65); });
+
+            stream.Flush();
+            Assert::AreEqual(4, second->Receive(buffer));
+            Assert::AreEqual<Byte>(9, buffer[0]);
+            Assert::AreEqual<Byte>(8, buffer[3]);
+        }
+
+        TEST_METHOD(NetworkStream_Read)
+        {
+            SocketPtr first, second;
+            Vector<Byte> buffer(4);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            NetworkStream stream(first, 64, 64);
+
+            second->Send(Vector<Byte>({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }));
+
+            // Ein einziger Aufruf füllt den Lese-Buffer.
+            Assert::AreEqual(4, stream.Read(buffer));
+            Assert::AreEqual<Byte>(4, buffer[3]);
+            Assert::AreEqual(6U, stream.Buffered());
+            Assert::AreEqual<Byte>(5, stream.Peek()[0]);
+
+            stream.Consume(2);
+            Assert::AreEqual(4U, stream.Buffered());
+            Assert::ExpectException<std::out_of_range>([&]() { stream.Consume(5); });
+            Assert::AreEqual(4, stream.Read(buffer));
+            Assert::AreEqual<Byte>(10, buffer[3]);
+            Assert::AreEqual(0U, stream.Buffered());
+        }
+
+        TEST_METHOD(NetworkStream_FillFlushes)
+        {
+            SocketPtr first, second;
+            Vector<Byte> buffer(8);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            NetworkStream stream(first, 64, 64);
+
+            second->Send(Vector<Byte>({ 1, 2 }));
+            stream.Write(Vector<Byte>({ 3 }));
+
+            // Ausstehende Daten werden vor dem Lesen gesendet.
+            Assert::AreEqual(2, stream.Fill());
+            Assert::AreEqual(0U, stream.Pending());
+            Assert::AreEqual(1, second->Receive(buffer));
+            Assert::AreEqual<Byte>(3, buffer[0]);
+
+            // Die Daten bleiben im Lese-Buffer bis sie entnommen werden.
+            second->Send(Vector<Byte>({ 4 }));
+            Assert::AreEqual(1, stream.Fill());
+            Assert::AreEqual(3U, stream.Buffered());
+            Assert::AreEqual<Byte>(4, stream.Peek()[2]);
+
+            // Ein voller Buffer ist kein Schließen der Verbindung.
+            second->Send(Vector<Byte>(61, 5));
+            Assert::AreEqual(61, stream.Fill());
+            Assert::ExpectException<std::out_of_range>([&] { stream.Fill(); });
+        }
+
+        TEST_METHOD(NetworkStream_Close)
+        {
+            SocketPtr first, second;
+            Vector<Byte> buffer(8);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+
+            {
+                NetworkStream stream(first, 64, 64);
+
+                stream.Write(Vector<Byte>({ 1, 2, 3 }));
+            }
+
+            // Der Destruktor sendet ausstehende Daten.
+            Assert::AreEqual(3, second->Receive(buffer));
+
+            NetworkStream stream(first, 64, 64);
+
+            stream.Write(Vector<Byte>({ 4 }));
+            stream.Close();
+            Assert::AreEqual(1, second->Receive(buffer));
+            Assert::AreEqual(0, second->Receive(buffer));
+        }
+    };
+}
@@ -0,0 +1,183 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Memory/PoolAllocator.h>
+#include <chrono>
+#include <set>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(PoolAllocatorTest)
+    {
+    public:
+
+        struct Entry
+        {
+            Entry(U32 id, String name) : Id(id), Name(name) {}
+
+            U32 Id;
+            String Name;
+        };
+
+        TEST_METHOD(PoolAllocator_CreateDestroy)
+        {
+            PoolAllocator<Entry> pool;
+            std::set<Entry*> entries;
+
+            for (U32 i = 0; i < 1000; i++) {
+                Entry* entry = pool.Create(i, "entry");
+
+                Assert::AreEqual(i, entry->Id);
+                Assert::AreEqual(0U, (U32)((UIntPtr)entry % std::alignment_of<Entry>::value));
+                entries.insert(entry);
+            }
+
+            Assert::AreEqual<size_t>(1000, entries.size());
+            Assert::IsTrue(pool.Reserved() >= 1000 * sizeof(Entry));
+
+            for (Entry* entry : entries) {
+                pool.Destroy(entry);
+            }
+
+            // Freigegebene Blöcke werden wiederverwendet.
+            U64 reserved = pool.Reserved();
+            Entry* entry = pool.Create(1, "reused");
+            Assert::IsTrue(entries.count(entry) == 1);
+            Assert::AreEqual(reserved, pool.Reserved());
+            pool.Destroy(entry);
+            pool.Destroy(nullptr);
+        }
+
+        TEST_METHOD(PoolAllocator_Alignment)
+        {
+            PoolAllocator<U32, true> pool;
+            FixedSizePool small(1, 1);
+
+            Assert::AreEqual(FixedSizePool::CacheLineSize, pool.BlockSize());
+            Assert::IsTrue(small.BlockSize() >= sizeof(void*));
+            Assert::ExpectException<std::invalid_argument>([] { FixedSizePool(8, 3); });
+
+            for (U32 i = 0; i < 200; i++) {
+                Assert::AreEqual(0U, (U32)((UIntPtr)pool.Allocate() % FixedSizePool::CacheLineSize));
+            }
+        }
+
+        TEST_METHOD(PoolAllocator_CrossThread)
+        {
+            PoolAllocator<U64> pool;
+            Vector<U64*> blocks;
+
+            // Ein Thread fordert an, ein anderer gibt frei.
+            Thread producer([&]() {
+                for (U32 i = 0; i < 10000; i++) {
+                    blocks.push_back(pool.Create(i));
+                }
+            });
+
+            producer.join();
+
+            Thread consumer([&]() {
+                for (U64* block : blocks) {
+                    pool.Free(block);
+                }
+            });
+
+            consumer.join();
+
+            U64 reserved = pool.Reserved();
+            std::set<U64*> reused;
+
+            for (U32 i = 0; i < 10000; i++) {
+                reused.insert(pool.Allocate());
+            }
+
+            Assert::AreEqual<size_t>(10000, reused.size());
+            Assert::AreEqual(reserved, pool.Reserved());
+        }
+
+        TEST_METHOD(PoolAllocator_ThreadExit)
+        {
+            PoolAllocator<U64> pool;
+            U64 reserved = 0;
+
+            // Die Magazine beendeter Threads gehen an die globale Liste,
+            // auch bei mehr Threads als Caches.
+            for (U32 i = 0; i < 200; i++) {
+                Thread([&]() {
+                    Vector<U64*> blocks;
+
+                    for (U32 j = 0; j < 3 * FixedSizePool::MagazineSize; j++) {
+                        blocks.push_back(pool.Allocate());
+                    }
+
+                    for (U64* block : blocks) {
+                        pool.Free(block);
+                    }
+                }).join();
+
+                if (i == 0) {
+                    reserved = pool.Reserved();
+                }
+            }
+
+            Assert::AreEqual(reserved, pool.Reserved());
+        }
+
+        TEST_METHOD(PoolAllocator_Benchmark)
+        {
+            const U32 threads = 4, iterations = 200000, live = 256;
+            PoolAllocator<Entry> pool;
+
+            auto run = [&](Function<void()> function) {
+                Vector<Thread> workers;
+                auto begin = std::chrono::high_resolution_clock::now();
+
+                for (U32 i = 0; i < threads; i++) {
+                    workers.push_back(Thread(function));
+                }
+
+                for (Thread& worker : workers) {
+                    worker.join();
+                }
+
+                return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+            };
+
+            // Jeder Thread hält eine Anzahl lebender Objekte und ersetzt
+            // reihum das älteste, wie bei kurzlebigen Verbindungen.
+            auto heap = run([&]() {
+                Vector<Entry*> entries(live, nullptr);
+
+                for (U32 i = 0; i < iterations; i++) {
+                    delete entries[i % live];
+                    entries[i % live] = new Entry(i, String());
+                }
+
+                for (Entry* entry : entries) {
+                    delete entry;
+                }
+            });
+
+            auto pooled = run([&]() {
+                Vector<Entry*> entries(live, nullptr);
+
+                for (U32 i = 0; i < iterations; i++) {
+                    pool.Destroy(entries[i % live]);
+                    entries[i % live] = pool.Create(i, String());
+                }
+
+                for (Entry* entry : entries) {
+                    pool.Destroy(entry);
+                }
+            });
+
+            String message = "new/delete: " + std::to_string(heap) + "us, "
+                "PoolAllocator: " + std::to_string(pooled) + "us\n";
+
+            Logger::WriteMessage(message.c_str());
+            Assert::IsTrue(pool.Reserved() < 2 * 1024 * 1024);
+        }
+    };
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+// Nachbildung des Microsoft CppUnitTest Frameworks für den POSIX-Build. Sie
+// umfasst nur was die Tests in FrameworkTest verwenden. Jede TEST_METHOD
+// meldet sich beim Programmstart an und wird von Main.cpp ausgeführt.
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace Microsoft { namespace VisualStudio { namespace CppUnitTestFramework {
+    //! Wird von Assert geworfen und von Main.cpp als Fehlschlag gemeldet.
+    class AssertFailure
+    {
+    public:
+        explicit AssertFailure(const std::string& message) :
+            mMessage(message)
+        {
+        }
+
+        const std::string& Message() const
+        {
+            return mMessage;
+        }
+
+    private:
+        std::string mMessage;
+    };
+
+    namespace Internal {
+        template <typename T>
+        class IsPrintable
+        {
+            template <typename U>
+            static auto Test(int) -> decltype(std::declval<std::ostream&>() << std::declval<const U&>(), std::true_type());
+
+            template <typename>
+            static std::false_type Test(...);
+
+        public:
+            static const bool value = decltype(Test<T>(0))::value;
+        };
+
+        //! Zeiger werden als Adresse ausgegeben, auch Byte-Zeiger.
+        template <typename T>
+        std::string ToString(T* value)
+        {
+            std::ostringstream stream;
+
+            stream << (const void*)value;
+            return stream.str();
+        }
+
+        template <typename T>
+        typename std::enable_if<IsPrintable<T>::value && !std::is_enum<T>::value && !std::is_pointer<T>::value, std::string>::type ToString(const T& value)
+        {
+            std::ostringstream stream;
+
+            stream << value;
+            return stream.str();
+        }
+
+        template <typename T>
+        typename std::enable_if<std::is_enum<T>::value, std::string>::type ToString(const T& value)
+        {
+            return std::to_string((long long)value);
+        }
+
+        template <typename T>
+        typename std::enable_if<!IsPrintable<T>::value && !std::is_enum<T>::value && !std::is_pointer<T>::value, std::string>::type ToString(const T&)
+        {
+            return "?";
+        }
+
+        inline std::string ToString(unsigned char value)
+        {
+            return std::to_string((unsigned)value);
+        }
+
+        inline std::string ToString(signed char value)
+        {
+            return std::to_string((int)value);
+        }
+
+        inline std::string Narrow(const wchar_t* message)
+        {
+            std::string result;
+
+            for (; message && *message; message++) {
+                result.push_back((*message < 0x80) ? (char)*message : '?');
+            }
+
+            return result;
+        }
+
+        inline void Fail(const std::string& what, const wchar_t* message)
+        {
+            std::string text = what;
+
+            if (message) {
+                text += " " + Narrow(message);
+            }
+
+            throw AssertFailure(text);
+        }
+
+        //! Verzeichnis aller Testklassen, liegt in Main.cpp.
+        void AddMethod(const char* className, const char* methodName, std::function<void()> method);
+        void SetClassInitialize(const char* className, std::function<void()> method);
+        void SetClassCleanup(const char* className, std::function<void()> method);
+
+        template <typename T, void (T::*Method)(), const char* (*Name)()>
+        struct MethodEntry
+        {
+            static const bool Registered;
+        };
+
+        template <typename T, void (T::*Method)(), const char* (*Name)()>
+        const bool MethodEntry<T, Method, Name>::Registered = (AddMethod(GetTestClassName((T*)nullptr), Name(), []() {
+            T test;
+            (test.*Method)();
+        }), true);
+
+        template <typename T, void (*Method)(), bool Initialize>
+        struct ClassEntry
+        {
+            static const bool Registered;
+        };
+
+        template <typename T, void (*Method)(), bool Initialize>
+        const bool ClassEntry<T, Method, Initialize>::Registered = (Initialize ?
+            SetClassInitialize(GetTestClassName((T*)nullptr), Method) :
+            SetClassCleanup(GetTestClassName((T*)nullptr), Method), true);
+    }
+
+    template <typename T>
+    class TestClass
+    {
+    public:
+        typedef T ThisClass;
+    };
+
+    class Logger
+    {
+    public:
+        static void WriteMessage(const char* message)
+        {
+            std::fputs(message, stdout);
+        }
+
+        static void WriteMessage(const wchar_t* message)
+        {
+            std::fputs(Internal::Narrow(message).c_str(), stdout);
+        }
+    };
+
+    //! Werte werden kopiert, damit statische Konstanten wie unter MSVC keine
+    //! Definition außerhalb der Klasse benötigen.
+    class Assert
+    {
+    public:
+        template <typename T>
+        static void AreEqual(T expected, T actual, const wchar_t* message = nullptr)
+        {
+            if (!(expected == actual)) {
+                Internal::Fail("AreEqual failed. Expected:<" + Internal::ToString(expected) + "> Actual:<" + Internal::ToString(actual) + ">", message);
+            }
+        }
+
+        static void AreEqual(const char* expected, const char* actual, const wchar_t* message = nullptr)
+        {
+            if (std::strcmp(expected, actual) != 0) {
+                Internal::Fail("AreEqual failed. Expected:<" + std::string(expected) + "> Actual:<" + actual + ">", message);
+            }
+        }
+
+        static void AreEqual(double expected, double actual, double tolerance, const wchar_t* message = nullptr)
+        {
+            if (std::fabs(expected - actual) > tolerance) {
+                Internal::Fail("AreEqual failed. Expected:<" + std::to_string(expected) + "> Actual:<" + std::to_string(actual) + ">", message);
+            }
+        }
+
+        template <typename T>
+        static void AreNotEqual(T notExpected, T actual, const wchar_t* message = nullptr)
+        {
+            if (notExpected == actual) {
+                Internal::Fail("AreNotEqual failed. Value:<" + Internal::ToString(actual) + ">", message);
+            }
+        }
+
+        static void IsTrue(bool condition, const wchar_t* message = nullptr)
+        {
+            if (!condition) {
+                Internal::Fail("IsTrue failed.", message);
+            }
+        }
+
+        static void IsFalse(bool condition, const wchar_t* message = nullptr)
+        {
+            if (condition) {
+                Internal::Fail("IsFalse failed.", message);
+            }
+        }
+
+        template <typename T>
+        static void IsNull(const T* pointer, const wchar_t* message = nullptr)
+        {
+            if (pointer != nullptr) {
+                Internal::Fail("IsNull failed.", message);
+            }
+        }
+
+        template <typename T>
+        static void IsNotNull(const T* pointer, const wchar_t* message = nullptr)
+        {
+            if (pointer == nullptr) {
+                Internal::Fail("IsNotNull failed.", message);
+            }
+        }
+
+        static void Fail(const wchar_t* message = nullptr)
+        {
+            Internal::Fail("Fail.", message);
+        }
+
+        template <typename E, typename F>
+        static void ExpectException(F functor, const wchar_t* message = nullptr)
+        {
+            try {
+                functor();
+            } catch (E&) {
+                return;
+            }
+
+            Internal::Fail("ExpectException failed. No exception was thrown.", message);
+        }
+    };
+}}}
+
+#define TEST_CLASS(className) \
+    class className; \
+    inline const char* GetTestClassName(className*) { return #className; } \
+    class className : public ::Microsoft::VisualStudio::CppUnitTestFramework::TestClass<className>
+
+#define TEST_METHOD(methodName) \
+    static const char* methodName##_Name() { return #methodName; } \
+    static bool methodName##_Registered() { return ::Microsoft::VisualStudio::CppUnitTestFramework::Internal::MethodEntry<ThisClass, &ThisClass::methodName, &ThisClass::methodName##_Name>::Registered; } \
+    void methodName()
+
+#define TEST_CLASS_INITIALIZE(methodName) \
+    static bool methodName##_Registered() { return ::Microsoft::VisualStudio::CppUnitTestFramework::Internal::ClassEntry<ThisClass, &ThisClass::methodName, true>::Registered; } \
+    static void methodName()
+
+#define TEST_CLASS_CLEANUP(methodName) \
+    static bool methodName##_Registered() { return ::Microsoft::VisualStudio::CppUnitTestFramework::Internal::ClassEntry<ThisClass, &ThisClass::methodName, false>::Registered; } \
+    static void methodName()
+
+// Die Tests initialisieren Winsock selbst, unter POSIX ist dafür nichts zu
+// tun.
+struct WSADATA
+{
+};
+
+inline int WSAStartup(unsigned short, WSADATA*)
+{
+    return 0;
+}
+
+inline int WSACleanup()
+{
+    return 0;
+}
+
+#define MAKEWORD(low, high) ((unsigned short)(((low) & 0xFF) | (((high) & 0xFF) << 8)))
@@ -0,0 +1,126 @@
+#include "CppUnitTest.h"
+#include <exception>
+#include <map>
+#include <vector>
+
+// Führt die angemeldeten Testklassen aus. Ohne Argumente laufen alle Klassen,
+// ansonsten nur die angegebenen. ctest startet jede Klasse einzeln.
+
+namespace Microsoft { namespace VisualStudio { namespace CppUnitTestFramework {
+    namespace Internal {
+        struct TestMethod
+        {
+            const char* Name;
+            std::function<void()> Run;
+        };
+
+        struct TestClassEntry
+        {
+            std::function<void()> Initialize;
+            std::function<void()> Cleanup;
+            std::vector<TestMethod> Methods;
+        };
+
+        std::map<std::string, TestClassEntry>& Classes()
+        {
+            static std::map<std::string, TestClassEntry> classes;
+            return classes;
+        }
+
+        void AddMethod(const char* className, const char* methodName, std::function<void()> method)
+        {
+            Classes()[className].Methods.push_back({ methodName, method });
+        }
+
+        void SetClassInitialize(const char* className, std::function<void()> method)
+        {
+            Classes()[className].Initialize = method;
+        }
+
+        void SetClassCleanup(const char* className, std::function<void()> method)
+        {
+            Classes()[className].Cleanup = method;
+        }
+
+        //! \returns Leer wenn der Aufruf gelang, ansonsten die Fehlermeldung.
+        std::string Invoke(const std::function<void()>& method)
+        {
+            try {
+                method();
+                return std::string();
+            } catch (AssertFailure& failure) {
+                return failure.Message();
+            } catch (std::exception& e) {
+                return std::string("Unhandled exception: ") + e.what();
+            } catch (...) {
+                return "Unhandled exception";
+            }
+        }
+
+        //! \returns Die Anzahl der fehlgeschlagenen Tests.
+        int RunClass(const std::string& name, const TestClassEntry& entry)
+        {
+            std::string error;
+            int failed = 0;
+
+            if (entry.Initialize && !(error = Invoke(entry.Initialize)).empty()) {
+                std::printf("[  FAILED  ] %s (class initialize): %s\n", name.c_str(), error.c_str());
+                return (int)entry.Methods.size();
+            }
+
+            for (const TestMethod& method : entry.Methods) {
+                std::printf("[ RUN      ] %s::%s\n", name.c_str(), method.Name);
+                std::fflush(stdout);
+
+                if ((error = Invoke(method.Run)).empty()) {
+                    std::printf("[       OK ] %s::%s\n", name.c_str(), method.Name);
+                } else {
+                    std::printf("[  FAILED  ] %s::%s: %s\n", name.c_str(), method.Name, error.c_str());
+                    failed++;
+                }
+            }
+
+            if (entry.Cleanup && !(error = Invoke(entry.Cleanup)).empty()) {
+                std::printf("[  FAILED  ] %s (class cleanup): %s\n", name.c_str(), error.c_str());
+                failed++;
+            }
+
+            return failed;
+        }
+    }
+}}}
+
+int main(int argc, char** argv)
+{
+    using namespace Microsoft::VisualStudio::CppUnitTestFramework::Internal;
+
+    std::vector<std::string> names;
+    int failed = 0;
+
+    for (int i = 1; i < argc; i++) {
+        names.push_back(argv[i]);
+    }
+
+    if (names.empty()) {
+        for (const auto& entry : Classes()) {
+            names.push_back(entry.first);
+        }
+    }
+
+    for (const std::string& name : names) {
+        auto it = Classes().find(name);
+
+        // Ist eine Klasse auf dieser Plattform bzw mit diesem Sprachstandard
+        // ausgeblendet, dann darf sie nicht unbemerkt als bestanden gelten.
+        if (it == Classes().end()) {
+            std::printf("[  FAILED  ] %s: no tests registered\n", name.c_str());
+            failed++;
+            continue;
+        }
+
+        failed += RunClass(name, it->second);
+    }
+
+    std::fflush(stdout);
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Threading/Scheduler.h>
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(SchedulerTest)
+    {
+    public:
+
+        TEST_METHOD(Scheduler_Constructor)
+        {
+            Assert::AreEqual(3U, Scheduler(3).Workers());
+            Assert::IsTrue(Scheduler().Workers() > 0);
+            Assert::ExpectException<std::invalid_argument>([]() { Scheduler(0); });
+        }
+
+        TEST_METHOD(Scheduler_Submit)
+        {
+            Atomic<U32> count(0);
+            Function<void(U32)> spawn;
+
+            {
+                Scheduler scheduler(4);
+
+                spawn = [&](U32 depth) {
+                    count++;
+
+                    if (depth > 0) {
+                        scheduler.Submit([&, depth]() { spawn(depth - 1); });
+                        scheduler.Submit([&, depth]() { spawn(depth - 1); });
+                    }
+                };
+
+                Assert::AreEqual(-1, scheduler.Current());
+                scheduler.Submit([&]() { spawn(10); });
+            }
+
+            Assert::AreEqual(2047U, count.load());
+        }
+
+        TEST_METHOD(Scheduler_Steal)
+        {
+            Vector<U32> counts(4);
+            Mutex mutex;
+
+            {
+                Scheduler scheduler(4);
+
+                for (U32 i = 0; i < 200; i++) {
+                    scheduler.Submit(0, [&]() {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                        LockGuard<Mutex> lock(mutex);
+                        counts[scheduler.Current()]++;
+                    });
+                }
+            }
+
+            // Alle Aufgaben gehören Worker 0, die anderen müssen stehlen.
+            Assert::IsTrue(counts[0] < 200);
+            Assert::AreEqual(200U, counts[0] + counts[1] + counts[2] + counts[3]);
+        }
+    };
+}
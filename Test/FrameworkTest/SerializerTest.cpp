@@ -0,0 +1,173 @@
+﻿#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Serializer.h>
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    enum class SerializerKind : U16
+    {
+        First = 1,
+        Second = 0x0203
+    };
+
+    struct SerializerPoint
+    {
+        S32 X;
+        S32 Y;
+        SerializerKind Kind;
+        bool Flag;
+        U8 Raw[3];
+
+        typedef Fields<
+            LUPUS_FIELD(SerializerPoint, X),
+            LUPUS_FIELD(SerializerPoint, Y),
+            LUPUS_FIELD(SerializerPoint, Kind),
+            LUPUS_FIELD(SerializerPoint, Flag),
+            LUPUS_FIELD(SerializerPoint, Raw)> Layout;
+    };
+
+    class SerializerMessage : public Serializable<SerializerMessage>
+    {
+    public:
+
+        String Name;
+        Vector<U32> Values;
+        Vector<SerializerPoint> Points;
+        Vector<String> Tags;
+
+        typedef Fields<
+            LUPUS_FIELD(SerializerMessage, Name),
+            LUPUS_FIELD(SerializerMessage, Values),
+            LUPUS_FIELD(SerializerMessage, Points),
+            LUPUS_FIELD(SerializerMessage, Tags)> Layout;
+    };
+
+    TEST_CLASS(SerializerTest)
+    {
+    public:
+
+        TEST_METHOD(Serializer_FixedLayout)
+        {
+            SerializerPoint point = { 1, -2, SerializerKind::Second, true, { 7, 8, 9 } };
+            SerializerPoint copy = {};
+            Byte buffer[14], expected[14];
+            ByteWriter writer(buffer, sizeof(buffer));
+            ByteWriter manual(expected, sizeof(expected));
+
+            Assert::IsTrue(Codec<SerializerPoint>::Fixed);
+            Assert::AreEqual(14U, Codec<SerializerPoint>::Size);
+
+            // Das Format entspricht dem von Hand geschriebenen.
+            Serialize(writer, point);
+            manual.Write((S32)1);
+            manual.Write((S32)-2);
+            manual.Write((U16)0x0203);
+            manual.Write(true);
+            manual.Write(point.Raw, 3);
+            Assert::AreEqual(0, memcmp(buffer, expected, sizeof(buffer)));
+
+            ByteReader reader(buffer, sizeof(buffer));
+            Deserialize(reader, copy);
+            Assert::AreEqual(-2, copy.Y);
+            Assert::IsTrue(copy.Kind == SerializerKind::Second);
+            Assert::AreEqual<U8>(9, copy.Raw[2]);
+        }
+
+        TEST_METHOD(Serializer_Serializable)
+        {
+            SerializerMessage message, copy;
+            SerializerPoint point = { 3, 4, SerializerKind::First, false, { 0, 0, 0 } };
+
+            message.Name = "lupus";
+            message.Values.assign(100, 0x01020304);
+            message.Points.assign(10, point);
+            message.Tags = { "a", "bc" };
+
+            Vector<Byte> buffer = message.Serialize();
+            copy.Deserialize(buffer);
+            Assert::AreEqual(message.Name, copy.Name);
+            Assert::IsTrue(message.Values == copy.Values);
+            Assert::AreEqual(4, copy.Points[9].Y);
+            Assert::IsTrue(message.Tags == copy.Tags);
+
+            buffer.pop_back();
+            Assert::ExpectException<std::invalid_argument>([&] { copy.Deserialize(buffer); });
+        }
+
+        TEST_METHOD(Serializer_Bulk)
+        {
+            Vector<U16> shorts = { 0x0102, 0x0304, 0x0506 };
+            Vector<U64> longs(20);
+            Vector<double> reals(9, -1.5);
+            Vector<bool> flags = { true, false, true };
+            Vector<U16> shortsCopy;
+            Vector<U64> longsCopy;
+            Vector<double> realsCopy;
+            Vector<bool> flagsCopy;
+            Vector<Byte> buffer(1024);
+            ByteWriter writer(buffer.data(), (U32)buffer.size());
+
+            for (U32 i = 0; i < longs.size(); i++) {
+                longs[i] = 0x0102030405060708ULL + i;
+            }
+
+            // Kurze und lange Folgen verwenden verschiedene Wege, das Format
+            // ist aber gleich.
+            Serialize(writer, shorts);
+            Serialize(writer, longs);
+            Serialize(writer, reals);
+            Serialize(writer, flags);
+            Assert::AreEqual<Byte>(0x01, buffer[4]);
+            Assert::AreEqual<Byte>(0x02, buffer[5]);
+            Assert::AreEqual<Byte>(0x01, buffer[14]);
+            Assert::AreEqual<Byte>(0x08, buffer[21]);
+
+            ByteReader reader(buffer.data(), writer.Written());
+            Deserialize(reader, shortsCopy);
+            Deserialize(reader, longsCopy);
+            Deserialize(reader, realsCopy);
+            Deserialize(reader, flagsCopy);
+            Assert::IsTrue(shorts == shortsCopy);
+            Assert::IsTrue(longs == longsCopy);
+            Assert::IsTrue(reals == realsCopy);
+            Assert::IsTrue(flags == flagsCopy);
+            Assert::AreEqual(0U, reader.Remaining());
+        }
+
+        TEST_METHOD(Serializer_Benchmark)
+        {
+            const S32 iterations = 2000;
+            Vector<U32> values(1000, 0x01020304);
+            Vector<Byte> buffer(8 * KiB);
+
+            auto begin = std::chrono::high_resolution_clock::now();
+
+            for (S32 i = 0; i < iterations; i++) {
+                ByteWriter writer(buffer.data(), (U32)buffer.size());
+                writer.Write((U32)values.size());
+
+                for (U32 value : values) {
+                    writer.Write(value);
+                }
+            }
+
+            auto single = std::chrono::high_resolution_clock::now() - begin;
+            begin = std::chrono::high_resolution_clock::now();
+
+            for (S32 i = 0; i < iterations; i++) {
+                ByteWriter writer(buffer.data(), (U32)buffer.size());
+                Serialize(writer, values);
+            }
+
+            auto bulk = std::chrono::high_resolution_clock::now() - begin;
+            String message = "ByteWriter::Write: " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(single).count()) + "us, "
+                "Serialize: " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(bulk).count()) + "us\n";
+
+            Logger::WriteMessage(message.c_str());
+        }
+    };
+}
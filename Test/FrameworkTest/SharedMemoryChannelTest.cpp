@@ -0,0 +1,171 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/SharedMemoryChannel.h>
+#include <Lupus/Network/Socket.h>
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(SharedMemoryChannelTest)
+    {
+    public:
+
+#ifdef __linux__
+        static void Connect(SocketPtr& first, SocketPtr& second, SharedMemoryChannelPtr& creator, SharedMemoryChannelPtr& acceptor)
+        {
+            Socket::CreatePair(SocketType::Stream, first, second);
+            creator = SharedMemoryChannel::Create(first, 4 * KiB);
+            acceptor = SharedMemoryChannel::Accept(second);
+        }
+
+        TEST_METHOD(SharedMemoryChannel_SendReceive)
+        {
+            SocketPtr first, second;
+            SharedMemoryChannelPtr creator, acceptor;
+            Vector<Byte> buffer(16);
+
+            Connect(first, second, creator, acceptor);
+            Assert::AreEqual(4U * KiB, creator->Capacity());
+            Assert::IsTrue(creator->IsConnected());
+            Assert::IsTrue(acceptor->IsConnected());
+
+            Assert::AreEqual(3, creator->Send(Vector<Byte>({ 1, 2, 3 })));
+            Assert::AreEqual(3U, acceptor->Available());
+            Assert::AreEqual(3, acceptor->Receive(buffer));
+            Assert::AreEqual<Byte>(3, buffer[2]);
+
+            Assert::AreEqual(2, acceptor->Send(Vector<Byte>({ 4, 5 })));
+            Assert::AreEqual(2, creator->Receive(buffer));
+            Assert::AreEqual<Byte>(5, buffer[1]);
+
+            // Null ist für das Schließen reserviert.
+            Assert::ExpectException<std::invalid_argument>([&]() { creator->Send(Vector<Byte>()); });
+            Assert::ExpectException<socket_error>([&]() { creator->Send(Vector<Byte>(4 * KiB)); });
+        }
+
+        TEST_METHOD(SharedMemoryChannel_NonBlocking)
+        {
+            SocketPtr first, second;
+            SharedMemoryChannelPtr creator, acceptor;
+            Vector<Byte> buffer(1 * KiB);
+            S32 sent = 0;
+
+            Connect(first, second, creator, acceptor);
+            creator->Blocking(false);
+            acceptor->Blocking(false);
+
+            Assert::AreEqual(-1, acceptor->Receive(buffer));
+
+            while (creator->Send(buffer) > 0) {
+                sent++;
+            }
+
+            Assert::IsTrue(sent > 0);
+
+            for (S32 i = 0; i < sent; i++) {
+                Assert::AreEqual(1 * 1024, acceptor->Receive(buffer));
+            }
+
+            Assert::AreEqual(-1, acceptor->Receive(buffer));
+        }
+
+        TEST_METHOD(SharedMemoryChannel_Close)
+        {
+            SocketPtr first, second;
+            SharedMemoryChannelPtr creator, acceptor;
+            Vector<Byte> buffer(16);
+
+            Connect(first, second, creator, acceptor);
+            creator->Send(Vector<Byte>({ 1, 2 }));
+            creator->Close();
+
+            // Bereits gesendete Nachrichten werden noch zugestellt.
+            Assert::IsFalse(acceptor->IsConnected());
+            Assert::AreEqual(2, acceptor->Receive(buffer));
+            Assert::AreEqual(0, acceptor->Receive(buffer));
+            Assert::ExpectException<socket_error>([&]() { acceptor->Send(buffer); });
+            Assert::ExpectException<socket_error>([&]() { creator->Receive(buffer); });
+        }
+
+        TEST_METHOD(SharedMemoryChannel_CloseWhileWaiting)
+        {
+            SocketPtr first, second;
+            SharedMemoryChannelPtr creator, acceptor;
+            S32 result = -1;
+
+            Connect(first, second, creator, acceptor);
+
+            Thread receiver([&]() {
+                Vector<Byte> buffer(16);
+                result = acceptor->Receive(buffer);
+            });
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            acceptor->Close();
+            receiver.join();
+            Assert::AreEqual(0, result);
+        }
+
+        TEST_METHOD(SharedMemoryChannel_LatencyBenchmark)
+        {
+            const S32 iterations = 20000;
+            SocketPtr first, second;
+            SharedMemoryChannelPtr creator, acceptor;
+            Vector<Byte> message(64, 1);
+
+            Connect(first, second, creator, acceptor);
+
+            // Ping-Pong zwischen zwei Threads, einmal über den Kanal und
+            // einmal über ein Socketpaar.
+            auto measure = [&](Function<void(Vector<Byte>&)> ping, Function<void(Vector<Byte>&)> pong) {
+                Thread partner([&]() {
+                    Vector<Byte> buffer(64);
+
+                    for (S32 i = 0; i < iterations; i++) {
+                        pong(buffer);
+                    }
+                });
+
+                Vector<Byte> buffer(64);
+                auto begin = std::chrono::high_resolution_clock::now();
+
+                for (S32 i = 0; i < iterations; i++) {
+                    ping(buffer);
+                }
+
+                auto elapsed = std::chrono::high_resolution_clock::now() - begin;
+                partner.join();
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / iterations;
+            };
+
+            auto shared = measure([&](Vector<Byte>& buffer) {
+                creator->Send(message);
+                creator->Receive(buffer);
+            }, [&](Vector<Byte>& buffer) {
+                acceptor->Receive(buffer);
+                acceptor->Send(message);
+            });
+
+            SocketPtr left, right;
+
+            Socket::CreatePair(SocketType::Stream, left, right);
+
+            auto sockets = measure([&](Vector<Byte>& buffer) {
+                left->Send(message);
+                left->Receive(buffer);
+            }, [&](Vector<Byte>& buffer) {
+                right->Receive(buffer);
+                right->Send(message);
+            });
+
+            String output = "SharedMemoryChannel: " + std::to_string(shared) + "ns, "
+                "Socket::CreatePair: " + std::to_string(sockets) + "ns per round trip\n";
+
+            Logger::WriteMessage(output.c_str());
+        }
+#endif
+    };
+}
@@ -0,0 +1,163 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/Socket.h>
+#include <Lupus/Network/SocketInformation.h>
+#include <Lupus/Network/IPEndPoint.h>
+#include <chrono>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(SocketTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(SocketTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(SocketTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        TEST_METHOD(Socket_Constructor)
+        {
+            Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP);
+            Socket(AddressFamily::InterNetwork, SocketType::Datagram, ProtocolType::UDP);
+        }
+
+        TEST_METHOD(Socket_CachedProperties)
+        {
+            Socket tcp(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP);
+            Socket udp(AddressFamily::InterNetworkV6, SocketType::Datagram, ProtocolType::Unspecified);
+
+            Assert::IsTrue(tcp.Family() == AddressFamily::InterNetwork);
+            Assert::IsTrue(tcp.Type() == SocketType::Stream);
+            Assert::IsTrue(tcp.Protocol() == ProtocolType::TCP);
+            Assert::IsTrue(udp.Family() == AddressFamily::InterNetworkV6);
+            Assert::IsTrue(udp.Type() == SocketType::Datagram);
+            Assert::IsTrue(udp.Protocol() == ProtocolType::UDP);
+
+            tcp.Close();
+            Assert::IsTrue(tcp.Family() == AddressFamily::InterNetwork);
+            Assert::IsTrue(tcp.Type() == SocketType::Stream);
+            Assert::IsTrue(tcp.Protocol() == ProtocolType::TCP);
+        }
+
+        TEST_METHOD(Socket_CreatePair)
+        {
+            SocketPtr first, second;
+            Vector<Byte> buffer(3);
+
+            Socket::CreatePair(SocketType::Stream, first, second);
+            Assert::IsTrue(first->IsConnected());
+            Assert::IsTrue(second->IsConnected());
+            Assert::AreEqual(3, first->Send(Vector<Byte>({ 1, 2, 3 })));
+            Assert::AreEqual(3, second->Receive(buffer));
+            Assert::AreEqual<Byte>(3, buffer[2]);
+        }
+
+#ifndef _MSC_VER
+        TEST_METHOD(Socket_ReceiveDuplicate)
+        {
+            SocketPtr channel, peer, client, server, copy;
+            SocketPtr listener(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+            AddrStorage address;
+            AddrLength length = sizeof(AddrStorage);
+            Vector<Byte> buffer(3);
+
+            Socket::CreatePair(SocketType::Stream, channel, peer);
+            listener->Bind(IPEndPointPtr(new IPEndPoint(0x7F000001, 0)));
+            listener->Listen(4);
+            getsockname(listener->Handle(), (Addr*)&address, &length);
+
+            // Ein gebundener und danach verbundener Socket bleibt verbunden.
+            client = SocketPtr(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+            client->Bind(IPEndPointPtr(new IPEndPoint(0x7F000001, 0)));
+            client->Connect(EndPoint::Create(Vector<Byte>((Byte*)&address, (Byte*)&address + sizeof(AddrStorage)), (U32)length));
+            server = listener->Accept();
+
+            Assert::IsTrue(client->DuplicateAndClose(channel).Options == SocketInformationOption::Connected);
+            Assert::IsTrue(client->Handle() == INVALID_SOCKET);
+
+            copy = Socket::ReceiveDuplicate(peer);
+            Assert::IsTrue(copy->IsConnected());
+            Assert::IsTrue(copy->Type() == SocketType::Stream);
+            Assert::IsTrue(copy->Protocol() == ProtocolType::TCP);
+            Assert::IsNotNull(copy->RemoteEndPoint().get());
+            Assert::AreEqual(3, copy->Send(Vector<Byte>({ 1, 2, 3 })));
+            Assert::AreEqual(3, server->Receive(buffer));
+            Assert::AreEqual<Byte>(3, buffer[2]);
+
+            // Der Listener wird nur dupliziert und nimmt danach in beiden
+            // Kopien Verbindungen an.
+            listener->Duplicate(channel);
+            copy = Socket::ReceiveDuplicate(peer);
+            Assert::IsTrue(copy->IsListening());
+            Assert::IsTrue(copy->IsBound());
+
+            client = SocketPtr(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+            client->Connect(EndPoint::Create(Vector<Byte>((Byte*)&address, (Byte*)&address + sizeof(AddrStorage)), (U32)length));
+            server = copy->Accept();
+            Assert::IsTrue(server->IsConnected());
+        }
+#endif
+
+        TEST_METHOD(Socket_DelayedClose)
+        {
+            SocketPtr socket(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+            socket->Close(0);
+            Assert::IsTrue(socket->Handle() != INVALID_SOCKET);
+
+            while (socket->Handle() != INVALID_SOCKET && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            Assert::IsTrue(socket->Handle() == INVALID_SOCKET);
+
+            // Der Zeitgeber darf einen bereits zerstörten Socket nicht mehr
+            // anfassen.
+            socket = SocketPtr(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+            socket->Close(0);
+            socket.reset();
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        TEST_METHOD(Socket_CachedPropertiesBenchmark)
+        {
+            const S32 iterations = 1000000;
+            Socket socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP);
+            S32 sum = 0;
+
+            auto begin = std::chrono::high_resolution_clock::now();
+
+            for (S32 i = 0; i < iterations; i++) {
+                S32 result, length = 4;
+                getsockopt(socket.Handle(), SOL_SOCKET, SO_TYPE, (char*)&result, (AddrLength*)&length);
+                sum += result;
+            }
+
+            auto syscall = std::chrono::high_resolution_clock::now() - begin;
+            begin = std::chrono::high_resolution_clock::now();
+
+            for (S32 i = 0; i < iterations; i++) {
+                sum += (S32)socket.Type();
+            }
+
+            auto cached = std::chrono::high_resolution_clock::now() - begin;
+            String message = "getsockopt: " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(syscall).count()) + "us, "
+                "Socket::Type: " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(cached).count()) + "us\n";
+
+            Logger::WriteMessage(message.c_str());
+            Assert::AreNotEqual(0, sum);
+        }
+    };
+}
@@ -1,6 +1,6 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
-#include <Lupus\Memory\StackAllocator.h>
+#include <Lupus/Memory/StackAllocator.h>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Lupus;
@@ -53,6 +53,56 @@ namespace FrameworkTest
             Assert::AreEqual(m1, allocator.GetMarker());
             Assert::AreNotEqual(m2, allocator.GetMarker());
             Assert::AreNotEqual(m3, allocator.GetMarker());
+
+            // Nach Clear steht wieder der gesamte Stack zur Verfügung.
+            Assert::IsNotNull(allocator.Allocate<U8>(32 * KiB));
+        }
+
+        TEST_METHOD(StackAllocator_Backing)
+        {
+            MemoryBacking backing;
+
+            backing.HugePages = true;
+            backing.NumaNode = 0;
+            backing.Prefault = true;
+
+            // Ohne Huge Pages bzw NUMA wird auf normale Seiten ausgewichen.
+            StackAllocator allocator(4 * 1024 * KiB, backing);
+            U8* block = allocator.Allocate<U8>(4 * 1024 * KiB);
+
+            Assert::IsNotNull(block);
+            Assert::AreEqual(0, (S32)((UIntPtr)block % (4 * KiB)));
+            memset(block, 0xFF, 4 * 1024 * KiB);
+            Assert::IsNull(allocator.Allocate<U8>());
+        }
+
+        TEST_METHOD(StackAllocator_Statistics)
+        {
+            StackAllocator allocator(1 * KiB);
+
+            allocator.Allocate<U8>(3);
+            allocator.Allocate<U32>(2);
+            Assert::IsNull(allocator.Allocate<U8>(2 * KiB));
+
+            AllocatorStatistics statistics = allocator.Statistics();
+#ifdef LUPUS_ALLOCATOR_STATISTICS
+            Assert::AreEqual<U64>(12, statistics.BytesInUse);
+            Assert::AreEqual<U64>(2, statistics.Allocations);
+            Assert::AreEqual<U64>(1, statistics.Failures);
+            Assert::AreEqual<U64>(1, statistics.AlignmentWaste);
+
+            // Der Höchststand bleibt nach der Freigabe bis zum nächsten Frame.
+            allocator.Clear();
+            allocator.Allocate<U8>(4);
+            allocator.NextFrame();
+            statistics = allocator.Statistics();
+            Assert::AreEqual<U64>(4, statistics.BytesInUse);
+            Assert::AreEqual<U64>(4, statistics.FramePeak);
+            Assert::AreEqual<U64>(12, statistics.LastFramePeak);
+            Assert::AreEqual<U64>(12, statistics.Peak);
+#else
+            Assert::AreEqual<U64>(0, statistics.Allocations);
+#endif
         }
 	};
 }
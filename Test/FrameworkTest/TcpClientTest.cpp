@@ -0,0 +1,116 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/TcpClient.h>
+#include <Lupus/Network/NetworkStream.h>
+#include <Lupus/Network/Socket.h>
+#include <Lupus/Network/IPAddress.h>
+#include <Lupus/Network/IPEndPoint.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(TcpClientTest)
+    {
+    public:
+
+        TEST_CLASS_INITIALIZE(TcpClientTest_Initialize)
+        {
+            WSADATA data;
+            WSAStartup(MAKEWORD(2, 2), &data);
+        }
+
+        TEST_CLASS_CLEANUP(TcpClientTest_Cleanup)
+        {
+            WSACleanup();
+        }
+
+        static U16 Listen(SocketPtr& listener)
+        {
+            AddrIn address;
+            AddrLength length = sizeof(AddrIn);
+
+            listener = SocketPtr(new Socket(AddressFamily::InterNetwork, SocketType::Stream, ProtocolType::TCP));
+            listener->Bind(IPEndPointPtr(new IPEndPoint(0x7F000001, 0)));
+            listener->Listen(1);
+            getsockname(listener->Handle(), (Addr*)&address, &length);
+            return ntohs(address.sin_port);
+        }
+
+        TEST_METHOD(TcpClient_Connect)
+        {
+            SocketPtr listener;
+            U16 port = Listen(listener);
+            TcpClient client;
+            Vector<Byte> buffer(3);
+
+            Assert::IsFalse(client.IsConnected());
+            Assert::ExpectException<socket_error>([&]() { client.GetStream(); });
+
+            client.Connect(IPAddress::Loopback, port);
+            SocketPtr server = listener->Accept();
+
+            Assert::IsTrue(client.IsConnected());
+            Assert::IsTrue(client.Active());
+            Assert::IsTrue(client.GetStream() == client.GetStream());
+
+            client.GetStream()->Write(Vector<Byte>({ 1, 2, 3 }));
+            Assert::AreEqual(0U, server->Available());
+            client.GetStream()->Flush();
+            Assert::AreEqual(3, server->Receive(buffer));
+            Assert::AreEqual<Byte>(3, buffer[2]);
+
+            Assert::AreEqual(2, server->Send(Vector<Byte>({ 4, 5 })));
+            Assert::AreEqual(2, client.GetStream()->Read(buffer));
+            Assert::AreEqual<Byte>(5, buffer[1]);
+
+            client.Close();
+            Assert::IsFalse(client.Active());
+            Assert::AreEqual(0, server->Receive(buffer));
+        }
+
+        TEST_METHOD(TcpClient_Options)
+        {
+            TcpClient client;
+
+            client.NoDelay(true);
+            Assert::IsTrue(client.NoDelay());
+            client.NoDelay(false);
+            Assert::IsFalse(client.NoDelay());
+
+            client.ExclusiveAddressUse(false);
+            Assert::IsFalse(client.ExclusiveAddressUse());
+            client.ExclusiveAddressUse(true);
+            Assert::IsTrue(client.ExclusiveAddressUse());
+
+            // Ein neuer Socket verwirft die zwischengespeicherten Werte, die
+            // Getter lesen dann die tatsächlichen Optionen.
+            client.Client(client.Client());
+            Assert::IsTrue(client.ExclusiveAddressUse());
+            Assert::IsFalse(client.NoDelay());
+
+            client.SendBuffer(64 * 1024);
+            Assert::IsTrue(client.SendBuffer() >= 64 * 1024);
+        }
+
+        TEST_METHOD(TcpClient_ExclusiveAddressUse)
+        {
+            SocketPtr listener;
+            U16 port = Listen(listener);
+            TcpClient first, second;
+
+            first.ExclusiveAddressUse(true);
+            first.Connect(IPAddress::Loopback, port);
+            listener->Accept();
+
+            // Der lokale Endpunkt der Verbindung ist exklusiv gebunden.
+            AddrStorage address;
+            AddrLength length = sizeof(AddrStorage);
+
+            getsockname(first.Client()->Handle(), (Addr*)&address, &length);
+            second.ExclusiveAddressUse(false);
+            Assert::AreNotEqual(0, bind(second.Client()->Handle(), (Addr*)&address, length));
+        }
+    };
+}
@@ -0,0 +1,81 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/TimerWheel.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(TimerWheelTest)
+    {
+    public:
+
+        TEST_METHOD(TimerWheel_StartAndStop)
+        {
+            TimerWheel wheel;
+            U64 fired = 0;
+            Timer first([&]() { fired = wheel.Now(); });
+            Timer second([&]() { Assert::Fail(L"stopped timer fired"); });
+
+            wheel.Start(first, 10);
+            wheel.Start(second, 5);
+            wheel.Stop(second);
+            Assert::AreEqual(1U, wheel.Count());
+            Assert::IsTrue(first.IsPending());
+            Assert::IsFalse(second.IsPending());
+            Assert::AreEqual(0U, wheel.Advance(9));
+            Assert::AreEqual(1U, wheel.Advance(10));
+            Assert::AreEqual<U64>(10, fired);
+            Assert::AreEqual(0U, wheel.Count());
+        }
+
+        TEST_METHOD(TimerWheel_Cascade)
+        {
+            const U64 delays[] = { 255, 256, 300, 65535, 65536, 70000, 16777217 };
+            TimerWheel wheel;
+            Vector<U64> fired;
+            Vector<TimerPtr> timers;
+
+            for (U64 delay : delays) {
+                timers.push_back(TimerPtr(new Timer([&]() { fired.push_back(wheel.Now()); })));
+                wheel.Start(*timers.back(), delay);
+            }
+
+            while (wheel.Count() > 0) {
+                wheel.Advance(wheel.Now() + wheel.NextExpiration());
+            }
+
+            Assert::AreEqual<size_t>(7, fired.size());
+
+            for (size_t i = 0; i < fired.size(); i++) {
+                Assert::AreEqual(delays[i], fired[i]);
+            }
+        }
+
+        TEST_METHOD(TimerWheel_Restart)
+        {
+            TimerWheel wheel;
+            Timer timer;
+            S32 count = 0;
+            bool owned = false;
+
+            timer.Callback([&]() {
+                if (++count < 5) {
+                    wheel.Start(timer, 10);
+                }
+            });
+
+            wheel.Start(timer, 10);
+            wheel.Schedule(3, [&]() { owned = true; });
+
+            for (U64 now = 1; now <= 100; now++) {
+                wheel.Advance(now);
+            }
+
+            Assert::AreEqual(5, count);
+            Assert::IsTrue(owned);
+            Assert::AreEqual(0U, wheel.Count());
+        }
+    };
+}
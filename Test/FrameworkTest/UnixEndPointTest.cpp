@@ -0,0 +1,55 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/UnixEndPoint.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(UnixEndPointTest)
+    {
+    public:
+
+        TEST_METHOD(UnixEndPoint_Constructor)
+        {
+            UnixEndPoint("/tmp/lupus.sock");
+            UnixEndPoint("lupus", true);
+
+            Assert::ExpectException<std::invalid_argument>([](){
+                UnixEndPoint("");
+            });
+
+            Assert::ExpectException<std::invalid_argument>([](){
+                UnixEndPoint(String(200, 'a'));
+            });
+        }
+
+        TEST_METHOD(UnixEndPoint_Path)
+        {
+            UnixEndPoint path("/tmp/lupus.sock");
+            UnixEndPoint name("lupus", true);
+
+            Assert::IsTrue(path.Family() == AddressFamily::UNIX);
+            Assert::AreEqual<String>("/tmp/lupus.sock", path.Path());
+            Assert::IsFalse(path.IsAbstract());
+            Assert::AreEqual<String>("lupus", name.Path());
+            Assert::IsTrue(name.IsAbstract());
+            Assert::IsTrue(path.Length() > name.Length());
+        }
+
+        TEST_METHOD(UnixEndPoint_Serialize)
+        {
+            UnixEndPoint name("lupus", true);
+            UnixEndPoint copy(name.Serialize(), name.Length());
+
+            Assert::AreEqual<String>("lupus", copy.Path());
+            Assert::IsTrue(copy.IsAbstract());
+            Assert::AreEqual(name.Length(), copy.Length());
+
+            Assert::ExpectException<std::invalid_argument>([](){
+                UnixEndPoint(Vector<Byte>(4), 4);
+            });
+        }
+    };
+}
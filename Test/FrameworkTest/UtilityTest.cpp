@@ -0,0 +1,92 @@
+﻿#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <Lupus/Network/Utility.h>
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Lupus;
+
+namespace FrameworkTest
+{
+    TEST_CLASS(UtilityTest)
+    {
+    public:
+
+        TEST_METHOD(Utility_ByteOrder)
+        {
+            Assert::AreEqual<U16>(htons(0x0102), HostToNetworkOrder((U16)0x0102));
+            Assert::AreEqual<U32>(htonl(0x01020304), HostToNetworkOrder((U32)0x01020304));
+            Assert::AreEqual<U64>(0x0102030405060708, NetworkToHostOrder(HostToNetworkOrder((U64)0x0102030405060708)));
+
+            // Die Inline Varianten liefern das selbe Ergebnis.
+            Assert::AreEqual(HostToNetworkOrder((U16)0x0102), ToNetworkOrder((U16)0x0102));
+            Assert::AreEqual(HostToNetworkOrder((U32)0x01020304), ToNetworkOrder((U32)0x01020304));
+            Assert::AreEqual(HostToNetworkOrder((U64)0x0102030405060708), ToNetworkOrder((U64)0x0102030405060708));
+            Assert::AreEqual<U32>(0x01020304, ToHostOrder(ToNetworkOrder((U32)0x01020304)));
+        }
+
+        TEST_METHOD(Utility_BulkByteOrder)
+        {
+            // Ungerade Anzahl und Versatz decken den Rest nach den
+            // SIMD-Blöcken und nicht ausgerichtete Zeiger ab.
+            Vector<U16> small(131);
+            Vector<U32> medium(131);
+            Vector<U64> large(131);
+            Vector<U16> small2(small.size());
+            Vector<U32> medium2(medium.size());
+            Vector<U64> large2(large.size());
+
+            for (U32 i = 0; i < 131; i++) {
+                small[i] = (U16)(i * 0x0301);
+                medium[i] = i * 0x07050301;
+                large[i] = i * 0x0F0D0B0907050301;
+            }
+
+            HostToNetworkOrder(small.data() + 1, small2.data() + 1, 130);
+            HostToNetworkOrder(medium.data() + 1, medium2.data() + 1, 130);
+            HostToNetworkOrder(large.data() + 1, large2.data() + 1, 130);
+
+            for (U32 i = 1; i < 131; i++) {
+                Assert::AreEqual(HostToNetworkOrder(small[i]), small2[i]);
+                Assert::AreEqual(HostToNetworkOrder(medium[i]), medium2[i]);
+                Assert::AreEqual(HostToNetworkOrder(large[i]), large2[i]);
+            }
+
+            // Umwandlung an Ort und Stelle.
+            NetworkToHostOrder(large2.data() + 1, large2.data() + 1, 130);
+            Assert::IsTrue(std::equal(large.begin() + 1, large.end(), large2.begin() + 1));
+        }
+
+        TEST_METHOD(Utility_BulkByteOrderBenchmark)
+        {
+            const S32 iterations = 2000;
+            Vector<U32> source(4096, 0x01020304), target(4096);
+            U32 sum = 0;
+
+            auto begin = std::chrono::high_resolution_clock::now();
+
+            for (S32 i = 0; i < iterations; i++) {
+                for (size_t j = 0; j < source.size(); j++) {
+                    target[j] = htonl(source[j]);
+                }
+
+                sum += target[i % target.size()];
+            }
+
+            auto single = std::chrono::high_resolution_clock::now() - begin;
+            begin = std::chrono::high_resolution_clock::now();
+
+            for (S32 i = 0; i < iterations; i++) {
+                HostToNetworkOrder(source.data(), target.data(), (U32)source.size());
+                sum += target[i % target.size()];
+            }
+
+            auto bulk = std::chrono::high_resolution_clock::now() - begin;
+            String message = "htonl: " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(single).count()) + "us, "
+                "HostToNetworkOrder: " + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(bulk).count()) + "us\n";
+
+            Logger::WriteMessage(message.c_str());
+            Assert::AreNotEqual(0U, sum);
+        }
+    };
+}